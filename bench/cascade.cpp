@@ -0,0 +1,152 @@
+// Benchmark da exclusão em cascata de professores: compara
+// ProfessorService::deleteById com o caminho anterior (excluir os
+// agendamentos horário por horário, cada um com uma reescrita de
+// agendamentos.csv), conta as reescritas de cada tabela e confere que não
+// sobram horários nem agendamentos dos professores excluídos.
+//
+// Uso: cascade [professores] [horarios_por_professor] [amostras] [saida.json]
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "service/agendamentoService.hpp"
+#include "service/horarioService.hpp"
+#include "service/professorService.hpp"
+#include "util/academicTerm.hpp"
+#include "util/metrics.hpp"
+
+using std::cout;
+using std::endl;
+using std::min;
+using std::stoi;
+using std::string;
+using std::to_string;
+using std::vector;
+
+// As reescritas acumuladas de uma tabela.
+static uint64_t reescritas(const string& tabela) {
+    return MetricsRegistry::instance()
+        .counter("appointment_table_rewrites_total",
+                 "table=\"" + tabela + "\"")
+        .load();
+}
+
+int main(int argc, char** argv) {
+    int professores = argc > 1 ? stoi(argv[1]) : 20;
+    int porProfessor = argc > 2 ? stoi(argv[2]) : 500;
+    size_t amostras = argc > 3 ? stoi(argv[3]) : 3;
+    string saida = argc > 4 ? argv[4] : "cascade.json";
+
+    amostras = min(amostras, size_t(professores / 2));
+
+    Sandbox sandbox("bench-cascade");
+
+    long base = current_term().inicio;
+    vector<string> linhasProfessores, alunos, horarios, agendamentos;
+    long id = 1;
+
+    for (int p = 1; p <= professores; ++p) {
+        linhasProfessores.push_back(to_string(p) + ",Professor " +
+                                    to_string(p) + ",prof" + to_string(p) +
+                                    "@bench.com,x,Disciplina");
+        alunos.push_back(to_string(p) + ",Aluno " + to_string(p) + ",aluno" +
+                         to_string(p) + "@bench.com,x," + to_string(p));
+
+        // Um agendamento por horário; um a cada três confirmado.
+        for (int h = 0; h < porProfessor; ++h, ++id) {
+            long inicio = base + id * 3600;
+            bool confirmado = id % 3 == 0;
+
+            horarios.push_back(to_string(id) + "," + to_string(p) + "," +
+                               to_string(inicio) + "," +
+                               to_string(inicio + 3600) +
+                               (confirmado ? ",0,1" : ",1,0"));
+            agendamentos.push_back(
+                to_string(id) + "," + to_string(id % professores + 1) + "," +
+                to_string(id) + (confirmado ? ",CONFIRMADO" : ",PENDENTE"));
+        }
+    }
+
+    sandbox.write(
+        Fixture{linhasProfessores, alunos, horarios, agendamentos});
+
+    MockConnection connection;
+    EventBus bus;
+    EntityManager manager(connection, bus);
+    ProfessorService& service = *manager.getProfessorService();
+    HorarioService& horarioService = *manager.getHorarioService();
+    AgendamentoService& agendamentoService = *manager.getAgendamentoService();
+
+    Report report("cascade");
+    report.set("professores", to_string(professores));
+    report.set("horarios_por_professor", to_string(porProfessor));
+
+    // Caminho anterior: os agendamentos de cada horário, um a um, e depois
+    // os horários e o professor.
+    uint64_t antes = reescritas(AGENDAMENTO_TABLE);
+
+    report.add(measure("horário a horário", "excluir professor", amostras,
+                       [&](size_t i) {
+                           long professor = long(i) + 1;
+
+                           for (const auto& horario :
+                                horarioService.listByIdProfessor(professor))
+                               agendamentoService.deleteByIdHorario(
+                                   horario->getId());
+
+                           service.deleteById(professor);
+                       }));
+
+    uint64_t anterior = reescritas(AGENDAMENTO_TABLE) - antes;
+
+    antes = reescritas(AGENDAMENTO_TABLE);
+    uint64_t antesHorarios = reescritas(HORARIO_TABLE);
+
+    report.add(measure("ProfessorService", "deleteById", amostras,
+                       [&](size_t i) {
+                           service.deleteById(long(amostras + i) + 1);
+                       }));
+
+    uint64_t cascata = reescritas(AGENDAMENTO_TABLE) - antes;
+    uint64_t cascataHorarios = reescritas(HORARIO_TABLE) - antesHorarios;
+
+    cout << "Reescritas de agendamentos por professor: anterior "
+         << anterior / amostras << ", em cascata " << cascata / amostras
+         << endl;
+    cout << "Reescritas de horários por professor: "
+         << cascataHorarios / amostras << endl;
+
+    // Nenhum horário nem agendamento dos professores excluídos fica para
+    // trás, e os demais continuam lá.
+    size_t divergencias = 0;
+    size_t restantes = size_t(professores) - 2 * amostras;
+
+    for (size_t p = 1; p <= 2 * amostras; ++p)
+        if (!horarioService.listByIdProfessor(long(p)).empty())
+            ++divergencias;
+
+    if (connection.selectAll(HORARIO_TABLE).size() !=
+            restantes * porProfessor ||
+        connection.selectAll(AGENDAMENTO_TABLE).size() !=
+            restantes * porProfessor)
+        ++divergencias;
+
+    if (cascata != amostras || cascataHorarios != amostras)
+        ++divergencias;
+
+    cout << "Divergências: " << divergencias << endl;
+
+    if (!report.write(saida)) {
+        cout << "Falha ao gravar " << saida << endl;
+        return 1;
+    }
+
+    cout << "Resultados gravados em " << saida << endl;
+
+    return divergencias == 0 ? 0 : 1;
+}
@@ -0,0 +1,123 @@
+// Benchmark de contenção: várias threads tentam confirmar agendamentos
+// pendentes que disputam os mesmos horários. Ao final, cada horário deve ter
+// exatamente um agendamento CONFIRMADO.
+//
+// Uso: contention [threads] [horarios] [pedidos_por_horario]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "model/agendamento.hpp"
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "service/agendamentoService.hpp"
+
+using std::atomic;
+using std::cout;
+using std::endl;
+using std::invalid_argument;
+using std::map;
+using std::mt19937;
+using std::stoi;
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+int main(int argc, char** argv) {
+    int threads = argc > 1 ? stoi(argv[1]) : 8;
+    int horarios = argc > 2 ? stoi(argv[2]) : 50;
+    int pedidos = argc > 3 ? stoi(argv[3]) : 8;
+
+    Sandbox sandbox("bench-contention");
+
+    vector<string> professores, alunos, slots, agendamentos;
+
+    professores.push_back("1,Professor Bench,prof@bench.com,x,Benchmark");
+
+    for (int a = 1; a <= pedidos; ++a)
+        alunos.push_back(to_string(a) + ",Aluno " + to_string(a) + ",aluno" +
+                         to_string(a) + "@bench.com,x," + to_string(a));
+
+    long id = 1;
+    for (int h = 1; h <= horarios; ++h) {
+        long inicio = 1767225600 + h * 3600L;
+        slots.push_back(to_string(h) + ",1," + to_string(inicio) + "," +
+                        to_string(inicio + 1800) + ",1,0");
+
+        for (int a = 1; a <= pedidos; ++a)
+            agendamentos.push_back(to_string(id++) + "," + to_string(a) + "," +
+                                   to_string(h) + ",PENDENTE");
+    }
+
+    sandbox.write(Fixture{professores, alunos, slots, agendamentos});
+
+    MockConnection connection;
+    EventBus bus;
+    EntityManager manager(connection, bus);
+    const auto& service = manager.getAgendamentoService();
+
+    vector<long> ids(agendamentos.size());
+    for (size_t i = 0; i < ids.size(); ++i)
+        ids[i] = static_cast<long>(i) + 1;
+    shuffle(ids.begin(), ids.end(), mt19937(42));
+
+    atomic<long> confirmados{0}, rejeitados{0}, erros{0};
+    vector<thread> pool;
+
+    auto inicio = steady_clock::now();
+
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            for (size_t i = t; i < ids.size(); i += threads) {
+                try {
+                    service->updateStatusById(ids[i], Status::CONFIRMADO);
+                    ++confirmados;
+                } catch (const invalid_argument&) {
+                    ++rejeitados;
+                } catch (const std::exception&) {
+                    ++erros;
+                }
+            }
+        });
+    }
+
+    for (auto& th : pool)
+        th.join();
+
+    double segundos = duration<double>(steady_clock::now() - inicio).count();
+
+    map<long, int> porHorario;
+    for (const auto& linha : connection.selectAll(AGENDAMENTO_TABLE)) {
+        auto ag = service->getById(getIdFromLine(linha));
+        if (ag->getStatus() == Status::CONFIRMADO)
+            ++porHorario[ag->getHorarioId()];
+    }
+
+    bool ok = static_cast<int>(porHorario.size()) == horarios;
+    for (const auto& par : porHorario)
+        ok = ok && par.second == 1;
+
+    cout << "threads:      " << threads << endl;
+    cout << "horarios:     " << horarios << endl;
+    cout << "tentativas:   " << ids.size() << endl;
+    cout << "confirmados:  " << confirmados << endl;
+    cout << "rejeitados:   " << rejeitados << endl;
+    cout << "erros:        " << erros << endl;
+    cout << "tempo (s):    " << segundos << endl;
+    cout << "ops/s:        " << ids.size() / segundos << endl;
+    cout << "invariante:   "
+         << (ok ? "OK (um CONFIRMADO por horario)" : "VIOLADA") << endl;
+
+    return ok && erros == 0 ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+#ifndef BENCH_DATASET_HPP
+#define BENCH_DATASET_HPP
+
+#include <algorithm>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "zipf.hpp"
+
+/**
+ * @brief Parâmetros de geração de uma pasta `data/` sintética.
+ * * Quantidades 0 são derivadas do número de agendamentos.
+ */
+struct DatasetConfig {
+    long agendamentos = 10000; /**< Número de agendamentos. */
+    long alunos = 0;           /**< Padrão: agendamentos / 20 (mín. 10). */
+    long professores = 0;      /**< Padrão: agendamentos / 500 (mín. 5). */
+    long horarios = 0;         /**< Padrão: agendamentos / 4 (mín. 10). */
+    int slotsPorSemana = 10;   /**< Horários semanais de cada professor. */
+    double zipf = 0.0;         /**< Assimetria da procura por professor. */
+    std::string senha = "x";   /**< Hash gravado para todos os usuários. */
+    unsigned seed = 42;        /**< Semente do gerador. */
+
+    /**
+     * @brief Pesos de PENDENTE, CONFIRMADO, RECUSADO e CANCELADO.
+     */
+    std::vector<double> status = {50, 20, 15, 15};
+};
+
+/**
+ * @brief Quantidades efetivamente geradas.
+ */
+struct Dataset {
+    long agendamentos, alunos, professores, horarios;
+    long porProfessor; /**< Horários por professor (o último pode ter menos). */
+
+    /**
+     * @brief Retorna o primeiro e o último ID de horário de um professor.
+     */
+    std::pair<long, long> horariosDe(long professor) const {
+        long first = (professor - 1) * porProfessor + 1;
+        return {first, std::min(horarios, first + porProfessor - 1)};
+    }
+};
+
+/**
+ * @brief Gera as quatro tabelas no sandbox, de forma coerente.
+ * * Cada professor tem uma grade semanal fixa (`slotsPorSemana` horários de
+ * 1h, de segunda a sexta) repetida semana após semana a partir de
+ * 05/01/2026, e os horários de um professor têm IDs contíguos. Cada
+ * agendamento escolhe o professor pela distribuição de Zipf (professores com
+ * ID menor são mais procurados), um horário dele e um aluno uniformemente, e
+ * um status pelos pesos configurados. Cada horário tem no máximo um
+ * agendamento CONFIRMADO, e só os horários sem confirmação ficam
+ * disponíveis. As linhas são gravadas direto no arquivo, sem manter a tabela
+ * em memória.
+ * @param sandbox O sandbox de destino.
+ * @param config Os parâmetros de geração.
+ * @return Dataset As quantidades geradas.
+ */
+inline Dataset generate_dataset(const Sandbox& sandbox, DatasetConfig config) {
+    Dataset d;
+    d.agendamentos = config.agendamentos;
+    d.alunos = config.alunos ? config.alunos
+                             : std::max(10L, config.agendamentos / 20);
+    d.professores = config.professores
+                        ? config.professores
+                        : std::max(5L, config.agendamentos / 500);
+    d.horarios = config.horarios ? config.horarios
+                                 : std::max(10L, config.agendamentos / 4);
+
+    std::mt19937_64 rng(config.seed);
+
+    std::ofstream professores(sandbox.table(PROFESSOR_TABLE));
+    professores << PROFESSOR_HEADER << "\n";
+    for (long p = 1; p <= d.professores; ++p)
+        professores << p << ",Professor " << p << ",prof" << p
+                    << "@bench.com," << config.senha << ",Disciplina "
+                    << (p % 40) << "\n";
+
+    std::ofstream alunos(sandbox.table(ALUNO_TABLE));
+    alunos << ALUNO_HEADER << "\n";
+    for (long a = 1; a <= d.alunos; ++a)
+        alunos << a << ",Aluno " << a << ",aluno" << a << "@bench.com,"
+               << config.senha << "," << (100000 + a) << "\n";
+
+    d.porProfessor = (d.horarios + d.professores - 1) / d.professores;
+    long comHorarios = (d.horarios + d.porProfessor - 1) / d.porProfessor;
+
+    std::vector<bool> confirmado(d.horarios + 1, false);
+    std::uniform_int_distribution<long> aluno(1, d.alunos);
+    Zipf professor(comHorarios, config.zipf);
+    std::discrete_distribution<int> status(config.status.begin(),
+                                           config.status.end());
+    static const char* nomes[] = {"PENDENTE", "CONFIRMADO", "RECUSADO",
+                                  "CANCELADO"};
+
+    std::ofstream agendamentos(sandbox.table(AGENDAMENTO_TABLE));
+    agendamentos << AGENDAMENTO_HEADER << "\n";
+    for (long i = 1; i <= d.agendamentos; ++i) {
+        auto faixa = d.horariosDe(professor(rng));
+        long h = std::uniform_int_distribution<long>(faixa.first,
+                                                     faixa.second)(rng);
+        int s = status(rng);
+
+        if (s == 1 && confirmado[h])
+            s = 2;
+        if (s == 1)
+            confirmado[h] = true;
+
+        agendamentos << i << "," << aluno(rng) << "," << h << "," << nomes[s]
+                     << "\n";
+    }
+
+    // Segunda-feira, 05/01/2026, 00:00 UTC.
+    const long segunda = 1767571200;
+    const int porSemana = std::max(1, std::min(config.slotsPorSemana, 25));
+
+    std::ofstream horarios(sandbox.table(HORARIO_TABLE));
+    horarios << HORARIO_HEADER << "\n";
+    for (long h = 1; h <= d.horarios; ++h) {
+        long p = (h - 1) / d.porProfessor + 1;
+        long k = (h - 1) % d.porProfessor;
+        long semana = k / porSemana, slot = k % porSemana;
+        long inicio = segunda + semana * 7 * 86400 + (slot % 5) * 86400 +
+                      (8 + 2 * (slot / 5) + p % 2) * 3600;
+
+        horarios << h << "," << p << "," << inicio << "," << inicio + 3600
+                 << "," << (confirmado[h] ? 0 : 1) << ",0\n";
+    }
+
+    return d;
+}
+
+#endif
@@ -0,0 +1,216 @@
+// Benchmark da busca de horários livres de todos os professores: compara a
+// primeira página de HorarioService::listDisponiveisBetween com o caminho
+// anterior (listar os professores e percorrer os horários disponíveis de cada
+// um), confere que as duas dão a mesma página, também depois de reservas, e
+// mede a paginação.
+//
+// Uso: freeSlots [professores] [horarios_por_professor] [amostras]
+//                [saida.json]
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "harness.hpp"
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "service/horarioService.hpp"
+#include "service/professorService.hpp"
+#include "util/academicTerm.hpp"
+
+using std::cout;
+using std::endl;
+using std::make_pair;
+using std::min;
+using std::shared_ptr;
+using std::sort;
+using std::stoi;
+using std::string;
+using std::to_string;
+using std::vector;
+
+#define PAGINA 20
+#define DISCIPLINAS 20
+#define SEMANA (7 * 86400L)
+
+// Caminho anterior: todos os professores e, de cada um, os disponíveis.
+static vector<long> por_professor(ProfessorService& professores,
+                                  Timestamp de, Timestamp ate) {
+    vector<shared_ptr<Horario>> livres;
+
+    for (const auto& professor : professores.listAll())
+        for (const auto& horario : *professor->getHorariosDisponiveis())
+            if (horario->getInicio() >= de && horario->getInicio() < ate)
+                livres.push_back(horario);
+
+    sort(livres.begin(), livres.end(),
+         [](const shared_ptr<Horario>& a, const shared_ptr<Horario>& b) {
+             return make_pair(a->getInicio(), a->getId()) <
+                    make_pair(b->getInicio(), b->getId());
+         });
+
+    vector<long> ids;
+    for (size_t i = 0; i < min(livres.size(), size_t(PAGINA)); ++i)
+        ids.push_back(livres[i]->getId());
+
+    return ids;
+}
+
+int main(int argc, char** argv) {
+    int professores = argc > 1 ? stoi(argv[1]) : 10000;
+    int porProfessor = argc > 2 ? stoi(argv[2]) : 20;
+    size_t amostras = argc > 3 ? stoi(argv[3]) : 200;
+    string saida = argc > 4 ? argv[4] : "freeSlots.json";
+
+    Sandbox sandbox("bench-free-slots");
+
+    AcademicTerm periodo = current_term();
+    long semanas = (periodo.fim - periodo.inicio) / SEMANA;
+
+    vector<string> linhasProfessores, horarios;
+    long id = 1;
+
+    for (int p = 1; p <= professores; ++p) {
+        linhasProfessores.push_back(
+            to_string(p) + ",Professor " + to_string(p) + ",prof" +
+            to_string(p) + "@bench.com,x,Disciplina " +
+            to_string(p % DISCIPLINAS));
+
+        for (int h = 0; h < porProfessor; ++h, ++id) {
+            long inicio = periodo.inicio + (id * 7919 % semanas) * SEMANA +
+                          (id % 10) * 3600 + p % 60 * 60;
+            horarios.push_back(to_string(id) + "," + to_string(p) + "," +
+                               to_string(inicio) + "," +
+                               to_string(inicio + 3600) + "," +
+                               (id % 10 < 7 ? "1" : "0") + ",0");
+        }
+    }
+
+    sandbox.write(Fixture{linhasProfessores, {}, horarios, {}});
+
+    MockConnection connection;
+    EventBus bus;
+    EntityManager manager(connection, bus);
+    HorarioService& service = *manager.getHorarioService();
+    ProfessorService& professorService = *manager.getProfessorService();
+
+    Report report("freeSlots");
+    report.set("professores", to_string(professores));
+    report.set("horarios", to_string(horarios.size()));
+    report.set("pagina", to_string(PAGINA));
+
+    // Janela de uma semana, que anda pelo período a cada amostra.
+    auto janela = [&](size_t i) {
+        Timestamp de = periodo.inicio + long(i % semanas) * SEMANA;
+        return make_pair(de, de + SEMANA);
+    };
+
+    size_t divergencias = 0;
+    size_t base = min(amostras, size_t(3));
+
+    for (size_t i = 0; i < base; ++i) {
+        auto [de, ate] = janela(i);
+        vector<long> esperado = por_professor(professorService, de, ate);
+        vector<long> obtido;
+
+        for (const auto& horario :
+             service.listDisponiveisBetween(de, ate, "", {}, PAGINA).horarios)
+            obtido.push_back(horario->getId());
+
+        if (obtido != esperado)
+            ++divergencias;
+    }
+
+    // Reservas depois das buscas: o índice e as visões dos professores são
+    // atualizados no lugar, e os dois caminhos continuam iguais.
+    for (size_t i = 0; i < base; ++i) {
+        auto [de, ate] = janela(i);
+        auto livres =
+            service.listDisponiveisBetween(de, ate, "", {}, PAGINA).horarios;
+
+        for (size_t j = 0; j < livres.size(); j += 3)
+            service.reservarById(livres[j]->getId());
+
+        vector<long> esperado = por_professor(professorService, de, ate);
+        vector<long> obtido;
+
+        for (const auto& horario :
+             service.listDisponiveisBetween(de, ate, "", {}, PAGINA).horarios)
+            obtido.push_back(horario->getId());
+
+        if (obtido != esperado)
+            ++divergencias;
+    }
+
+    cout << "Divergências: " << divergencias << endl;
+
+    size_t sink = 0;
+
+    report.add(measure("por professor", "primeira página", base,
+                       [&](size_t i) {
+                           auto [de, ate] = janela(i);
+                           sink += por_professor(professorService, de, ate)
+                                       .size();
+                       }));
+    report.add(measure("HorarioService", "listDisponiveisBetween", amostras,
+                       [&](size_t i) {
+                           auto [de, ate] = janela(i);
+                           sink += service
+                                       .listDisponiveisBetween(de, ate, "", {},
+                                                               PAGINA)
+                                       .horarios.size();
+                       }));
+    report.add(measure("HorarioService", "reserva e página", amostras,
+                       [&](size_t i) {
+                           auto [de, ate] = janela(i);
+                           auto page = service.listDisponiveisBetween(
+                               de, ate, "", {}, PAGINA);
+                           if (page.horarios.empty())
+                               return;
+                           long id = page.horarios.front()->getId();
+                           service.reservarById(id);
+                           sink += service
+                                       .listDisponiveisBetween(de, ate, "", {},
+                                                               PAGINA)
+                                       .horarios.size();
+                           service.liberarById(id);
+                       }));
+    report.add(measure("HorarioService", "com disciplina", amostras,
+                       [&](size_t i) {
+                           auto [de, ate] = janela(i);
+                           string disciplina =
+                               "Disciplina " + to_string(i % DISCIPLINAS);
+                           sink += service
+                                       .listDisponiveisBetween(
+                                           de, ate, disciplina, {}, PAGINA)
+                                       .horarios.size();
+                       }));
+    report.add(measure("HorarioService", "10 páginas", amostras,
+                       [&](size_t i) {
+                           auto [de, ate] = janela(i);
+                           TimeIndex::Cursor cursor;
+                           for (int p = 0; p < 10; ++p) {
+                               HorarioPage page =
+                                   service.listDisponiveisBetween(
+                                       de, ate, "", cursor, PAGINA);
+                               sink += page.horarios.size();
+                               if (!page.hasMore)
+                                   break;
+                               cursor = page.next;
+                           }
+                       }));
+
+    if (sink == 0)
+        cout << endl;
+
+    if (!report.write(saida)) {
+        cout << "Falha ao gravar " << saida << endl;
+        return 1;
+    }
+
+    cout << "Resultados gravados em " << saida << endl;
+
+    return divergencias == 0 ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+#ifndef BENCH_HARNESS_HPP
+#define BENCH_HARNESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Resumo estatístico de uma série de medições.
+ */
+struct Summary {
+    std::string group;   /**< Camada medida (ex: MockConnection). */
+    std::string name;    /**< Operação medida. */
+    size_t count = 0;    /**< Número de execuções. */
+    double seconds = 0;  /**< Tempo total (s). */
+    double opsPerSec = 0; /**< Vazão. */
+    double meanUs = 0;   /**< Latência média (us). */
+    double p50Us = 0;    /**< Mediana (us). */
+    double p90Us = 0;    /**< Percentil 90 (us). */
+    double p99Us = 0;    /**< Percentil 99 (us). */
+    double p999Us = 0;   /**< Percentil 99,9 (us). */
+    double maxUs = 0;    /**< Latência máxima (us). */
+};
+
+/**
+ * @brief Acumula latências individuais e calcula percentis.
+ */
+class LatencyRecorder {
+   private:
+    std::vector<double> samples; /**< Latências em microssegundos. */
+
+    double percentile(double p) const {
+        if (samples.empty())
+            return 0;
+
+        size_t index = static_cast<size_t>(p * (samples.size() - 1) + 0.5);
+        return samples[std::min(index, samples.size() - 1)];
+    }
+
+   public:
+    /**
+     * @brief Registra uma latência.
+     * @param us A latência em microssegundos.
+     */
+    void record(double us) {
+        samples.push_back(us);
+    }
+
+    /**
+     * @brief Incorpora as latências de outro registro (ex: de outra thread).
+     * @param other O outro registro.
+     */
+    void merge(const LatencyRecorder& other) {
+        samples.insert(samples.end(), other.samples.begin(),
+                       other.samples.end());
+    }
+
+    /**
+     * @brief Calcula o resumo das latências registradas.
+     * @param group A camada medida.
+     * @param name A operação medida.
+     * @param seconds O tempo total da série.
+     * @return Summary O resumo.
+     */
+    Summary summarize(const std::string& group, const std::string& name,
+                      double seconds) {
+        std::sort(samples.begin(), samples.end());
+
+        Summary s;
+        s.group = group;
+        s.name = name;
+        s.count = samples.size();
+        s.seconds = seconds;
+        s.opsPerSec = seconds > 0 ? s.count / seconds : 0;
+
+        double total = 0;
+        for (double sample : samples)
+            total += sample;
+
+        s.meanUs = s.count ? total / s.count : 0;
+        s.p50Us = percentile(0.50);
+        s.p90Us = percentile(0.90);
+        s.p99Us = percentile(0.99);
+        s.p999Us = percentile(0.999);
+        s.maxUs = samples.empty() ? 0 : samples.back();
+
+        return s;
+    }
+};
+
+/**
+ * @brief Executa `fn(i)` para i em [0, iterations) medindo cada chamada.
+ * @tparam Fn A função medida.
+ * @param group A camada medida.
+ * @param name A operação medida.
+ * @param iterations O número de execuções.
+ * @param fn A função medida.
+ * @return Summary O resumo da série.
+ */
+template <typename Fn>
+Summary measure(const std::string& group, const std::string& name,
+                size_t iterations, Fn&& fn) {
+    using std::chrono::duration;
+    using std::chrono::steady_clock;
+
+    LatencyRecorder recorder;
+    auto start = steady_clock::now();
+
+    for (size_t i = 0; i < iterations; ++i) {
+        auto before = steady_clock::now();
+        fn(i);
+        recorder.record(
+            duration<double, std::micro>(steady_clock::now() - before).count());
+    }
+
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    return recorder.summarize(group, name, seconds);
+}
+
+/**
+ * @brief Relatório dos resultados, impresso em tabela e gravado em JSON.
+ * * O JSON tem um objeto `meta` (parâmetros da execução) e uma lista
+ * `results` com um objeto por operação, para acompanhamento de regressões.
+ */
+class Report {
+   private:
+    std::string benchmark; /**< Nome do benchmark. */
+    std::vector<std::pair<std::string, std::string>> meta; /**< Parâmetros. */
+    std::vector<Summary> results; /**< Resultados. */
+
+    static std::string quote(const std::string& value) {
+        std::string out = "\"";
+
+        for (char c : value) {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+
+        return out + "\"";
+    }
+
+   public:
+    /**
+     * @brief Construtor da classe Report.
+     * @param benchmark O nome do benchmark.
+     */
+    explicit Report(const std::string& benchmark) : benchmark(benchmark) {}
+
+    /**
+     * @brief Registra um parâmetro da execução.
+     */
+    void set(const std::string& key, const std::string& value) {
+        meta.emplace_back(key, value);
+    }
+
+    /**
+     * @brief Adiciona um resultado e o imprime.
+     */
+    void add(const Summary& s) {
+        results.push_back(s);
+
+        std::cout << std::left << std::setw(20) << s.group << std::setw(22)
+                  << s.name << std::right << std::fixed
+                  << std::setprecision(1) << std::setw(12) << s.opsPerSec
+                  << " ops/s  p50 " << std::setw(9) << s.p50Us << " us  p99 "
+                  << std::setw(9) << s.p99Us << " us  max " << std::setw(9)
+                  << s.maxUs << " us" << std::endl;
+    }
+
+    /**
+     * @brief Grava o relatório em JSON.
+     * @param path O caminho do arquivo.
+     * @return bool True se o arquivo foi gravado.
+     */
+    bool write(const std::string& path) const {
+        std::ofstream out(path, std::ios::trunc);
+
+        if (!out.is_open())
+            return false;
+
+        out << std::fixed << std::setprecision(3);
+        out << "{\n  \"benchmark\": " << quote(benchmark) << ",\n";
+        out << "  \"timestamp\": " << std::time(nullptr) << ",\n";
+        out << "  \"meta\": {";
+
+        for (size_t i = 0; i < meta.size(); ++i)
+            out << (i ? ", " : "") << quote(meta[i].first) << ": "
+                << quote(meta[i].second);
+
+        out << "},\n  \"results\": [\n";
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Summary& s = results[i];
+            out << "    {\"group\": " << quote(s.group)
+                << ", \"op\": " << quote(s.name) << ", \"count\": " << s.count
+                << ", \"seconds\": " << s.seconds
+                << ", \"ops_per_sec\": " << s.opsPerSec
+                << ", \"mean_us\": " << s.meanUs << ", \"p50_us\": " << s.p50Us
+                << ", \"p90_us\": " << s.p90Us << ", \"p99_us\": " << s.p99Us
+                << ", \"p999_us\": " << s.p999Us
+                << ", \"max_us\": " << s.maxUs << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n}\n";
+
+        return true;
+    }
+};
+
+#endif
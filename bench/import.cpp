@@ -0,0 +1,140 @@
+// Benchmark da importação de alunos em lote: mede o cadastro um a um
+// (AlunoController::create, com duas consultas de unicidade, a busca do
+// maior ID e um anexo por aluno) em amostras com a tabela vazia e cheia e a
+// importação de um arquivo inteiro (AlunoController::importar), e confere que
+// todos os alunos foram gravados com IDs distintos e que reimportar o arquivo
+// não grava nada.
+// O custo do hash é fixado em `iteracoes_kdf` (padrão: 10, bem abaixo do de
+// produção) para que a medição mostre o caminho de E/S e de validação; o hash
+// escala com o número de núcleos.
+//
+// Uso: import [alunos] [um_a_um] [iteracoes_kdf] [saida.json]
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "controller/alunoController.hpp"
+#include "harness.hpp"
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "util/kdf.hpp"
+
+using std::cout;
+using std::endl;
+using std::ofstream;
+using std::stoi;
+using std::stoul;
+using std::string;
+using std::to_string;
+using std::unordered_set;
+using std::vector;
+
+#define ARQUIVO "alunos_import.csv"
+
+static string nome(size_t i) { return "Aluno " + to_string(i); }
+
+static string email(size_t i) { return "aluno" + to_string(i) + "@bench.com"; }
+
+static long matricula(size_t i) { return 30000000 + long(i); }
+
+int main(int argc, char** argv) {
+    size_t alunos = argc > 1 ? stoul(argv[1]) : 100000;
+    size_t umAUm = argc > 2 ? stoul(argv[2]) : 500;
+    uint32_t iteracoes = argc > 3 ? stoi(argv[3]) : 10;
+    string saida = argc > 4 ? argv[4] : "import.json";
+
+    set_kdf_iterations(iteracoes);
+
+    Sandbox sandbox("bench-import");
+
+    sandbox.write(Fixture{});
+
+    {
+        ofstream arquivo(ARQUIVO);
+
+        arquivo << "nome,email,senha,matricula\n";
+        for (size_t i = 0; i < alunos; ++i)
+            arquivo << nome(i) << "," << email(i) << ",senha" << i << ","
+                    << matricula(i) << "\n";
+    }
+
+    MockConnection connection;
+    EventBus bus;
+    EntityManager manager(connection, bus);
+    AlunoController controller(manager.getAlunoService());
+
+    Report report("import");
+    report.set("alunos", to_string(alunos));
+    report.set("kdf_iteracoes", to_string(iteracoes));
+
+    // Caminho anterior, em uma amostra: o custo de cada cadastro cresce com
+    // a tabela, então a média subestima o de um arquivo inteiro.
+    Summary individual =
+        measure("um a um", "AlunoController::create", umAUm, [&](size_t i) {
+            controller.create(nome(alunos + i), email(alunos + i),
+                              "senha" + to_string(i), matricula(alunos + i));
+        });
+    report.add(individual);
+
+    sandbox.write(ALUNO_TABLE, {});
+
+    size_t divergencias = 0;
+    ImportReport resultado;
+
+    report.add(measure("em lote", "AlunoController::importar", 1, [&](size_t) {
+        resultado = controller.importar(ARQUIVO);
+    }));
+
+    if (resultado.importados != alunos || !resultado.erros.empty())
+        ++divergencias;
+
+    // Todos os alunos gravados, com IDs distintos e senhas verificáveis.
+    auto linhas = connection.selectAll(ALUNO_TABLE);
+    unordered_set<long> ids;
+
+    for (const string& linha : linhas)
+        ids.insert(getIdFromLine(linha));
+
+    if (linhas.size() != alunos || ids.size() != alunos)
+        ++divergencias;
+
+    auto ultimo = manager.getAlunoService()->getById(long(alunos));
+
+    if (!ultimo || !verify_kdf(ultimo->getSenha(),
+                               "senha" + to_string(alunos - 1)))
+        ++divergencias;
+
+    // Reimportar o mesmo arquivo recusa todas as linhas.
+    resultado = controller.importar(ARQUIVO);
+
+    if (resultado.importados != 0 || resultado.erros.size() != alunos)
+        ++divergencias;
+
+    // O mesmo cadastro com a tabela cheia: o custo cresce linearmente com a
+    // tabela, então o de um arquivo inteiro é estimado pela média das duas
+    // amostras.
+    Summary cheia = measure(
+        "um a um", "AlunoController::create (tabela cheia)", umAUm / 10 + 1,
+        [&](size_t i) {
+            size_t j = 2 * alunos + i;
+            controller.create(nome(j), email(j), "senha" + to_string(i),
+                              matricula(j));
+        });
+    report.add(cheia);
+
+    cout << "Divergências: " << divergencias << endl;
+    cout << "Um a um (estimado para " << alunos << " alunos, s): "
+         << (individual.meanUs + cheia.meanUs) / 2 * alunos / 1e6 << endl;
+
+    if (!report.write(saida)) {
+        cout << "Falha ao gravar " << saida << endl;
+        return 1;
+    }
+
+    cout << "Resultados gravados em " << saida << endl;
+
+    return divergencias == 0 ? 0 : 1;
+}
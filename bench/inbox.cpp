@@ -0,0 +1,166 @@
+// Benchmark da caixa de entrada dos professores: compara
+// AgendamentoService::listPendentesByIdProfessor com o caminho anterior
+// (percorrer os horários do professor e juntar os pendentes de cada um),
+// confere que os dois dão os mesmos agendamentos e mede a confirmação de
+// todos os pendentes de um professor, um a um e em lote.
+//
+// Uso: inbox [professores] [horarios_por_professor] [amostras] [saida.json]
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "service/agendamentoService.hpp"
+#include "service/professorService.hpp"
+#include "util/academicTerm.hpp"
+
+using std::cout;
+using std::endl;
+using std::min;
+using std::sort;
+using std::stoi;
+using std::string;
+using std::to_string;
+using std::vector;
+
+#define LOTES 5
+
+// Caminho anterior: os pendentes de cada horário do professor.
+static vector<long> por_horario(ProfessorService& professores, long id) {
+    Horario::AgendamentoVector agendamentos;
+
+    for (const auto& horario : professores.getById(id)->getHorarios()) {
+        auto pendentes = horario->getAgendamentosPendentes();
+
+        agendamentos.insert(agendamentos.begin(), pendentes->begin(),
+                            pendentes->end());
+    }
+
+    vector<long> ids;
+    for (const auto& agendamento : agendamentos)
+        ids.push_back(agendamento->getId());
+
+    sort(ids.begin(), ids.end());
+
+    return ids;
+}
+
+// Os IDs da caixa de entrada de um professor.
+static vector<long> caixa(AgendamentoService& service, long id) {
+    vector<long> ids;
+
+    for (const auto& agendamento : *service.listPendentesByIdProfessor(id))
+        ids.push_back(agendamento->getId());
+
+    return ids;
+}
+
+int main(int argc, char** argv) {
+    int professores = argc > 1 ? stoi(argv[1]) : 200;
+    int porProfessor = argc > 2 ? stoi(argv[2]) : 30;
+    size_t amostras = argc > 3 ? stoi(argv[3]) : 50;
+    string saida = argc > 4 ? argv[4] : "inbox.json";
+
+    Sandbox sandbox("bench-inbox");
+
+    long base = current_term().inicio;
+    vector<string> linhasProfessores, alunos, horarios, agendamentos;
+    long id = 1;
+
+    for (int p = 1; p <= professores; ++p) {
+        linhasProfessores.push_back(to_string(p) + ",Professor " +
+                                    to_string(p) + ",prof" + to_string(p) +
+                                    "@bench.com,x,Disciplina");
+        alunos.push_back(to_string(p) + ",Aluno " + to_string(p) + ",aluno" +
+                         to_string(p) + "@bench.com,x," + to_string(p));
+
+        // Um pedido pendente por horário, de um aluno qualquer.
+        for (int h = 0; h < porProfessor; ++h, ++id) {
+            long inicio = base + id * 3600;
+            horarios.push_back(to_string(id) + "," + to_string(p) + "," +
+                               to_string(inicio) + "," +
+                               to_string(inicio + 3600) + ",1,0");
+            agendamentos.push_back(to_string(id) + "," +
+                                   to_string(id % professores + 1) + "," +
+                                   to_string(id) + ",PENDENTE");
+        }
+    }
+
+    sandbox.write(
+        Fixture{linhasProfessores, alunos, horarios, agendamentos});
+
+    MockConnection connection;
+    EventBus bus;
+    EntityManager manager(connection, bus);
+    AgendamentoService& service = *manager.getAgendamentoService();
+    ProfessorService& professorService = *manager.getProfessorService();
+
+    Report report("inbox");
+    report.set("professores", to_string(professores));
+    report.set("pendentes", to_string(agendamentos.size()));
+
+    size_t divergencias = 0;
+
+    for (int p = 1; p <= min(professores, 20); ++p)
+        if (por_horario(professorService, p) != caixa(service, p))
+            ++divergencias;
+
+    cout << "Divergências: " << divergencias << endl;
+
+    size_t sink = 0;
+
+    report.add(measure("por horário", "abrir pendentes", amostras,
+                       [&](size_t i) {
+                           sink += por_horario(professorService,
+                                               i % professores + 1)
+                                       .size();
+                       }));
+    report.add(measure("AgendamentoService", "listPendentesByIdProfessor",
+                       amostras, [&](size_t i) {
+                           sink += service
+                                       .listPendentesByIdProfessor(
+                                           i % professores + 1)
+                                       ->size();
+                       }));
+
+    // Cada amostra confirma todos os pendentes de um professor diferente.
+    size_t lotes = min(size_t(LOTES), size_t(professores / 2));
+
+    report.add(measure("um a um", "confirmar todos", lotes, [&](size_t i) {
+        auto pendentes = service.listPendentesByIdProfessor(long(i) + 1);
+
+        for (const auto& agendamento : *pendentes)
+            service.updateStatusById(agendamento->getId(), Status::CONFIRMADO);
+    }));
+    report.add(measure("AgendamentoService", "updateStatusPendentes", lotes,
+                       [&](size_t i) {
+                           long professor = long(lotes + i) + 1;
+                           vector<long> ids = caixa(service, professor);
+
+                           for (const auto& resultado :
+                                service.updateStatusPendentes(
+                                    professor, ids, Status::CONFIRMADO))
+                               if (!resultado.sucesso)
+                                   ++divergencias;
+                       }));
+
+    for (size_t p = 1; p <= 2 * lotes; ++p)
+        if (!caixa(service, long(p)).empty())
+            ++divergencias;
+
+    if (sink == 0)
+        cout << endl;
+
+    if (!report.write(saida)) {
+        cout << "Falha ao gravar " << saida << endl;
+        return 1;
+    }
+
+    cout << "Resultados gravados em " << saida << endl;
+
+    return divergencias == 0 ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+// Benchmark do hash de senha: mede hashes por segundo (no total e por thread)
+// do PBKDF2 com 10000 iterações e com o custo calibrado, e do hash simulado
+// legado (custo 12), com 1, 2, 4, ... threads. Mede também a verificação pelo
+// pool dedicado (PasswordVerifier), usado no login.
+//
+// Uso: kdf [amostras] [max_threads] [saida.json]
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "util/kdf.hpp"
+#include "util/passwordVerifier.hpp"
+#include "util/utils.hpp"
+
+using std::cout;
+using std::endl;
+using std::stoi;
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+// Executa `amostras` verificações em cada uma de `threads` threads.
+template <typename Fn>
+Summary run(const string& group, const string& name, int threads, int amostras,
+            Fn&& fn) {
+    vector<LatencyRecorder> recorders(threads);
+    vector<thread> workers;
+
+    auto start = steady_clock::now();
+
+    for (int t = 0; t < threads; ++t)
+        workers.emplace_back([&, t]() {
+            for (int i = 0; i < amostras; ++i) {
+                auto before = steady_clock::now();
+                if (!fn())
+                    throw std::logic_error("verificação falhou");
+                recorders[t].record(
+                    duration<double, std::micro>(steady_clock::now() - before)
+                        .count());
+            }
+        });
+
+    for (auto& worker : workers)
+        worker.join();
+
+    double seconds = duration<double>(steady_clock::now() - start).count();
+
+    for (int t = 1; t < threads; ++t)
+        recorders[0].merge(recorders[t]);
+
+    return recorders[0].summarize(group, name + " x" + to_string(threads),
+                                  seconds);
+}
+
+// Adiciona o resultado ao relatório e imprime a vazão por thread.
+void add(Report& report, const Summary& s, int threads) {
+    report.add(s);
+    cout << "    " << s.opsPerSec / threads << " hashes/s por thread" << endl;
+}
+
+int main(int argc, char** argv) {
+    int amostras = argc > 1 ? stoi(argv[1]) : 20;
+    int maxThreads =
+        argc > 2 ? stoi(argv[2]) : int(thread::hardware_concurrency());
+    string saida = argc > 3 ? argv[3] : "kdf.json";
+
+    if (maxThreads < 1)
+        maxThreads = 1;
+
+    uint32_t calibrado = kdf_iterations();
+
+    Report report("kdf");
+    report.set("amostras", to_string(amostras));
+    report.set("max_threads", to_string(maxThreads));
+    report.set("iteracoes_calibradas", to_string(calibrado));
+
+    cout << "Iterações calibradas para " << KDF_TARGET_MS
+         << " ms: " << calibrado << endl;
+
+    string legado = mock_bcrypt("senha", 12);
+    string minimo = hash_password("senha", KDF_MIN_ITERATIONS);
+    string padrao = hash_password("senha", calibrado);
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        add(report,
+            run("legado", "mk cost 12", threads, amostras,
+                [&]() { return check(legado, "senha"); }),
+            threads);
+        add(report,
+            run("pbkdf2", to_string(KDF_MIN_ITERATIONS), threads, amostras,
+                [&]() { return verify_kdf(minimo, "senha"); }),
+            threads);
+        add(report,
+            run("pbkdf2", to_string(calibrado), threads, amostras,
+                [&]() { return verify_kdf(padrao, "senha"); }),
+            threads);
+    }
+
+    // Pelo pool dedicado, com tantos clientes quanto o máximo de threads: a
+    // vazão fica limitada ao tamanho do pool.
+    PasswordVerifier& verifier = PasswordVerifier::shared();
+    add(report,
+        run("PasswordVerifier", "verify", maxThreads, amostras,
+            [&]() { return verifier.verify(padrao, "senha"); }),
+        maxThreads);
+
+    if (!report.write(saida)) {
+        cout << "Falha ao gravar " << saida << endl;
+        return 1;
+    }
+
+    cout << "Resultados gravados em " << saida << endl;
+
+    return 0;
+}
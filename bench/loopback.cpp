@@ -0,0 +1,250 @@
+// Cliente de loopback do servidor TCP: sobe o servidor no próprio processo,
+// sobre dados sintéticos, e dispara vários clientes concorrentes que fazem o
+// fluxo completo (login, listagens, agendar, confirmar/cancelar) pelo
+// protocolo de linhas. Ao final, confere se nenhum comando falhou.
+//
+// Uso: loopback [clientes] [rodadas] [workers]
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "controller/agendamentoController.hpp"
+#include "controller/loginController.hpp"
+#include "controller/professorController.hpp"
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "server/tcpServer.hpp"
+#include "util/academicTerm.hpp"
+#include "util/utils.hpp"
+
+using std::atomic;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::istringstream;
+using std::runtime_error;
+using std::stoi;
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+/**
+ * @brief Cliente bloqueante mínimo do protocolo de linhas.
+ */
+class Client {
+   private:
+    int fd;
+    string buffer;
+
+    string readLine() {
+        size_t pos;
+        char chunk[4096];
+
+        while ((pos = buffer.find('\n')) == string::npos) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0)
+                throw runtime_error("conexão encerrada pelo servidor");
+            buffer.append(chunk, n);
+        }
+
+        string line = buffer.substr(0, pos);
+        buffer.erase(0, pos + 1);
+        return line;
+    }
+
+   public:
+    explicit Client(uint16_t port) {
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(port);
+        inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+
+        if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+            throw runtime_error("falha ao conectar");
+    }
+
+    ~Client() {
+        ::close(fd);
+    }
+
+    // Envia um comando e retorna a primeira linha da resposta; as linhas de
+    // listagem (`OK <n>`) são lidas para `rows`.
+    string call(const string& command, vector<string>* rows = nullptr) {
+        string line = command + "\n";
+        send(fd, line.data(), line.size(), MSG_NOSIGNAL);
+
+        string head = readLine();
+
+        if (rows) {
+            rows->clear();
+            size_t count = std::stoul(head.substr(3));
+            for (size_t i = 0; i < count; ++i)
+                rows->push_back(readLine());
+        }
+
+        return head;
+    }
+};
+
+static bool is_ok(const string& response) {
+    return response.rfind("OK", 0) == 0;
+}
+
+static long first_field(const string& row) {
+    return std::stol(row.substr(0, row.find('\t')));
+}
+
+int main(int argc, char** argv) {
+    int clientes = argc > 1 ? stoi(argv[1]) : 8;
+    int rodadas = argc > 2 ? stoi(argv[2]) : 20;
+    int workers = argc > 3 ? stoi(argv[3]) : 4;
+
+    Sandbox sandbox("bench-loopback");
+
+    string senha = mock_bcrypt("senha", 4);
+    vector<string> professores, alunos, horarios;
+
+    for (int p = 1; p <= clientes; ++p)
+        professores.push_back(to_string(p) + ",Professor " + to_string(p) +
+                              ",prof" + to_string(p) + "@bench.com," + senha +
+                              ",Benchmark");
+
+    for (int a = 1; a <= clientes; ++a)
+        alunos.push_back(to_string(a) + ",Aluno " + to_string(a) + ",aluno" +
+                         to_string(a) + "@bench.com," + senha + "," +
+                         to_string(a));
+
+    // Os horários ficam no período atual, o único listado aos alunos.
+    long base = current_term().inicio;
+    long id = 1;
+    for (int p = 1; p <= clientes; ++p) {
+        for (int r = 0; r < rodadas; ++r) {
+            long inicio = base + id * 3600L;
+            horarios.push_back(to_string(id++) + "," + to_string(p) + "," +
+                               to_string(inicio) + "," +
+                               to_string(inicio + 1800) + ",1,0");
+        }
+    }
+
+    sandbox.write(Fixture{professores, alunos, horarios, {}});
+
+    MockConnection connection;
+    EventBus bus;
+    EntityManager manager(connection, bus);
+
+    ProfessorController professorController(manager.getProfessorService());
+    LoginController loginController(manager.getAlunoService(),
+                                    manager.getProfessorService(), bus);
+    AgendamentoController agendamentoController(
+        manager.getAgendamentoService());
+
+    RequestHandler handler(loginController, professorController,
+                           agendamentoController, manager.getSessionService());
+    TcpServer server(handler, workers);
+    uint16_t port = server.listen(0, "127.0.0.1");
+
+    thread loop([&server]() { server.run(); });
+
+    atomic<long> requisicoes{0}, falhas{0};
+    vector<thread> pool;
+
+    auto inicio = steady_clock::now();
+
+    // O cliente c age como o aluno c e o professor c: agenda os horários do
+    // próprio professor, confirma metade e cancela a outra metade.
+    for (int c = 1; c <= clientes; ++c) {
+        pool.emplace_back([&, c]() {
+            auto expect = [&](const string& response, const string& cmd) {
+                ++requisicoes;
+                if (!is_ok(response)) {
+                    ++falhas;
+                    cerr << cmd << " -> " << response << endl;
+                }
+                return response;
+            };
+
+            try {
+                Client client(port);
+                vector<string> rows;
+
+                string aluno = expect(
+                    client.call("LOGIN_ALUNO aluno" + to_string(c) +
+                                "@bench.com senha"),
+                    "LOGIN_ALUNO").substr(3);
+                string prof = expect(
+                    client.call("LOGIN_PROFESSOR prof" + to_string(c) +
+                                "@bench.com senha"),
+                    "LOGIN_PROFESSOR").substr(3);
+
+                expect(client.call("PROFESSORES", &rows), "PROFESSORES");
+
+                for (int r = 0; r < rodadas; ++r) {
+                    expect(client.call("HORARIOS " + to_string(c), &rows),
+                           "HORARIOS");
+                    if (rows.empty())
+                        break;
+
+                    long horario = first_field(rows.front());
+                    string ag = expect(client.call("AGENDAR " + aluno + " " +
+                                                   to_string(horario)),
+                                       "AGENDAR");
+                    if (!is_ok(ag))
+                        continue;
+
+                    string agId = ag.substr(3);
+
+                    expect(client.call("PENDENTES " + prof, &rows),
+                           "PENDENTES");
+
+                    if (r % 2 == 0)
+                        expect(client.call("CONFIRMAR " + prof + " " + agId),
+                               "CONFIRMAR");
+                    else
+                        expect(client.call("CANCELAR " + aluno + " " + agId),
+                               "CANCELAR");
+                }
+
+                expect(client.call("AGENDAMENTOS " + aluno, &rows),
+                       "AGENDAMENTOS");
+                expect(client.call("LOGOUT " + aluno), "LOGOUT");
+                expect(client.call("LOGOUT " + prof), "LOGOUT");
+            } catch (const std::exception& e) {
+                ++falhas;
+                cerr << "cliente " << c << ": " << e.what() << endl;
+            }
+        });
+    }
+
+    for (auto& th : pool)
+        th.join();
+
+    double segundos = duration<double>(steady_clock::now() - inicio).count();
+
+    server.stop();
+    loop.join();
+
+    cout << "clientes:     " << clientes << endl;
+    cout << "workers:      " << workers << endl;
+    cout << "requisicoes:  " << requisicoes << endl;
+    cout << "falhas:       " << falhas << endl;
+    cout << "tempo (s):    " << segundos << endl;
+    cout << "req/s:        " << requisicoes / segundos << endl;
+
+    return falhas == 0 ? 0 : 1;
+}
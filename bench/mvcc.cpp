@@ -0,0 +1,166 @@
+// Benchmark das leituras por versão da MockConnection: várias threads listam
+// os horários de um professor enquanto outra reescreve a disponibilidade de
+// todos eles de uma vez (HorarioService::updateDisponivelByIds). Mede a
+// latência das leituras sem e com o escritor e confere que nenhuma leitura
+// enxerga uma reescrita pela metade (todos os horários com a mesma
+// disponibilidade).
+//
+// Uso: mvcc [leitores] [horarios] [segundos_por_fase] [saida.json]
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "harness.hpp"
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "service/horarioService.hpp"
+#include "util/academicTerm.hpp"
+
+using std::atomic;
+using std::cout;
+using std::endl;
+using std::map;
+using std::stod;
+using std::stoi;
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+#define DISPONIVEL_COL_INDEX 4
+
+// Uma coluna de uma linha CSV.
+static string coluna(const string& linha, size_t indice) {
+    size_t inicio = 0;
+
+    for (size_t i = 0; i < indice; ++i)
+        inicio = linha.find(',', inicio) + 1;
+
+    return linha.substr(inicio, linha.find(',', inicio) - inicio);
+}
+
+int main(int argc, char** argv) {
+    int leitores = argc > 1 ? stoi(argv[1]) : 4;
+    int horarios = argc > 2 ? stoi(argv[2]) : 2000;
+    double segundos = argc > 3 ? stod(argv[3]) : 2;
+    string saida = argc > 4 ? argv[4] : "mvcc.json";
+
+    Sandbox sandbox("bench-mvcc");
+
+    long base = current_term().inicio;
+    vector<string> linhas;
+
+    // Os horários do professor 1 e, intercalados, os de um segundo professor
+    // que ninguém altera.
+    for (int h = 1; h <= 2 * horarios; ++h) {
+        long inicio = base + h * 3600L;
+
+        linhas.push_back(to_string(h) + "," + to_string(h % 2 + 1) + "," +
+                         to_string(inicio) + "," + to_string(inicio + 1800) +
+                         ",1,0");
+    }
+
+    sandbox.write(Fixture{{"1,Professor 1,prof1@bench.com,x,Bench",
+                           "2,Professor 2,prof2@bench.com,x,Bench"},
+                          {}, linhas, {}});
+
+    MockConnection connection;
+    EventBus bus;
+    EntityManager manager(connection, bus);
+    HorarioService& horarioService = *manager.getHorarioService();
+
+    Report report("mvcc");
+    report.set("leitores", to_string(leitores));
+    report.set("horarios", to_string(horarios));
+
+    atomic<size_t> inconsistentes{0};
+
+    // Cada leitor lista os horários do professor 1 até o fim da fase.
+    auto fase = [&](const string& nome, bool comEscritor) {
+        atomic<bool> parar{false};
+        atomic<size_t> escritas{0};
+        vector<LatencyRecorder> registros(leitores);
+        vector<thread> threads;
+
+        for (int r = 0; r < leitores; ++r) {
+            threads.emplace_back([&, r]() {
+                while (!parar.load()) {
+                    auto inicio = steady_clock::now();
+                    auto lista = connection.selectByColumn(HORARIO_TABLE, 1,
+                                                           "1");
+                    registros[r].record(
+                        duration<double, std::micro>(steady_clock::now() -
+                                                     inicio)
+                            .count());
+
+                    map<string, size_t> valores;
+
+                    for (const string& linha : lista)
+                        ++valores[coluna(linha, DISPONIVEL_COL_INDEX)];
+
+                    if (lista.size() != size_t(horarios) ||
+                        valores.size() != 1)
+                        ++inconsistentes;
+                }
+            });
+        }
+
+        if (comEscritor) {
+            threads.emplace_back([&]() {
+                bool disponivel = false;
+
+                while (!parar.load()) {
+                    map<long, bool> mudancas;
+
+                    for (int h = 2; h <= 2 * horarios; h += 2)
+                        mudancas[h] = disponivel;
+
+                    horarioService.updateDisponivelByIds(mudancas);
+                    disponivel = !disponivel;
+                    ++escritas;
+                }
+            });
+        }
+
+        auto inicio = steady_clock::now();
+
+        std::this_thread::sleep_for(duration<double>(segundos));
+        parar = true;
+
+        for (auto& t : threads)
+            t.join();
+
+        double total = duration<double>(steady_clock::now() - inicio).count();
+        LatencyRecorder todos;
+
+        for (const auto& registro : registros)
+            todos.merge(registro);
+
+        report.add(todos.summarize("MockConnection", nome, total));
+
+        if (comEscritor)
+            cout << "Reescritas da disponibilidade: " << escritas.load()
+                 << endl;
+    };
+
+    fase("selectByColumn", false);
+    fase("selectByColumn (escrita)", true);
+
+    cout << "Leituras inconsistentes: " << inconsistentes.load() << endl;
+
+    if (!report.write(saida)) {
+        cout << "Falha ao gravar " << saida << endl;
+        return 1;
+    }
+
+    cout << "Resultados gravados em " << saida << endl;
+
+    return inconsistentes == 0 ? 0 : 1;
+}
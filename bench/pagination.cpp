@@ -0,0 +1,191 @@
+// Benchmark das listagens em páginas: compara a primeira página de
+// ProfessorService::listPage e AgendamentoService::listPageByIdAluno /
+// listPageByIdHorario com as listas completas (listAll, listByIdAluno,
+// listByIdHorario), e confere que percorrer todas as páginas devolve os
+// mesmos registros, na mesma ordem, inclusive depois de uma mudança de
+// status.
+//
+// Uso: pagination [professores] [agendamentos_do_aluno] [pagina] [amostras]
+//                 [saida.json]
+
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "service/agendamentoService.hpp"
+#include "service/professorService.hpp"
+#include "util/academicTerm.hpp"
+
+using std::cout;
+using std::endl;
+using std::shared_ptr;
+using std::stoi;
+using std::string;
+using std::to_string;
+using std::vector;
+
+#define ALUNO_BENCH 1
+#define HORARIO_BENCH 1
+
+// Os IDs de uma lista.
+template <typename T>
+static vector<long> ids(const vector<shared_ptr<T>>& lista) {
+    vector<long> resultado;
+
+    for (const auto& item : lista)
+        resultado.push_back(item->getId());
+
+    return resultado;
+}
+
+int main(int argc, char** argv) {
+    int professores = argc > 1 ? stoi(argv[1]) : 10000;
+    int agendamentos = argc > 2 ? stoi(argv[2]) : 5000;
+    size_t pagina = argc > 3 ? stoi(argv[3]) : 10;
+    size_t amostras = argc > 4 ? stoi(argv[4]) : 20;
+    string saida = argc > 5 ? argv[5] : "pagination.json";
+
+    Sandbox sandbox("bench-pagination");
+
+    long base = current_term().inicio;
+    vector<string> linhasProfessores, horarios, linhasAgendamentos;
+
+    // Nomes fora de ordem e repetidos, para exercitar o desempate por ID.
+    for (int p = 1; p <= professores; ++p)
+        linhasProfessores.push_back(
+            to_string(p) + ",Professor " + to_string((p * 7919) % 1000) +
+            ",prof" + to_string(p) + "@bench.com,x,Bench");
+
+    // Um horário por agendamento do aluno e, no horário 1, um agendamento
+    // de cada um dos outros alunos; os status se alternam.
+    const char* status[] = {"PENDENTE", "CONFIRMADO", "RECUSADO",
+                            "CANCELADO"};
+    long id = 1;
+
+    for (int a = 1; a <= agendamentos; ++a, ++id) {
+        long inicio = base + (a * 37 % agendamentos) * 3600L;
+
+        horarios.push_back(to_string(a) + ",1," + to_string(inicio) + "," +
+                           to_string(inicio + 1800) + ",1,0");
+        linhasAgendamentos.push_back(to_string(id) + "," +
+                                     to_string(ALUNO_BENCH) + "," +
+                                     to_string(a) + "," + status[a % 4]);
+    }
+
+    for (int a = 2; a <= agendamentos; ++a, ++id)
+        linhasAgendamentos.push_back(to_string(id) + "," + to_string(a) +
+                                     "," + to_string(HORARIO_BENCH) + "," +
+                                     status[a % 4]);
+
+    sandbox.write(Fixture{linhasProfessores, {}, horarios, linhasAgendamentos});
+
+    MockConnection connection;
+    EventBus bus;
+    EntityManager manager(connection, bus);
+    ProfessorService& professorService = *manager.getProfessorService();
+    AgendamentoService& agendamentoService = *manager.getAgendamentoService();
+
+    Report report("pagination");
+    report.set("professores", to_string(professores));
+    report.set("agendamentos_do_aluno", to_string(agendamentos));
+    report.set("pagina", to_string(pagina));
+
+    // Todas as páginas, concatenadas.
+    auto todosProfessores = [&]() {
+        vector<long> resultado;
+        ProfessorCursor cursor;
+
+        while (true) {
+            auto page = professorService.listPage(cursor, pagina);
+
+            for (long i : ids(page.professores))
+                resultado.push_back(i);
+
+            if (!page.hasMore)
+                return resultado;
+
+            cursor = page.next;
+        }
+    };
+
+    auto todosAgendamentos = [&](bool porAluno) {
+        vector<long> resultado;
+        AgendamentoCursor cursor;
+
+        while (true) {
+            auto page = porAluno ? agendamentoService.listPageByIdAluno(
+                                       ALUNO_BENCH, cursor, pagina)
+                                 : agendamentoService.listPageByIdHorario(
+                                       HORARIO_BENCH, cursor, pagina);
+
+            for (long i : ids(page.agendamentos))
+                resultado.push_back(i);
+
+            if (!page.hasMore)
+                return resultado;
+
+            cursor = page.next;
+        }
+    };
+
+    size_t divergencias = 0;
+
+    auto conferir = [&]() {
+        if (todosProfessores() != ids(professorService.listAll()))
+            ++divergencias;
+
+        if (todosAgendamentos(true) !=
+            ids(agendamentoService.listByIdAluno(ALUNO_BENCH)))
+            ++divergencias;
+
+        if (todosAgendamentos(false) !=
+            ids(agendamentoService.listByIdHorario(HORARIO_BENCH)))
+            ++divergencias;
+    };
+
+    conferir();
+
+    report.add(measure("ProfessorService", "listAll", amostras,
+                       [&](size_t) { professorService.listAll(); }));
+    report.add(measure("ProfessorService", "listPage", amostras, [&](size_t) {
+        professorService.listPage(ProfessorCursor(), pagina);
+    }));
+    report.add(measure("AgendamentoService", "listByIdAluno", amostras,
+                       [&](size_t) {
+                           agendamentoService.listByIdAluno(ALUNO_BENCH);
+                       }));
+    report.add(measure("AgendamentoService", "listPageByIdAluno", amostras,
+                       [&](size_t) {
+                           agendamentoService.listPageByIdAluno(
+                               ALUNO_BENCH, AgendamentoCursor(), pagina);
+                       }));
+    report.add(measure("AgendamentoService", "listByIdHorario", amostras,
+                       [&](size_t) {
+                           agendamentoService.listByIdHorario(HORARIO_BENCH);
+                       }));
+    report.add(measure("AgendamentoService", "listPageByIdHorario", amostras,
+                       [&](size_t) {
+                           agendamentoService.listPageByIdHorario(
+                               HORARIO_BENCH, AgendamentoCursor(), pagina);
+                       }));
+
+    // Uma mudança de status reordena os agendamentos nas páginas seguintes.
+    agendamentoService.updateStatusById(1, Status::CANCELADO);
+
+    conferir();
+
+    cout << "Divergências: " << divergencias << endl;
+
+    if (!report.write(saida)) {
+        cout << "Falha ao gravar " << saida << endl;
+        return 1;
+    }
+
+    cout << "Resultados gravados em " << saida << endl;
+
+    return divergencias == 0 ? 0 : 1;
+}
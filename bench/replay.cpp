@@ -0,0 +1,265 @@
+// Driver de replay: gera dados sintéticos realistas (grade semanal, procura
+// por professor em Zipf, mistura de status) e um trace de operações (logins,
+// listagens, agendamentos, avaliações e cancelamentos), e o executa contra os
+// services do EntityManager com várias threads. Mede vazão e latência por tipo
+// de operação e grava o resultado em JSON.
+//
+// Se o arquivo de trace já existir, ele é reaproveitado; senão, é gerado e
+// gravado, permitindo repetir exatamente a mesma carga.
+//
+// Com METRICS=1, os histogramas dos pontos instrumentados também são
+// impressos e exportados em formato Prometheus (saida.json.prom).
+//
+// Uso: replay [agendamentos] [operacoes] [threads] [zipf] [trace.txt]
+//             [saida.json]
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dataset.hpp"
+#include "harness.hpp"
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "service/agendamentoService.hpp"
+#include "service/alunoService.hpp"
+#include "service/horarioService.hpp"
+#include "service/professorService.hpp"
+#include "util/metrics.hpp"
+#include "util/utils.hpp"
+#include "workload.hpp"
+
+using std::atomic;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::invalid_argument;
+using std::stod;
+using std::stol;
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Resultado de uma operação do trace.
+ */
+enum class Outcome { OK, VAZIA, REJEITADA, ERRO };
+
+/**
+ * @brief Executa as operações do trace sobre os services.
+ */
+class Replayer {
+   private:
+    EntityManager& manager;
+
+    // Avalia o primeiro agendamento pendente dos horários do professor, como
+    // faz o menu de pendentes da interface.
+    Outcome avaliar(long professorId, const Status& status) {
+        for (const auto& horario :
+             manager.getHorarioService()->listByIdProfessor(professorId)) {
+            for (const auto& ag :
+                 manager.getAgendamentoService()->listByIdHorario(
+                     horario->getId())) {
+                if (ag->getStatus() == Status::PENDENTE) {
+                    manager.getAgendamentoService()->updateStatusById(
+                        ag->getId(), status);
+                    return Outcome::OK;
+                }
+            }
+        }
+
+        return Outcome::VAZIA;
+    }
+
+   public:
+    explicit Replayer(EntityManager& manager) : manager(manager) {}
+
+    Outcome run(const Operation& op) {
+        const auto& alunos = manager.getAlunoService();
+        const auto& professores = manager.getProfessorService();
+        const auto& horarios = manager.getHorarioService();
+        const auto& agendamentos = manager.getAgendamentoService();
+
+        switch (op.type) {
+            case OpType::LOGIN_ALUNO: {
+                auto aluno = alunos->getOneByEmail(
+                    "aluno" + to_string(op.arg1) + "@bench.com");
+                return aluno && check(aluno->getSenha(), "senha")
+                           ? Outcome::OK
+                           : Outcome::ERRO;
+            }
+            case OpType::LOGIN_PROFESSOR: {
+                auto professor = professores->getOneByEmail(
+                    "prof" + to_string(op.arg1) + "@bench.com");
+                return professor && check(professor->getSenha(), "senha")
+                           ? Outcome::OK
+                           : Outcome::ERRO;
+            }
+            case OpType::LISTAR_PROFESSORES:
+                professores->listAll();
+                return Outcome::OK;
+            case OpType::LISTAR_HORARIOS: {
+                size_t disponiveis = 0;
+                for (const auto& h : horarios->listByIdProfessor(op.arg1))
+                    disponiveis += h->isDisponivel();
+                return disponiveis ? Outcome::OK : Outcome::VAZIA;
+            }
+            case OpType::LISTAR_AGENDAMENTOS:
+                agendamentos->listByIdAluno(op.arg1);
+                return Outcome::OK;
+            case OpType::AGENDAR:
+                agendamentos->save(op.arg1, op.arg2);
+                return Outcome::OK;
+            case OpType::CONFIRMAR:
+                return avaliar(op.arg1, Status::CONFIRMADO);
+            case OpType::RECUSAR:
+                return avaliar(op.arg1, Status::RECUSADO);
+            case OpType::CANCELAR:
+                for (const auto& ag : agendamentos->listByIdAluno(op.arg1)) {
+                    if (ag->getStatus() == Status::PENDENTE ||
+                        ag->getStatus() == Status::CONFIRMADO) {
+                        agendamentos->updateStatusById(ag->getId(),
+                                                       Status::CANCELADO);
+                        return Outcome::OK;
+                    }
+                }
+                return Outcome::VAZIA;
+        }
+
+        return Outcome::ERRO;
+    }
+};
+
+int main(int argc, char** argv) {
+    DatasetConfig dados;
+    dados.agendamentos = argc > 1 ? stol(argv[1]) : 10000;
+    dados.zipf = argc > 4 ? stod(argv[4]) : 0.99;
+    dados.senha = mock_bcrypt("senha", 4);
+
+    TraceConfig carga;
+    carga.operacoes = argc > 2 ? stol(argv[2]) : 2000;
+    carga.zipf = dados.zipf;
+
+    int threads = argc > 3 ? stol(argv[3]) : 4;
+    string tracePath =
+        argc > 5 && *argv[5] ? fs::absolute(argv[5]).string() : "";
+    string saida =
+        fs::absolute(argc > 6 ? argv[6] : "replay-results.json").string();
+
+    Sandbox sandbox("bench-replay");
+    Dataset d = generate_dataset(sandbox, dados);
+
+    vector<Operation> ops;
+    if (!tracePath.empty() && fs::exists(tracePath)) {
+        ops = load_trace(tracePath);
+        cout << "trace carregado: " << tracePath << endl;
+    } else {
+        ops = generate_trace(d, carga);
+        if (!tracePath.empty()) {
+            save_trace(tracePath, ops);
+            cout << "trace gravado: " << tracePath << endl;
+        }
+    }
+
+    cout << "agendamentos: " << d.agendamentos << ", alunos: " << d.alunos
+         << ", professores: " << d.professores
+         << ", horarios: " << d.horarios << ", operacoes: " << ops.size()
+         << ", threads: " << threads << endl;
+
+    MockConnection connection;
+    EventBus bus;
+    EntityManager manager(connection, bus);
+
+    vector<vector<LatencyRecorder>> latencias(
+        threads, vector<LatencyRecorder>(OP_TYPE_COUNT));
+    atomic<long> resultados[4] = {{0}, {0}, {0}, {0}};
+    vector<thread> pool;
+
+    auto inicio = steady_clock::now();
+
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            Replayer replayer(manager);
+
+            for (size_t i = t; i < ops.size(); i += threads) {
+                Outcome outcome;
+                auto antes = steady_clock::now();
+
+                try {
+                    outcome = replayer.run(ops[i]);
+                } catch (const invalid_argument&) {
+                    outcome = Outcome::REJEITADA;
+                } catch (const std::exception& e) {
+                    outcome = Outcome::ERRO;
+                    cerr << op_name(ops[i].type) << ": " << e.what() << endl;
+                }
+
+                latencias[t][static_cast<int>(ops[i].type)].record(
+                    duration<double, std::micro>(steady_clock::now() - antes)
+                        .count());
+                ++resultados[static_cast<int>(outcome)];
+            }
+        });
+    }
+
+    for (auto& th : pool)
+        th.join();
+
+    double segundos = duration<double>(steady_clock::now() - inicio).count();
+
+    Report report("replay");
+    report.set("agendamentos", to_string(d.agendamentos));
+    report.set("operacoes", to_string(ops.size()));
+    report.set("threads", to_string(threads));
+    report.set("zipf", to_string(dados.zipf));
+    report.set("ok", to_string(resultados[0]));
+    report.set("vazias", to_string(resultados[1]));
+    report.set("rejeitadas", to_string(resultados[2]));
+    report.set("erros", to_string(resultados[3]));
+
+    LatencyRecorder total;
+
+    for (int tipo = 0; tipo < OP_TYPE_COUNT; ++tipo) {
+        LatencyRecorder porTipo;
+        for (int t = 0; t < threads; ++t)
+            porTipo.merge(latencias[t][tipo]);
+
+        total.merge(porTipo);
+
+        // A vazão por tipo é relativa ao tempo total da execução.
+        report.add(porTipo.summarize(
+            "replay", op_name(static_cast<OpType>(tipo)), segundos));
+    }
+
+    report.add(total.summarize("replay", "TOTAL", segundos));
+
+    cout << "ok: " << resultados[0] << ", vazias: " << resultados[1]
+         << ", rejeitadas: " << resultados[2] << ", erros: " << resultados[3]
+         << endl;
+
+    if (!report.write(saida)) {
+        cerr << "falha ao gravar " << saida << endl;
+        return 1;
+    }
+
+    cout << "resultados: " << saida << endl;
+
+    if (MetricsRegistry::enabled()) {
+        string metricas = saida + ".prom";
+        MetricsRegistry::instance().write(cout, MetricsFormat::TEXT);
+        MetricsRegistry::instance().dump(metricas, MetricsFormat::PROMETHEUS);
+        cout << "metricas: " << metricas << endl;
+    }
+
+    return resultados[3] == 0 ? 0 : 1;
+}
@@ -0,0 +1,117 @@
+#ifndef BENCH_SANDBOX_HPP
+#define BENCH_SANDBOX_HPP
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "persistence/entityManager.hpp"
+
+#define PROFESSOR_HEADER "id,nome,email,senha,disciplina"
+#define ALUNO_HEADER "id,nome,email,senha,matricula"
+#define HORARIO_HEADER "id,id_professor,inicio,fim,disponivel,versao"
+#define AGENDAMENTO_HEADER "id,id_aluno,id_horario,status"
+
+/**
+ * @brief Linhas de dados das quatro tabelas de um cenário, sem cabeçalho.
+ * * Tabelas deixadas vazias são gravadas só com o cabeçalho.
+ */
+struct Fixture {
+    std::vector<std::string> professores;  /**< Linhas de professores. */
+    std::vector<std::string> alunos;       /**< Linhas de alunos. */
+    std::vector<std::string> horarios;     /**< Linhas de horários. */
+    std::vector<std::string> agendamentos; /**< Linhas de agendamentos. */
+};
+
+/**
+ * @brief Retorna o cabeçalho CSV de uma tabela.
+ * @param table O nome da tabela.
+ * @return const char* O cabeçalho (vazio para uma tabela desconhecida).
+ */
+inline const char* table_header(const std::string& table) {
+    if (table == PROFESSOR_TABLE)
+        return PROFESSOR_HEADER;
+    if (table == ALUNO_TABLE)
+        return ALUNO_HEADER;
+    if (table == HORARIO_TABLE)
+        return HORARIO_HEADER;
+    if (table == AGENDAMENTO_TABLE)
+        return AGENDAMENTO_HEADER;
+    return "";
+}
+
+/**
+ * @brief Diretório de trabalho temporário para os benchmarks.
+ * * Cria um diretório com uma pasta `data/` própria e o torna o diretório
+ * corrente, já que a persistência lê `data/<tabela>.csv` relativo a ele. No
+ * destrutor, o diretório anterior é restaurado e o temporário é removido.
+ */
+class Sandbox {
+   private:
+    std::filesystem::path previous; /**< Diretório corrente original. */
+    std::filesystem::path root;     /**< Raiz do diretório temporário. */
+
+   public:
+    /**
+     * @brief Cria o diretório temporário e entra nele.
+     * @param name Prefixo do nome do diretório.
+     */
+    explicit Sandbox(const std::string& name)
+        : previous(std::filesystem::current_path()),
+          root(std::filesystem::temp_directory_path() /
+               (name + "-" + std::to_string(getpid()))) {
+        std::filesystem::remove_all(root);
+        std::filesystem::create_directories(root / "data");
+        std::filesystem::current_path(root);
+    }
+
+    /**
+     * @brief Restaura o diretório original e remove o temporário.
+     */
+    ~Sandbox() {
+        std::filesystem::current_path(previous);
+        std::filesystem::remove_all(root);
+    }
+
+    Sandbox(const Sandbox&) = delete;
+    Sandbox& operator=(const Sandbox&) = delete;
+
+    /**
+     * @brief Retorna o caminho do arquivo de uma tabela no sandbox.
+     * @param table O nome da tabela.
+     * @return std::filesystem::path O caminho de `data/<tabela>.csv`.
+     */
+    std::filesystem::path table(const std::string& table) const {
+        return root / "data" / (table + ".csv");
+    }
+
+    /**
+     * @brief Grava uma tabela completa (cabeçalho + linhas).
+     * @param table O nome da tabela.
+     * @param lines As linhas de dados.
+     */
+    void write(const std::string& table,
+               const std::vector<std::string>& lines) const {
+        std::ofstream file(this->table(table), std::ios::trunc);
+
+        file << table_header(table) << "\n";
+        for (const auto& line : lines)
+            file << line << "\n";
+    }
+
+    /**
+     * @brief Grava as quatro tabelas de um cenário.
+     * @param fixture As linhas de cada tabela.
+     */
+    void write(const Fixture& fixture) const {
+        write(PROFESSOR_TABLE, fixture.professores);
+        write(ALUNO_TABLE, fixture.alunos);
+        write(HORARIO_TABLE, fixture.horarios);
+        write(AGENDAMENTO_TABLE, fixture.agendamentos);
+    }
+};
+
+#endif
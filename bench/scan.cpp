@@ -0,0 +1,126 @@
+// Benchmark da varredura paralela: gera um agendamentos.csv grande e mede a
+// vazão de filtrar e converter todos os registros com pools de 1, 2, 4, ...
+// threads, conferindo que o resultado (e a ordem) é sempre o mesmo da versão
+// de uma thread. Também mede selectByColumn pelo executor compartilhado.
+//
+// Uso: scan [linhas] [max_threads]
+
+#include <chrono>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "util/parallel.hpp"
+
+using std::cout;
+using std::endl;
+using std::getline;
+using std::nullopt;
+using std::optional;
+using std::stoi;
+using std::stol;
+using std::string;
+using std::stringstream;
+using std::thread;
+using std::to_string;
+using std::vector;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+struct Registro {
+    long id, aluno, horario;
+    string status;
+
+    bool operator==(const Registro& other) const {
+        return id == other.id && aluno == other.aluno &&
+               horario == other.horario && status == other.status;
+    }
+};
+
+// Converte a linha e mantém apenas os agendamentos pendentes.
+static optional<Registro> parse_pendente(const string& linha) {
+    stringstream ss(linha);
+    string id, aluno, horario, status;
+
+    getline(ss, id, ',');
+    getline(ss, aluno, ',');
+    getline(ss, horario, ',');
+    getline(ss, status, ',');
+
+    if (status != "PENDENTE")
+        return nullopt;
+
+    return Registro{stol(id), stol(aluno), stol(horario), status};
+}
+
+int main(int argc, char** argv) {
+    long linhas = argc > 1 ? stol(argv[1]) : 1000000;
+    size_t maxThreads = argc > 2 ? stoi(argv[2])
+                                 : std::max(4u, thread::hardware_concurrency());
+
+    Sandbox sandbox("bench-scan");
+
+    static const char* status[] = {"PENDENTE", "CONFIRMADO", "RECUSADO",
+                                   "CANCELADO"};
+    vector<string> agendamentos;
+    agendamentos.reserve(linhas);
+
+    for (long i = 1; i <= linhas; ++i)
+        agendamentos.push_back(to_string(i) + "," + to_string(i % 5000 + 1) +
+                               "," + to_string(i % 20000 + 1) + "," +
+                               status[i % 4]);
+
+    sandbox.write(AGENDAMENTO_TABLE, agendamentos);
+
+    MockConnection connection;
+
+    cout << "linhas:  " << linhas << endl;
+    cout << "nucleos: " << thread::hardware_concurrency() << endl;
+
+    auto inicio = steady_clock::now();
+    auto todas = connection.selectAll(AGENDAMENTO_TABLE);
+    double leitura = duration<double>(steady_clock::now() - inicio).count();
+
+    cout << "leitura do arquivo (s): " << leitura << endl;
+
+    vector<Registro> referencia;
+    bool ok = true;
+    double base = 0;
+
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+
+        inicio = steady_clock::now();
+        auto resultado =
+            parallel_filter_map<Registro>(todas, 0, parse_pendente, pool);
+        double segundos =
+            duration<double>(steady_clock::now() - inicio).count();
+
+        if (threads == 1) {
+            referencia = resultado;
+            base = segundos;
+        } else if (!(resultado == referencia)) {
+            ok = false;
+        }
+
+        cout << "threads " << threads << ": " << segundos << " s, "
+             << static_cast<long>(linhas / segundos) << " linhas/s, speedup "
+             << base / segundos << endl;
+    }
+
+    inicio = steady_clock::now();
+    auto porAluno = connection.selectByColumn(AGENDAMENTO_TABLE, 1, "42");
+    cout << "selectByColumn (s): "
+         << duration<double>(steady_clock::now() - inicio).count() << " ("
+         << porAluno.size() << " linhas)" << endl;
+
+    cout << "pendentes: " << referencia.size() << endl;
+    cout << "ordem/resultado: " << (ok ? "OK" : "DIVERGENTE") << endl;
+
+    return ok ? 0 : 1;
+}
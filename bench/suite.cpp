@@ -0,0 +1,189 @@
+// Suíte de benchmarks da persistência e dos services: gera uma pasta data/
+// sintética na escala pedida e mede vazão e percentis de latência de cada
+// operação da MockConnection e dos principais métodos dos services. Os
+// resultados são impressos e gravados em JSON para acompanhar regressões.
+//
+// Uso: suite [agendamentos] [iteracoes] [saida.json]
+
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "dataset.hpp"
+#include "harness.hpp"
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "service/agendamentoService.hpp"
+#include "service/alunoService.hpp"
+#include "service/horarioService.hpp"
+#include "service/professorService.hpp"
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::max;
+using std::mt19937_64;
+using std::stol;
+using std::string;
+using std::to_string;
+using std::uniform_int_distribution;
+using std::vector;
+
+int main(int argc, char** argv) {
+    DatasetConfig config;
+    config.agendamentos = argc > 1 ? stol(argv[1]) : 10000;
+    size_t iteracoes = argc > 2 ? stol(argv[2]) : 200;
+    string saida = std::filesystem::absolute(
+                       argc > 3 ? argv[3] : "bench-results.json")
+                       .string();
+
+    size_t escritas = max<size_t>(1, iteracoes / 2);
+    size_t varreduras = max<size_t>(1, iteracoes / 20);
+
+    Sandbox sandbox("bench-suite");
+    Dataset d = generate_dataset(sandbox, config);
+
+    Report report("suite");
+    report.set("agendamentos", to_string(d.agendamentos));
+    report.set("alunos", to_string(d.alunos));
+    report.set("professores", to_string(d.professores));
+    report.set("horarios", to_string(d.horarios));
+    report.set("iteracoes", to_string(iteracoes));
+
+    cout << "agendamentos: " << d.agendamentos << ", alunos: " << d.alunos
+         << ", professores: " << d.professores
+         << ", horarios: " << d.horarios << endl;
+
+    mt19937_64 rng(7);
+    uniform_int_distribution<long> agendamento(1, d.agendamentos);
+    uniform_int_distribution<long> aluno(1, d.alunos);
+    uniform_int_distribution<long> horario(1, d.horarios);
+    uniform_int_distribution<long> professor(1, d.professores);
+
+    MockConnection connection;
+
+    // --- MockConnection ---
+
+    report.add(measure("MockConnection", "selectOne", iteracoes, [&](size_t) {
+        connection.selectOne(AGENDAMENTO_TABLE, agendamento(rng));
+    }));
+
+    report.add(
+        measure("MockConnection", "selectByColumn", iteracoes, [&](size_t) {
+            connection.selectByColumn(AGENDAMENTO_TABLE, 1,
+                                      to_string(aluno(rng)));
+        }));
+
+    report.add(measure("MockConnection", "selectAll", varreduras, [&](size_t) {
+        connection.selectAll(AGENDAMENTO_TABLE);
+    }));
+
+    vector<long> inseridos(escritas);
+
+    report.add(measure("MockConnection", "insert", escritas, [&](size_t i) {
+        inseridos[i] = connection.insert(
+            AGENDAMENTO_TABLE, "1,-" + to_string(i + 1) + ",PENDENTE");
+    }));
+
+    report.add(measure("MockConnection", "update", escritas, [&](size_t i) {
+        connection.update(AGENDAMENTO_TABLE, inseridos[i],
+                          "1,-" + to_string(i + 1) + ",RECUSADO");
+    }));
+
+    report.add(
+        measure("MockConnection", "compareAndUpdate", escritas, [&](size_t i) {
+            connection.compareAndUpdate(
+                AGENDAMENTO_TABLE, inseridos[i], 3, "RECUSADO",
+                "1,-" + to_string(i + 1) + ",PENDENTE");
+        }));
+
+    report.add(measure("MockConnection", "deleteByColumn", escritas / 2,
+                       [&](size_t i) {
+                           connection.deleteByColumn(AGENDAMENTO_TABLE, 2,
+                                                     "-" + to_string(i + 1));
+                       }));
+
+    report.add(measure("MockConnection", "deleteRecord",
+                       escritas - escritas / 2, [&](size_t i) {
+                           connection.deleteRecord(AGENDAMENTO_TABLE,
+                                                   inseridos[escritas / 2 + i]);
+                       }));
+
+    // --- Services ---
+
+    EventBus bus;
+    EntityManager manager(connection, bus);
+    const auto& agendamentos = manager.getAgendamentoService();
+    const auto& horarios = manager.getHorarioService();
+    const auto& professores = manager.getProfessorService();
+    const auto& alunos = manager.getAlunoService();
+
+    report.add(
+        measure("AgendamentoService", "getById", iteracoes,
+                [&](size_t) { agendamentos->getById(agendamento(rng)); }));
+
+    report.add(
+        measure("AgendamentoService", "listByIdAluno", iteracoes,
+                [&](size_t) { agendamentos->listByIdAluno(aluno(rng)); }));
+
+    report.add(
+        measure("AgendamentoService", "listByIdHorario", iteracoes,
+                [&](size_t) { agendamentos->listByIdHorario(horario(rng)); }));
+
+    report.add(measure("HorarioService", "getById", iteracoes,
+                       [&](size_t) { horarios->getById(horario(rng)); }));
+
+    report.add(
+        measure("HorarioService", "listByIdProfessor", iteracoes,
+                [&](size_t) { horarios->listByIdProfessor(professor(rng)); }));
+
+    report.add(measure("ProfessorService", "getById", iteracoes,
+                       [&](size_t) { professores->getById(professor(rng)); }));
+
+    report.add(measure("ProfessorService", "listAll", varreduras,
+                       [&](size_t) { professores->listAll(); }));
+
+    report.add(measure("AlunoService", "getById", iteracoes,
+                       [&](size_t) { alunos->getById(aluno(rng)); }));
+
+    report.add(measure("AlunoService", "getOneByEmail", iteracoes, [&](size_t) {
+        alunos->getOneByEmail("aluno" + to_string(aluno(rng)) + "@bench.com");
+    }));
+
+    vector<long> disponiveis;
+    for (const auto& linha : connection.selectByColumn(HORARIO_TABLE, 4, "1"))
+        disponiveis.push_back(getIdFromLine(linha));
+
+    if (disponiveis.empty()) {
+        cerr << "nenhum horario disponivel para agendar" << endl;
+        return 1;
+    }
+
+    vector<long> salvos(escritas);
+
+    report.add(measure("AgendamentoService", "save", escritas, [&](size_t i) {
+        salvos[i] = agendamentos
+                        ->save(aluno(rng), disponiveis[i % disponiveis.size()])
+                        ->getId();
+    }));
+
+    report.add(
+        measure("AgendamentoService", "updateStatusById", escritas,
+                [&](size_t i) {
+                    agendamentos->updateStatusById(salvos[i], Status::RECUSADO);
+                }));
+
+    report.add(measure("AgendamentoService", "deleteById", escritas,
+                       [&](size_t i) { agendamentos->deleteById(salvos[i]); }));
+
+    if (!report.write(saida)) {
+        cerr << "falha ao gravar " << saida << endl;
+        return 1;
+    }
+
+    cout << "resultados: " << saida << endl;
+
+    return 0;
+}
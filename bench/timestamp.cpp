@@ -0,0 +1,166 @@
+// Benchmark da formatação e da conversão de datas (dd/mm HH:MM): compara
+// timestamp_to_string/string_to_timestamp com a implementação anterior, via
+// iostream (put_time/get_time + localtime/mktime), e confere que as duas
+// produzem os mesmos resultados para todos os minutos de um ano.
+//
+// Uso: timestamp [amostras] [saida.json]
+// O fuso testado é o do ambiente (ex: TZ=America/Sao_Paulo).
+
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+#include "util/utils.hpp"
+
+using std::cout;
+using std::endl;
+using std::get_time;
+using std::istringstream;
+using std::ostringstream;
+using std::put_time;
+using std::stoi;
+using std::string;
+using std::to_string;
+using std::vector;
+
+// Implementação anterior, mantida como referência.
+static string legacy_format(Timestamp tt) {
+    tm tm_struct = *localtime(&tt);
+
+    ostringstream ss;
+    ss << put_time(&tm_struct, "%d/%m %H:%M");
+    return ss.str();
+}
+
+static Timestamp legacy_parse(const string& timeStr) {
+    tm tm_struct = {};
+    istringstream ss(timeStr);
+
+    ss >> get_time(&tm_struct, "%d/%m %H:%M");
+
+    if (ss.fail())
+        return (Timestamp)-1;
+
+    int original_day = tm_struct.tm_mday;
+    int original_mon = tm_struct.tm_mon;
+
+    tm_struct.tm_year = 2025 - 1900;
+    tm_struct.tm_isdst = -1;
+
+    Timestamp result = mktime(&tm_struct);
+
+    if (result == (Timestamp)-1 || tm_struct.tm_mday != original_day ||
+        tm_struct.tm_mon != original_mon)
+        return (Timestamp)-1;
+
+    return result;
+}
+
+int main(int argc, char** argv) {
+    size_t amostras = argc > 1 ? stoi(argv[1]) : 200000;
+    string saida = argc > 2 ? argv[2] : "timestamp.json";
+
+    const char* tz = getenv("TZ");
+
+    Report report("timestamp");
+    report.set("amostras", to_string(amostras));
+    report.set("tz", tz ? tz : "");
+
+    // Conferência: todos os minutos de 2025 e alguns textos inválidos. A
+    // referência da inferência do ano é o início de 2025, o ano fixo da
+    // implementação anterior.
+    const Timestamp inicio = 1735689600 - 86400;
+    const Timestamp referencia = local_timestamp(2025, 1, 1, 0, 0);
+    size_t divergencias = 0;
+
+    auto conferir = [&](const string& texto) {
+        Timestamp obtido = string_to_timestamp(texto, referencia);
+        Timestamp esperado = legacy_parse(texto);
+
+        if (obtido != esperado && divergencias++ < 5)
+            cout << "parse(\"" << texto << "\"): " << obtido
+                 << " != " << esperado << endl;
+    };
+
+    for (Timestamp t = inicio; t < inicio + 367 * 86400; t += 60) {
+        string esperado = legacy_format(t);
+        if (timestamp_to_string(t) != esperado && divergencias++ < 5)
+            cout << "format(" << t << "): " << timestamp_to_string(t)
+                 << " != " << esperado << endl;
+
+        if (t % 3600 == 0)
+            conferir(esperado);
+    }
+
+    for (string texto :
+         {"31/02 10:00", "00/01 10:00", "10/13 10:00", "10/10 24:00",
+          "10/10 10:60", "", "1/2 3:04", "  05/06   07:08", "05-06 07:08",
+          "05/06 07:08 extra", "05/06 0708"})
+        conferir(texto);
+
+    // O fim de um intervalo herda o ano do início: só muda de ano na virada.
+    auto conferirFim = [&](const string& texto, Timestamp inicioIntervalo,
+                           Timestamp esperado) {
+        Timestamp obtido = string_to_end_timestamp(texto, inicioIntervalo);
+
+        if (obtido != esperado && divergencias++ < 5)
+            cout << "fim(\"" << texto << "\"): " << obtido
+                 << " != " << esperado << endl;
+    };
+
+    Timestamp ultimo = local_timestamp(2025, 12, 31, 23, 0);
+    Timestamp novembro = local_timestamp(2025, 11, 1, 9, 0);
+
+    conferirFim("01/01 00:30", ultimo, local_timestamp(2026, 1, 1, 0, 30));
+    conferirFim("31/12 23:30", ultimo, local_timestamp(2025, 12, 31, 23, 30));
+    conferirFim("01/11 10:00", novembro, local_timestamp(2025, 11, 1, 10, 0));
+    conferirFim("01/11 08:00", novembro, local_timestamp(2025, 11, 1, 8, 0));
+
+    cout << "Divergências: " << divergencias << endl;
+
+    // Horários espalhados pelo ano, como na listagem de horários.
+    vector<Timestamp> instantes(amostras);
+    vector<string> textos(amostras);
+    for (size_t i = 0; i < amostras; ++i) {
+        instantes[i] = inicio + (i * 7919 % 365) * 86400 + i % 1440 * 60;
+        textos[i] = legacy_format(instantes[i]);
+    }
+
+    size_t sink = 0;
+
+    report.add(measure("iostream", "timestamp_to_string", amostras,
+                       [&](size_t i) {
+                           sink += legacy_format(instantes[i]).size();
+                       }));
+    report.add(measure("utils", "timestamp_to_string", amostras,
+                       [&](size_t i) {
+                           sink += timestamp_to_string(instantes[i]).size();
+                       }));
+    report.add(measure("utils", "format_timestamp", amostras, [&](size_t i) {
+        char text[TIMESTAMP_TEXT_SIZE];
+        sink += format_timestamp(instantes[i], text);
+    }));
+    report.add(measure("iostream", "string_to_timestamp", amostras,
+                       [&](size_t i) { sink += legacy_parse(textos[i]); }));
+    report.add(measure("utils", "string_to_timestamp", amostras,
+                       [&](size_t i) {
+                           sink +=
+                               string_to_timestamp(textos[i], referencia);
+                       }));
+
+    if (sink == 0)
+        cout << endl;
+
+    if (!report.write(saida)) {
+        cout << "Falha ao gravar " << saida << endl;
+        return 1;
+    }
+
+    cout << "Resultados gravados em " << saida << endl;
+
+    return divergencias == 0 ? 0 : 1;
+}
@@ -0,0 +1,301 @@
+// Benchmark das transações da persistência: mede AlunoService::deleteById
+// (agendamentos, horários liberados e aluno gravados em um único commit),
+// conta as reescritas de cada tabela e confere que uma falha no meio da
+// cascata, um conflito com outra escrita e um commit interrompido depois do
+// ponto de confirmação não deixam as tabelas inconsistentes, que um conflito
+// no commit de AgendamentoService::deleteById é repetido com sucesso e que
+// outras threads não veem as escritas de uma transação aberta.
+//
+// Uso: transaction [alunos] [agendamentos_por_aluno] [amostras] [saida.json]
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "event/events.hpp"
+#include "harness.hpp"
+#include "persistence/entityManager.hpp"
+#include "sandbox.hpp"
+#include "service/agendamentoService.hpp"
+#include "service/alunoService.hpp"
+#include "service/horarioService.hpp"
+#include "util/academicTerm.hpp"
+#include "util/metrics.hpp"
+
+using std::cout;
+using std::endl;
+using std::ofstream;
+using std::runtime_error;
+using std::stoi;
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+
+#define PROFESSORES 10
+
+// As reescritas acumuladas de uma tabela.
+static uint64_t reescritas(const string& tabela) {
+    return MetricsRegistry::instance()
+        .counter("appointment_table_rewrites_total",
+                 "table=\"" + tabela + "\"")
+        .load();
+}
+
+int main(int argc, char** argv) {
+    int alunos = argc > 1 ? stoi(argv[1]) : 2000;
+    int porAluno = argc > 2 ? stoi(argv[2]) : 5;
+    size_t amostras = argc > 3 ? stoi(argv[3]) : 20;
+    string saida = argc > 4 ? argv[4] : "transaction.json";
+
+    if (amostras + 3 > size_t(alunos))
+        amostras = alunos > 3 ? alunos - 3 : 0;
+
+    Sandbox sandbox("bench-transaction");
+
+    long base = current_term().inicio;
+    vector<string> professores, linhasAlunos, horarios, agendamentos;
+
+    for (int p = 1; p <= PROFESSORES; ++p)
+        professores.push_back(to_string(p) + ",Professor " + to_string(p) +
+                              ",prof" + to_string(p) +
+                              "@bench.com,x,Disciplina");
+
+    // Cada aluno com seus próprios horários; um a cada três confirmado.
+    long id = 1;
+
+    for (int a = 1; a <= alunos; ++a) {
+        linhasAlunos.push_back(to_string(a) + ",Aluno " + to_string(a) +
+                               ",aluno" + to_string(a) + "@bench.com,x," +
+                               to_string(a));
+
+        for (int k = 0; k < porAluno; ++k, ++id) {
+            long inicio = base + id * 3600;
+            bool confirmado = id % 3 == 0;
+
+            horarios.push_back(to_string(id) + "," +
+                               to_string(id % PROFESSORES + 1) + "," +
+                               to_string(inicio) + "," +
+                               to_string(inicio + 3600) +
+                               (confirmado ? ",0,1" : ",1,0"));
+            agendamentos.push_back(
+                to_string(id) + "," + to_string(a) + "," + to_string(id) +
+                (confirmado ? ",CONFIRMADO" : ",PENDENTE"));
+        }
+    }
+
+    sandbox.write(Fixture{professores, linhasAlunos, horarios, agendamentos});
+
+    MockConnection connection;
+    EventBus bus;
+    EntityManager manager(connection, bus);
+    AlunoService& service = *manager.getAlunoService();
+    HorarioService& horarioService = *manager.getHorarioService();
+    AgendamentoService& agendamentoService = *manager.getAgendamentoService();
+
+    Report report("transaction");
+    report.set("alunos", to_string(alunos));
+    report.set("agendamentos_por_aluno", to_string(porAluno));
+
+    // Os pendentes de todas as caixas de entrada.
+    auto pendentes = [&]() {
+        size_t total = 0;
+
+        for (long p = 1; p <= PROFESSORES; ++p)
+            total += agendamentoService.listPendentesByIdProfessor(p)->size();
+
+        return total;
+    };
+
+    size_t divergencias = 0;
+    size_t pendentesAntes = pendentes();
+    uint64_t antesAgendamentos = reescritas(AGENDAMENTO_TABLE);
+    uint64_t antesHorarios = reescritas(HORARIO_TABLE);
+    uint64_t antesAlunos = reescritas(ALUNO_TABLE);
+
+    report.add(measure("AlunoService", "deleteById", amostras, [&](size_t i) {
+        service.deleteById(long(i) + 1);
+    }));
+
+    if (amostras > 0) {
+        cout << "Reescritas por aluno: agendamentos "
+             << (reescritas(AGENDAMENTO_TABLE) - antesAgendamentos) / amostras
+             << ", horários "
+             << (reescritas(HORARIO_TABLE) - antesHorarios) / amostras
+             << ", alunos "
+             << (reescritas(ALUNO_TABLE) - antesAlunos) / amostras << endl;
+    }
+
+    // Os pendentes dos alunos excluídos saíram das caixas.
+    size_t pendentesExcluidos = 0;
+
+    for (long i = 1; i <= long(amostras) * porAluno; ++i)
+        if (i % 3 != 0)
+            ++pendentesExcluidos;
+
+    if (pendentes() != pendentesAntes - pendentesExcluidos)
+        ++divergencias;
+
+    // O estado de um aluno: os agendamentos e os horários confirmados ainda
+    // ocupados.
+    auto intacto = [&](long aluno) {
+        auto lista = agendamentoService.listByIdAluno(aluno);
+
+        if (!service.getById(aluno) || lista.size() != size_t(porAluno))
+            return false;
+
+        for (const auto& agendamento : lista)
+            if (agendamento->getStatus() == Status::CONFIRMADO &&
+                horarioService.isDisponivelById(agendamento->getHorarioId()))
+                return false;
+
+        return true;
+    };
+
+    size_t linhas = connection.selectAll(AGENDAMENTO_TABLE).size();
+    size_t pendentesMeio = pendentes();
+
+    // Uma falha entre a exclusão dos agendamentos e a do aluno desfaz tudo,
+    // inclusive as caixas de entrada já alteradas em memória.
+    long falha = long(amostras) + 1;
+
+    try {
+        Transaction transaction = connection.begin();
+
+        agendamentoService.deleteByIdAluno(falha);
+
+        throw runtime_error("Falha simulada.");
+    } catch (const runtime_error& e) {
+    }
+
+    if (!intacto(falha) || pendentes() != pendentesMeio ||
+        connection.selectAll(AGENDAMENTO_TABLE).size() != linhas)
+        ++divergencias;
+
+    // Outra escrita em uma tabela lida pela transação faz o commit falhar.
+    long conflito = long(amostras) + 2;
+    bool recusado = false;
+
+    try {
+        Transaction transaction = connection.begin();
+
+        agendamentoService.deleteByIdAluno(conflito);
+
+        thread([&connection, ultimo = id - 1]() {
+            string linha = connection.selectOne(AGENDAMENTO_TABLE, ultimo);
+            connection.update(AGENDAMENTO_TABLE, ultimo,
+                              linha.substr(linha.find(',') + 1));
+        }).join();
+
+        connection.deleteRecord(ALUNO_TABLE, conflito);
+
+        transaction.commit();
+    } catch (const TransactionConflict& e) {
+        recusado = true;
+    }
+
+    if (!recusado || !intacto(conflito) || pendentes() != pendentesMeio)
+        ++divergencias;
+
+    // Os agendamentos de outro aluno: um pendente e um confirmado.
+    long aluno = long(amostras) + 3, pendente = 0, confirmado = 0;
+
+    for (long i = (aluno - 1) * porAluno + 1; i <= aluno * porAluno; ++i)
+        (i % 3 == 0 ? confirmado : pendente) = i;
+
+    long professorPendente = pendente % PROFESSORES + 1;
+    auto naCaixa = [&]() {
+        for (const auto& a :
+             *agendamentoService.listPendentesByIdProfessor(professorPendente))
+            if (a->getId() == pendente)
+                return true;
+
+        return false;
+    };
+
+    // Com a transação aberta, as outras threads continuam vendo o pedido
+    // pendente na caixa e o horário do confirmado ocupado.
+    if (pendente && confirmado) {
+        Transaction transaction = connection.begin();
+
+        agendamentoService.deleteById(pendente);
+        agendamentoService.deleteById(confirmado);
+
+        bool visto = false;
+
+        thread([&]() {
+            visto = !naCaixa() || horarioService.isDisponivelById(confirmado);
+        }).join();
+
+        if (visto)
+            ++divergencias;
+    }
+
+    if (!naCaixa() || horarioService.isDisponivelById(confirmado))
+        ++divergencias;
+
+    // Uma escrita concorrente entre a leitura e o commit faz a transação
+    // repetir a exclusão, que então é gravada; a liberação do horário só é
+    // publicada pela tentativa confirmada.
+    size_t tentativas = 0, liberacoes = 0;
+
+    bus.subscribe<HorarioLiberadoEvent>(
+        [&](const HorarioLiberadoEvent&) { ++liberacoes; });
+
+    auto excluir = [&]() {
+        bool excluido = agendamentoService.deleteById(confirmado);
+
+        if (++tentativas > 1)
+            return excluido;
+
+        thread([&connection, ultimo = id - 1]() {
+            string linha = connection.selectOne(AGENDAMENTO_TABLE, ultimo);
+            connection.update(AGENDAMENTO_TABLE, ultimo,
+                              linha.substr(linha.find(',') + 1));
+        }).join();
+
+        return excluido;
+    };
+
+    if (confirmado &&
+        (!Transaction::retry(connection, excluir) || tentativas != 2 ||
+         liberacoes != 1 ||
+         !connection.selectByColumn(AGENDAMENTO_TABLE, 0, to_string(confirmado))
+              .empty() ||
+         !horarioService.isDisponivelById(confirmado)))
+        ++divergencias;
+
+    cout << "Tentativas da exclusão com conflito: " << tentativas << endl;
+
+    // Um commit interrompido depois do ponto de confirmação é concluído na
+    // próxima abertura de uma conexão.
+    {
+        ofstream temporario("data/" + string(ALUNO_TABLE) + ".csv.tmp");
+        temporario << ALUNO_HEADER << "\n"
+                   << linhasAlunos.back() << "\n";
+
+        ofstream diario("data/transacao.log");
+        diario << ALUNO_TABLE << "\n";
+    }
+
+    MockConnection reaberta;
+
+    if (reaberta.selectAll(ALUNO_TABLE).size() != 1 ||
+        std::filesystem::exists("data/transacao.log"))
+        ++divergencias;
+
+    cout << "Divergências: " << divergencias << endl;
+
+    if (!report.write(saida)) {
+        cout << "Falha ao gravar " << saida << endl;
+        return 1;
+    }
+
+    cout << "Resultados gravados em " << saida << endl;
+
+    return divergencias == 0 ? 0 : 1;
+}
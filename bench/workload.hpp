@@ -0,0 +1,165 @@
+#ifndef BENCH_WORKLOAD_HPP
+#define BENCH_WORKLOAD_HPP
+
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "dataset.hpp"
+#include "zipf.hpp"
+
+/**
+ * @brief Tipos de operação de um trace de carga.
+ */
+enum class OpType {
+    LOGIN_ALUNO,         /**< arg1 = aluno. */
+    LOGIN_PROFESSOR,     /**< arg1 = professor. */
+    LISTAR_PROFESSORES,  /**< Sem argumentos. */
+    LISTAR_HORARIOS,     /**< arg1 = professor. */
+    LISTAR_AGENDAMENTOS, /**< arg1 = aluno. */
+    AGENDAR,             /**< arg1 = aluno, arg2 = horário. */
+    CONFIRMAR,           /**< arg1 = professor (primeiro pendente). */
+    RECUSAR,             /**< arg1 = professor (primeiro pendente). */
+    CANCELAR,            /**< arg1 = aluno (primeiro cancelável). */
+};
+
+/**
+ * @brief Número de tipos de operação.
+ */
+#define OP_TYPE_COUNT 9
+
+/**
+ * @brief Nomes das operações, na ordem de OpType; usados no arquivo de trace.
+ */
+inline const char* op_name(OpType type) {
+    static const char* nomes[OP_TYPE_COUNT] = {
+        "LOGIN_ALUNO",         "LOGIN_PROFESSOR", "LISTAR_PROFESSORES",
+        "LISTAR_HORARIOS",     "LISTAR_AGENDAMENTOS", "AGENDAR",
+        "CONFIRMAR",           "RECUSAR",         "CANCELAR"};
+
+    return nomes[static_cast<int>(type)];
+}
+
+/**
+ * @brief Uma operação do trace.
+ */
+struct Operation {
+    OpType type;   /**< O tipo da operação. */
+    long arg1 = 0; /**< Primeiro argumento. */
+    long arg2 = 0; /**< Segundo argumento. */
+};
+
+/**
+ * @brief Parâmetros de geração de um trace.
+ */
+struct TraceConfig {
+    long operacoes = 10000; /**< Número de operações. */
+    double zipf = 0.99;     /**< Assimetria da procura por professor. */
+    unsigned seed = 7;      /**< Semente do gerador. */
+
+    /**
+     * @brief Pesos de cada tipo de operação, na ordem de OpType.
+     */
+    std::vector<double> pesos = {10, 3, 10, 25, 15, 20, 8, 4, 5};
+};
+
+/**
+ * @brief Gera um trace de operações coerente com o dataset.
+ * * Alunos são sorteados uniformemente; professores (listagem de horários,
+ * agendamento e avaliação de pendentes) seguem a distribuição de Zipf, como
+ * na geração dos dados.
+ * @param d O dataset sobre o qual o trace será executado.
+ * @param config Os parâmetros de geração.
+ * @return std::vector<Operation> As operações, em ordem.
+ */
+inline std::vector<Operation> generate_trace(const Dataset& d,
+                                             const TraceConfig& config) {
+    std::mt19937_64 rng(config.seed);
+    std::discrete_distribution<int> tipo(config.pesos.begin(),
+                                         config.pesos.end());
+    std::uniform_int_distribution<long> aluno(1, d.alunos);
+    Zipf professor((d.horarios + d.porProfessor - 1) / d.porProfessor,
+                   config.zipf);
+
+    std::vector<Operation> ops;
+    ops.reserve(config.operacoes);
+
+    for (long i = 0; i < config.operacoes; ++i) {
+        Operation op{static_cast<OpType>(tipo(rng))};
+
+        switch (op.type) {
+            case OpType::LOGIN_ALUNO:
+            case OpType::LISTAR_AGENDAMENTOS:
+            case OpType::CANCELAR:
+                op.arg1 = aluno(rng);
+                break;
+            case OpType::LOGIN_PROFESSOR:
+            case OpType::LISTAR_HORARIOS:
+            case OpType::CONFIRMAR:
+            case OpType::RECUSAR:
+                op.arg1 = professor(rng);
+                break;
+            case OpType::AGENDAR: {
+                auto faixa = d.horariosDe(professor(rng));
+                op.arg1 = aluno(rng);
+                op.arg2 = std::uniform_int_distribution<long>(
+                    faixa.first, faixa.second)(rng);
+                break;
+            }
+            case OpType::LISTAR_PROFESSORES:
+                break;
+        }
+
+        ops.push_back(op);
+    }
+
+    return ops;
+}
+
+/**
+ * @brief Grava um trace, uma operação por linha: `NOME arg1 arg2`.
+ */
+inline void save_trace(const std::string& path,
+                       const std::vector<Operation>& ops) {
+    std::ofstream out(path, std::ios::trunc);
+
+    for (const auto& op : ops)
+        out << op_name(op.type) << " " << op.arg1 << " " << op.arg2 << "\n";
+}
+
+/**
+ * @brief Lê um trace gravado por save_trace().
+ * @throws std::runtime_error Se houver uma operação desconhecida.
+ */
+inline std::vector<Operation> load_trace(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<Operation> ops;
+    std::string line;
+
+    while (std::getline(in, line)) {
+        std::istringstream ss(line);
+        std::string nome;
+        Operation op{OpType::LISTAR_PROFESSORES};
+
+        if (!(ss >> nome))
+            continue;
+
+        int t = 0;
+        while (t < OP_TYPE_COUNT && nome != op_name(static_cast<OpType>(t)))
+            ++t;
+
+        if (t == OP_TYPE_COUNT)
+            throw std::runtime_error("Operação desconhecida no trace: " + nome);
+
+        op.type = static_cast<OpType>(t);
+        ss >> op.arg1 >> op.arg2;
+        ops.push_back(op);
+    }
+
+    return ops;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef BENCH_ZIPF_HPP
+#define BENCH_ZIPF_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+/**
+ * @brief Distribuição de Zipf sobre {1, ..., n}: P(k) proporcional a 1/k^s.
+ * * Com s = 0 a distribuição é uniforme; valores próximos de 1 concentram a
+ * maior parte das escolhas nos primeiros itens. A CDF é pré-calculada e a
+ * amostragem é uma busca binária.
+ */
+class Zipf {
+   private:
+    std::vector<double> cdf; /**< Função de distribuição acumulada. */
+    std::uniform_real_distribution<double> uniform{0.0, 1.0};
+
+   public:
+    /**
+     * @brief Construtor da classe Zipf.
+     * @param n O número de itens.
+     * @param s O expoente (assimetria).
+     */
+    Zipf(long n, double s) : cdf(std::max(1L, n)) {
+        double total = 0;
+
+        for (size_t k = 0; k < cdf.size(); ++k) {
+            total += 1.0 / std::pow(static_cast<double>(k + 1), s);
+            cdf[k] = total;
+        }
+
+        for (auto& value : cdf)
+            value /= total;
+    }
+
+    /**
+     * @brief Sorteia um item.
+     * @param rng O gerador de números aleatórios.
+     * @return long Um valor em [1, n].
+     */
+    template <typename Rng>
+    long operator()(Rng& rng) {
+        double u = uniform(rng);
+        auto it = std::lower_bound(cdf.begin(), cdf.end(), u);
+
+        return std::min<long>(it - cdf.begin(), cdf.size() - 1) + 1;
+    }
+};
+
+#endif
@@ -1,6 +1,8 @@
 #ifndef APP_COMPOSER_HPP
 #define APP_COMPOSER_HPP
 
+#include <cstdint>
+
 #include "view/alunoUI.hpp"
 #include "view/authUI.hpp"
 #include "view/professorUI.hpp"
@@ -51,9 +53,39 @@ class App {
      * @brief Inicia o ciclo de execução da aplicação.
      * * Este método contém o loop principal que alterna entre as diferentes
      * interfaces de usuário (AuthUI, AlunoUI, ProfessorUI) com base no estado
-     * do SessionService.
+     * do SessionService. Enquanto executa, SIGUSR1 grava as métricas em
+     * `metrics.txt` e `metrics.prom`.
      */
     void run();
+
+    /**
+     * @brief Executa a aplicação como servidor TCP, sem interface de console.
+     * * Expõe os controllers pelo protocolo de linhas do RequestHandler e
+     * bloqueia até receber SIGINT ou SIGTERM. SIGUSR1 grava as métricas em
+     * `metrics.txt` e `metrics.prom`.
+     * @param port A porta de escuta.
+     * @param workers O número de threads de atendimento (0 usa o número de
+     * núcleos).
+     */
+    void serve(uint16_t port, size_t workers = 0);
+
+    /**
+     * @brief Move para o arquivo morto os Horários (e seus Agendamentos)
+     * encerrados antes do início do período letivo corrente.
+     * @return size_t O número de horários arquivados.
+     */
+    size_t archive();
+
+    /**
+     * @brief Importa em lote um arquivo CSV de alunos, professores ou
+     * horários e informa as linhas recusadas.
+     * @param tabela "alunos", "professores" ou "horarios".
+     * @param arquivo O caminho do arquivo.
+     * @return size_t O número de registros importados.
+     * @throws std::invalid_argument Se a tabela for desconhecida.
+     * @throws std::runtime_error Se o arquivo não puder ser aberto.
+     */
+    size_t import(const std::string& tabela, const std::string& arquivo);
 };
 
 #endif
\ No newline at end of file
@@ -38,6 +38,14 @@ class AgendamentoController {
      */
     std::shared_ptr<Agendamento> agendarHorario(long alunoID, long horarioId);
 
+    /**
+     * @brief Busca um agendamento pelo ID (Requisição GET).
+     * * @param id O identificador único do agendamento.
+     * @return std::shared_ptr<Agendamento> O agendamento encontrado, ou
+     * nullptr.
+     */
+    std::shared_ptr<Agendamento> read(long id);
+
     /**
      * @brief Altera o status do agendamento para CANCELADO.
      * * Realiza uma atualização parcial (PATCH) no recurso, modificando apenas
@@ -61,6 +69,56 @@ class AgendamentoController {
      * * @param id O identificador único do agendamento a ser recusado.
      */
     void recusar(long id);
+
+    /**
+     * @brief Retorna a caixa de entrada de um professor (Requisição GET).
+     * * @param idProfessor O identificador único do professor.
+     * @return Horario::AgendamentoView Os agendamentos pendentes dos horários
+     * do professor, em ordem de pedido.
+     */
+    Horario::AgendamentoView listarPendentes(long idProfessor);
+
+    /**
+     * @brief Lista os agendamentos de um aluno em páginas (Requisição GET).
+     * * @param idAluno O identificador único do aluno.
+     * @param after A posição retornada pela página anterior.
+     * @param limite O número máximo de agendamentos da página.
+     * @return AgendamentoPage A página de agendamentos.
+     */
+    AgendamentoPage listarPorAluno(long idAluno, const AgendamentoCursor& after,
+                                   size_t limite);
+
+    /**
+     * @brief Confirma vários agendamentos pendentes de um professor de uma
+     * vez.
+     * * @param idProfessor O identificador único do professor.
+     * @param ids Os identificadores dos agendamentos.
+     * @return std::vector<StatusUpdateResult> O resultado de cada
+     * agendamento, na ordem dos IDs.
+     */
+    std::vector<StatusUpdateResult> confirmarPendentes(
+        long idProfessor, const std::vector<long>& ids);
+
+    /**
+     * @brief Recusa vários agendamentos pendentes de um professor de uma vez.
+     * * @param idProfessor O identificador único do professor.
+     * @param ids Os identificadores dos agendamentos.
+     * @return std::vector<StatusUpdateResult> O resultado de cada
+     * agendamento, na ordem dos IDs.
+     */
+    std::vector<StatusUpdateResult> recusarPendentes(
+        long idProfessor, const std::vector<long>& ids);
+
+    /**
+     * @brief Altera o status de vários agendamentos de uma vez (Requisição
+     * PATCH em lote).
+     * * Uma mudança que falha não impede as demais.
+     * @param mudancas O identificador de cada agendamento e o novo status.
+     * @return std::vector<StatusUpdateResult> O resultado de cada mudança, na
+     * mesma ordem.
+     */
+    std::vector<StatusUpdateResult> alterarStatusEmLote(
+        const std::vector<std::pair<long, Status>>& mudancas);
 };
 
 #endif
\ No newline at end of file
@@ -72,6 +72,19 @@ class AlunoController {
      * @return false Se a operação falhar (ex: aluno não encontrado).
      */
     bool destroy(long id);
+
+    /**
+     * @brief Importa vários alunos de um arquivo CSV (Requisição POST em lote).
+     * * O arquivo tem um cabeçalho e uma linha por aluno, com os campos
+     * `nome,email,senha,matricula`. As validações são as de create(); as senhas
+     * passam pelo hash em paralelo (ver hash_passwords()). Linhas inválidas ou
+     * repetidas são recusadas sem impedir as demais.
+     * @param arquivo O caminho do arquivo.
+     * @return ImportReport O número de registros gravados e o motivo de cada
+     * linha recusada.
+     * @throws std::runtime_error Se o arquivo não puder ser aberto.
+     */
+    ImportReport importar(const std::string& arquivo);
 };
 
 #endif
\ No newline at end of file
@@ -60,6 +60,35 @@ class HorarioController {
      * @return false Se a operação falhar (ex: horário não encontrado).
      */
     bool excluirPorId(long idHorario);
+
+    /**
+     * @brief Busca, em páginas, os Horários disponíveis de todos os
+     * professores em um intervalo (Requisição GET).
+     * * @param inicio O início do intervalo (inclusivo).
+     * @param fim O fim do intervalo (exclusivo).
+     * @param disciplina A disciplina dos professores (vazia para todas).
+     * @param after A posição retornada pela página anterior.
+     * @param limite O número máximo de horários da página.
+     * @return HorarioPage A página de horários.
+     */
+    HorarioPage buscarDisponiveis(Timestamp inicio, Timestamp fim,
+                                  const std::string& disciplina,
+                                  const TimeIndex::Cursor& after,
+                                  size_t limite);
+
+    /**
+     * @brief Importa vários horários de um arquivo CSV (Requisição POST em
+     * lote).
+     * * O arquivo tem um cabeçalho e uma linha por horário, com os campos
+     * `email_professor,inicio,fim` (dd/mm HH:MM, com o ano inferido como no
+     * cadastro individual). Linhas inválidas ou repetidas são recusadas sem
+     * impedir as demais.
+     * @param arquivo O caminho do arquivo.
+     * @return ImportReport O número de registros gravados e o motivo de cada
+     * linha recusada.
+     * @throws std::runtime_error Se o arquivo não puder ser aberto.
+     */
+    ImportReport importar(const std::string& arquivo);
 };
 
 #endif
\ No newline at end of file
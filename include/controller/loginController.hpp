@@ -1,9 +1,51 @@
 #ifndef LOGIN_CONTROLLER_HPP
 #define LOGIN_CONTROLLER_HPP
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+
 #include "event/bus.hpp"
 #include "service/alunoService.hpp"
 #include "service/professorService.hpp"
+#include "util/rateLimiter.hpp"
+
+/**
+ * @brief Tentativas de login por segundo admitidas para um mesmo email, em
+ * regime.
+ */
+#define LOGIN_EMAIL_RATE 0.2
+
+/**
+ * @brief Rajada de tentativas de login admitida para um mesmo email.
+ */
+#define LOGIN_EMAIL_BURST 5
+
+/**
+ * @brief Tentativas de login por segundo admitidas no total, em regime.
+ */
+#define LOGIN_GLOBAL_RATE 100
+
+/**
+ * @brief Rajada de tentativas de login admitida no total.
+ */
+#define LOGIN_GLOBAL_BURST 200
+
+/**
+ * @brief Máximo de rehashes de senha pendentes (executando ou na fila).
+ */
+#define LOGIN_REHASH_CAPACITY 4
+
+/**
+ * @brief Exceção lançada quando uma tentativa de login é recusada pelo
+ * limitador de taxa, antes de qualquer busca ou verificação de senha.
+ */
+class LoginRateLimited : public std::runtime_error {
+   public:
+    using std::runtime_error::runtime_error;
+};
 
 /**
  * @brief Controller para gerenciamento de autenticação (Login).
@@ -32,6 +74,39 @@ class LoginController {
      */
     EventBus& bus;
 
+    /**
+     * @brief Limita as tentativas de login por email e no total.
+     * * Consultado antes da busca do usuário e da verificação da senha, para
+     * que uma enxurrada de tentativas não consuma CPU de hash.
+     */
+    RateLimiter limiter;
+
+    /**
+     * @brief Admite uma tentativa de login no limitador.
+     * @param email O email informado.
+     * @throws LoginRateLimited Se o limite de tentativas foi excedido.
+     */
+    void admit(const std::string& email);
+
+    std::mutex rehashMx;                /**< Protege os rehashes pendentes. */
+    std::condition_variable rehashDone; /**< Sinaliza o fim de um rehash. */
+    std::set<std::string> rehashing;    /**< Hashes sendo refeitos. */
+
+    /**
+     * @brief Refaz em segundo plano um hash com parâmetros desatualizados.
+     * * Chamado após um login bem-sucedido, única ocasião em que a senha em
+     * texto claro está disponível. O novo hash é calculado no pool do
+     * PasswordVerifier e entregue a `store`, que só deve gravá-lo se o hash
+     * armazenado ainda for `cypher` (ver AlunoService::updateSenhaById()).
+     * Não faz nada se o hash estiver atualizado, se já estiver sendo refeito
+     * ou se LOGIN_REHASH_CAPACITY rehashes estiverem pendentes.
+     * @param cypher O hash armazenado.
+     * @param senha A senha em texto claro.
+     * @param store Grava o novo hash.
+     */
+    void scheduleRehash(const std::string& cypher, const std::string& senha,
+                        std::function<void(const std::string&)> store);
+
    public:
     /**
      * @brief Construtor da classe LoginController.
@@ -45,14 +120,15 @@ class LoginController {
                     EventBus& bus);
 
     /**
-     * @brief Destrutor padrão.
+     * @brief Destrutor: aguarda os rehashes pendentes, que usam os serviços.
      */
-    ~LoginController() = default;
+    ~LoginController();
 
     /**
      * @brief Tenta realizar o login de um Aluno.
      * * Usa AlunoService para resgatar o usuário e conferir a senha. Em caso de
-     * sucesso, notifica o EventBus.
+     * sucesso, notifica o EventBus e, se o hash estiver desatualizado, agenda
+     * o seu rehash.
      * * @param email O email do aluno.
      * @param senha A senha do aluno.
      * @return std::shared_ptr<Aluno> O objeto Aluno autenticado se o login for
@@ -64,7 +140,8 @@ class LoginController {
     /**
      * @brief Tenta realizar o login de um Professor.
      * * Usa ProfessorService para resgatar o usuário e conferir a senha. Em
-     * caso de sucesso, notifica o EventBus.
+     * caso de sucesso, notifica o EventBus e, se o hash estiver desatualizado,
+     * agenda o seu rehash.
      * * @param email O email do professor.
      * @param senha A senha do professor.
      * @return std::shared_ptr<Professor> O objeto Professor autenticado se o
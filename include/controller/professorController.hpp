@@ -60,6 +60,14 @@ class ProfessorController {
      */
     std::vector<std::shared_ptr<Professor>> list();
 
+    /**
+     * @brief Lista os Professores cadastrados em páginas (Requisição GET).
+     * * @param after A posição retornada pela página anterior.
+     * @param limit O número máximo de professores da página.
+     * @return ProfessorPage A página de professores.
+     */
+    ProfessorPage listPage(const ProfessorCursor& after, size_t limit);
+
     /**
      * @brief Atualiza as informações de um Professor (Requisição PUT).
      * * @param id O identificador único do professor a ser atualizado.
@@ -83,6 +91,20 @@ class ProfessorController {
      * @return false Se a operação falhar (ex: professor não encontrado).
      */
     bool destroy(long id);
+
+    /**
+     * @brief Importa vários professores de um arquivo CSV (Requisição POST em
+     * lote).
+     * * O arquivo tem um cabeçalho e uma linha por professor, com os campos
+     * `nome,email,senha,disciplina`. As validações são as de create(); as
+     * senhas passam pelo hash em paralelo (ver hash_passwords()). Linhas
+     * inválidas ou repetidas são recusadas sem impedir as demais.
+     * @param arquivo O caminho do arquivo.
+     * @return ImportReport O número de registros gravados e o motivo de cada
+     * linha recusada.
+     * @throws std::runtime_error Se o arquivo não puder ser aberto.
+     */
+    ImportReport importar(const std::string& arquivo);
 };
 
 #endif
\ No newline at end of file
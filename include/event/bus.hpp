@@ -6,6 +6,9 @@
 #include <typeindex>
 #include <unordered_map>
 
+#include "util/metrics.hpp"
+#include "util/tracing.hpp"
+
 /**
  * @brief Implementa um mecanismo de Barramento de Eventos (Event Bus) síncrono.
  * * Segue o padrão Publicador/Assinante (Publisher/Subscriber), permitindo
@@ -67,6 +70,9 @@ class EventBus {
      */
     template <typename EventType>
     void publish(const EventType& event) {
+        METRIC_SCOPE("EventBus::publish");
+        TRACE_SPAN("EventBus::publish");
+
         std::lock_guard<std::mutex> lock(mx);
 
         auto it = subscribers.find(std::type_index(typeid(EventType)));
@@ -21,6 +21,11 @@ enum class Status {
     CONFIRMADO /**< O agendamento foi confirmado pelo professor. */
 };
 
+/**
+ * @brief Número de valores da enumeração Status.
+ */
+#define STATUS_COUNT 4
+
 /**
  * @brief Converte uma string para o valor correspondente da enumeração Status.
  * * Não lança exceção, mas pode retornar um status padrão se a string for
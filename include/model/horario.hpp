@@ -30,6 +30,8 @@ class Horario {
     Timestamp fim;    /**< O timestamp de fim do horário. */
     bool disponivel;  /**< Indica se o horário está atualmente disponível para
                          agendamento. */
+    long versao;      /**< Versão do registro, incrementada a cada escrita
+                         (controle de concorrência otimista). */
 
     /**
      * @brief Função de callback para carregar o objeto Professor proprietário
@@ -39,7 +41,8 @@ class Horario {
 
     /**
      * @brief Lista de agendamentos associados a este horário.
-     * * Armazenada como EntityList para suportar carregamento preguiçoso.
+     * * Armazenada como EntityList para suportar carregamento preguiçoso, com
+     * uma visão por status.
      */
     EntityList<Agendamento> agendamentos;
 
@@ -64,6 +67,11 @@ class Horario {
      */
     using AgendamentoVector = AgendamentoList::EntityVector;
 
+    /**
+     * @brief Alias para uma visão imutável e compartilhada de Agendamentos.
+     */
+    using AgendamentoView = std::shared_ptr<const AgendamentoVector>;
+
     /**
      * @brief Construtor da classe Horario.
      * * Inicializa os atributos e injeta as funções de carregamento para as
@@ -73,11 +81,12 @@ class Horario {
      * @param inicio O timestamp de início.
      * @param fim O timestamp de fim.
      * @param disp O status inicial de disponibilidade.
+     * @param versao A versão persistida do registro.
      * @param profLoader Função de callback para carregar o objeto Professor.
      * @param agLoader Função de callback para carregar a lista de Agendamentos.
      */
     Horario(long id, long idProf, Timestamp inicio, Timestamp fim, bool disp,
-            const ProfessorLoader& profLoader,
+            long versao, const ProfessorLoader& profLoader,
             const AgendamentosLoader& agLoader);
 
     /**
@@ -110,6 +119,12 @@ class Horario {
      */
     bool isDisponivel() const;
 
+    /**
+     * @brief Retorna a versão do registro do horário.
+     * @return long A versão.
+     */
+    long getVersao() const;
+
     /**
      * @brief Retorna o timestamp de início formatado como string.
      * @return std::string A string formatada do início.
@@ -129,18 +144,24 @@ class Horario {
     std::shared_ptr<Professor> getProfessor();
 
     /**
-     * @brief Retorna uma lista filtrada de Agendamentos com status PENDENTE.
-     * * Carrega a lista completa de agendamentos e aplica a filtragem.
-     * @return AgendamentoVector Um vetor contendo agendamentos pendentes.
+     * @brief Retorna a lista de Agendamentos do horário.
+     * @return AgendamentoList& A referência para a lista.
+     */
+    AgendamentoList& getAgendamentos();
+
+    /**
+     * @brief Retorna os Agendamentos com status PENDENTE.
+     * * Visão mantida pela lista a cada mudança de status, sem cópia.
+     * @return AgendamentoView Os agendamentos pendentes.
      */
-    AgendamentoVector getAgendamentosPendentes();
+    AgendamentoView getAgendamentosPendentes();
 
     /**
-     * @brief Retorna uma lista filtrada de Agendamentos com status CONFIRMADO.
-     * * Carrega a lista completa de agendamentos e aplica a filtragem.
-     * @return AgendamentoVector Um vetor contendo agendamentos confirmados.
+     * @brief Retorna os Agendamentos com status CONFIRMADO.
+     * * Visão mantida pela lista a cada mudança de status, sem cópia.
+     * @return AgendamentoView Os agendamentos confirmados.
      */
-    AgendamentoVector getAgendamentosConfirmados();
+    AgendamentoView getAgendamentosConfirmados();
 
     /**
      * @brief Define um novo ID para o horário.
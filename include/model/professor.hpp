@@ -21,7 +21,8 @@ class Professor : public Usuario {
 
     /**
      * @brief Lista de horários de disponibilidade associados a este professor.
-     * * Armazenada como EntityList para suportar carregamento preguiçoso.
+     * * Armazenada como EntityList para suportar carregamento preguiçoso, com
+     * uma visão dos disponíveis e outra dos ocupados.
      */
     EntityList<Horario> horarios;
 
@@ -36,6 +37,11 @@ class Professor : public Usuario {
      */
     using HorarioVector = HorarioList::EntityVector;
 
+    /**
+     * @brief Alias para uma visão imutável e compartilhada de Horários.
+     */
+    using HorarioView = std::shared_ptr<const HorarioVector>;
+
     /**
      * @brief Alias para a função de carregamento que fornece a lista de
      * horários.
@@ -78,18 +84,20 @@ class Professor : public Usuario {
     HorarioList& getHorarios();
 
     /**
-     * @brief Retorna uma lista filtrada de Horários que estão disponíveis.
-     * * Carrega a lista completa de horários e aplica a lógica de filtragem.
-     * @return HorarioVector Um vetor contendo apenas os horários disponíveis.
+     * @brief Retorna os Horários que estão disponíveis.
+     * * As visões são montadas no carregamento da lista e atualizadas a cada
+     * mudança de disponibilidade (ver EntityList::replace()); a chamada não
+     * copia nem filtra nada.
+     * @return HorarioView Os horários disponíveis, em ordem.
      */
-    HorarioVector getHorariosDisponiveis();
+    HorarioView getHorariosDisponiveis();
 
     /**
-     * @brief Retorna uma lista filtrada de Horários que estão ocupados.
-     * * Carrega a lista completa de horários e aplica a lógica de filtragem.
-     * @return HorarioVector Um vetor contendo apenas os horários ocupados.
+     * @brief Retorna os Horários que estão ocupados.
+     * * Mantida como getHorariosDisponiveis().
+     * @return HorarioView Os horários ocupados, em ordem.
      */
-    HorarioVector getHorariosOcupados();
+    HorarioView getHorariosOcupados();
 
     /**
      * @brief Operador de comparação para ordenação.
@@ -3,8 +3,13 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
+#include "persistence/transaction.hpp"
 #include "util/fileObserver.hpp"
+#include "util/metrics.hpp"
 
 /**
  * @brief Implementa um cache genérico para entidades do sistema.
@@ -13,6 +18,12 @@
  * * O cache suporta **invalidação automática** baseada na observação de
  * arquivos de dados, garantindo que os dados em memória sejam atualizados
  * quando os arquivos persistidos mudarem.
+ * * As operações pontuais (invalidate, contains, at, find, put, erase) são
+ * protegidas por um mutex interno; a iteração não é, e só deve ser usada
+ * quando nenhuma outra thread escreve no cache.
+ * * Acertos e falhas de find/at, invalidações e entradas descartadas são
+ * contados no MetricsRegistry, rotulados pelo primeiro arquivo observado
+ * (a tabela principal do cache).
  * @tparam T O tipo da entidade a ser armazenada (ex: Aluno, Professor).
  */
 template <typename T>
@@ -32,6 +43,27 @@ class EntityCache {
      */
     FileObserver fileObserver;
 
+    /**
+     * @brief Mutex que serializa o acesso ao mapa e ao observador.
+     */
+    mutable std::mutex mx;
+
+    Counter& hits;          /**< Buscas atendidas pelo cache. */
+    Counter& misses;        /**< Buscas que não encontraram a entidade. */
+    Counter& invalidations; /**< Invalidações por mudança de arquivo. */
+    Counter& cleared;       /**< Entradas descartadas nas invalidações. */
+
+    /**
+     * @brief Retorna um contador deste cache no MetricsRegistry.
+     */
+    static Counter& counter(const std::string& family,
+                            const std::vector<std::string>& observedFiles) {
+        std::string name = observedFiles.empty() ? "" : observedFiles.front();
+
+        return MetricsRegistry::instance().counter(family,
+                                                   "cache=\"" + name + "\"");
+    }
+
    public:
     /**
      * @brief Alias para o tipo do mapa interno de cache.
@@ -56,7 +88,13 @@ class EntityCache {
      * arquivos de dados que, se alterados, devem invalidar este cache.
      */
     EntityCache(const std::vector<std::string>& observedFiles)
-        : fileObserver(observedFiles) {}
+        : fileObserver(observedFiles),
+          hits(counter("appointment_cache_hits_total", observedFiles)),
+          misses(counter("appointment_cache_misses_total", observedFiles)),
+          invalidations(
+              counter("appointment_cache_invalidations_total", observedFiles)),
+          cleared(counter("appointment_cache_entries_cleared_total",
+                          observedFiles)) {}
 
     /**
      * @brief Destrutor padrão.
@@ -70,7 +108,13 @@ class EntityCache {
      * arquivo, false caso contrário.
      */
     bool invalidate() {
+        METRIC_SCOPE("EntityCache::invalidate");
+
+        std::lock_guard<std::mutex> lock(mx);
+
         if (fileObserver.hasFileChanged()) {
+            invalidations.fetch_add(1, std::memory_order_relaxed);
+            cleared.fetch_add(cache.size(), std::memory_order_relaxed);
             cache.clear();
             return true;
         }
@@ -78,6 +122,19 @@ class EntityCache {
         return false;
     }
 
+    /**
+     * @brief Absorve uma escrita deste processo nos arquivos observados, já
+     * aplicada às entidades do cache, para que invalidate() não limpe o
+     * cache por causa dela.
+     * * Deve ser chamado depois da escrita (no commit, se houver transação;
+     * ver Transaction::afterCommit()).
+     */
+    void absorb() {
+        std::lock_guard<std::mutex> lock(mx);
+
+        fileObserver.hasFileChanged();
+    }
+
     /**
      * @brief Verifica se uma entidade com o ID especificado está presente no
      * cache.
@@ -85,6 +142,8 @@ class EntityCache {
      * @return bool True se o ID estiver no cache, false caso contrário.
      */
     bool contains(long id) const {
+        std::lock_guard<std::mutex> lock(mx);
+
         return cache.count(id) > 0;
     }
 
@@ -96,13 +155,45 @@ class EntityCache {
      * @throws std::out_of_range Se o ID não for encontrado no cache.
      */
     std::shared_ptr<T> at(long id) {
-        if (contains(id))
-            return cache[id];
+        std::lock_guard<std::mutex> lock(mx);
+
+        auto it = cache.find(id);
+
+        if (it != cache.end()) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return it->second;
+        }
+
+        misses.fetch_add(1, std::memory_order_relaxed);
 
         throw std::out_of_range("Id " + std::to_string(id) +
                                 " não encontrado no cache");
     }
 
+    /**
+     * @brief Busca uma entidade no cache sem lançar exceção.
+     * * Prefira este método ao par contains/at quando houver concorrência:
+     * a consulta é atômica e não sofre com uma invalidação entre as duas
+     * chamadas.
+     * @param id O identificador único da entidade.
+     * @return std::shared_ptr<T> O ponteiro para a entidade, ou nullptr se
+     * ela não estiver no cache.
+     */
+    std::shared_ptr<T> find(long id) const {
+        std::lock_guard<std::mutex> lock(mx);
+
+        auto it = cache.find(id);
+
+        if (it == cache.end()) {
+            misses.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        hits.fetch_add(1, std::memory_order_relaxed);
+
+        return it->second;
+    }
+
     /**
      * @brief Retorna um iterador constante para o início do cache.
      * @return ConstIterator O iterador.
@@ -140,15 +231,26 @@ class EntityCache {
      * @return size_t O tamanho atual do cache.
      */
     size_t size() const {
+        std::lock_guard<std::mutex> lock(mx);
+
         return cache.size();
     }
 
     /**
      * @brief Insere ou atualiza uma entidade no cache.
+     * * Não tem efeito se a thread tiver uma transação ativa: a entidade pode
+     * refletir escritas ainda não confirmadas, que as outras threads não
+     * devem ver. Depois do commit, a entidade é gravada no cache (ver
+     * absorb()) ou as tabelas alteradas o invalidam.
      * @param id O identificador único da entidade.
      * @param entity O ponteiro inteligente para a entidade.
      */
     void put(long id, std::shared_ptr<T> entity) {
+        if (Transaction::inProgress())
+            return;
+
+        std::lock_guard<std::mutex> lock(mx);
+
         cache[id] = entity;
     }
 
@@ -157,6 +259,8 @@ class EntityCache {
      * @param id O identificador único da entidade a ser removida.
      */
     void erase(long id) {
+        std::lock_guard<std::mutex> lock(mx);
+
         cache.erase(id);
     }
 };
@@ -26,6 +26,9 @@ class Horario;
 #define HORARIO_TABLE "horarios"
 #define PROFESSOR_TABLE "professores"
 
+#define AGENDAMENTO_ARCHIVE_TABLE "agendamentos_arquivo"
+#define HORARIO_ARCHIVE_TABLE "horarios_arquivo"
+
 /**
  * @brief Classe central que gerencia a inicialização e o acesso a todos os
  * serviços de negócio (Services) e às funções de carregamento (Loaders) de
@@ -0,0 +1,93 @@
+#ifndef INTERVAL_INDEX_HPP
+#define INTERVAL_INDEX_HPP
+
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "util/utils.hpp"
+
+/**
+ * @brief Conjunto ordenado de intervalos [inicio, fim) por dono, para
+ * detectar sobreposições.
+ * * Os intervalos de cada dono ficam ordenados por início, junto com a maior
+ * duração já vista. Um intervalo que sobrepõe [inicio, fim) começa antes de
+ * `fim` e depois de `inicio - maior duração`; a busca parte desse ponto com
+ * uma busca binária e percorre só os k candidatos da janela, em O(log n + k).
+ *
+ * Não é thread-safe: o dono do índice deve serializar os acessos.
+ */
+class IntervalIndex {
+   private:
+    /**
+     * @brief A chave de um intervalo: o início e o ID.
+     */
+    using Key = std::pair<Timestamp, long>;
+
+    /**
+     * @brief Os intervalos de um dono.
+     */
+    struct Owner {
+        std::map<Key, Timestamp> intervals; /**< Fim de cada intervalo. */
+        Timestamp maxLength = 0;            /**< A maior duração. */
+    };
+
+    std::unordered_map<long, Owner> owners; /**< Os intervalos por dono. */
+
+    /**
+     * @brief O dono e a chave de cada ID, para a remoção.
+     */
+    std::unordered_map<long, std::pair<long, Key>> byId;
+
+   public:
+    /**
+     * @brief Remove todos os intervalos.
+     */
+    void clear();
+
+    /**
+     * @brief Insere um intervalo, ou o substitui se o ID já existir.
+     * @param owner O dono do intervalo (ex: o professor).
+     * @param id O ID do intervalo.
+     * @param inicio O início (inclusivo).
+     * @param fim O fim (exclusivo).
+     */
+    void insert(long owner, long id, Timestamp inicio, Timestamp fim);
+
+    /**
+     * @brief Remove um intervalo.
+     * @param id O ID do intervalo.
+     * @return bool True se o intervalo existia.
+     */
+    bool erase(long id);
+
+    /**
+     * @brief Remove todos os intervalos de um dono.
+     * @param owner O dono.
+     * @return size_t O número de intervalos removidos.
+     */
+    size_t eraseOwner(long owner);
+
+    /**
+     * @brief Busca os intervalos de um dono que se sobrepõem a [inicio, fim).
+     * * Intervalos que apenas se tocam (um termina quando o outro começa) não
+     * se sobrepõem.
+     * @param owner O dono.
+     * @param inicio O início (inclusivo).
+     * @param fim O fim (exclusivo).
+     * @param except Um ID a ignorar (ex: o do próprio intervalo, na
+     * atualização), ou -1.
+     * @return std::vector<long> Os IDs, em ordem de início.
+     */
+    std::vector<long> overlapping(long owner, Timestamp inicio, Timestamp fim,
+                                  long except = -1) const;
+
+    /**
+     * @brief Retorna o número de intervalos.
+     * @return size_t O número de intervalos.
+     */
+    size_t size() const;
+};
+
+#endif
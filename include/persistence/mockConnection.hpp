@@ -1,16 +1,179 @@
 #ifndef MOCK_CONNECTION_HPP
 #define MOCK_CONNECTION_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
+#include "persistence/transaction.hpp"
+#include "util/metrics.hpp"
+
+/**
+ * @brief Contadores de E/S de uma tabela, registrados no MetricsRegistry com
+ * o rótulo `table`.
+ */
+struct TableCounters {
+    Counter& bytesRead;    /**< Bytes lidos do arquivo. */
+    Counter& bytesWritten; /**< Bytes gravados (anexados ou reescritos). */
+    Counter& linesParsed;  /**< Linhas lidas do arquivo. */
+    Counter& rewrites;     /**< Reescritas completas do arquivo. */
+
+    /**
+     * @brief Construtor da struct TableCounters.
+     * @param table_name O nome da tabela.
+     */
+    explicit TableCounters(const std::string& table_name);
+};
+
 /**
  * @brief Simula uma conexão de persistência.
  * * Esta classe fornece métodos que imitam as operações CRUD (Create, Read,
  * Update, Delete) de um banco de dados, mas manipula dados em arquivos CSV.
+ * * Cada tabela é mantida em memória como uma sequência de versões imutáveis
+ * (Snapshot). As consultas leem a versão mais recente sem travar a tabela:
+ * não esperam os escritores nem os fazem esperar, e cada uma enxerga uma
+ * versão consistente do começo ao fim. As escritas são serializadas pelo lock
+ * exclusivo da tabela; cada uma grava o arquivo e publica uma nova versão, e
+ * as versões antigas são liberadas quando a última consulta que as usa
+ * termina. Uma versão é relida do arquivo quando ele muda por fora (horário
+ * de modificação ou tamanho diferentes dos gravados).
+ * * Cada tabela também acumula contadores de E/S (ver TableCounters).
+ * * Dentro de uma Transaction da thread, as operações leem e escrevem a cópia
+ * da tabela mantida pela transação, sem tocar no arquivo (exceto moveWhere(),
+ * que não é transacional).
  */
 class MockConnection {
+   private:
+    /**
+     * @brief Uma versão imutável das linhas de uma tabela.
+     */
+    struct Snapshot {
+        std::vector<std::string> lines; /**< As linhas, com o cabeçalho. */
+        uint64_t version = 0;           /**< O número da versão. */
+        int64_t mtime = 0;       /**< Modificação do arquivo (ns). */
+        std::uintmax_t size = 0; /**< Tamanho do arquivo. */
+    };
+
+    /**
+     * @brief Estado de uma tabela: o lock de escrita, os contadores de E/S e
+     * a versão mais recente.
+     */
+    struct Table {
+        std::shared_mutex lock; /**< O lock da tabela. */
+        TableCounters counters; /**< Os contadores de E/S. */
+
+        /**
+         * @brief A versão mais recente, ou nullptr antes da primeira leitura.
+         * * Lida e trocada somente com std::atomic_load e std::atomic_store.
+         * Na libstdc++ essas funções não são livres de lock: usam um mutex
+         * global (escolhido pelo endereço do ponteiro) durante a cópia do
+         * ponteiro. A seção é curta e não inclui E/S, mas as consultas não
+         * são totalmente livres de espera.
+         */
+        std::shared_ptr<const Snapshot> snapshot;
+
+        std::atomic<uint64_t> versions{0}; /**< A última versão numerada. */
+
+        explicit Table(const std::string& name) : counters(name) {}
+    };
+
+    /**
+     * @brief Mutex que protege a criação das tabelas.
+     */
+    mutable std::mutex tablesMx;
+
+    /**
+     * @brief Estado das tabelas, criado sob demanda.
+     */
+    mutable std::map<std::string, std::unique_ptr<Table>> tables;
+
+    /**
+     * @brief Retorna o estado de uma tabela, criando-o sob demanda.
+     * @param table_name O nome da tabela.
+     * @return Table& O lock e os contadores da tabela.
+     */
+    Table& table(const std::string& table_name) const;
+
+    /**
+     * @brief Retorna a versão mais recente de uma tabela para uma consulta.
+     * * Sem travar a tabela, se a versão corresponder ao arquivo. Se o arquivo
+     * mudou por fora, ela é relida sob o lock compartilhado; se um escritor
+     * tiver o lock nesse momento, a última versão publicada é usada.
+     * @param table_name O nome da tabela.
+     * @param t O estado da tabela.
+     * @return std::shared_ptr<const Snapshot> A versão.
+     */
+    std::shared_ptr<const Snapshot> read(const std::string& table_name,
+                                         Table& t) const;
+
+    /**
+     * @brief Retorna a versão mais recente de uma tabela, relendo o arquivo se
+     * ele mudou por fora. Deve ser chamado com o lock da tabela travado.
+     * @param table_name O nome da tabela.
+     * @param t O estado da tabela.
+     * @return std::shared_ptr<const Snapshot> A versão.
+     */
+    std::shared_ptr<const Snapshot> latest(const std::string& table_name,
+                                           Table& t) const;
+
+    /**
+     * @brief Publica uma nova versão de uma tabela, depois de gravar o
+     * arquivo. Deve ser chamado com o lock exclusivo da tabela travado.
+     * @param table_name O nome da tabela.
+     * @param t O estado da tabela.
+     * @param lines As linhas gravadas, com o cabeçalho.
+     */
+    void publish(const std::string& table_name, Table& t,
+                 std::vector<std::string> lines) const;
+
+    /**
+     * @brief Copia a versão mais recente de uma tabela, com o cabeçalho, para
+     * uma transação.
+     * * Ao contrário de read(), espera um escritor em andamento terminar: a
+     * versão anterior à dele seria recusada no commit (ver commit()).
+     * @param table_name O nome da tabela.
+     * @param version Recebe o número da versão copiada.
+     * @return std::vector<std::string> As linhas.
+     */
+    std::vector<std::string> load(const std::string& table_name,
+                                  uint64_t& version) const;
+
+    /**
+     * @brief Grava as tabelas alteradas por uma transação.
+     * * Toma o lock exclusivo de todas as tabelas, em ordem de nome, e confere
+     * as versões antes de gravar qualquer uma. Os temporários e o diário são
+     * sincronizados com o disco antes das renomeações, e o diretório, antes
+     * e depois delas.
+     * @param tables As cópias das tabelas tocadas pela transação.
+     * @throws TransactionConflict Se alguma tabela mudou desde a leitura.
+     * @throws std::runtime_error Se a gravação falhar.
+     */
+    void commit(const std::map<std::string, Transaction::Buffer>& tables) const;
+
+    friend class Transaction;
+
    public:
+    /**
+     * @brief Construtor da classe MockConnection.
+     * * Conclui um commit de transação interrompido depois do seu ponto de
+     * confirmação (ver Transaction).
+     */
+    MockConnection();
+
+    /**
+     * @brief Inicia uma transação na conexão para a thread atual. [SQL: BEGIN]
+     * @return Transaction A transação, desfeita ao sair de escopo se
+     * Transaction::commit() não for chamado.
+     */
+    Transaction begin() const;
+
     /**
      * @brief Insere um novo registro na "tabela" especificada. [SQL: INSERT]
      * * Simula a criação de um novo registro.
@@ -20,6 +183,20 @@ class MockConnection {
      */
     long insert(const std::string& table_name, const std::string& data) const;
 
+    /**
+     * @brief Insere vários registros na "tabela" especificada. [SQL: INSERT
+     * ... VALUES (...), (...)]
+     * * O maior ID é lido uma única vez e os registros recebem um bloco
+     * contíguo de IDs, na ordem de `data`, anexados ao arquivo em uma única
+     * escrita sob o lock exclusivo da tabela.
+     * @param table_name O nome da tabela.
+     * @param data Os dados de cada registro.
+     * @return long O ID do primeiro registro (o i-ésimo recebe esse ID + i),
+     * ou 0 se `data` for vazio.
+     */
+    long insertMany(const std::string& table_name,
+                    const std::vector<std::string>& data) const;
+
     /**
      * @brief Seleciona e retorna um único registro pelo seu ID. [SQL: SELECT]
      * * Simula a busca por chave primária.
@@ -33,7 +210,9 @@ class MockConnection {
     /**
      * @brief Seleciona e retorna vários registros que correspondem a um valor
      * em uma coluna. [SQL: SELECT]
-     * * Simula uma cláusula WHERE baseada em uma coluna específica.
+     * * Simula uma cláusula WHERE baseada em uma coluna específica. Em tabelas
+     * grandes, a comparação é feita em paralelo no executor compartilhado
+     * (ver parallel_filter_map()).
      * @param table_name O nome da tabela.
      * @param index O índice da coluna (simulada) para a busca.
      * @param value O valor a ser comparado na coluna.
@@ -62,6 +241,43 @@ class MockConnection {
     void update(const std::string& table_name, long id,
                 const std::string& data) const;
 
+    /**
+     * @brief Atualiza um registro somente se uma de suas colunas ainda tiver o
+     * valor esperado. [SQL: UPDATE ... WHERE id = ? AND coluna = ?]
+     * * A comparação e a escrita acontecem atomicamente sob o lock exclusivo
+     * da tabela. Usada para controle de concorrência otimista, comparando uma
+     * coluna de versão.
+     * @param table_name O nome da tabela.
+     * @param id O identificador único do registro.
+     * @param index O índice da coluna comparada.
+     * @param expected O valor esperado para a coluna.
+     * @param data A string contendo os novos dados do registro.
+     * @return bool True se o registro foi atualizado; false se a coluna tinha
+     * outro valor.
+     * @throws std::runtime_error Se o ID não existir na tabela.
+     */
+    bool compareAndUpdate(const std::string& table_name, long id, size_t index,
+                          const std::string& expected,
+                          const std::string& data) const;
+
+    /**
+     * @brief Atualiza vários registros, cada um somente se uma de suas colunas
+     * ainda tiver o valor esperado. [SQL: UPDATE ... WHERE id IN (...) AND
+     * coluna = ?]
+     * * Variante em lote de compareAndUpdate(): o arquivo é lido e reescrito
+     * uma única vez, sob o lock exclusivo da tabela.
+     * @param table_name O nome da tabela.
+     * @param index O índice da coluna comparada.
+     * @param changes Para cada ID, o valor esperado da coluna e os novos
+     * dados do registro.
+     * @return std::vector<long> Os IDs atualizados, em ordem crescente. IDs
+     * ausentes ou com outro valor na coluna ficam de fora.
+     */
+    std::vector<long> compareAndUpdateMany(
+        const std::string& table_name, size_t index,
+        const std::map<long, std::pair<std::string, std::string>>& changes)
+        const;
+
     /**
      * @brief Exclui um único registro pelo seu ID. [SQL: DELETE]
      * * @param table_name O nome da tabela.
@@ -81,6 +297,39 @@ class MockConnection {
      */
     size_t deleteByColumn(const std::string& table_name, size_t index,
                           const std::string& value) const;
+
+    /**
+     * @brief Exclui os registros que satisfazem um predicado. [SQL: DELETE
+     * ... WHERE id IN (...)]
+     * * O arquivo é lido e reescrito uma única vez, sob o lock exclusivo da
+     * tabela, qualquer que seja o número de registros excluídos.
+     * @param table_name O nome da tabela.
+     * @param pred O predicado, aplicado a cada linha de dados.
+     * @return std::vector<std::string> As linhas excluídas.
+     */
+    std::vector<std::string> deleteWhere(
+        const std::string& table_name,
+        const std::function<bool(const std::string&)>& pred) const;
+
+    /**
+     * @brief Move para outra tabela os registros que satisfazem um predicado,
+     * mantendo os IDs. [SQL: INSERT INTO ... SELECT; DELETE]
+     * * As linhas são anexadas ao destino (criado com o cabeçalho da origem,
+     * se ainda não existir) antes de a origem ser reescrita: uma falha entre
+     * as duas escritas deixa registros repetidos no destino, nunca perdidos.
+     * O registro de maior ID nunca é movido, para que insert() não reutilize
+     * IDs arquivados.
+     * * Não pode ser usada dentro de uma transação.
+     * @param table_name A tabela de origem.
+     * @param archive_name A tabela de destino.
+     * @param pred O predicado, aplicado a cada linha de dados da origem.
+     * @return std::vector<std::string> As linhas movidas.
+     * @throws std::logic_error Se a thread tiver uma transação ativa na
+     * conexão.
+     */
+    std::vector<std::string> moveWhere(
+        const std::string& table_name, const std::string& archive_name,
+        const std::function<bool(const std::string&)>& pred) const;
 };
 
 /**
@@ -0,0 +1,151 @@
+#ifndef TIME_INDEX_HPP
+#define TIME_INDEX_HPP
+
+#include <functional>
+#include <limits>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "util/utils.hpp"
+
+/**
+ * @brief Largura de cada partição do índice, em dias.
+ */
+#define TIME_INDEX_PARTITION_DAYS 7
+
+/**
+ * @brief Índice de registros por intervalo de tempo, particionado por faixas
+ * fixas do instante de início.
+ * * Cada partição guarda os registros ordenados por dono e início; uma
+ * consulta só percorre as partições que intersectam o intervalo pedido, sem
+ * tocar nos registros de períodos anteriores. O índice guarda a linha CSV de
+ * cada registro, para que a consulta não precise voltar à tabela.
+ *
+ * Os registros ativos (ex: horários disponíveis) de cada partição também
+ * ficam ordenados só por início, o que permite percorrê-los em ordem de tempo
+ * entre todos os donos, em páginas (ver scan()).
+ *
+ * Depois de montado, o índice acompanha as escritas registro a registro
+ * (put(), erase()), sem ser remontado.
+ *
+ * Não é thread-safe: o dono do índice deve serializar os acessos.
+ */
+class TimeIndex {
+   public:
+    /**
+     * @brief Um registro indexado.
+     */
+    struct Entry {
+        Timestamp inicio; /**< O início do registro (chave da partição). */
+        Timestamp fim;    /**< O fim do registro. */
+        long owner;       /**< O dono do registro (ex: o professor). */
+        long id;          /**< O ID do registro. */
+        std::string line; /**< A linha CSV do registro. */
+        bool active;      /**< Se o registro entra em scan(). */
+        long version;     /**< A versão do registro (ver put()). */
+    };
+
+    /**
+     * @brief Uma posição na ordem de scan(): o início e o ID do último
+     * registro visitado. O padrão é antes do primeiro registro.
+     */
+    struct Cursor {
+        Timestamp inicio = std::numeric_limits<Timestamp>::min();
+        long id = 0;
+    };
+
+   private:
+    /**
+     * @brief Uma faixa de tempo do índice.
+     */
+    struct Partition {
+        std::vector<Entry> entries; /**< Ordenados por dono e início. */
+        std::vector<size_t> active; /**< Os ativos, por início e ID. */
+    };
+
+    /**
+     * @brief As partições, pela faixa de início.
+     */
+    std::map<long long, Partition> partitions;
+
+    size_t count = 0; /**< Total de registros. */
+
+    /**
+     * @brief A partição de cada registro, pelo ID.
+     */
+    std::unordered_map<long, long long> partitionById;
+
+    /**
+     * @brief Retorna a partição de um instante.
+     */
+    static long long partitionOf(Timestamp tt);
+
+    /**
+     * @brief Remonta a lista de ativos de uma partição.
+     */
+    static void indexActive(Partition& partition);
+
+   public:
+    /**
+     * @brief Substitui o conteúdo do índice.
+     * @param entries Os registros, em qualquer ordem.
+     */
+    void build(std::vector<Entry> entries);
+
+    /**
+     * @brief Insere um registro ou substitui o de mesmo ID.
+     * * Um registro que só muda a linha e o flag `active` é alterado no
+     * lugar; os demais mudam de posição. Custa O(tamanho da partição).
+     * @param entry O registro.
+     * @return bool False se o índice já tinha uma versão mais nova do
+     * registro, que é mantida.
+     */
+    bool put(Entry entry);
+
+    /**
+     * @brief Remove um registro pelo ID.
+     * @param id O ID do registro.
+     * @return bool True se o registro estava no índice.
+     */
+    bool erase(long id);
+
+    /**
+     * @brief Busca os registros de um dono com início em [from, to).
+     * @param owner O dono.
+     * @param from O início do intervalo (inclusivo).
+     * @param to O fim do intervalo (exclusivo).
+     * @return std::vector<const Entry*> Os registros, em ordem de início; os
+     * ponteiros valem até a próxima alteração do índice.
+     */
+    std::vector<const Entry*> query(long owner, Timestamp from,
+                                    Timestamp to) const;
+
+    /**
+     * @brief Percorre os registros ativos de todos os donos com início em
+     * [from, to), em ordem de início e ID, a partir de uma posição.
+     * * Só as partições do intervalo são visitadas, e a busca pela posição
+     * inicial é binária; o custo é proporcional ao que for visitado.
+     * @param from O início do intervalo (inclusivo).
+     * @param to O fim do intervalo (exclusivo).
+     * @param after A posição; só registros depois dela são visitados.
+     * @param visit Chamada para cada registro; retorna false para parar.
+     */
+    void scan(Timestamp from, Timestamp to, const Cursor& after,
+              const std::function<bool(const Entry&)>& visit) const;
+
+    /**
+     * @brief Retorna o número de registros indexados.
+     * @return size_t O número de registros.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Retorna o número de partições não vazias.
+     * @return size_t O número de partições.
+     */
+    size_t partitionCount() const;
+};
+
+#endif
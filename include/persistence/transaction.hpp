@@ -0,0 +1,198 @@
+#ifndef TRANSACTION_HPP
+#define TRANSACTION_HPP
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Número de tentativas de Transaction::retry() antes de desistir.
+ */
+#define TRANSACTION_MAX_ATTEMPTS 3
+
+class MockConnection;
+
+/**
+ * @brief Lançada por Transaction::commit() quando outra operação escreveu em
+ * uma das tabelas lidas pela transação; a transação é desfeita.
+ */
+class TransactionConflict : public std::runtime_error {
+   public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Transação sobre uma MockConnection. [SQL: BEGIN; COMMIT; ROLLBACK]
+ * * Enquanto a transação está ativa, toda operação da conexão feita pela
+ * thread que a iniciou passa a ler e escrever uma cópia em memória de cada
+ * tabela tocada, carregada no primeiro acesso; nada é gravado até commit().
+ * Assim, os services continuam chamando a conexão como antes, e uma cascata
+ * que atravessa vários services cabe em uma única transação.
+ * * O controle de concorrência é otimista, como o da coluna de versão dos
+ * horários: nenhum lock de tabela é mantido durante a transação, e commit()
+ * toma o lock exclusivo de todas as tabelas tocadas e confere que nenhuma
+ * foi escrita por outra operação desde a sua leitura; se alguma foi, a
+ * transação é desfeita e commit() lança TransactionConflict (ver retry()).
+ * * O commit grava cada tabela alterada em um arquivo temporário e, em
+ * seguida, um diário com os nomes dessas tabelas: o diário gravado é o ponto
+ * de confirmação. Os temporários, o diário e o diretório são sincronizados
+ * com o disco (fsync) antes de seguir. Só então os temporários substituem as
+ * tabelas e o diário é removido; uma queda entre as duas etapas é concluída
+ * na próxima abertura de uma MockConnection.
+ * * Enquanto a thread tem uma transação ativa, os caches de entidades não
+ * guardam o que ela lê (ver EntityCache::put()), e os services adiam para o
+ * commit as mudanças nas suas estruturas em memória (ver afterCommit()):
+ * outras threads não veem nada que ainda não foi gravado.
+ * * Uma transação iniciada quando a thread já tem outra ativa na mesma conexão
+ * participa da externa: o seu commit() e o seu rollback() não têm efeito, e
+ * só a externa grava ou desfaz as escritas.
+ * * Não é thread-safe: a transação pertence à thread que a criou e deve ser
+ * encerrada nela, na ordem inversa da criação (como um objeto local).
+ */
+class Transaction {
+   private:
+    /**
+     * @brief A cópia de uma tabela tocada pela transação.
+     */
+    struct Buffer {
+        std::vector<std::string> lines; /**< As linhas, com o cabeçalho. */
+        uint64_t version = 0;           /**< A versão lida da tabela. */
+        bool dirty = false;             /**< Se a cópia foi alterada. */
+    };
+
+    const MockConnection& connection; /**< A conexão da transação. */
+    Transaction* outer; /**< A transação anterior da thread, em qualquer
+                           conexão. */
+    Transaction* owner; /**< A que grava: esta ou a externa da conexão. */
+    bool active = true; /**< Se ainda não foi encerrada. */
+    std::map<std::string, Buffer> tables; /**< As tabelas tocadas, por nome. */
+    std::vector<std::function<void()>> callbacks; /**< Ver onCommit(). */
+
+    /**
+     * @brief Retorna a cópia de uma tabela, carregando-a no primeiro acesso.
+     * @param table_name O nome da tabela.
+     * @return Buffer& A cópia da tabela (da transação externa, se esta
+     * participar de uma).
+     */
+    Buffer& buffer(const std::string& table_name);
+
+    /**
+     * @brief Encerra a transação: deixa de ser a ativa da thread.
+     */
+    void finish();
+
+    /**
+     * @brief Descarta os buffers e os callbacks de commit.
+     * * As escritas nunca chegaram aos arquivos, e caches e índices só as
+     * aplicam nos callbacks de commit, então não há o que invalidar.
+     */
+    void discard();
+
+    friend class MockConnection;
+
+   public:
+    /**
+     * @brief Inicia uma transação na conexão para a thread atual.
+     * @param connection A conexão.
+     */
+    explicit Transaction(const MockConnection& connection);
+
+    /**
+     * @brief Destrutor: desfaz a transação se ela não foi confirmada.
+     */
+    ~Transaction();
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    /**
+     * @brief Grava todas as escritas da transação.
+     * @throws TransactionConflict Se outra operação escreveu em uma das
+     * tabelas tocadas (a transação é desfeita).
+     * @throws std::runtime_error Se a gravação falhar.
+     * @throws std::logic_error Se a transação já foi encerrada.
+     */
+    void commit();
+
+    /**
+     * @brief Descarta todas as escritas da transação.
+     */
+    void rollback();
+
+    /**
+     * @brief Registra uma função a ser chamada depois que as escritas forem
+     * gravadas, já sem os locks das tabelas.
+     * * Usada pelos services para absorver as próprias escritas nos seus
+     * FileObserver, como fazem fora de uma transação. A função é descartada
+     * se a transação for desfeita.
+     * @param callback A função (registrada na transação externa, se esta
+     * participar de uma).
+     */
+    void onCommit(std::function<void()> callback);
+
+    /**
+     * @brief Retorna a transação ativa da thread atual em uma conexão.
+     * @param connection A conexão.
+     * @return Transaction* A transação mais interna da conexão, ou nullptr.
+     */
+    static Transaction* current(const MockConnection& connection);
+
+    /**
+     * @brief Retorna se a thread atual tem uma transação ativa, em qualquer
+     * conexão.
+     * @return bool True se houver uma transação ativa.
+     */
+    static bool inProgress();
+
+    /**
+     * @brief Executa uma função depois que as escritas da thread na conexão
+     * forem gravadas: na hora, se não houver transação ativa, ou no commit
+     * (ver onCommit()).
+     * @param connection A conexão.
+     * @param callback A função.
+     */
+    static void afterCommit(const MockConnection& connection,
+                            std::function<void()> callback);
+
+    /**
+     * @brief Executa uma função em uma transação e a confirma, repetindo
+     * tudo desde o início se o commit encontrar um conflito.
+     * * A função deve fazer as suas leituras dentro da transação, para que a
+     * repetição parta do estado novo. Se a thread já tiver uma transação
+     * ativa na conexão, a função participa dela e um conflito só aparece no
+     * commit da externa.
+     * @param connection A conexão.
+     * @param body A função.
+     * @return O retorno da função.
+     * @throws TransactionConflict Se as TRANSACTION_MAX_ATTEMPTS tentativas
+     * encontrarem conflitos.
+     */
+    template <typename F>
+    static auto retry(const MockConnection& connection, F body)
+        -> decltype(body()) {
+        for (int attempt = 1;; ++attempt) {
+            Transaction transaction(connection);
+
+            try {
+                if constexpr (std::is_void_v<decltype(body())>) {
+                    body();
+                    transaction.commit();
+                    return;
+                } else {
+                    auto result = body();
+                    transaction.commit();
+                    return result;
+                }
+            } catch (const TransactionConflict&) {
+                if (attempt == TRANSACTION_MAX_ATTEMPTS)
+                    throw;
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef REQUEST_HANDLER_HPP
+#define REQUEST_HANDLER_HPP
+
+#include <string>
+#include <vector>
+
+#include "controller/agendamentoController.hpp"
+#include "controller/loginController.hpp"
+#include "controller/professorController.hpp"
+#include "service/sessionService.hpp"
+
+/**
+ * @brief Interpreta o protocolo de linhas do servidor e o traduz em chamadas
+ * aos controllers.
+ * * Cada requisição é uma linha `COMANDO arg1 arg2 ...` (argumentos separados
+ * por espaço). A resposta começa com `OK` ou `ERR <mensagem>`; respostas de
+ * listagem são `OK <n>` seguidas de n linhas com campos separados por TAB.
+ *
+ * Comandos:
+ * - `LOGIN_ALUNO <email> <senha>` / `LOGIN_PROFESSOR <email> <senha>` ->
+ * `OK <token>`
+ * - `LOGOUT <token>`
+ * - `PROFESSORES` -> `id  nome  disciplina`
+ * - `HORARIOS <idProfessor>` -> horários disponíveis `id  inicio  fim`
+ * (timestamps em segundos)
+ * - `AGENDAMENTOS <token>` -> agendamentos do aluno `id  idHorario  status`
+ * - `PENDENTES <token>` -> pendentes do professor `id  idHorario  idAluno`
+ * - `AGENDAR <token> <idHorario>` -> `OK <idAgendamento>`
+ * - `CONFIRMAR <token> <id>` / `RECUSAR <token> <id>` (professor dono do
+ * horário)
+ * - `CANCELAR <token> <id>` (aluno dono do agendamento ou professor dono do
+ * horário)
+ * - `CONFIRMAR_LOTE <token> <id>...` / `RECUSAR_LOTE <token> <id>...`
+ * (pendentes do professor) -> `id  OK` ou `id  ERR <mensagem>` por ID
+ *
+ * A classe não guarda estado por conexão: a sessão é identificada pelo token,
+ * então várias threads podem atender requisições ao mesmo tempo.
+ */
+class RequestHandler {
+   private:
+    LoginController& loginController; /**< Autenticação. */
+    ProfessorController& professorController; /**< Consulta de professores. */
+    AgendamentoController& agendamentoController; /**< Agendamentos. */
+    const std::shared_ptr<SessionService>& sessionService; /**< Sessões. */
+
+    /**
+     * @brief Autentica e retorna o token da sessão aberta pelo login.
+     */
+    std::string login(const std::vector<std::string>& args, bool professor);
+
+    /**
+     * @brief Lista os professores cadastrados.
+     */
+    std::string professores();
+
+    /**
+     * @brief Lista os horários disponíveis de um professor.
+     */
+    std::string horarios(const std::vector<std::string>& args);
+
+    /**
+     * @brief Lista os agendamentos do aluno da sessão.
+     */
+    std::string agendamentos(const std::vector<std::string>& args);
+
+    /**
+     * @brief Lista os agendamentos pendentes do professor da sessão.
+     */
+    std::string pendentes(const std::vector<std::string>& args);
+
+    /**
+     * @brief Cria um agendamento para o aluno da sessão.
+     */
+    std::string agendar(const std::vector<std::string>& args);
+
+    /**
+     * @brief Confirma, recusa ou cancela um agendamento após verificar se a
+     * sessão tem permissão sobre ele.
+     */
+    std::string alterarStatus(const std::vector<std::string>& args,
+                              const Status& status);
+
+    /**
+     * @brief Confirma ou recusa, de uma vez, vários agendamentos pendentes
+     * do professor da sessão, com um resultado por agendamento.
+     */
+    std::string alterarStatusEmLote(const std::vector<std::string>& args,
+                                    const Status& status);
+
+   public:
+    /**
+     * @brief Construtor da classe RequestHandler.
+     * @param loginController O controller de login.
+     * @param professorController O controller de professores.
+     * @param agendamentoController O controller de agendamentos.
+     * @param sessionService O serviço de sessões.
+     */
+    RequestHandler(LoginController& loginController,
+                   ProfessorController& professorController,
+                   AgendamentoController& agendamentoController,
+                   const std::shared_ptr<SessionService>& sessionService);
+
+    /**
+     * @brief Atende uma requisição.
+     * * Erros de validação ou de negócio não são propagados: viram uma
+     * resposta `ERR`.
+     * @param line A linha da requisição (sem o '\n').
+     * @return std::string A resposta completa, terminada em '\n'.
+     */
+    std::string handle(const std::string& line);
+};
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef TCP_SERVER_HPP
+#define TCP_SERVER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "server/requestHandler.hpp"
+#include "util/threadPool.hpp"
+
+/**
+ * @brief Servidor TCP do protocolo de linhas, sem interface de console.
+ * * Uma única thread executa o laço de eventos (epoll): aceita conexões, lê
+ * bytes, separa linhas completas e escreve respostas. O trabalho de cada
+ * requisição (controllers, services, persistência) é executado em um
+ * ThreadPool, de modo que requisições lentas não bloqueiam o laço.
+ *
+ * Em uma mesma conexão as requisições são atendidas em ordem: enquanto um lote
+ * de linhas está no pool, as próximas aguardam no buffer de entrada. O comando
+ * `QUIT` encerra a conexão após enviar as respostas anteriores.
+ *
+ * A leitura de uma conexão é suspensa (EPOLLIN desligado) enquanto um lote
+ * dela está no pool, enquanto a saída pendente passa de um limite ou enquanto
+ * a entrada acumulada atinge outro; os bytes restantes aguardam no socket, e
+ * um cliente que envia mais rápido do que lê não faz o servidor crescer sem
+ * limite.
+ *
+ * Disponível apenas no Linux.
+ */
+class TcpServer {
+   private:
+    /**
+     * @brief Estado de uma conexão, acessado apenas pela thread do laço.
+     */
+    struct Connection {
+        int fd;             /**< O socket do cliente. */
+        std::string input;  /**< Bytes recebidos ainda não atendidos. */
+        std::string output; /**< Respostas ainda não enviadas. */
+        bool busy = false;  /**< Há um lote desta conexão no pool. */
+        bool eof = false;   /**< O cliente parou de enviar (ou QUIT). */
+        uint32_t events = 0; /**< Eventos registrados no epoll. */
+    };
+
+    RequestHandler& handler; /**< Intérprete do protocolo. */
+
+    /**
+     * @brief Threads que atendem as requisições. Destruído antes dos demais
+     * membros, já que as tarefas em andamento os acessam.
+     */
+    std::unique_ptr<ThreadPool> pool;
+
+    int listenFd = -1; /**< Socket de escuta. */
+    int epollFd = -1;  /**< Instância do epoll. */
+    int wakeFd = -1;   /**< eventfd usado para acordar o laço. */
+    uint16_t boundPort = 0; /**< Porta efetivamente associada. */
+    std::atomic<bool> running{false}; /**< O laço deve continuar. */
+
+    uint64_t nextId = 2; /**< Próximo ID de conexão (0 e 1 são reservados). */
+    std::unordered_map<uint64_t, Connection> connections; /**< Conexões. */
+
+    std::mutex doneMx; /**< Protege a fila de lotes concluídos. */
+    std::vector<std::pair<uint64_t, std::string>> done; /**< Respostas. */
+
+    /**
+     * @brief Aceita todas as conexões pendentes no socket de escuta.
+     */
+    void acceptAll();
+
+    /**
+     * @brief Lê os bytes disponíveis de uma conexão, até o limite da entrada
+     * acumulada.
+     * @return bool False se ocorreu um erro e a conexão deve ser fechada.
+     */
+    bool readFrom(Connection& conn);
+
+    /**
+     * @brief Envia ao pool as linhas completas da conexão, se ela estiver
+     * ociosa e sua saída pendente estiver abaixo do limite.
+     */
+    void dispatch(uint64_t id, Connection& conn);
+
+    /**
+     * @brief Escreve o que for possível da saída da conexão.
+     * @return bool False se ocorreu um erro e a conexão deve ser fechada.
+     */
+    bool flush(Connection& conn);
+
+    /**
+     * @brief Avança o estado de uma conexão após um evento: despacha linhas,
+     * escreve respostas, ajusta os eventos do epoll e fecha se terminou.
+     */
+    void progress(uint64_t id);
+
+    /**
+     * @brief Entrega ao laço as respostas dos lotes concluídos pelo pool.
+     */
+    void collectDone();
+
+    /**
+     * @brief Fecha e esquece uma conexão.
+     */
+    void close(uint64_t id);
+
+    /**
+     * @brief Acorda o laço de eventos a partir de outra thread.
+     */
+    void wake();
+
+   public:
+    /**
+     * @brief Construtor da classe TcpServer.
+     * @param handler O intérprete do protocolo.
+     * @param workers O número de threads do pool (0 usa o número de núcleos).
+     */
+    TcpServer(RequestHandler& handler, size_t workers = 0);
+
+    /**
+     * @brief Destrutor: fecha todos os sockets.
+     */
+    ~TcpServer();
+
+    TcpServer(const TcpServer&) = delete;
+    TcpServer& operator=(const TcpServer&) = delete;
+
+    /**
+     * @brief Associa o servidor a um endereço e começa a escutar.
+     * @param port A porta (0 escolhe uma porta livre).
+     * @param address O endereço IPv4 de escuta.
+     * @return uint16_t A porta efetivamente associada.
+     * @throws std::runtime_error Se o socket não puder ser criado ou
+     * associado.
+     */
+    uint16_t listen(uint16_t port, const std::string& address = "0.0.0.0");
+
+    /**
+     * @brief Executa o laço de eventos até que stop() seja chamado.
+     * @throws std::runtime_error Se listen() não tiver sido chamado.
+     */
+    void run();
+
+    /**
+     * @brief Pede o encerramento do laço. Pode ser chamado de qualquer thread.
+     */
+    void stop();
+
+    /**
+     * @brief Retorna a porta associada por listen().
+     * @return uint16_t A porta.
+     */
+    uint16_t port() const;
+};
+
+#endif
@@ -1,7 +1,17 @@
 #ifndef AGENDAMENTO_SERVICE_HPP
 #define AGENDAMENTO_SERVICE_HPP
 
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 #include "model/agendamento.hpp"
+#include "model/horario.hpp"
 #include "persistence/entityCache.hpp"
 #include "persistence/entityManager.hpp"
 #include "persistence/mockConnection.hpp"
@@ -11,6 +21,41 @@
  */
 using AgendamentoCache = EntityCache<Agendamento>;
 
+/**
+ * @brief O resultado da mudança de status de um Agendamento em lote.
+ */
+struct StatusUpdateResult {
+    long id = 0;          /**< O ID do agendamento. */
+    bool sucesso = false; /**< Se o agendamento ficou com o novo status. */
+    std::string erro;     /**< O motivo da falha, se houver. */
+    std::shared_ptr<Agendamento> agendamento; /**< A nova versão. */
+};
+
+/**
+ * @brief Uma posição na ordem de listagem dos Agendamentos (a de
+ * Agendamento::operator<): a chave do último agendamento visitado. O padrão
+ * é antes do primeiro agendamento.
+ */
+struct AgendamentoCursor {
+    int prioridade = std::numeric_limits<int>::min(); /**< A prioridade do
+                                                         status. */
+    Timestamp inicio = 0; /**< O início do horário (decrescente). */
+    Timestamp fim = 0;    /**< O fim do horário (decrescente). */
+    long id = 0;          /**< O ID (decrescente). */
+
+    bool operator<(const AgendamentoCursor& other) const;
+};
+
+/**
+ * @brief Uma página de Agendamentos e a posição para buscar a seguinte.
+ */
+struct AgendamentoPage {
+    std::vector<std::shared_ptr<Agendamento>>
+        agendamentos;       /**< Os agendamentos. */
+    bool hasMore = false;   /**< Se há mais agendamentos depois desta página. */
+    AgendamentoCursor next; /**< A posição do último agendamento da página. */
+};
+
 /**
  * @brief Serviço de negócio responsável pela lógica e manipulação de
  * Agendamentos.
@@ -27,6 +72,97 @@ class AgendamentoService {
     EventBus& bus;          /**< Referência para o barramento de eventos. */
     AgendamentoCache cache; /**< Cache local para entidades Agendamento. */
 
+    /**
+     * @brief A caixa de entrada de cada professor: os agendamentos pendentes
+     * dos seus horários do período letivo corrente em diante (ver
+     * current_term()), em ordem de pedido (ID).
+     * * Cada caixa é um vetor imutável compartilhado, trocado a cada escrita
+     * deste service.
+     */
+    std::unordered_map<long, Horario::AgendamentoView> inbox;
+    std::unordered_map<long, long> inboxOwners; /**< Professor de cada um. */
+    FileObserver inboxObserver; /**< Detecta escritas de fora. */
+    bool inboxReady = false;    /**< Se as caixas já foram montadas. */
+    std::mutex inboxMx;         /**< Serializa as caixas e as escritas. */
+
+    /**
+     * @brief As chaves de ordenação dos agendamentos de cada aluno e de cada
+     * horário, e a linha de cada agendamento (ver listPageByIdAluno()).
+     * * Como a ordem depende do início e do fim dos horários, a ordenação é
+     * remontada quando qualquer uma das duas tabelas muda.
+     */
+    std::unordered_map<long, std::set<AgendamentoCursor>> sortedByAluno;
+    std::unordered_map<long, std::set<AgendamentoCursor>> sortedByHorario;
+    std::unordered_map<long, std::string> sortedLines;
+    FileObserver sortedObserver; /**< Detecta alterações nas tabelas. */
+    bool sortedReady = false;    /**< Se a ordenação já foi montada. */
+    std::mutex sortedMx;         /**< Protege a ordenação. */
+
+    /**
+     * @brief Remonta a ordenação se uma das tabelas mudou desde a última
+     * montagem. Deve ser chamado com sortedMx travado.
+     */
+    void refreshSorted();
+
+    /**
+     * @brief Monta uma página a partir das chaves ordenadas de um aluno ou de
+     * um horário. Deve ser chamado com sortedMx travado.
+     * @param sorted As chaves (nullptr se não houver nenhuma).
+     * @param after A posição retornada pela página anterior.
+     * @param limit O número máximo de agendamentos da página.
+     * @return AgendamentoPage A página.
+     */
+    AgendamentoPage pageOf(const std::set<AgendamentoCursor>* sorted,
+                           const AgendamentoCursor& after, size_t limit);
+
+    /**
+     * @brief Remonta as caixas de entrada se a tabela de agendamentos foi
+     * alterada por outra escrita que não as deste service. Deve ser chamado
+     * com inboxMx travado.
+     */
+    void refreshInbox();
+
+    /**
+     * @brief Coloca um agendamento pendente na caixa do professor do seu
+     * horário, se o horário não for de um período anterior. Deve ser chamado
+     * com inboxMx travado.
+     * @param horario O horário do agendamento.
+     * @param agendamento O agendamento.
+     */
+    void inboxPut(const std::shared_ptr<Horario>& horario,
+                  const std::shared_ptr<Agendamento>& agendamento);
+
+    /**
+     * @brief Retira um agendamento da caixa em que estiver, se estiver em
+     * alguma. Deve ser chamado com inboxMx travado.
+     * @param id O ID do agendamento.
+     */
+    void inboxErase(long id);
+
+    /**
+     * @brief Absorve uma escrita deste service na tabela de agendamentos, para
+     * que refreshInbox() não remonte as caixas por causa dela, e aplica a
+     * mudança correspondente às caixas: na hora ou, se a thread tiver uma
+     * transação ativa, no commit (que então não pode ser feito com inboxMx
+     * travado). Deve ser chamado com inboxMx travado.
+     * @param apply A mudança nas caixas (ex: inboxErase()), chamada com
+     * inboxMx travado; descartada se a transação for desfeita.
+     */
+    void inboxWritten(const std::function<void()>& apply = nullptr);
+
+    /**
+     * @brief Aplica às listas de agendamentos dos horários uma escrita deste
+     * service na tabela de agendamentos e absorve a alteração nos caches de
+     * horários e de professores (ver HorarioService::absorb()), para que ela
+     * não os limpe: na hora ou, se a thread tiver uma transação ativa, no
+     * commit.
+     * @param gravados Os agendamentos novos ou alterados.
+     * @param excluidos Os agendamentos excluídos: ID -> ID do horário.
+     */
+    void agendamentosWritten(
+        const std::vector<std::shared_ptr<Agendamento>>& gravados,
+        const std::map<long, long>& excluidos = {});
+
     /**
      * @brief Converte uma linha de dados brutos (string) em um objeto
      * Agendamento.
@@ -35,6 +171,15 @@ class AgendamentoService {
      */
     std::shared_ptr<Agendamento> loadAgendamento(const std::string& line);
 
+    /**
+     * @brief Aplica um lote de mudanças de status (ver updateStatusByIds()).
+     * Deve ser chamado com inboxMx travado.
+     * @param mudancas O ID de cada agendamento e o novo status.
+     * @return std::vector<StatusUpdateResult> Um resultado por mudança.
+     */
+    std::vector<StatusUpdateResult> applyStatusUpdates(
+        const std::vector<std::pair<long, Status>>& mudancas);
+
    public:
     /**
      * @brief Construtor da classe AgendamentoService.
@@ -69,11 +214,17 @@ class AgendamentoService {
 
     /**
      * @brief Atualiza todos os campos de um Agendamento (exceto ID).
+     * * A transição para CONFIRMADO reserva o horário com compare-and-set e
+     * a escrita do agendamento é condicionada ao status lido, de modo que
+     * duas confirmações concorrentes nunca ocupam o mesmo horário.
      * @param id O ID do agendamento a ser atualizado.
      * @param alunoId O novo ID do aluno.
      * @param horarioId O novo ID do horário.
      * @param status O novo status do agendamento.
      * @return std::shared_ptr<Agendamento> O agendamento atualizado.
+     * @throws std::invalid_argument Se o horário já estiver ocupado.
+     * @throws TransactionConflict Se o status mudar entre a leitura e a
+     * escrita em TRANSACTION_MAX_ATTEMPTS tentativas.
      */
     std::shared_ptr<Agendamento> updateById(long id, long alunoId,
                                             long horarioId,
@@ -81,8 +232,8 @@ class AgendamentoService {
 
     /**
      * @brief Atualiza apenas o status de um Agendamento.
-     * * Envia notificação de evento (HorarioOcupadoEvent/HorarioLiberadoEvent)
-     * se a mudança de status afetar a disponibilidade do horário.
+     * * Uma confirmação reserva o horário (HorarioService::reservarById());
+     * deixar de estar confirmado envia HorarioLiberadoEvent.
      * @param id O ID do agendamento.
      * @param status O novo status (CONFIRMADO, CANCELADO, RECUSADO).
      * @return std::shared_ptr<Agendamento> O agendamento atualizado.
@@ -90,6 +241,54 @@ class AgendamentoService {
     std::shared_ptr<Agendamento> updateStatusById(long id,
                                                   const Status& status);
 
+    /**
+     * @brief Retorna a caixa de entrada de um Professor: os Agendamentos
+     * pendentes dos seus horários do período letivo corrente em diante, em
+     * ordem de pedido.
+     * * A caixa é mantida a cada escrita deste service; abrir a caixa não lê
+     * nenhuma tabela.
+     * @param idProfessor O ID do Professor.
+     * @return Horario::AgendamentoView Os agendamentos pendentes.
+     */
+    Horario::AgendamentoView listPendentesByIdProfessor(long idProfessor);
+
+    /**
+     * @brief Aplica várias mudanças de status de uma vez.
+     * * Os agendamentos são lidos uma vez e gravados em uma única reescrita
+     * da tabela, condicionada ao status lido de cada um. As mudanças de
+     * disponibilidade dos horários (ocupar nas confirmações, liberar quando
+     * um agendamento confirmado muda de status) são agrupadas em uma única
+     * escrita antes disso, sem eventos por agendamento (ver
+     * HorarioService::updateDisponivelByIds()). Uma mudança que falha não
+     * impede as demais.
+     * @param mudancas O ID de cada agendamento e o novo status.
+     * @return std::vector<StatusUpdateResult> Um resultado por mudança, na
+     * mesma ordem.
+     */
+    std::vector<StatusUpdateResult> updateStatusByIds(
+        const std::vector<std::pair<long, Status>>& mudancas);
+
+    /**
+     * @brief Confirma ou recusa, de uma vez, Agendamentos da caixa de entrada
+     * de um Professor (ver updateStatusByIds()).
+     * @param idProfessor O ID do Professor.
+     * @param ids Os IDs dos agendamentos.
+     * @param status O novo status (CONFIRMADO ou RECUSADO).
+     * @return std::vector<StatusUpdateResult> Um resultado por ID, na mesma
+     * ordem; IDs fora da caixa do professor falham.
+     * @throws std::invalid_argument Se o status não for CONFIRMADO nem
+     * RECUSADO.
+     */
+    std::vector<StatusUpdateResult> updateStatusPendentes(
+        long idProfessor, const std::vector<long>& ids, const Status& status);
+
+    /**
+     * @brief Descarta as caixas de entrada, que são remontadas no próximo
+     * acesso.
+     * * Chamado quando um horário muda de professor.
+     */
+    void invalidateInbox();
+
     /**
      * @brief Lista todos os Agendamentos associados a um Horário.
      * @param id O ID do Horário.
@@ -97,10 +296,22 @@ class AgendamentoService {
      */
     std::vector<std::shared_ptr<Agendamento>> listByIdHorario(long id);
 
+    /**
+     * @brief Lista, em páginas, os Agendamentos associados a um Horário, na
+     * ordem de listByIdHorario() (ver listPageByIdAluno()).
+     * @param id O ID do Horário.
+     * @param after A posição retornada pela página anterior (padrão: início).
+     * @param limit O número máximo de agendamentos da página.
+     * @return AgendamentoPage A página.
+     * @throws std::invalid_argument Se limit for zero.
+     */
+    AgendamentoPage listPageByIdHorario(long id, const AgendamentoCursor& after,
+                                        size_t limit);
+
     /**
      * @brief Exclui um Agendamento pelo seu ID.
-     * * Envia notificação de evento (HorarioLiberadoEvent) se a exclusão
-     * estava ocupando um horário.
+     * * Envia notificação de evento (HorarioLiberadoEvent), no commit da
+     * exclusão, se o agendamento estava ocupando um horário.
      * @param id O ID do agendamento a ser excluído.
      * @return bool True se a exclusão foi bem-sucedida.
      */
@@ -113,9 +324,27 @@ class AgendamentoService {
      */
     std::vector<std::shared_ptr<Agendamento>> listByIdAluno(long id);
 
+    /**
+     * @brief Lista, em páginas, os Agendamentos associados a um Aluno, na
+     * ordem de listByIdAluno().
+     * * As chaves de ordenação de cada aluno ficam prontas em memória; a
+     * página começa logo depois da posição e para assim que enche, de modo
+     * que só os agendamentos da página são carregados, sem montar nem
+     * ordenar a lista completa.
+     * @param id O ID do Aluno.
+     * @param after A posição retornada pela página anterior (padrão: início).
+     * @param limit O número máximo de agendamentos da página.
+     * @return AgendamentoPage A página.
+     * @throws std::invalid_argument Se limit for zero.
+     */
+    AgendamentoPage listPageByIdAluno(long id, const AgendamentoCursor& after,
+                                      size_t limit);
+
     /**
      * @brief Exclui todos os Agendamentos feitos por um Aluno.
-     * * Usado principalmente ao excluir um Aluno.
+     * * Usado principalmente ao excluir um Aluno. Os horários dos agendamentos
+     * confirmados são liberados juntos, em uma única escrita (ver
+     * HorarioService::updateDisponivelByIds()), depois da exclusão.
      * @param id O ID do Aluno.
      * @return bool True se um ou mais agendamentos foram excluídos.
      */
@@ -128,6 +357,32 @@ class AgendamentoService {
      * @return bool True se um ou mais agendamentos foram excluídos.
      */
     bool deleteByIdHorario(long id);
+
+    /**
+     * @brief Exclui todos os Agendamentos de um conjunto de Horários.
+     * * Usado na exclusão em cascata de um Professor: a tabela é reescrita
+     * uma única vez, qualquer que seja o número de horários.
+     * @param ids Os IDs dos Horários.
+     * @return size_t O número de agendamentos excluídos.
+     */
+    size_t deleteByIdHorarios(const std::set<long>& ids);
+
+    /**
+     * @brief Move para o arquivo morto (AGENDAMENTO_ARCHIVE_TABLE) os
+     * Agendamentos de um conjunto de Horários.
+     * * Usado ao arquivar Horários de períodos anteriores.
+     * @param ids Os IDs dos Horários.
+     * @return size_t O número de agendamentos arquivados.
+     */
+    size_t archiveByIdHorarios(const std::set<long>& ids);
+
+    /**
+     * @brief Retorna o Horário do Agendamento de maior ID.
+     * * Esse agendamento nunca é arquivado (ver MockConnection::moveWhere), e
+     * portanto o seu horário também não pode ser.
+     * @return long O ID do horário, ou -1 se não houver agendamentos.
+     */
+    long lastIdHorario();
 };
 
 #endif
\ No newline at end of file
@@ -1,10 +1,13 @@
 #ifndef ALUNO_SERVICE_HPP
 #define ALUNO_SERVICE_HPP
 
+#include <functional>
+
 #include "model/aluno.hpp"
 #include "persistence/entityCache.hpp"
 #include "persistence/entityManager.hpp"
 #include "persistence/mockConnection.hpp"
+#include "util/csvImport.hpp"
 
 /**
  * @brief Alias de tipo para o cache de entidades Aluno.
@@ -112,6 +115,23 @@ class AlunoService {
                                 const std::string& email,
                                 const std::string& senha, long matricula);
 
+    /**
+     * @brief Cadastra vários Alunos de uma vez (importação em lote).
+     * * A unicidade de email e matrícula é verificada em conjuntos montados
+     * com uma única leitura da tabela, em vez de duas consultas por aluno, e
+     * os alunos aceitos recebem um bloco de IDs em uma única escrita (ver
+     * MockConnection::insertMany()).
+     * @param rows As linhas, com os campos nome, email, senha e matrícula.
+     * @param report Recebe o número de alunos gravados e as linhas recusadas.
+     * @param preparar Chamada com as linhas aceitas antes da escrita, para
+     * completá-las (ex: com o hash das senhas, que assim não é calculado
+     * para linhas recusadas).
+     * @return size_t O número de alunos gravados.
+     */
+    size_t saveAll(
+        const std::vector<ImportRow>& rows, ImportReport& report,
+        const std::function<void(std::vector<ImportRow>&)>& preparar = nullptr);
+
     /**
      * @brief Busca um Aluno pelo seu ID, utilizando o cache.
      * @param id O ID único do aluno.
@@ -145,6 +165,22 @@ class AlunoService {
                                       const std::string& email,
                                       const std::string& senha, long matricula);
 
+    /**
+     * @brief Troca o hash de senha de um Aluno somente se o armazenado ainda
+     * for o esperado.
+     * * A leitura, a comparação e a escrita acontecem em uma transação: uma
+     * escrita concorrente na tabela faz o commit falhar e a troca ser refeita
+     * a partir do registro novo (ver Transaction::retry()). Usada para
+     * refazer hashes desatualizados sem sobrescrever uma senha trocada.
+     * @param id O ID do aluno.
+     * @param esperada O hash que deve estar armazenado.
+     * @param senha O novo hash.
+     * @return bool True se o hash foi trocado; false se o aluno não
+     * existir ou tiver outro hash.
+     */
+    bool updateSenhaById(long id, const std::string& esperada,
+                         const std::string& senha);
+
     /**
      * @brief Exclui um Aluno pelo seu ID.
      * * Dispara a exclusão de todos os Agendamentos associados e notifica via
@@ -1,16 +1,37 @@
 #ifndef HORARIO_SERVICE_HPP
 #define HORARIO_SERVICE_HPP
 
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "model/horario.hpp"
 #include "persistence/entityCache.hpp"
 #include "persistence/entityManager.hpp"
+#include "persistence/intervalIndex.hpp"
 #include "persistence/mockConnection.hpp"
+#include "persistence/timeIndex.hpp"
+#include "util/csvImport.hpp"
 
 /**
  * @brief Alias de tipo para o cache de entidades Horario.
  */
 using HorarioCache = EntityCache<Horario>;
 
+/**
+ * @brief Uma página de Horários e a posição para buscar a seguinte.
+ */
+struct HorarioPage {
+    std::vector<std::shared_ptr<Horario>> horarios; /**< Os horários. */
+    bool hasMore = false;  /**< Se há mais horários depois desta página. */
+    TimeIndex::Cursor next; /**< A posição do último horário da página. */
+};
+
 /**
  * @brief Serviço de negócio responsável pela lógica e manipulação de Horários.
  * * Esta classe gerencia a criação, atualização e exclusão de Horários de
@@ -25,6 +46,91 @@ class HorarioService {
     EventBus& bus;      /**< Referência para o barramento de eventos. */
     HorarioCache cache; /**< Cache local para entidades Horario. */
 
+    TimeIndex index;            /**< Horários por professor e início. */
+    FileObserver indexObserver; /**< Detecta alterações na tabela. */
+    bool indexReady = false;    /**< Se o índice já foi construído. */
+    std::mutex indexMx;         /**< Protege o índice. */
+
+    /**
+     * @brief Reconstrói o índice de horários se a tabela mudou desde a
+     * última construção por outra escrita que não as deste service (que o
+     * atualizam registro a registro; ver horariosWritten()). Deve ser
+     * chamado com indexMx travado.
+     */
+    void refreshIndex();
+
+    /**
+     * @brief IDs dos professores de cada disciplina já buscada.
+     */
+    std::map<std::string, std::unordered_set<long>> disciplinas;
+    FileObserver disciplinasObserver; /**< Observa os professores. */
+
+    /**
+     * @brief Retorna os IDs dos professores de uma disciplina, relendo a
+     * tabela de professores só quando ela muda. Deve ser chamado com indexMx
+     * travado.
+     * @param disciplina A disciplina.
+     * @return const std::unordered_set<long>& Os IDs.
+     */
+    const std::unordered_set<long>& professoresDe(
+        const std::string& disciplina);
+
+    IntervalIndex intervals;        /**< Intervalos por professor. */
+    FileObserver intervalsObserver; /**< Detecta escritas de fora. */
+    bool intervalsReady = false;    /**< Se os intervalos já foram lidos. */
+    std::mutex intervalsMx; /**< Serializa verificações e escritas. */
+
+    /**
+     * @brief Protege intervalsObserver, que as reservas consomem sem
+     * intervalsMx (elas podem ser feitas com o inboxMx do
+     * AgendamentoService travado, que vem depois dele).
+     */
+    std::mutex intervalsObserverMx;
+
+    /**
+     * @brief Relê os intervalos da tabela se ela foi alterada por outra
+     * escrita que não as deste service. Deve ser chamado com intervalsMx
+     * travado.
+     */
+    void refreshIntervals();
+
+    /**
+     * @brief Absorve uma escrita deste service na tabela de horários, para que
+     * refreshIntervals() não releia os intervalos por causa dela, e aplica a
+     * mudança correspondente aos intervalos: na hora ou, se a thread tiver
+     * uma transação ativa, no commit (que então não pode ser feito com
+     * intervalsMx travado). Deve ser chamado com intervalsMx travado, a não
+     * ser que não haja mudança nos intervalos (ex: uma reserva).
+     * @param apply A mudança nos intervalos, chamada com intervalsMx
+     * travado; descartada se a transação for desfeita.
+     */
+    void intervalsWritten(const std::function<void()>& apply = nullptr);
+
+    /**
+     * @brief Aplica ao índice, ao cache e às listas dos professores uma
+     * escrita deste service na tabela de horários e absorve a alteração no
+     * índice e nos caches (ver absorb()), para que ela não os refaça: na
+     * hora ou, se a thread tiver uma transação ativa, no commit.
+     * * Não deve ser chamado com indexMx travado: a lista de um professor é
+     * carregada com ele travado.
+     * @param gravados Os horários novos ou alterados.
+     * @param excluidos Os horários excluídos (ou que mudaram de professor):
+     * ID -> ID do professor anterior.
+     */
+    void horariosWritten(const std::vector<std::shared_ptr<Horario>>& gravados,
+                         const std::map<long, long>& excluidos = {});
+
+    /**
+     * @brief Lança uma exceção se [inicio, fim) sobrepõe outro horário do
+     * professor. Deve ser chamado com intervalsMx travado.
+     * @param idProfessor O ID do professor.
+     * @param inicio O início do horário.
+     * @param fim O fim do horário.
+     * @param except O ID do próprio horário, na atualização, ou -1.
+     */
+    void checkOverlap(long idProfessor, Timestamp inicio, Timestamp fim,
+                      long except);
+
     /**
      * @brief Converte uma linha de dados brutos (string) em um objeto Horario.
      * @param line A string contendo os dados do horário.
@@ -32,6 +138,20 @@ class HorarioService {
      */
     std::shared_ptr<Horario> loadHorario(const std::string& line);
 
+    /**
+     * @brief Altera a disponibilidade de um Horário somente se ela ainda tiver
+     * o valor esperado (compare-and-set).
+     * * Lê a versão atual do registro direto da persistência e grava a nova
+     * disponibilidade condicionada a essa versão. Se outra escrita ocorrer no
+     * meio do caminho, a operação é refeita com a versão nova.
+     * @param id O ID do horário.
+     * @param esperado A disponibilidade esperada.
+     * @param novo A nova disponibilidade.
+     * @return bool True se esta chamada realizou a transição; false se o
+     * horário já não tinha a disponibilidade esperada.
+     */
+    bool compareAndSetDisponivel(long id, bool esperado, bool novo);
+
    public:
     /**
      * @brief Construtor da classe HorarioService.
@@ -56,9 +176,77 @@ class HorarioService {
      */
     std::vector<std::shared_ptr<Horario>> listByIdProfessor(long id);
 
+    /**
+     * @brief Lista os Horários de um Professor com início em [from, to).
+     * * Consulta o índice particionado por tempo, que só percorre as
+     * partições do intervalo e só relê a tabela quando ela muda.
+     * @param id O ID do Professor.
+     * @param from O início do intervalo (inclusivo).
+     * @param to O fim do intervalo (exclusivo).
+     * @return std::vector<std::shared_ptr<Horario>> Os horários, em ordem.
+     */
+    std::vector<std::shared_ptr<Horario>> listByIdProfessorBetween(
+        long id, Timestamp from, Timestamp to);
+
+    /**
+     * @brief Lista os Horários de um Professor a partir do início do período
+     * letivo corrente (ver current_term()).
+     * @param id O ID do Professor.
+     * @return std::vector<std::shared_ptr<Horario>> Os horários, em ordem.
+     */
+    std::vector<std::shared_ptr<Horario>> listCurrentByIdProfessor(long id);
+
+    /**
+     * @brief Lista, em páginas, os Horários disponíveis de todos os
+     * professores com início em [from, to), em ordem de início.
+     * * Percorre os horários disponíveis do índice em ordem de tempo e para
+     * assim que a página enche, sem carregar os horários das páginas
+     * seguintes nem consultar professor por professor.
+     * @param from O início do intervalo (inclusivo).
+     * @param to O fim do intervalo (exclusivo).
+     * @param disciplina Filtra pelos professores da disciplina (vazia para
+     * todos).
+     * @param after A posição retornada pela página anterior (padrão: início).
+     * @param limit O número máximo de horários da página.
+     * @return HorarioPage A página.
+     * @throws std::invalid_argument Se limit for zero.
+     */
+    HorarioPage listDisponiveisBetween(Timestamp from, Timestamp to,
+                                       const std::string& disciplina,
+                                       const TimeIndex::Cursor& after,
+                                       size_t limit);
+
+    /**
+     * @brief Move para o arquivo morto (HORARIO_ARCHIVE_TABLE) os Horários
+     * encerrados antes de um instante, junto com os seus Agendamentos.
+     * * O horário do agendamento de maior ID, e o horário de maior ID, ficam
+     * na tabela (ver MockConnection::moveWhere).
+     * @param corte O instante de corte (fim < corte).
+     * @return size_t O número de horários arquivados.
+     */
+    size_t archiveBefore(Timestamp corte);
+
+    /**
+     * @brief Cadastra vários Horários de uma vez (importação em lote).
+     * * Os professores são resolvidos pelo email com uma única leitura da
+     * tabela de professores (ver ProfessorService::mapIdsByEmail()). Cada
+     * horário é comparado com o índice de intervalos e com os horários já
+     * aceitos do lote; os aceitos recebem um bloco de IDs em uma única
+     * escrita (ver MockConnection::insertMany()).
+     * @param rows As linhas, com os campos email do professor, início e fim
+     * (timestamps em segundos).
+     * @param report Recebe o número de horários gravados e as linhas
+     * recusadas.
+     * @return size_t O número de horários gravados.
+     */
+    size_t saveAll(const std::vector<ImportRow>& rows, ImportReport& report);
+
     /**
      * @brief Exclui todos os Horários criados por um Professor.
-     * * Dispara a exclusão de Agendamentos relacionados.
+     * * Dispara a exclusão de Agendamentos relacionados. A tabela de
+     * agendamentos e a de horários são reescritas uma única vez cada,
+     * qualquer que seja o número de horários (ver
+     * AgendamentoService::deleteByIdHorarios()).
      * @param id O ID do Professor.
      * @return bool True se um ou mais horários foram excluídos.
      */
@@ -75,6 +263,8 @@ class HorarioService {
     /**
      * @brief Cria e salva um novo Horário, inicialmente marcado como
      * disponível.
+     * * Rejeita horários que se sobreponham a outro do mesmo professor,
+     * consultando o IntervalIndex em memória.
      * @param idProfessor O ID do professor proprietário.
      * @param inicio O timestamp de início do horário.
      * @param fim O timestamp de fim do horário.
@@ -90,8 +280,30 @@ class HorarioService {
      */
     std::shared_ptr<Horario> getById(long id);
 
+    /**
+     * @brief Busca vários Horários pelos seus IDs, utilizando o cache.
+     * * Os horários fora do cache são carregados com uma única leitura da
+     * tabela.
+     * @param ids Os IDs.
+     * @return std::vector<std::shared_ptr<Horario>> Os horários encontrados,
+     * em ordem qualquer; IDs inexistentes ficam de fora.
+     */
+    std::vector<std::shared_ptr<Horario>> getByIds(const std::set<long>& ids);
+
+    /**
+     * @brief Retorna o início e o fim de cada Horário, indexados pelo ID.
+     * * Não carrega os horários: a tabela é lida uma única vez.
+     * @return std::unordered_map<long, std::pair<Timestamp, Timestamp>>
+     * ID -> (início, fim).
+     */
+    std::unordered_map<long, std::pair<Timestamp, Timestamp>>
+    mapIntervalsById();
+
     /**
      * @brief Atualiza todos os campos de um Horário (exceto ID).
+     * * Rejeita intervalos que se sobreponham a outro horário do professor.
+     * A escrita é condicionada à versão do horário relida da tabela (ver
+     * reservarById()); se outra escrita a alterou, a leitura é refeita.
      * @param id O ID do horário a ser atualizado.
      * @param idProfessor O novo ID do professor (se alterado).
      * @param inicio O novo timestamp de início.
@@ -120,6 +332,61 @@ class HorarioService {
      * @return bool True se o horário estiver disponível, false caso contrário.
      */
     bool isDisponivelById(long id);
+
+    /**
+     * @brief Reserva atomicamente um Horário disponível (disponível ->
+     * ocupado).
+     * * Entre várias chamadas concorrentes para o mesmo horário, apenas uma
+     * retorna true.
+     * @param id O ID do horário.
+     * @return bool True se a reserva foi feita por esta chamada.
+     */
+    bool reservarById(long id);
+
+    /**
+     * @brief Libera atomicamente um Horário ocupado (ocupado -> disponível).
+     * @param id O ID do horário.
+     * @return bool True se a liberação foi feita por esta chamada.
+     */
+    bool liberarById(long id);
+
+    /**
+     * @brief Altera a disponibilidade de vários Horários com uma única
+     * reescrita da tabela (variante em lote de reservarById() e
+     * liberarById()).
+     * * Cada horário só é alterado se ainda não tiver a disponibilidade
+     * pedida, com o mesmo compare-and-set pela versão.
+     * @param disponiveis A nova disponibilidade de cada horário, pelo ID.
+     * @return std::set<long> Os horários alterados por esta chamada.
+     */
+    std::set<long> updateDisponivelByIds(
+        const std::map<long, bool>& disponiveis);
+
+    /**
+     * @brief Aplica a nova versão de um Agendamento (ou um agendamento novo) à
+     * lista do Horário dele, se ele estiver no cache.
+     * * Chamado pelo AgendamentoService a cada gravação, antes de absorb().
+     * @param agendamento A nova versão do agendamento.
+     */
+    void applyAgendamentoUpdate(
+        const std::shared_ptr<Agendamento>& agendamento);
+
+    /**
+     * @brief Retira um Agendamento excluído da lista do Horário dele, se ele
+     * estiver no cache.
+     * * Chamado pelo AgendamentoService a cada exclusão, antes de absorb().
+     * @param idHorario O ID do horário.
+     * @param id O ID do agendamento.
+     */
+    void applyAgendamentoRemoval(long idHorario, long id);
+
+    /**
+     * @brief Absorve, no cache de horários e no de professores, uma escrita
+     * deste processo já aplicada às entidades (ex: por
+     * applyAgendamentoUpdate()), para que ela não os limpe.
+     * * Deve ser chamado depois da escrita (no commit, se houver transação).
+     */
+    void absorb();
 };
 
 #endif
\ No newline at end of file
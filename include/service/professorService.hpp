@@ -1,16 +1,44 @@
 #ifndef PROFESSOR_SERVICE_HPP
 #define PROFESSOR_SERVICE_HPP
 
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "model/horario.hpp"
 #include "model/professor.hpp"
 #include "persistence/entityCache.hpp"
 #include "persistence/entityManager.hpp"
 #include "persistence/mockConnection.hpp"
+#include "util/csvImport.hpp"
 
 /**
  * @brief Alias de tipo para o cache de entidades Professor.
  */
 using ProfessorCache = EntityCache<Professor>;
 
+/**
+ * @brief Uma posição na ordem de listagem dos Professores: o nome e o ID do
+ * último professor visitado. O padrão é antes do primeiro professor.
+ */
+struct ProfessorCursor {
+    std::string nome; /**< O nome (chave principal da ordem). */
+    long id = 0;      /**< O ID (desempate entre nomes iguais). */
+
+    bool operator<(const ProfessorCursor& other) const;
+};
+
+/**
+ * @brief Uma página de Professores e a posição para buscar a seguinte.
+ */
+struct ProfessorPage {
+    std::vector<std::shared_ptr<Professor>> professores; /**< Os professores. */
+    bool hasMore = false; /**< Se há mais professores depois desta página. */
+    ProfessorCursor next; /**< A posição do último professor da página. */
+};
+
 /**
  * @brief Serviço de negócio responsável pela lógica e manipulação de
  * Professores.
@@ -26,6 +54,20 @@ class ProfessorService {
     EventBus& bus;        /**< Referência para o barramento de eventos. */
     ProfessorCache cache; /**< Cache local para entidades Professor. */
 
+    /**
+     * @brief As linhas da tabela, ordenadas por nome e ID (ver listPage()).
+     */
+    std::map<ProfessorCursor, std::string> sorted;
+    FileObserver sortedObserver; /**< Detecta alterações na tabela. */
+    bool sortedReady = false;    /**< Se a ordenação já foi montada. */
+    std::mutex sortedMx;         /**< Protege a ordenação. */
+
+    /**
+     * @brief Remonta a ordenação se a tabela mudou desde a última montagem.
+     * Deve ser chamado com sortedMx travado.
+     */
+    void refreshSorted();
+
     /**
      * @brief Converte uma linha de dados brutos (string) em um objeto
      * Professor.
@@ -92,6 +134,23 @@ class ProfessorService {
                                     const std::string& senha,
                                     const std::string& disciplina);
 
+    /**
+     * @brief Cadastra vários Professores de uma vez (importação em lote).
+     * * A unicidade do email é verificada em um conjunto montado com uma
+     * única leitura da tabela, e os professores aceitos recebem um bloco de
+     * IDs em uma única escrita (ver MockConnection::insertMany()).
+     * @param rows As linhas, com os campos nome, email, senha e disciplina.
+     * @param report Recebe o número de professores gravados e as linhas
+     * recusadas.
+     * @param preparar Chamada com as linhas aceitas antes da escrita, para
+     * completá-las (ex: com o hash das senhas, que assim não é calculado
+     * para linhas recusadas).
+     * @return size_t O número de professores gravados.
+     */
+    size_t saveAll(
+        const std::vector<ImportRow>& rows, ImportReport& report,
+        const std::function<void(std::vector<ImportRow>&)>& preparar = nullptr);
+
     /**
      * @brief Busca um Professor pelo seu ID, utilizando o cache.
      * @param id O ID único do professor.
@@ -108,12 +167,69 @@ class ProfessorService {
     std::shared_ptr<Professor> getOneByEmail(const std::string& email);
 
     /**
-     * @brief Lista todos os Professores cadastrados no sistema.
+     * @brief Lista todos os Professores cadastrados no sistema, em ordem de
+     * nome e, entre nomes iguais, de ID.
+     * * A ordenação é mantida entre as chamadas e só é refeita quando a
+     * tabela muda.
      * @return std::vector<std::shared_ptr<Professor>> Uma lista de todos os
      * professores.
      */
     std::vector<std::shared_ptr<Professor>> listAll();
 
+    /**
+     * @brief Lista, em páginas, os Professores cadastrados, na ordem de
+     * listAll().
+     * * Percorre as linhas já ordenadas a partir da posição e para assim que a
+     * página enche: só os professores da página são carregados, e nenhuma
+     * lista com todos eles é montada ou ordenada.
+     * @param after A posição retornada pela página anterior (padrão: início).
+     * @param limit O número máximo de professores da página.
+     * @return ProfessorPage A página.
+     * @throws std::invalid_argument Se limit for zero.
+     */
+    ProfessorPage listPage(const ProfessorCursor& after, size_t limit);
+
+    /**
+     * @brief Retorna os IDs dos Professores de uma disciplina.
+     * * Não carrega os professores: só os IDs das linhas são lidos.
+     * @param disciplina A disciplina (comparação exata).
+     * @return std::unordered_set<long> Os IDs.
+     */
+    std::unordered_set<long> listIdsByDisciplina(const std::string& disciplina);
+
+    /**
+     * @brief Retorna o ID de cada Professor, indexado pelo email.
+     * * Não carrega os professores: a tabela é lida uma única vez.
+     * @return std::unordered_map<std::string, long> Email -> ID.
+     */
+    std::unordered_map<std::string, long> mapIdsByEmail();
+
+    /**
+     * @brief Aplica a nova versão de um Horário (ou um horário novo) à lista
+     * do Professor dono, se ele estiver no cache.
+     * * Chamado pelo HorarioService a cada gravação, inclusive as reservas
+     * e as liberações (HorarioLiberadoEvent), antes de absorb().
+     * @param horario A nova versão do horário.
+     */
+    void applyHorarioUpdate(const std::shared_ptr<Horario>& horario);
+
+    /**
+     * @brief Retira um Horário excluído da lista do Professor, se ele estiver
+     * no cache.
+     * * Chamado pelo HorarioService a cada exclusão, antes de absorb().
+     * @param idProfessor O ID do professor.
+     * @param id O ID do horário.
+     */
+    void applyHorarioRemoval(long idProfessor, long id);
+
+    /**
+     * @brief Absorve no cache uma escrita deste processo nas tabelas
+     * observadas, já aplicada às entidades (ex: por applyHorarioUpdate()),
+     * para que ela não limpe o cache.
+     * * Deve ser chamado depois da escrita (no commit, se houver transação).
+     */
+    void absorb();
+
     /**
      * @brief Atualiza as informações de um Professor existente.
      * * Executa validações de unicidade para email, excluindo o próprio ID.
@@ -130,10 +246,27 @@ class ProfessorService {
                                           const std::string& senha,
                                           const std::string& disciplina);
 
+    /**
+     * @brief Troca o hash de senha de um Professor somente se o armazenado
+     * ainda for o esperado.
+     * * A leitura, a comparação e a escrita acontecem em uma transação: uma
+     * escrita concorrente na tabela faz o commit falhar e a troca ser refeita
+     * a partir do registro novo (ver Transaction::retry()). Usada para
+     * refazer hashes desatualizados sem sobrescrever uma senha trocada.
+     * @param id O ID do professor.
+     * @param esperada O hash que deve estar armazenado.
+     * @param senha O novo hash.
+     * @return bool True se o hash foi trocado; false se o professor não
+     * existir ou tiver outro hash.
+     */
+    bool updateSenhaById(long id, const std::string& esperada,
+                         const std::string& senha);
+
     /**
      * @brief Exclui um Professor pelo seu ID.
-     * * Dispara a exclusão de todos os Horários e Agendamentos associados e
-     * notifica via EventBus (ProfessorDeletedEvent).
+     * * Dispara a exclusão de todos os Horários e Agendamentos associados,
+     * com uma reescrita por tabela, e só depois notifica via EventBus
+     * (ProfessorDeletedEvent).
      * @param id O ID do professor a ser excluído.
      * @return bool True se a exclusão foi bem-sucedida.
      */
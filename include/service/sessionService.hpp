@@ -1,9 +1,16 @@
-#ifndef SESSION_MANAGER_HPP
-#define SESSION_MANAGER_HPP
+#ifndef SESSION_SERVICE_HPP
+#define SESSION_SERVICE_HPP
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
 
 #include "model/aluno.hpp"
 #include "model/professor.hpp"
 #include "persistence/entityManager.hpp"
+#include "util/shardedMap.hpp"
+#include "util/timerWheel.hpp"
 
 /**
  * @brief Enumeração que define o tipo de usuário logado na sessão atual.
@@ -15,18 +22,65 @@ enum class UserType {
 };
 
 /**
- * @brief Serviço de negócio responsável por gerenciar o estado da sessão de
- * usuário.
- * * Lida com o login, logout, verificação do estado e carregamento da entidade
- * do usuário logado sob demanda (Lazy Loading).
+ * @brief Estado de uma sessão aberta.
+ */
+struct Session {
+    UserType type; /**< O tipo do usuário dono da sessão. */
+    long userId;   /**< O ID do usuário dono da sessão. */
+    std::chrono::steady_clock::time_point
+        lastSeen; /**< O instante do último uso da sessão. */
+};
+
+/**
+ * @brief Serviço de negócio responsável por gerenciar as sessões de usuário.
+ * * Mantém várias sessões simultâneas, cada uma identificada por um token
+ * opaco, em um mapa concorrente. Sessões ociosas por mais que o tempo limite
+ * expiram através de uma roda de temporização.
+ * * Cada thread pode estar associada a um token (a "sessão atual"). Como o
+ * EventBus é síncrono, o login executado por uma thread associa a ela a
+ * sessão recém-aberta; os métodos sem token operam sobre essa sessão, o que
+ * mantém a interface de console inalterada. A associação pertence a cada
+ * instância: duas instâncias na mesma thread não compartilham a sessão
+ * atual.
  */
 class SessionService {
    private:
     EntityManager* manager; /**< Ponteiro para o gerenciador de entidades (IoC
                                Container). */
     EventBus& bus;          /**< Referência para o barramento de eventos. */
-    long userId;   /**< ID do usuário logado (0 se ninguém estiver logado). */
-    UserType type; /**< O tipo do usuário logado (NONE, ALUNO, PROFESSOR). */
+
+    /**
+     * @brief Sessões abertas, indexadas pelo token.
+     */
+    ShardedMap<std::string, Session> sessions;
+
+    /**
+     * @brief Roda de temporização que agenda a verificação de ociosidade de
+     * cada token.
+     */
+    TimerWheel<std::string> wheel;
+
+    /**
+     * @brief Mutex que serializa o avanço da roda de temporização.
+     */
+    std::mutex wheelMx;
+
+    /**
+     * @brief Tempo máximo que uma sessão pode ficar sem uso.
+     */
+    std::chrono::seconds idleTimeout;
+
+    /**
+     * @brief Token da sessão associada a cada thread, indexado pelo ID da
+     * thread.
+     */
+    ShardedMap<std::thread::id, std::string> bound;
+
+    /**
+     * @brief Retorna o token associado à thread corrente.
+     * @return std::string O token, ou uma string vazia.
+     */
+    std::string currentToken() const;
 
     /**
      * @brief Função de carregamento (Loader) para a entidade Aluno.
@@ -38,15 +92,35 @@ class SessionService {
      */
     const LoadFunction<Professor>& professorLoader;
 
+    /**
+     * @brief Busca uma sessão válida (existente e não expirada).
+     * @param token O token da sessão.
+     * @return std::optional<Session> A sessão, ou std::nullopt.
+     */
+    std::optional<Session> find(const std::string& token) const;
+
+    /**
+     * @brief Marca a sessão como usada agora e avança a roda de expiração.
+     * @param token O token da sessão.
+     */
+    void touch(const std::string& token);
+
    public:
+    /**
+     * @brief Tempo limite padrão de ociosidade de uma sessão.
+     */
+    static constexpr std::chrono::seconds DEFAULT_IDLE_TIMEOUT{30 * 60};
+
     /**
      * @brief Construtor da classe SessionService.
-     * * Inicializa o estado da sessão como deslogado e injeta as dependências.
+     * * Inicializa o serviço sem sessões e injeta as dependências.
      * @param manager O EntityManager, usado para acessar funções de
      * carregamento.
      * @param bus O barramento de eventos.
+     * @param idleTimeout O tempo limite de ociosidade das sessões.
      */
-    SessionService(EntityManager* manager, EventBus& bus);
+    SessionService(EntityManager* manager, EventBus& bus,
+                   std::chrono::seconds idleTimeout = DEFAULT_IDLE_TIMEOUT);
 
     /**
      * @brief Destrutor padrão.
@@ -54,42 +128,118 @@ class SessionService {
     ~SessionService() = default;
 
     /**
-     * @brief Encerra a sessão atual (logout).
-     * * Redefine o userId para 0 e o tipo para NONE.
+     * @brief Abre uma nova sessão para um usuário.
+     * @param type O tipo do usuário.
+     * @param userId O ID do usuário.
+     * @return std::string O token opaco da nova sessão.
+     */
+    std::string open(UserType type, long userId);
+
+    /**
+     * @brief Associa um token à thread corrente.
+     * * Os métodos sem token passam a operar sobre essa sessão.
+     * @param token O token (vazio para desassociar).
+     */
+    void bind(const std::string& token);
+
+    /**
+     * @brief Retorna o token associado à thread corrente.
+     * @return std::string O token, ou uma string vazia.
+     */
+    std::string current() const;
+
+    /**
+     * @brief Remove as sessões ociosas cujo prazo já venceu.
+     * @return size_t O número de sessões expiradas.
+     */
+    size_t expireIdle();
+
+    /**
+     * @brief Retorna o número de sessões abertas.
+     * @return size_t O número de sessões.
+     */
+    size_t activeSessions() const;
+
+    /**
+     * @brief Encerra a sessão identificada pelo token.
+     * * Desassocia o token de todas as threads a que ele estava associado.
+     * @param token O token da sessão.
+     */
+    void logout(const std::string& token);
+
+    /**
+     * @brief Verifica se o token identifica uma sessão válida.
+     * @param token O token da sessão.
+     * @return bool True se a sessão existir e não estiver expirada.
+     */
+    bool isLogged(const std::string& token) const;
+
+    /**
+     * @brief Verifica se a sessão pertence a um Professor.
+     * @param token O token da sessão.
+     * @return bool True se o UserType for PROFESSOR.
+     */
+    bool isProfessor(const std::string& token) const;
+
+    /**
+     * @brief Verifica se a sessão pertence a um Aluno.
+     * @param token O token da sessão.
+     * @return bool True se o UserType for ALUNO.
+     */
+    bool isAluno(const std::string& token) const;
+
+    /**
+     * @brief Retorna o objeto Professor dono da sessão.
+     * @param token O token da sessão.
+     * @return std::shared_ptr<Professor> O objeto Professor.
+     * @throws std::runtime_error Se a sessão não existir ou não for de um
+     * Professor.
+     */
+    std::shared_ptr<Professor> getProfessor(const std::string& token);
+
+    /**
+     * @brief Retorna o objeto Aluno dono da sessão.
+     * @param token O token da sessão.
+     * @return std::shared_ptr<Aluno> O objeto Aluno.
+     * @throws std::runtime_error Se a sessão não existir ou não for de um
+     * Aluno.
+     */
+    std::shared_ptr<Aluno> getAluno(const std::string& token);
+
+    /**
+     * @brief Encerra a sessão associada à thread corrente (logout).
      */
     void logout();
 
     /**
-     * @brief Verifica se há algum usuário logado.
-     * @return bool True se userId > 0 e type != NONE.
+     * @brief Verifica se há uma sessão válida associada à thread corrente.
+     * @return bool True se houver uma sessão válida.
      */
     bool isLogged() const;
 
     /**
-     * @brief Verifica se o usuário logado é um Professor.
+     * @brief Verifica se a sessão da thread corrente é de um Professor.
      * @return bool True se o UserType for PROFESSOR.
      */
     bool isProfessor() const;
 
     /**
-     * @brief Verifica se o usuário logado é um Aluno.
+     * @brief Verifica se a sessão da thread corrente é de um Aluno.
      * @return bool True se o UserType for ALUNO.
      */
     bool isAluno() const;
 
     /**
-     * @brief Retorna o objeto Professor logado.
-     * @return std::shared_ptr<Professor> O objeto Professor, ou nullptr se não
-     * for um Professor logado.
+     * @brief Retorna o objeto Professor logado na thread corrente.
+     * @return std::shared_ptr<Professor> O objeto Professor.
      */
     std::shared_ptr<Professor> getProfessor();
 
     /**
-     * @brief Retorna o objeto Aluno logado.
-     * @return std::shared_ptr<Aluno> O objeto Aluno, ou nullptr se não for um
-     * Aluno logado.
+     * @brief Retorna o objeto Aluno logado na thread corrente.
+     * @return std::shared_ptr<Aluno> O objeto Aluno.
      */
     std::shared_ptr<Aluno> getAluno();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,47 @@
+#ifndef ACADEMIC_TERM_HPP
+#define ACADEMIC_TERM_HPP
+
+#include "util/utils.hpp"
+
+/**
+ * @brief Um período letivo: o intervalo [inicio, fim).
+ */
+struct AcademicTerm {
+    Timestamp inicio; /**< Início do período (inclusivo). */
+    Timestamp fim;    /**< Fim do período (exclusivo). */
+
+    /**
+     * @brief Indica se um instante pertence ao período.
+     * @param tt O instante.
+     * @return bool True se inicio <= tt < fim.
+     */
+    bool contains(Timestamp tt) const {
+        return tt >= inicio && tt < fim;
+    }
+};
+
+/**
+ * @brief Retorna o semestre civil (janeiro a junho ou julho a dezembro, no
+ * horário local) que contém um instante.
+ * @param tt O instante.
+ * @return AcademicTerm O semestre.
+ */
+AcademicTerm semester_of(Timestamp tt);
+
+/**
+ * @brief Define a janela do período letivo corrente, em vez do semestre
+ * civil.
+ * @param inicio O início do período.
+ * @param fim O fim do período.
+ * @throws std::invalid_argument Se fim <= inicio.
+ */
+void set_term_window(Timestamp inicio, Timestamp fim);
+
+/**
+ * @brief Retorna o período letivo corrente: a janela definida com
+ * set_term_window() ou, se não houver, o semestre civil de agora.
+ * @return AcademicTerm O período corrente.
+ */
+AcademicTerm current_term();
+
+#endif
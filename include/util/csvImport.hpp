@@ -0,0 +1,60 @@
+#ifndef CSV_IMPORT_HPP
+#define CSV_IMPORT_HPP
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Uma linha de dados de um arquivo de importação.
+ */
+struct ImportRow {
+    size_t linha;                    /**< O número da linha no arquivo. */
+    std::vector<std::string> campos; /**< Os campos, na ordem do arquivo. */
+};
+
+/**
+ * @brief O resultado de uma importação em lote.
+ */
+struct ImportReport {
+    size_t importados = 0; /**< Registros gravados. */
+
+    /**
+     * @brief O número e o motivo de cada linha recusada.
+     */
+    std::vector<std::pair<size_t, std::string>> erros;
+
+    /**
+     * @brief Registra uma linha recusada.
+     * @param linha O número da linha no arquivo.
+     * @param erro O motivo.
+     */
+    void recusar(size_t linha, const std::string& erro) {
+        erros.emplace_back(linha, erro);
+    }
+};
+
+/**
+ * @brief Lê um arquivo CSV de importação.
+ * * A primeira linha é o cabeçalho e é ignorada, assim como as linhas vazias.
+ * Campos não são citados: vírgulas separam sempre, como nas tabelas da
+ * MockConnection. Espaços nas pontas de cada campo são removidos.
+ * @param path O caminho do arquivo.
+ * @param campos O número de campos esperado em cada linha.
+ * @param report Recebe uma mensagem para cada linha com outro número de
+ * campos.
+ * @return std::vector<ImportRow> As linhas com o número certo de campos.
+ * @throws std::runtime_error Se o arquivo não puder ser aberto.
+ */
+std::vector<ImportRow> read_import_file(const std::string& path,
+                                        size_t campos, ImportReport& report);
+
+/**
+ * @brief Substitui a senha de cada linha pelo seu hash, calculado em paralelo
+ * (ver hash_passwords()).
+ * @param rows As linhas.
+ * @param coluna O índice do campo da senha.
+ */
+void hash_import_passwords(std::vector<ImportRow>& rows, size_t coluna);
+
+#endif
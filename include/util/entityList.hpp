@@ -1,10 +1,19 @@
 #ifndef ENTITY_LIST_HPP
 #define ENTITY_LIST_HPP
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
 #include <functional>
+#include <iterator>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "util/tracing.hpp"
+
 /**
  * @brief Alias de tipo para funções de carregamento de lista de entidades.
  * * Usada para carregar coleções de entidades associadas a um ID de
@@ -27,30 +36,66 @@ using ListLoaderFunction = std::function<std::vector<std::shared_ptr<T>>(long)>;
 template <typename T>
 using LoadFunction = std::function<std::shared_ptr<T>(long)>;
 
+/**
+ * @brief Alias de tipo para funções que classificam uma entidade em uma das
+ * visões de uma EntityList (ex: pelo status).
+ * @tparam T O tipo da entidade.
+ * @return size_t O índice da visão; um índice fora do intervalo deixa a
+ * entidade fora de todas as visões.
+ * @param const T& A entidade.
+ */
+template <typename T>
+using ViewClassifier = std::function<size_t(const T&)>;
+
 /**
  * @brief Implementa o padrão Lazy Loading para listas de entidades.
  * * Esta classe armazena uma função de carregamento (ListLoaderFunction) e só
  * executa a consulta de dados quando a lista é acessada pela primeira vez (ex:
- * size(), begin(), operator[]).
- * @tparam T O tipo da entidade armazenada.
+ * size(), begin(), operator[]). O carregamento é feito uma única vez mesmo
+ * com acessos concorrentes.
+ * * O contexto de trace de quem criou a lista é guardado e propagado para o
+ * span do carregamento, que pode acontecer bem depois (e em outra thread).
+ * * Com um classificador, a lista também mantém visões particionadas (ex: uma
+ * por status), montadas no carregamento, e acompanha as escritas feitas
+ * depois dele por replace() e remove(). A lista completa e cada visão são
+ * vetores imutáveis compartilhados: ler não copia nada, e uma alteração cria
+ * outro vetor só para a lista e as visões afetadas.
+ * @tparam T O tipo da entidade armazenada (com getId() e operator<).
  */
 template <typename T>
 class EntityList {
    private:
+    /**
+     * @brief Alias para o vetor de entidades.
+     */
+    using Vector = std::vector<std::shared_ptr<T>>;
+
+    /**
+     * @brief Alias para um vetor imutável compartilhado.
+     */
+    using View = std::shared_ptr<const Vector>;
+
     /**
      * @brief A função de callback responsável por carregar os dados.
      */
     ListLoaderFunction<T> loaderFunction;
 
     /**
-     * @brief O contêiner para armazenar os dados carregados.
+     * @brief Os dados carregados; lidos e trocados atomicamente.
      */
-    std::vector<std::shared_ptr<T>> data;
+    View data = std::make_shared<const Vector>();
 
     /**
      * @brief Flag que indica se os dados já foram carregados.
      */
-    bool isLoaded = false;
+    std::atomic<bool> isLoaded{false};
+
+    /**
+     * @brief Serializa o primeiro carregamento e as alterações (replace(),
+     * remove()), para que uma escrita feita durante o carregamento não se
+     * perca.
+     */
+    std::mutex loadMx;
 
     /**
      * @brief O ID da entidade proprietária (ex: Aluno ID) usado como parâmetro
@@ -58,27 +103,160 @@ class EntityList {
      */
     long ownerId;
 
+    /**
+     * @brief O contexto de trace no momento da criação da lista.
+     */
+    TraceContext origin;
+
+    ViewClassifier<T> classifier; /**< Classifica as entidades nas visões. */
+    size_t viewCount = 0;         /**< O número de visões. */
+
+    /**
+     * @brief As visões, na ordem da lista; lidas e trocadas atomicamente.
+     */
+    std::vector<View> views;
+
+    /**
+     * @brief A posição na lista e a visão atual de cada entidade, pelo ID.
+     */
+    std::unordered_map<long, std::pair<size_t, size_t>> placement;
+
+    /**
+     * @brief Monta as visões a partir dos dados carregados.
+     */
+    void buildViews() {
+        std::vector<Vector> parts(viewCount);
+
+        for (size_t i = 0; i < data->size(); ++i) {
+            const auto& entity = (*data)[i];
+            size_t view = classifier(*entity);
+
+            placement[entity->getId()] = {i, view};
+
+            if (view < viewCount)
+                parts[view].push_back(entity);
+        }
+
+        views.clear();
+        for (auto& part : parts)
+            views.push_back(std::make_shared<const Vector>(std::move(part)));
+    }
+
     /**
      * @brief Executa o carregamento dos dados se ainda não tiverem sido
      * carregados.
      */
     void loadData() {
-        if (!isLoaded && loaderFunction) {
-            data = loaderFunction(ownerId);
-            isLoaded = true;
+        if (isLoaded.load(std::memory_order_acquire) || !loaderFunction)
+            return;
+
+        std::lock_guard<std::mutex> lock(loadMx);
+
+        if (!isLoaded.load(std::memory_order_relaxed)) {
+            TraceSpan span("EntityList::load", origin);
+            std::atomic_store(
+                &data, View(std::make_shared<const Vector>(
+                           loaderFunction(ownerId))));
+
+            if (classifier)
+                buildViews();
+
+            isLoaded.store(true, std::memory_order_release);
         }
     }
 
+    /**
+     * @brief Publica um vetor novo no lugar de outro (a lista ou uma visão).
+     */
+    static void store(View& target, Vector&& items) {
+        std::atomic_store(&target,
+                          View(std::make_shared<const Vector>(
+                              std::move(items))));
+    }
+
+    /**
+     * @brief Atualiza a posição das entidades a partir de um índice, depois
+     * de uma inserção ou remoção na lista.
+     */
+    void renumber(const Vector& items, size_t from) {
+        for (size_t i = from; i < items.size(); ++i)
+            placement[items[i]->getId()].first = i;
+    }
+
+    /**
+     * @brief Retorna, em uma visão, o lugar da entidade que está (ou estaria)
+     * numa posição da lista.
+     */
+    typename Vector::iterator find(Vector& items, size_t position) {
+        return std::lower_bound(
+            items.begin(), items.end(), position,
+            [this](const std::shared_ptr<T>& e, size_t pos) {
+                return placement.at(e->getId()).first < pos;
+            });
+    }
+
    public:
     /**
      * @brief Alias para o tipo do vetor interno de entidades.
      */
-    using EntityVector = std::vector<std::shared_ptr<T>>;
+    using EntityVector = Vector;
 
     /**
-     * @brief Alias para o iterador mutável do vetor de entidades.
+     * @brief Iterador sobre a lista completa.
+     * * Guarda o vetor em que a iteração começou: uma alteração feita no meio
+     * dela (replace(), remove()) não a invalida, e só aparece na próxima.
+     * O iterador final é uma sentinela.
      */
-    using Iterator = typename EntityVector::iterator;
+    class Iterator {
+       private:
+        View items;       /**< O vetor percorrido (nulo na sentinela). */
+        size_t index = 0; /**< A posição atual. */
+
+        bool atEnd() const {
+            return !items || index >= items->size();
+        }
+
+       public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::shared_ptr<T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const std::shared_ptr<T>*;
+        using reference = const std::shared_ptr<T>&;
+
+        Iterator() = default;
+
+        explicit Iterator(View items) : items(std::move(items)) {}
+
+        reference operator*() const {
+            return (*items)[index];
+        }
+
+        pointer operator->() const {
+            return &(*items)[index];
+        }
+
+        Iterator& operator++() {
+            ++index;
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator previous = *this;
+            ++index;
+            return previous;
+        }
+
+        bool operator==(const Iterator& other) const {
+            if (atEnd() || other.atEnd())
+                return atEnd() && other.atEnd();
+
+            return items == other.items && index == other.index;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+    };
 
     /**
      * @brief Construtor da classe EntityList.
@@ -87,7 +265,25 @@ class EntityList {
      * carregamento.
      */
     EntityList(ListLoaderFunction<T> loader, long ownerId)
-        : loaderFunction(loader), ownerId(ownerId) {}
+        : loaderFunction(loader),
+          ownerId(ownerId),
+          origin(Tracer::context()) {}
+
+    /**
+     * @brief Construtor da classe EntityList com visões particionadas.
+     * @param loader A função de carregamento que será executada sob demanda.
+     * @param ownerId O ID do proprietário, passado para a função de
+     * carregamento.
+     * @param classifier Classifica cada entidade em uma das visões.
+     * @param viewCount O número de visões.
+     */
+    EntityList(ListLoaderFunction<T> loader, long ownerId,
+               ViewClassifier<T> classifier, size_t viewCount)
+        : loaderFunction(loader),
+          ownerId(ownerId),
+          origin(Tracer::context()),
+          classifier(classifier),
+          viewCount(viewCount) {}
 
     /**
      * @brief Destrutor padrão.
@@ -104,7 +300,7 @@ class EntityList {
     std::shared_ptr<T> operator[](size_t index) {
         loadData();
 
-        return data[index];
+        return (*std::atomic_load(&data))[index];
     }
 
     /**
@@ -115,7 +311,7 @@ class EntityList {
     Iterator begin() {
         loadData();
 
-        return data.begin();
+        return Iterator(std::atomic_load(&data));
     }
 
     /**
@@ -126,7 +322,7 @@ class EntityList {
     Iterator end() {
         loadData();
 
-        return data.end();
+        return Iterator();
     }
 
     /**
@@ -137,7 +333,7 @@ class EntityList {
     size_t size() {
         loadData();
 
-        return data.size();
+        return std::atomic_load(&data)->size();
     }
 
     /**
@@ -148,6 +344,136 @@ class EntityList {
     bool empty() {
         return size() == 0;
     }
+
+    /**
+     * @brief Retorna uma visão da lista, sem cópia.
+     * * Dispara o carregamento preguiçoso. O vetor retornado não muda: uma
+     * chamada posterior a replace() ou remove() cria outro.
+     * @param index O índice da visão.
+     * @return std::shared_ptr<const EntityVector> As entidades da visão, na
+     * ordem da lista (vazia se não houver classificador).
+     */
+    std::shared_ptr<const EntityVector> view(size_t index) {
+        loadData();
+
+        if (index >= views.size())
+            return std::make_shared<const EntityVector>();
+
+        return std::atomic_load(&views[index]);
+    }
+
+    /**
+     * @brief Grava na lista uma versão nova de uma entidade (mesmo ID),
+     * movendo-a de visão se a classificação mudou, ou uma entidade nova que
+     * pertença a alguma visão.
+     * * A entidade nova entra antes da primeira que a sucede (operator<).
+     * Custa O(tamanho da lista): só ela e as visões afetadas são recriadas.
+     * Não tem efeito antes do carregamento, que já lerá a escrita, nem sem
+     * classificador.
+     * @param entity A versão nova.
+     * @return bool True se a entidade foi gravada.
+     */
+    bool replace(const std::shared_ptr<T>& entity) {
+        if (!classifier)
+            return false;
+
+        std::lock_guard<std::mutex> lock(loadMx);
+
+        if (!isLoaded.load(std::memory_order_relaxed))
+            return false;
+
+        Vector items(*data);
+        size_t to = classifier(*entity);
+        size_t from = viewCount;
+        size_t position;
+        auto it = placement.find(entity->getId());
+
+        if (it != placement.end()) {
+            position = it->second.first;
+            from = it->second.second;
+            items[position] = entity;
+        } else {
+            if (to >= viewCount)
+                return false;
+
+            auto at = std::find_if(
+                items.begin(), items.end(),
+                [&entity](const std::shared_ptr<T>& e) {
+                    return *entity < *e;
+                });
+
+            position = at - items.begin();
+            items.insert(at, entity);
+            renumber(items, position);
+        }
+
+        placement[entity->getId()].second = to;
+
+        if (from < viewCount) {
+            Vector copy(*views[from]);
+            auto at = find(copy, position);
+
+            if (from == to)
+                *at = entity;
+            else
+                copy.erase(at);
+
+            store(views[from], std::move(copy));
+        }
+
+        if (to < viewCount && to != from) {
+            Vector copy(*views[to]);
+
+            copy.insert(find(copy, position), entity);
+            store(views[to], std::move(copy));
+        }
+
+        store(data, std::move(items));
+
+        return true;
+    }
+
+    /**
+     * @brief Retira uma entidade da lista e da sua visão.
+     * * Custa O(tamanho da lista). Não tem efeito antes do carregamento nem
+     * sem classificador.
+     * @param id O ID da entidade.
+     * @return bool True se a entidade estava na lista.
+     */
+    bool remove(long id) {
+        if (!classifier)
+            return false;
+
+        std::lock_guard<std::mutex> lock(loadMx);
+
+        if (!isLoaded.load(std::memory_order_relaxed))
+            return false;
+
+        auto it = placement.find(id);
+
+        if (it == placement.end())
+            return false;
+
+        size_t position = it->second.first;
+        size_t from = it->second.second;
+
+        if (from < viewCount) {
+            Vector copy(*views[from]);
+
+            copy.erase(find(copy, position));
+            store(views[from], std::move(copy));
+        }
+
+        Vector items(*data);
+
+        items.erase(items.begin() + position);
+        placement.erase(it);
+        renumber(items, position);
+
+        store(data, std::move(items));
+
+        return true;
+    }
 };
 
 #endif
\ No newline at end of file
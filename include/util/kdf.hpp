@@ -0,0 +1,166 @@
+#ifndef KDF_HPP
+#define KDF_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Prefixo dos hashes PBKDF2-HMAC-SHA256
+ * (`$pbkdf2-sha256$<iteracoes>$<salt>$<digest>`, no formato do passlib).
+ */
+#define KDF_PREFIX "$pbkdf2-sha256$"
+
+/**
+ * @brief Tamanho do salt, em bytes.
+ */
+#define KDF_SALT_BYTES 16
+
+/**
+ * @brief Tamanho do digest, em bytes.
+ */
+#define KDF_HASH_BYTES 32
+
+/**
+ * @brief Menor número de iterações aceito pela calibração.
+ */
+#define KDF_MIN_ITERATIONS 10000
+
+/**
+ * @brief Orçamento de tempo padrão de um hash, em milissegundos.
+ */
+#define KDF_TARGET_MS 50
+
+/**
+ * @brief Arquivo em que o número de iterações calibrado é guardado, para que
+ * as execuções seguintes usem o mesmo alvo.
+ */
+#define KDF_ITERATIONS_PATH "data/kdf_iterations"
+
+/**
+ * @brief SHA-256 incremental (FIPS 180-4), sem alocação dinâmica.
+ */
+class Sha256 {
+   private:
+    uint32_t state[8];   /**< O estado da função de compressão. */
+    uint8_t buffer[64];  /**< O bloco parcial. */
+    size_t buffered = 0; /**< Bytes no bloco parcial. */
+    uint64_t length = 0; /**< Total de bytes processados. */
+
+   public:
+    /**
+     * @brief Aplica a função de compressão a um bloco de 64 bytes.
+     * @param state O estado, atualizado no lugar.
+     * @param block O bloco.
+     */
+    static void compress(uint32_t state[8], const uint8_t block[64]);
+
+    Sha256();
+
+    /**
+     * @brief Processa mais bytes da mensagem.
+     */
+    void update(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Conclui o hash.
+     * @param out Recebe os 32 bytes do digest.
+     */
+    void finish(uint8_t out[32]);
+
+    /**
+     * @brief Copia o estado interno; só é válido após blocos completos.
+     * @param out Recebe as 8 palavras do estado.
+     */
+    void exportState(uint32_t out[8]) const;
+};
+
+/**
+ * @brief Deriva uma chave com PBKDF2-HMAC-SHA256 (RFC 8018).
+ * * Os estados internos do HMAC são pré-calculados a partir da senha; cada
+ * iteração custa duas compressões sobre blocos fixos na pilha, sem alocação.
+ * @param pwd A senha.
+ * @param salt O salt.
+ * @param saltLen O tamanho do salt.
+ * @param iterations O número de iterações.
+ * @param out Recebe a chave derivada.
+ * @param outLen O tamanho da chave.
+ */
+void pbkdf2_sha256(const std::string& pwd, const uint8_t* salt,
+                   size_t saltLen, uint32_t iterations, uint8_t* out,
+                   size_t outLen);
+
+/**
+ * @brief Mede o custo do PBKDF2 nesta máquina e calcula o número de
+ * iterações que leva aproximadamente o tempo pedido.
+ * @param budget O orçamento de tempo de um hash.
+ * @return uint32_t O número de iterações (no mínimo KDF_MIN_ITERATIONS).
+ */
+uint32_t calibrate_kdf_iterations(std::chrono::milliseconds budget);
+
+/**
+ * @brief Retorna o número de iterações usado nos novos hashes.
+ * * Definido com set_kdf_iterations() ou, senão, lido de
+ * KDF_ITERATIONS_PATH na primeira chamada; se o arquivo não existir, é
+ * calibrado para KDF_TARGET_MS e gravado nele.
+ * @return uint32_t O número de iterações.
+ */
+uint32_t kdf_iterations();
+
+/**
+ * @brief Define o número de iterações dos novos hashes.
+ * @param iterations O número de iterações (0 volta ao de
+ * KDF_ITERATIONS_PATH).
+ */
+void set_kdf_iterations(uint32_t iterations);
+
+/**
+ * @brief Gera o hash PBKDF2 de uma senha com salt aleatório.
+ * @param pwd A senha em texto claro.
+ * @param iterations O número de iterações (0 usa kdf_iterations()).
+ * @return std::string O hash no formato de KDF_PREFIX.
+ */
+std::string hash_password(const std::string& pwd, uint32_t iterations = 0);
+
+/**
+ * @brief Gera os hashes PBKDF2 de várias senhas em paralelo.
+ * * As senhas são divididas em blocos executados no executor compartilhado
+ * (ThreadPool::shared()); a thread chamadora processa um dos blocos e ajuda a
+ * executar os demais enquanto espera.
+ * @param pwds As senhas em texto claro.
+ * @param iterations O número de iterações (0 usa kdf_iterations()).
+ * @return std::vector<std::string> Os hashes, na ordem das senhas.
+ */
+std::vector<std::string> hash_passwords(const std::vector<std::string>& pwds,
+                                        uint32_t iterations = 0);
+
+/**
+ * @brief Verifica uma senha contra um hash PBKDF2.
+ * * A comparação do digest tem tempo constante.
+ * @param cypher O hash no formato de KDF_PREFIX.
+ * @param pwd A senha em texto claro.
+ * @return bool True se a senha corresponder; false se não corresponder ou se
+ * o hash for malformado.
+ */
+bool verify_kdf(const std::string& cypher, const std::string& pwd);
+
+/**
+ * @brief Retorna o número de iterações de um hash PBKDF2.
+ * @param cypher O hash.
+ * @return uint32_t O número de iterações, ou 0 se o hash não for PBKDF2.
+ */
+uint32_t kdf_hash_iterations(const std::string& cypher);
+
+/**
+ * @brief Indica se um hash foi gerado com parâmetros desatualizados.
+ * * Hashes de outro algoritmo (ex: `$mk$`) sempre precisam ser refeitos.
+ * Hashes PBKDF2 precisam quando têm menos iterações que kdf_iterations();
+ * um hash mais caro que o alvo é mantido.
+ * @param cypher O hash armazenado.
+ * @return bool True se o hash deve ser refeito com hash_password().
+ */
+bool kdf_needs_rehash(const std::string& cypher);
+
+#endif
@@ -0,0 +1,281 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Número máximo de métricas distintas registradas no processo.
+ */
+#define METRICS_MAX 256
+
+/**
+ * @brief Número de baldes de cada histograma.
+ * * Valores abaixo de 16 ns têm um balde cada; acima disso, cada potência de
+ * dois é dividida em 8 baldes (erro relativo de até 12,5%), até 2^40 ns
+ * (~18 minutos). Valores maiores caem no último balde.
+ */
+#define HISTOGRAM_BUCKETS 304
+
+/**
+ * @brief Histograma de latências em nanossegundos, no estilo HDR (baldes
+ * log-lineares).
+ * * Cada instância tem um único escritor (a thread dona), que atualiza os
+ * contadores sem instruções atômicas de leitura-modificação-escrita; leitores
+ * de outras threads veem valores consistentes por contador, e o total pode
+ * estar levemente defasado durante a leitura.
+ */
+class LatencyHistogram {
+   private:
+    std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> buckets{};
+    std::atomic<uint64_t> count{0}; /**< Número de amostras. */
+    std::atomic<uint64_t> sum{0};   /**< Soma das amostras (ns). */
+    std::atomic<uint64_t> max{0};   /**< Maior amostra (ns). */
+
+    friend struct HistogramSnapshot;
+
+   public:
+    /**
+     * @brief Retorna o balde de um valor.
+     * @param ns O valor em nanossegundos.
+     * @return size_t O índice do balde.
+     */
+    static size_t bucketOf(uint64_t ns);
+
+    /**
+     * @brief Retorna o menor valor contido em um balde.
+     * @param bucket O índice do balde.
+     * @return uint64_t O limite inferior, em nanossegundos.
+     */
+    static uint64_t lowerBound(size_t bucket);
+
+    /**
+     * @brief Retorna o maior valor contido em um balde.
+     * @param bucket O índice do balde.
+     * @return uint64_t O limite superior, em nanossegundos.
+     */
+    static uint64_t upperBound(size_t bucket);
+
+    /**
+     * @brief Registra uma amostra. Só deve ser chamado pela thread dona.
+     * @param ns A latência em nanossegundos.
+     */
+    void record(uint64_t ns) {
+        auto& bucket = buckets[bucketOf(ns)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_relaxed);
+        sum.store(sum.load(std::memory_order_relaxed) + ns,
+                  std::memory_order_relaxed);
+        count.store(count.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+
+        if (ns > max.load(std::memory_order_relaxed))
+            max.store(ns, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Cópia agregada (de todas as threads) do histograma de uma métrica.
+ */
+struct HistogramSnapshot {
+    std::string name;              /**< O nome da métrica. */
+    std::vector<uint64_t> buckets; /**< Contagem por balde. */
+    uint64_t count = 0;            /**< Número de amostras. */
+    uint64_t sum = 0;              /**< Soma das amostras (ns). */
+    uint64_t max = 0;              /**< Maior amostra (ns). */
+
+    /**
+     * @brief Soma os contadores de um histograma a esta cópia.
+     * @param histogram O histograma de uma thread.
+     */
+    void merge(const LatencyHistogram& histogram);
+
+    /**
+     * @brief Estima um percentil pelo ponto médio do balde que o contém.
+     * @param p O percentil, entre 0 e 1.
+     * @return uint64_t O valor estimado, em nanossegundos.
+     */
+    uint64_t percentile(double p) const;
+};
+
+/**
+ * @brief Contador monotônico de eventos.
+ * * Incrementado com `fetch_add(n, std::memory_order_relaxed)`; os contadores
+ * ficam sempre ativos, independentemente de ENABLE_METRICS.
+ */
+using Counter = std::atomic<uint64_t>;
+
+/**
+ * @brief Formatos de exportação das métricas.
+ */
+enum class MetricsFormat {
+    TEXT,      /**< Tabela legível. */
+    PROMETHEUS /**< Formato de exposição de texto do Prometheus. */
+};
+
+/**
+ * @brief Registro global dos histogramas de latência e dos contadores.
+ * * Cada thread grava nos seus próprios histogramas (criados no primeiro uso
+ * de cada métrica), de modo que a gravação não disputa locks nem linhas de
+ * cache com outras threads. A exportação soma os histogramas de todas as
+ * threads, inclusive as já encerradas.
+ */
+class MetricsRegistry {
+   private:
+    /**
+     * @brief Os histogramas de uma thread, indexados pelo id da métrica.
+     */
+    struct ThreadHistograms {
+        std::array<std::atomic<LatencyHistogram*>, METRICS_MAX> slots{};
+        std::vector<std::unique_ptr<LatencyHistogram>> owned;
+    };
+
+    mutable std::mutex mx;                     /**< Protege os campos abaixo. */
+    std::unordered_map<std::string, size_t> ids; /**< Id de cada nome. */
+    std::vector<std::string> names;              /**< Nome de cada id. */
+    std::vector<std::unique_ptr<ThreadHistograms>> threads;
+
+    std::deque<Counter> counters; /**< Os contadores (endereços estáveis). */
+    std::map<std::pair<std::string, std::string>, Counter*> counterIds;
+
+    /**
+     * @brief Os histogramas da thread corrente; mantidos pelo registro mesmo
+     * depois que a thread termina.
+     */
+    static thread_local ThreadHistograms* current;
+
+    MetricsRegistry() = default;
+
+    /**
+     * @brief Retorna os histogramas da thread corrente, registrando-os no
+     * primeiro uso.
+     */
+    ThreadHistograms& local();
+
+    /**
+     * @brief Escreve os contadores, um por linha (`familia{rotulos} valor`).
+     */
+    void writeCounters(std::ostream& out, MetricsFormat format) const;
+
+   public:
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    /**
+     * @brief Retorna o registro do processo.
+     * @return MetricsRegistry& O registro.
+     */
+    static MetricsRegistry& instance();
+
+    /**
+     * @brief Indica se a instrumentação foi compilada (ENABLE_METRICS).
+     * @return bool True se os pontos de medição estão ativos.
+     */
+    static bool enabled();
+
+    /**
+     * @brief Retorna o id de uma métrica, registrando-a se for nova.
+     * @param name O nome da métrica (ex: "MockConnection::insert").
+     * @return size_t O id da métrica.
+     * @throws std::length_error Se o limite METRICS_MAX for excedido.
+     */
+    size_t id(const std::string& name);
+
+    /**
+     * @brief Registra uma amostra no histograma da thread corrente.
+     * @param id O id da métrica.
+     * @param ns A latência em nanossegundos.
+     */
+    void record(size_t id, uint64_t ns);
+
+    /**
+     * @brief Agrega os histogramas de todas as threads.
+     * @return std::vector<HistogramSnapshot> Uma cópia por métrica, na ordem
+     * de registro.
+     */
+    std::vector<HistogramSnapshot> snapshot() const;
+
+    /**
+     * @brief Retorna um contador, registrando-o se for novo.
+     * * Contadores com a mesma família e os mesmos rótulos são compartilhados;
+     * a referência permanece válida durante toda a execução.
+     * @param family O nome da família no formato do Prometheus (ex:
+     * "appointment_cache_hits_total").
+     * @param labels Os rótulos já formatados (ex: `cache="alunos"`).
+     * @return Counter& O contador.
+     */
+    Counter& counter(const std::string& family, const std::string& labels);
+
+    /**
+     * @brief Escreve as métricas no formato pedido.
+     * * No formato texto, imprime uma linha por métrica com contagem, média,
+     * percentis e máximo em microssegundos, seguida dos contadores. No
+     * Prometheus, exporta um `summary` com rótulo `op` e os quantis 0.5, 0.9,
+     * 0.99 e 0.999, e uma família `counter` por nome de contador.
+     * @param out O fluxo de saída.
+     * @param format O formato.
+     */
+    void write(std::ostream& out, MetricsFormat format) const;
+
+    /**
+     * @brief Grava as métricas em um arquivo, substituindo o conteúdo.
+     * @param path O caminho do arquivo.
+     * @param format O formato.
+     * @return bool True se o arquivo foi gravado.
+     */
+    bool dump(const std::string& path, MetricsFormat format) const;
+};
+
+/**
+ * @brief Temporizador de escopo: mede o tempo de vida do objeto e o registra
+ * na métrica informada.
+ */
+class ScopedTimer {
+   private:
+    size_t id; /**< O id da métrica. */
+    std::chrono::steady_clock::time_point start; /**< Início da medição. */
+
+   public:
+    explicit ScopedTimer(size_t id)
+        : id(id), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        MetricsRegistry::instance().record(
+            id, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+                    .count());
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+#define METRICS_CONCAT_(a, b) a##b
+#define METRICS_CONCAT(a, b) METRICS_CONCAT_(a, b)
+
+/**
+ * @brief Mede a latência do restante do escopo corrente na métrica `name`.
+ * * Só gera código quando compilado com ENABLE_METRICS (`make METRICS=1`);
+ * caso contrário, expande para uma instrução vazia.
+ */
+#ifdef ENABLE_METRICS
+#define METRIC_SCOPE(name)                                        \
+    static const size_t METRICS_CONCAT(metricId, __LINE__) =      \
+        MetricsRegistry::instance().id(name);                     \
+    ScopedTimer METRICS_CONCAT(metricTimer, __LINE__)(            \
+        METRICS_CONCAT(metricId, __LINE__))
+#else
+#define METRIC_SCOPE(name) static_cast<void>(0)
+#endif
+
+#endif
@@ -0,0 +1,107 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <exception>
+#include <future>
+#include <iterator>
+#include <optional>
+#include <vector>
+
+#include "util/threadPool.hpp"
+
+/**
+ * @brief Quantidade mínima de itens para que uma varredura seja dividida entre
+ * as threads. Abaixo disso, o custo de coordenação supera o ganho.
+ */
+#define PARALLEL_MIN_ITEMS 4096
+
+/**
+ * @brief Número de blocos por thread em uma varredura paralela; mais blocos
+ * que threads equilibram a carga via roubo de trabalho.
+ */
+#define PARALLEL_CHUNKS_PER_THREAD 4
+
+/**
+ * @brief Filtra e transforma os itens [first, items.size()) em paralelo,
+ * preservando a ordem original.
+ * * Os itens são divididos em blocos contíguos executados no pool (por
+ * padrão, o ThreadPool::shared()); a thread chamadora processa o primeiro
+ * bloco e ajuda a executar os demais blocos da mesma chamada enquanto espera.
+ * Os resultados de cada bloco são concatenados na ordem dos blocos.
+ * @tparam Out O tipo dos resultados.
+ * @tparam In O tipo dos itens.
+ * @tparam Fn Função `std::optional<Out>(const In&)`; std::nullopt descarta o
+ * item.
+ * @param items Os itens de entrada.
+ * @param first O índice do primeiro item considerado.
+ * @param fn A função de filtro e transformação. Deve ser segura para chamadas
+ * concorrentes.
+ * @param pool O executor dos blocos.
+ * @return std::vector<Out> Os resultados, na ordem dos itens.
+ */
+template <typename Out, typename In, typename Fn>
+std::vector<Out> parallel_filter_map(const std::vector<In>& items, size_t first,
+                                     const Fn& fn,
+                                     ThreadPool& pool = ThreadPool::shared()) {
+    size_t total = items.size() > first ? items.size() - first : 0;
+
+    auto runChunk = [&items, &fn](size_t begin, size_t end) {
+        std::vector<Out> out;
+
+        for (size_t i = begin; i < end; ++i) {
+            std::optional<Out> mapped = fn(items[i]);
+            if (mapped)
+                out.push_back(std::move(*mapped));
+        }
+
+        return out;
+    };
+
+    if (total < PARALLEL_MIN_ITEMS || pool.size() < 2)
+        return runChunk(first, items.size());
+
+    size_t chunks = pool.size() * PARALLEL_CHUNKS_PER_THREAD;
+    size_t chunkSize = std::max<size_t>(PARALLEL_MIN_ITEMS / 4,
+                                        (total + chunks - 1) / chunks);
+
+    std::vector<std::future<std::vector<Out>>> pending;
+
+    for (size_t begin = first + chunkSize; begin < items.size();
+         begin += chunkSize) {
+        size_t end = std::min(items.size(), begin + chunkSize);
+        pending.push_back(pool.submit(
+            [&runChunk, begin, end]() { return runChunk(begin, end); },
+            &pending));
+    }
+
+    // Os blocos referenciam variáveis locais: todos precisam terminar antes
+    // de a função retornar, mesmo que algum deles lance uma exceção.
+    std::vector<Out> results;
+    std::exception_ptr error;
+
+    try {
+        results = runChunk(first, std::min(items.size(), first + chunkSize));
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    for (auto& future : pending) {
+        try {
+            std::vector<Out> part = pool.await(future, &pending);
+            results.insert(results.end(),
+                           std::make_move_iterator(part.begin()),
+                           std::make_move_iterator(part.end()));
+        } catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+
+    return results;
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef PASSWORD_VERIFIER_HPP
+#define PASSWORD_VERIFIER_HPP
+
+#include <atomic>
+#include <string>
+
+#include "util/threadPool.hpp"
+
+/**
+ * @brief Número máximo de verificações em andamento (executando ou na fila)
+ * no verificador compartilhado.
+ */
+#define PASSWORD_VERIFIER_CAPACITY 64
+
+/**
+ * @brief Executa as verificações de senha em um pool próprio e limitado.
+ * * O hash de senha é caro por definição; executá-lo fora do pool
+ * compartilhado impede que uma rajada de logins ocupe as threads usadas pelas
+ * demais operações. Acima da capacidade, novas verificações são recusadas em
+ * vez de enfileiradas.
+ */
+class PasswordVerifier {
+   private:
+    ThreadPool pool;                 /**< As threads de verificação. */
+    const size_t capacity;           /**< Máximo de verificações admitidas. */
+    std::atomic<size_t> inFlight{0}; /**< Verificações admitidas. */
+
+   public:
+    /**
+     * @brief Construtor da classe PasswordVerifier.
+     * @param threads O número de threads do pool.
+     * @param capacity O máximo de verificações em andamento.
+     */
+    PasswordVerifier(size_t threads, size_t capacity);
+
+    PasswordVerifier(const PasswordVerifier&) = delete;
+    PasswordVerifier& operator=(const PasswordVerifier&) = delete;
+
+    /**
+     * @brief Retorna o verificador do processo, com metade dos núcleos (ao
+     * menos uma thread) e capacidade PASSWORD_VERIFIER_CAPACITY.
+     * @return PasswordVerifier& O verificador compartilhado.
+     */
+    static PasswordVerifier& shared();
+
+    /**
+     * @brief Verifica uma senha no pool e aguarda o resultado.
+     * @param cypher O hash armazenado.
+     * @param pwd A senha em texto claro.
+     * @return bool True se a senha corresponder ao hash.
+     * @throws std::runtime_error Se a capacidade estiver esgotada.
+     */
+    bool verify(const std::string& cypher, const std::string& pwd);
+
+    /**
+     * @brief Enfileira um trabalho de hash em segundo plano (ex: rehash de
+     * uma senha) no pool de verificação.
+     * * Não conta para a capacidade: o chamador limita os próprios trabalhos.
+     * @param job O trabalho.
+     */
+    void post(std::function<void()> job);
+
+    /**
+     * @brief Retorna o número de verificações em andamento.
+     * @return size_t O número de verificações.
+     */
+    size_t pending() const;
+};
+
+#endif
@@ -0,0 +1,106 @@
+#ifndef RATE_LIMITER_HPP
+#define RATE_LIMITER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "util/shardedMap.hpp"
+
+/**
+ * @brief Número de pedidos entre duas limpezas dos baldes cheios.
+ */
+#define RATE_LIMITER_SWEEP_EVERY 4096
+
+/**
+ * @brief Balde de fichas (token bucket) sem lock.
+ * * Implementado como GCRA: em vez de fichas e último reabastecimento, guarda
+ * só o instante teórico em que o balde volta a ficar cheio, atualizado com
+ * compare-and-swap. Admite rajadas de até `burst` pedidos e, em regime, um
+ * pedido a cada `interval`.
+ */
+class TokenBucket {
+   private:
+    const int64_t interval;         /**< Custo de uma ficha (ns). */
+    const int64_t tolerance;        /**< Rajada máxima, em ns. */
+    std::atomic<int64_t> fullAt{0}; /**< Quando o balde volta a encher. */
+
+   public:
+    /**
+     * @brief Construtor da classe TokenBucket.
+     * @param perSecond Fichas repostas por segundo.
+     * @param burst Capacidade do balde.
+     */
+    TokenBucket(double perSecond, uint32_t burst);
+
+    /**
+     * @brief Tenta consumir uma ficha.
+     * @param now O instante corrente (ns, relógio monotônico).
+     * @return bool True se havia ficha; false se o pedido deve ser recusado.
+     */
+    bool tryAcquire(int64_t now);
+
+    /**
+     * @brief Indica se o balde está cheio, isto é, se esquecê-lo não muda o
+     * comportamento do limitador.
+     * @param now O instante corrente (ns).
+     * @return bool True se o balde está cheio.
+     */
+    bool full(int64_t now) const;
+};
+
+/**
+ * @brief Limitador de taxa com um balde global e um balde por chave.
+ * * Um pedido é admitido só se houver ficha no balde da sua chave e no
+ * global; recusas na chave não consomem o global. Os baldes por chave ficam
+ * em um ShardedMap e são descartados quando voltam a ficar cheios, a cada
+ * RATE_LIMITER_SWEEP_EVERY pedidos.
+ */
+class RateLimiter {
+   private:
+    const double keyRate;    /**< Fichas por segundo de cada chave. */
+    const uint32_t keyBurst; /**< Capacidade do balde de cada chave. */
+    TokenBucket global;      /**< O balde global. */
+
+    /**
+     * @brief Os baldes por chave; compartilhados para que a ficha possa ser
+     * consumida fora do lock do fragmento.
+     */
+    ShardedMap<std::string, std::shared_ptr<TokenBucket>> buckets;
+
+    std::atomic<uint64_t> requests{0}; /**< Pedidos desde a criação. */
+
+    /**
+     * @brief Descarta os baldes por chave que já estão cheios.
+     * @param now O instante corrente (ns).
+     */
+    void sweep(int64_t now);
+
+   public:
+    /**
+     * @brief Construtor da classe RateLimiter.
+     * @param keyRate Fichas por segundo de cada chave.
+     * @param keyBurst Capacidade do balde de cada chave.
+     * @param globalRate Fichas por segundo do balde global.
+     * @param globalBurst Capacidade do balde global.
+     */
+    RateLimiter(double keyRate, uint32_t keyBurst, double globalRate,
+                uint32_t globalBurst);
+
+    /**
+     * @brief Tenta admitir um pedido.
+     * @param key A chave do pedido (ex: o email).
+     * @return bool True se o pedido foi admitido.
+     */
+    bool allow(const std::string& key);
+
+    /**
+     * @brief Retorna o número de baldes por chave em memória.
+     * @return size_t O número de baldes.
+     */
+    size_t tracked() const;
+};
+
+#endif
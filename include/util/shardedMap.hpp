@@ -0,0 +1,177 @@
+#ifndef SHARDED_MAP_HPP
+#define SHARDED_MAP_HPP
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+/**
+ * @brief Mapa hash concorrente particionado em fragmentos (shards).
+ * * Cada fragmento possui seu próprio mutex, de modo que operações sobre
+ * chaves de fragmentos distintos não disputam o mesmo lock. Os valores são
+ * sempre devolvidos por cópia, nunca por referência, para que nenhum acesso
+ * escape da região protegida.
+ * @tparam K O tipo da chave.
+ * @tparam V O tipo do valor.
+ * @tparam Shards O número de fragmentos (potência de dois recomendada).
+ */
+template <typename K, typename V, size_t Shards = 16>
+class ShardedMap {
+   private:
+    /**
+     * @brief Um fragmento do mapa: um mutex e a tabela hash que ele protege.
+     */
+    struct Shard {
+        mutable std::mutex mx;
+        std::unordered_map<K, V> map;
+    };
+
+    /**
+     * @brief Os fragmentos do mapa.
+     */
+    std::array<Shard, Shards> shards;
+
+    /**
+     * @brief Seleciona o fragmento responsável por uma chave.
+     * @param key A chave.
+     * @return Shard& O fragmento correspondente.
+     */
+    Shard& shardFor(const K& key) {
+        return shards[std::hash<K>{}(key) % Shards];
+    }
+
+    /**
+     * @brief Versão constante de shardFor.
+     */
+    const Shard& shardFor(const K& key) const {
+        return shards[std::hash<K>{}(key) % Shards];
+    }
+
+   public:
+    /**
+     * @brief Insere ou substitui o valor associado a uma chave.
+     * @param key A chave.
+     * @param value O valor.
+     */
+    void put(const K& key, const V& value) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mx);
+
+        shard.map[key] = value;
+    }
+
+    /**
+     * @brief Busca o valor associado a uma chave.
+     * @param key A chave.
+     * @return std::optional<V> Uma cópia do valor, ou std::nullopt se a chave
+     * não existir.
+     */
+    std::optional<V> find(const K& key) const {
+        const Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mx);
+
+        auto it = shard.map.find(key);
+
+        if (it == shard.map.end())
+            return std::nullopt;
+
+        return it->second;
+    }
+
+    /**
+     * @brief Aplica uma função ao valor de uma chave existente, sob o lock do
+     * seu fragmento.
+     * @param key A chave.
+     * @param fn A função que recebe o valor por referência mutável.
+     * @return bool True se a chave existia e a função foi aplicada.
+     */
+    bool update(const K& key, const std::function<void(V&)>& fn) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mx);
+
+        auto it = shard.map.find(key);
+
+        if (it == shard.map.end())
+            return false;
+
+        fn(it->second);
+        return true;
+    }
+
+    /**
+     * @brief Retorna o valor de uma chave, criando-o com a fábrica fornecida
+     * caso ainda não exista.
+     * @param key A chave.
+     * @param factory Função que constrói o valor inicial.
+     * @return V Uma cópia do valor existente ou recém-criado.
+     */
+    V getOrCreate(const K& key, const std::function<V()>& factory) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mx);
+
+        auto it = shard.map.find(key);
+
+        if (it == shard.map.end())
+            it = shard.map.emplace(key, factory()).first;
+
+        return it->second;
+    }
+
+    /**
+     * @brief Remove uma chave do mapa.
+     * @param key A chave.
+     * @return bool True se a chave existia.
+     */
+    bool erase(const K& key) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mx);
+
+        return shard.map.erase(key) > 0;
+    }
+
+    /**
+     * @brief Remove todas as entradas que satisfazem um predicado.
+     * * Os fragmentos são percorridos um de cada vez, nunca há dois locks
+     * mantidos simultaneamente.
+     * @param pred Predicado que recebe a chave e o valor.
+     * @return size_t O número de entradas removidas.
+     */
+    size_t eraseIf(const std::function<bool(const K&, const V&)>& pred) {
+        size_t removed = 0;
+
+        for (Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mx);
+
+            for (auto it = shard.map.begin(); it != shard.map.end();) {
+                if (pred(it->first, it->second)) {
+                    it = shard.map.erase(it);
+                    ++removed;
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        return removed;
+    }
+
+    /**
+     * @brief Retorna o número total de entradas.
+     * * O valor é apenas aproximado sob escrita concorrente.
+     * @return size_t O tamanho do mapa.
+     */
+    size_t size() const {
+        size_t total = 0;
+
+        for (const Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mx);
+            total += shard.map.size();
+        }
+
+        return total;
+    }
+};
+
+#endif
@@ -0,0 +1,167 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Conjunto fixo de threads com roubo de trabalho (work stealing).
+ * * Cada thread possui a sua própria fila. Tarefas enfileiradas por uma thread
+ * do pool vão para a fila dela e são executadas em ordem LIFO (melhor
+ * localidade para tarefas que se subdividem); tarefas vindas de fora são
+ * distribuídas entre as filas em rodízio. Uma thread sem trabalho rouba a
+ * tarefa mais antiga da fila de outra.
+ *
+ * Não há garantia de ordem entre tarefas. O destrutor aguarda a conclusão de
+ * todas as tarefas já enfileiradas antes de encerrar as threads.
+ *
+ * Uma tarefa pode pertencer a um lote, identificado por um endereço qualquer
+ * do chamador (ex: o vetor dos seus futures). Enquanto aguarda o lote, o
+ * chamador ajuda executando apenas tarefas desse mesmo lote (ver await()).
+ */
+class ThreadPool {
+   private:
+    /**
+     * @brief Uma tarefa enfileirada.
+     */
+    struct Task {
+        std::function<void()> fn; /**< O trabalho. */
+        const void* batch;        /**< O lote da tarefa (ou nullptr). */
+    };
+
+    /**
+     * @brief A fila de uma thread do pool.
+     */
+    struct Queue {
+        std::mutex mx;          /**< Protege a fila. */
+        std::deque<Task> tasks; /**< As tarefas. */
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues; /**< Uma fila por thread. */
+    std::vector<std::thread> workers;           /**< As threads. */
+
+    std::atomic<size_t> pending{0};   /**< Tarefas ainda não iniciadas. */
+    std::atomic<size_t> nextQueue{0}; /**< Rodízio das tarefas externas. */
+
+    std::mutex sleepMx;         /**< Protege a espera das threads ociosas. */
+    std::condition_variable cv; /**< Sinaliza trabalho ou encerramento. */
+    bool stopping = false;      /**< Indica que o pool está sendo encerrado. */
+
+    /**
+     * @brief Retorna o índice da fila da thread corrente neste pool, ou o
+     * número de filas se a thread não pertencer a ele.
+     */
+    size_t localIndex() const;
+
+    /**
+     * @brief Retira uma tarefa, começando pela fila `home` (pelo fim) e
+     * roubando das demais (pelo início).
+     * @param home O índice da fila preferida.
+     * @param task Recebe a tarefa retirada.
+     * @param batch Se não for nulo, só tarefas deste lote são retiradas.
+     * @return bool True se alguma tarefa foi retirada.
+     */
+    bool take(size_t home, std::function<void()>& task,
+              const void* batch = nullptr);
+
+    /**
+     * @brief Laço executado por cada thread do pool.
+     * @param index O índice da fila da thread.
+     */
+    void workerLoop(size_t index);
+
+   public:
+    /**
+     * @brief Construtor da classe ThreadPool.
+     * @param threads O número de threads (0 usa o número de núcleos).
+     */
+    explicit ThreadPool(size_t threads = 0);
+
+    /**
+     * @brief Destrutor: executa as tarefas pendentes e encerra as threads.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Retorna o executor compartilhado do processo, criado no primeiro
+     * uso com uma thread por núcleo.
+     * * Usado pelas operações paralelas da persistência.
+     * @return ThreadPool& O executor compartilhado.
+     */
+    static ThreadPool& shared();
+
+    /**
+     * @brief Enfileira uma tarefa sem valor de retorno.
+     * @param task A tarefa.
+     * @param batch O lote da tarefa (nullptr se não pertencer a nenhum).
+     */
+    void post(std::function<void()> task, const void* batch = nullptr);
+
+    /**
+     * @brief Enfileira uma tarefa e retorna um future para o seu resultado.
+     * * Exceções lançadas pela tarefa são propagadas pelo future.
+     * @tparam F O tipo da função.
+     * @param fn A função a ser executada.
+     * @param batch O lote da tarefa (nullptr se não pertencer a nenhum).
+     * @return std::future<R> O future do resultado.
+     */
+    template <typename F>
+    auto submit(F&& fn, const void* batch = nullptr)
+        -> std::future<decltype(fn())> {
+        using R = decltype(fn());
+
+        auto task =
+            std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        auto future = task->get_future();
+
+        post([task]() { (*task)(); }, batch);
+
+        return future;
+    }
+
+    /**
+     * @brief Aguarda um future executando as tarefas pendentes do mesmo lote
+     * enquanto ele não fica pronto.
+     * * Permite que uma tarefa do pool espere por subtarefas sem bloquear a
+     * sua thread (o que poderia esgotar o pool). Tarefas de outros lotes
+     * nunca são executadas aqui: elas poderiam esperar por um lock mantido
+     * pelo chamador ou atrasá-lo por tempo indeterminado.
+     * @tparam R O tipo do resultado.
+     * @param future O future aguardado.
+     * @param batch O lote ao qual a tarefa do future pertence.
+     * @return R O resultado do future.
+     */
+    template <typename R>
+    R await(std::future<R>& future, const void* batch) {
+        std::function<void()> task;
+
+        while (future.wait_for(std::chrono::seconds(0)) !=
+               std::future_status::ready) {
+            if (batch && take(localIndex(), task, batch))
+                task();
+            else
+                future.wait_for(std::chrono::microseconds(50));
+        }
+
+        return future.get();
+    }
+
+    /**
+     * @brief Retorna o número de threads do pool.
+     * @return size_t O número de threads.
+     */
+    size_t size() const;
+};
+
+#endif
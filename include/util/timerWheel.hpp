@@ -0,0 +1,109 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Roda de temporização (hashed timing wheel) para expiração em lote.
+ * * O tempo é medido em ticks inteiros. Cada chave é agendada no slot
+ * `prazo % numeroDeSlots`; prazos maiores que uma volta completa permanecem
+ * no slot até que o tick correto seja alcançado. Agendar custa O(1) e
+ * avançar custa O(entradas dos slots percorridos).
+ * * A classe não é thread-safe: o chamador deve serializar o acesso.
+ * @tparam Key O tipo da chave agendada.
+ */
+template <typename Key>
+class TimerWheel {
+   private:
+    /**
+     * @brief Entrada de um slot: a chave e o tick absoluto de seu prazo.
+     */
+    using Entry = std::pair<Key, uint64_t>;
+
+    /**
+     * @brief Os slots da roda.
+     */
+    std::vector<std::vector<Entry>> slots;
+
+    /**
+     * @brief O último tick já processado.
+     */
+    uint64_t currentTick;
+
+   public:
+    /**
+     * @brief Função chamada para cada chave cujo prazo venceu.
+     * * Deve retornar 0 para descartar a chave ou um novo tick de prazo para
+     * reagendá-la (ex: a sessão foi usada desde o agendamento).
+     */
+    using ExpireHandler = std::function<uint64_t(const Key&)>;
+
+    /**
+     * @brief Construtor da classe TimerWheel.
+     * @param slotCount O número de slots da roda.
+     * @param startTick O tick inicial.
+     */
+    TimerWheel(size_t slotCount, uint64_t startTick)
+        : slots(slotCount), currentTick(startTick) {}
+
+    /**
+     * @brief Agenda uma chave para expirar no tick informado.
+     * @param key A chave.
+     * @param deadlineTick O tick absoluto do prazo.
+     */
+    void schedule(const Key& key, uint64_t deadlineTick) {
+        if (deadlineTick <= currentTick)
+            deadlineTick = currentTick + 1;
+
+        slots[deadlineTick % slots.size()].emplace_back(key, deadlineTick);
+    }
+
+    /**
+     * @brief Avança a roda até o tick informado, disparando as chaves
+     * vencidas.
+     * * Se o salto for maior que uma volta, cada slot é visitado uma única
+     * vez.
+     * @param nowTick O tick atual.
+     * @param onExpire Função chamada para cada chave vencida.
+     */
+    void advance(uint64_t nowTick, const ExpireHandler& onExpire) {
+        if (nowTick <= currentTick)
+            return;
+
+        uint64_t steps = nowTick - currentTick;
+
+        if (steps > slots.size())
+            steps = slots.size();
+
+        std::vector<Entry> rescheduled;
+
+        for (uint64_t i = 1; i <= steps; ++i) {
+            auto& slot = slots[(currentTick + i) % slots.size()];
+            std::vector<Entry> pending;
+
+            for (auto& entry : slot) {
+                if (entry.second > nowTick) {
+                    pending.push_back(std::move(entry));
+                    continue;
+                }
+
+                uint64_t next = onExpire(entry.first);
+
+                if (next != 0)
+                    rescheduled.emplace_back(std::move(entry.first), next);
+            }
+
+            slot.swap(pending);
+        }
+
+        currentTick = nowTick;
+
+        for (auto& entry : rescheduled)
+            schedule(entry.first, entry.second);
+    }
+};
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef TRACING_HPP
+#define TRACING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Número máximo de spans guardados por thread; os excedentes são
+ * descartados (e contados).
+ */
+#define TRACE_MAX_EVENTS_PER_THREAD 1000000
+
+/**
+ * @brief Identifica a requisição e o span correntes de uma thread.
+ * * Pode ser copiado e levado a outro ponto de execução (ex: um carregamento
+ * preguiçoso) para que os spans de lá sejam associados à requisição de
+ * origem.
+ */
+struct TraceContext {
+    uint64_t request = 0;       /**< A requisição (0 se não houver). */
+    const char* span = nullptr; /**< O nome do span corrente. */
+};
+
+/**
+ * @brief Um span concluído.
+ */
+struct TraceEvent {
+    const char* name;    /**< O nome do span. */
+    const char* origin;  /**< Span de origem do trabalho, ou nullptr. */
+    uint64_t request;    /**< A requisição do span. */
+    uint64_t startNs;    /**< Início, relativo ao início do trace. */
+    uint64_t durationNs; /**< Duração. */
+};
+
+/**
+ * @brief Coletor de spans do processo, exportados no formato de eventos de
+ * trace do Chrome (abre em chrome://tracing ou no Perfetto).
+ * * Desligado por padrão: enquanto inativo, cada span custa uma leitura
+ * atômica. Cada thread grava em um buffer próprio; a exportação junta os
+ * buffers de todas as threads.
+ */
+class Tracer {
+   private:
+    /**
+     * @brief Os spans concluídos de uma thread.
+     */
+    struct Buffer {
+        std::mutex mx;                  /**< Protege os eventos. */
+        std::vector<TraceEvent> events; /**< Os spans. */
+        uint32_t tid;                   /**< Id sequencial da thread. */
+    };
+
+    std::atomic<bool> active{false};      /**< Indica se o trace está ligado. */
+    std::atomic<uint64_t> nextRequest{1}; /**< Próximo id de requisição. */
+    std::atomic<uint64_t> dropped{0};     /**< Spans descartados. */
+    std::chrono::steady_clock::time_point epoch; /**< Início do trace. */
+
+    mutable std::mutex mx; /**< Protege a lista de buffers. */
+    std::vector<std::unique_ptr<Buffer>> buffers;
+
+    /**
+     * @brief O buffer da thread corrente.
+     */
+    static thread_local Buffer* local;
+
+    /**
+     * @brief O contexto da thread corrente.
+     */
+    static thread_local TraceContext current;
+
+    Tracer() = default;
+
+    friend class TraceSpan;
+
+   public:
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    /**
+     * @brief Retorna o coletor do processo.
+     * @return Tracer& O coletor.
+     */
+    static Tracer& instance();
+
+    /**
+     * @brief Liga a coleta, descartando os spans anteriores.
+     */
+    void start();
+
+    /**
+     * @brief Desliga a coleta. Os spans coletados são mantidos.
+     */
+    void stop();
+
+    /**
+     * @brief Indica se a coleta está ligada.
+     * @return bool True se os spans estão sendo registrados.
+     */
+    bool enabled() const {
+        return active.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Retorna o contexto da thread corrente, para propagação.
+     * @return TraceContext O contexto (vazio se não houver span aberto).
+     */
+    static TraceContext context();
+
+    /**
+     * @brief Grava os spans coletados em JSON (Chrome trace-event format).
+     * * Cada span vira um evento completo (`"ph": "X"`) com a requisição e,
+     * quando houver, a origem em `args`.
+     * @param path O caminho do arquivo.
+     * @return bool True se o arquivo foi gravado.
+     */
+    bool write(const std::string& path) const;
+
+    /**
+     * @brief Registra um span concluído no buffer da thread corrente.
+     * @param event O span.
+     */
+    void record(const TraceEvent& event);
+
+    /**
+     * @brief Retorna o tempo decorrido desde o início do trace.
+     * @return uint64_t O tempo em nanossegundos.
+     */
+    uint64_t now() const;
+};
+
+/**
+ * @brief Span de escopo: registra o intervalo entre a construção e a
+ * destruição do objeto.
+ * * O primeiro span aberto em uma thread sem contexto inicia uma nova
+ * requisição; os spans abertos dentro dele ficam aninhados na mesma
+ * requisição.
+ */
+class TraceSpan {
+   private:
+    const char* name;    /**< O nome do span. */
+    const char* origin;  /**< O span de origem, se propagado. */
+    TraceContext saved;  /**< O contexto anterior, restaurado ao final. */
+    uint64_t start = 0;  /**< O início do span. */
+    bool active = false; /**< Se o span está sendo registrado. */
+
+    void open(const TraceContext& parent);
+
+   public:
+    /**
+     * @brief Abre um span no contexto da thread corrente.
+     * @param name O nome do span (deve ter duração estática, ex: literal).
+     */
+    explicit TraceSpan(const char* name);
+
+    /**
+     * @brief Abre um span associado a um contexto capturado em outro ponto.
+     * * Se a thread corrente não tiver requisição, o span adota a do
+     * contexto; em todo caso, o nome do span de origem fica registrado.
+     * @param name O nome do span.
+     * @param parent O contexto capturado com Tracer::context().
+     */
+    TraceSpan(const char* name, const TraceContext& parent);
+
+    ~TraceSpan();
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+/**
+ * @brief Abre um span com o nome dado até o fim do escopo corrente.
+ */
+#define TRACE_SPAN(name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(name)
+
+#endif
@@ -11,6 +11,11 @@
  */
 using Timestamp = std::time_t;
 
+/**
+ * @brief Tamanho do buffer de format_timestamp ("dd/mm HH:MM" e o '\0').
+ */
+#define TIMESTAMP_TEXT_SIZE 12
+
 /**
  * @brief Função utilitária para lidar com exceções na camada Controller.
  * * Imprime uma mensagem de erro formatada no stderr e relança a exceção.
@@ -47,10 +52,11 @@ inline bool is_alphanumeric(const std::string& s) {
 std::string mock_bcrypt(const std::string& pwd, int cost_factor = 12);
 
 /**
- * @brief Verifica se uma senha em texto claro corresponde a um hash simulado.
- * * @param cypher O hash simulado.
+ * @brief Verifica se uma senha em texto claro corresponde a um hash.
+ * * Aceita hashes PBKDF2 (util/kdf.hpp) e os hashes simulados legados.
+ * @param cypher O hash.
  * @param pwd A senha em texto claro (fornecida pelo usuário).
- * @return bool True se a senha corresponder ao hash simulado.
+ * @return bool True se a senha corresponder ao hash.
  */
 bool check(const std::string& cypher, const std::string& pwd);
 
@@ -80,12 +86,67 @@ void desenhar_relogio();
  */
 std::string timestamp_to_string(Timestamp tt);
 
+/**
+ * @brief Formata um timestamp (dd/mm HH:MM, horário local) em um buffer.
+ * * Não aloca e pode ser chamada de várias threads: o deslocamento do fuso é
+ * memoizado por dia em uma tabela de cada thread, e a biblioteca C só é
+ * consultada na primeira vez que um dia aparece.
+ * @param tt O timestamp.
+ * @param out O buffer, com pelo menos TIMESTAMP_TEXT_SIZE bytes; recebe o
+ * texto terminado em '\0'.
+ * @return size_t O tamanho do texto, sem o terminador.
+ */
+size_t format_timestamp(Timestamp tt, char* out);
+
 /**
  * @brief Converte uma string de data e hora em um Timestamp (std::time_t).
- * * A string deve estar no formato esperado (dd/mm HH:MM).
+ * * A string deve estar no formato esperado (dd/mm HH:MM). O ano é inferido
+ * como o da próxima ocorrência da data a partir de `reference`. Não aloca e
+ * pode ser chamada de várias threads.
  * @param date_str A string de data e hora.
- * @return Timestamp O valor de std::time_t correspondente.
+ * @param reference O instante de referência (padrão: agora).
+ * @return Timestamp O valor de std::time_t correspondente, ou -1 se a string
+ * for inválida.
+ */
+Timestamp string_to_timestamp(const std::string& date_str,
+                              Timestamp reference = std::time(nullptr));
+
+/**
+ * @brief Converte o fim de um intervalo (dd/mm HH:MM) cujo início já foi
+ * convertido por string_to_timestamp().
+ * * O ano não é inferido de novo a partir de agora: é o da próxima
+ * ocorrência a partir do dia do início. Assim o fim só muda de ano quando o
+ * intervalo passa da virada (ex: 31/12 23:00 - 01/01 00:30), e um fim
+ * anterior ao início no mesmo dia continua anterior a ele.
+ * @param date_str A string de data e hora do fim.
+ * @param inicio O início do intervalo.
+ * @return Timestamp O fim, ou -1 se a string for inválida.
+ */
+Timestamp string_to_end_timestamp(const std::string& date_str,
+                                  Timestamp inicio);
+
+/**
+ * @brief Converte uma data completa (dd/mm/aaaa) no início do dia, no
+ * horário local.
+ * @param date_str A string da data.
+ * @return Timestamp O início do dia, ou -1 se a data for inválida.
+ */
+Timestamp string_to_date(const std::string& date_str);
+
+/**
+ * @brief Converte uma data e hora do horário local em um Timestamp.
+ * * Um horário repetido na volta do horário de verão fica com a primeira
+ * ocorrência, como no std::mktime.
+ * @return Timestamp O instante, ou -1 se a data não existir.
+ */
+Timestamp local_timestamp(int year, unsigned month, unsigned day,
+                          unsigned hour, unsigned minute);
+
+/**
+ * @brief Retorna o ano de um instante no horário local.
+ * @param tt O instante.
+ * @return int O ano.
  */
-Timestamp string_to_timestamp(const std::string& date_str);
+int local_year(Timestamp tt);
 
 #endif
\ No newline at end of file
@@ -8,6 +8,11 @@
 #include "service/sessionService.hpp"
 #include "view/consoleUI.hpp"
 
+/**
+ * @brief Número de horários por página na busca de horários livres.
+ */
+#define ALUNO_UI_PAGE_SIZE 10
+
 /**
  * @brief Gerencia a Interface de Usuário (UI) para um Aluno logado.
  * * Herda de ConsoleUI e implementa as funcionalidades específicas disponíveis
@@ -26,6 +31,12 @@ class AlunoUI : public ConsoleUI {
      */
     ProfessorController& professorController;
 
+    /**
+     * @brief Referência ao Controller de Horário para buscar horários livres
+     * de todos os professores.
+     */
+    HorarioController& horarioController;
+
     /**
      * @brief Referência ao Controller de Agendamento para criar, visualizar e
      * cancelar agendamentos.
@@ -38,6 +49,20 @@ class AlunoUI : public ConsoleUI {
      */
     void agendar_horario();
 
+    /**
+     * @brief Permite ao aluno buscar os horários livres de todos os
+     * professores em um intervalo de datas, opcionalmente de uma disciplina,
+     * página por página, e agendar um deles.
+     */
+    void buscar_horarios_livres();
+
+    /**
+     * @brief Envia o pedido de agendamento de um horário para o aluno logado
+     * e exibe o resultado.
+     * @param horario O horário escolhido.
+     */
+    void enviar_agendamento(const std::shared_ptr<Horario>& horario);
+
     /**
      * @brief Permite ao aluno modificar seus dados cadastrais (nome, email,
      * senha, matrícula).
@@ -67,10 +92,11 @@ class AlunoUI : public ConsoleUI {
      * gerenciar o estado do usuário logado.
      * @param ac Referência para o AlunoController.
      * @param pc Referência para o ProfessorController.
+     * @param hc Referência para o HorarioController.
      * @param agc Referência para o AgendamentoController.
      * @param ss Ponteiro inteligente para o SessionService.
      */
-    AlunoUI(AlunoController& ac, ProfessorController& pc,
+    AlunoUI(AlunoController& ac, ProfessorController& pc, HorarioController& hc,
             AgendamentoController& agc,
             const std::shared_ptr<SessionService>& ss);
 
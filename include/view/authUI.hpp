@@ -78,7 +78,8 @@ class AuthUI : public ConsoleUI {
     /**
      * @brief Exibe o menu principal de autenticação (Login ou Cadastro) e
      * processa as escolhas.
-     * * Implementação da interface virtual da classe base ConsoleUI.
+     * * Implementação da interface virtual da classe base ConsoleUI. A opção
+     * oculta 3 imprime as métricas do MetricsRegistry.
      * @return bool Retorna true se a UI deve continuar (menu deve ser exibido
      * novamente), false para encerrar o sistema.
      */
@@ -75,6 +75,13 @@ class ProfessorUI : public ConsoleUI {
      */
     bool avaliar_agendamentos();
 
+    /**
+     * @brief Confirma ou recusa, de uma vez, todos os agendamentos listados
+     * na caixa de entrada.
+     * @param agendamentos Os agendamentos pendentes exibidos.
+     */
+    void responder_todos(const Horario::AgendamentoVector& agendamentos);
+
     /**
      * @brief Processa a avaliação (confirmação/recusa) dos agendamentos
      * pendentes.
@@ -1,8 +1,40 @@
 #include "app.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <csignal>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
 
+#include "server/tcpServer.hpp"
+#include "util/academicTerm.hpp"
+#include "util/metrics.hpp"
+
+using std::atomic;
+using std::cerr;
 using std::cout;
+using std::endl;
+using std::invalid_argument;
+using std::sort;
+using std::string;
+using std::thread;
+
+#define METRICS_TEXT_FILE "metrics.txt"
+#define METRICS_PROMETHEUS_FILE "metrics.prom"
+
+// Grava as métricas em texto e no formato do Prometheus (SIGUSR1).
+static void dump_metrics() {
+    const auto& registry = MetricsRegistry::instance();
+
+    if (registry.dump(METRICS_TEXT_FILE, MetricsFormat::TEXT) &&
+        registry.dump(METRICS_PROMETHEUS_FILE, MetricsFormat::PROMETHEUS))
+        cerr << ">> Métricas gravadas em " METRICS_TEXT_FILE " e "
+                METRICS_PROMETHEUS_FILE
+             << endl;
+    else
+        cerr << ">> Falha ao gravar as métricas" << endl;
+}
 
 App::App()
     : connection(),
@@ -20,22 +52,130 @@ App::App()
       agendamentoController(agendamentoService),
       authUI(alunoController, professorController, loginController,
              sessionService),
-      alunoUI(alunoController, professorController, agendamentoController,
-              sessionService),
+      alunoUI(alunoController, professorController, horarioController,
+              agendamentoController, sessionService),
       professorUI(professorController, horarioController, agendamentoController,
                   sessionService) {}
 
 void App::run() {
+    // SIGUSR1 grava as métricas; o sinal é bloqueado antes de qualquer thread
+    // ser criada e atendido por uma thread dedicada, encerrada ao sair.
+    sigset_t sinais;
+    sigemptyset(&sinais);
+    sigaddset(&sinais, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &sinais, nullptr);
+
+    atomic<bool> saindo{false};
+
+    thread despejo([&saindo, sinais]() {
+        int sinal;
+        while (sigwait(&sinais, &sinal) == 0 && !saindo)
+            dump_metrics();
+    });
+
+    auto encerrar_despejo = [&]() {
+        saindo = true;
+        pthread_kill(despejo.native_handle(), SIGUSR1);
+        despejo.join();
+    };
+
     bool keepRunning = true;
 
-    while (keepRunning) {
-        if (sessionService->isProfessor())
-            keepRunning = professorUI.show();
-        else if (sessionService->isAluno())
-            keepRunning = alunoUI.show();
-        else
-            keepRunning = authUI.show();
+    try {
+        while (keepRunning) {
+            if (sessionService->isProfessor())
+                keepRunning = professorUI.show();
+            else if (sessionService->isAluno())
+                keepRunning = alunoUI.show();
+            else
+                keepRunning = authUI.show();
+        }
+    } catch (...) {
+        encerrar_despejo();
+        throw;
     }
 
+    encerrar_despejo();
+
     cout << "\n>> Saindo do programa\n";
-}
\ No newline at end of file
+}
+
+void App::serve(uint16_t port, size_t workers) {
+    // Os sinais de encerramento são bloqueados antes de criar as threads do
+    // servidor (que herdam a máscara) e tratados por uma thread dedicada, que
+    // pede a parada do laço de eventos. SIGUSR1 grava as métricas.
+    sigset_t sinais;
+    sigemptyset(&sinais);
+    sigaddset(&sinais, SIGINT);
+    sigaddset(&sinais, SIGTERM);
+    sigaddset(&sinais, SIGUSR1);
+    pthread_sigmask(SIG_BLOCK, &sinais, nullptr);
+
+    RequestHandler handler(loginController, professorController,
+                           agendamentoController, sessionService);
+    TcpServer server(handler, workers);
+
+    uint16_t porta = server.listen(port);
+    cout << ">> Servidor escutando na porta " << porta << std::endl;
+
+    thread sinalizador([&server, sinais]() {
+        int sinal;
+        while (sigwait(&sinais, &sinal) == 0 && sinal == SIGUSR1)
+            dump_metrics();
+        server.stop();
+    });
+
+    try {
+        server.run();
+    } catch (...) {
+        pthread_kill(sinalizador.native_handle(), SIGTERM);
+        sinalizador.join();
+        throw;
+    }
+
+    sinalizador.join();
+
+    cout << "\n>> Servidor encerrado\n";
+}
+
+size_t App::archive() {
+    AcademicTerm term = current_term();
+    size_t arquivados = horarioService->archiveBefore(term.inicio);
+
+    cout << ">> " << arquivados << " horário(s) encerrado(s) antes de "
+         << timestamp_to_string(term.inicio) << " arquivado(s) em data/"
+         << HORARIO_ARCHIVE_TABLE ".csv" << endl;
+
+    return arquivados;
+}
+
+size_t App::import(const string& tabela, const string& arquivo) {
+    ImportReport report;
+
+    if (tabela == "alunos")
+        report = alunoController.importar(arquivo);
+    else if (tabela == "professores")
+        report = professorController.importar(arquivo);
+    else if (tabela == "horarios")
+        report = horarioController.importar(arquivo);
+    else
+        throw invalid_argument("Tabela desconhecida: " + tabela +
+                               " (use alunos, professores ou horarios).");
+
+    cout << ">> " << report.importados << " registro(s) importado(s) em data/"
+         << tabela << ".csv" << endl;
+
+    if (!report.erros.empty()) {
+        // As linhas são recusadas em etapas diferentes (leitura, validação,
+        // unicidade): a lista é mostrada na ordem do arquivo.
+        sort(report.erros.begin(), report.erros.end());
+
+        cout << ">> " << report.erros.size() << " linha(s) recusada(s):"
+             << endl;
+
+        for (const auto& [linha, erro] : report.erros)
+            cout << "   linha " << linha << ": " << erro << endl;
+    }
+
+    return report.importados;
+}
@@ -5,9 +5,11 @@
 #include "util/utils.hpp"
 
 using std::invalid_argument;
+using std::pair;
 using std::runtime_error;
 using std::shared_ptr;
 using std::to_string;
+using std::vector;
 
 AgendamentoController::AgendamentoController(
     const shared_ptr<AgendamentoService>& service)
@@ -37,6 +39,17 @@ shared_ptr<Agendamento> AgendamentoController::agendarHorario(long alunoID,
     }
 }
 
+shared_ptr<Agendamento> AgendamentoController::read(long id) {
+    try {
+        return agendamentoService->getById(id);
+    } catch (const runtime_error& e) {
+        handle_controller_exception(e,
+                                    "ler agendamento pelo ID " + to_string(id));
+
+        throw;
+    }
+}
+
 void AgendamentoController::cancelar(long agendamentoId) {
     try {
         agendamentoService->updateStatusById(agendamentoId, Status::CANCELADO);
@@ -66,4 +79,65 @@ void AgendamentoController::recusar(long agendamentoId) {
             e, "recusar agendamento com ID " + to_string(agendamentoId));
         throw;
     }
+}
+
+Horario::AgendamentoView AgendamentoController::listarPendentes(
+    long idProfessor) {
+    try {
+        return agendamentoService->listPendentesByIdProfessor(idProfessor);
+    } catch (const runtime_error& e) {
+        handle_controller_exception(
+            e, "listar pendentes do professor com ID " +
+                   to_string(idProfessor));
+        throw;
+    }
+}
+
+AgendamentoPage AgendamentoController::listarPorAluno(
+    long idAluno, const AgendamentoCursor& after, size_t limite) {
+    try {
+        return agendamentoService->listPageByIdAluno(idAluno, after, limite);
+    } catch (const invalid_argument& e) {
+        handle_controller_exception(
+            e, "listar agendamentos do aluno com ID " + to_string(idAluno));
+        throw;
+    } catch (const runtime_error& e) {
+        handle_controller_exception(
+            e, "listar agendamentos do aluno com ID " + to_string(idAluno));
+        throw;
+    }
+}
+
+vector<StatusUpdateResult> AgendamentoController::confirmarPendentes(
+    long idProfessor, const vector<long>& ids) {
+    try {
+        return agendamentoService->updateStatusPendentes(idProfessor, ids,
+                                                         Status::CONFIRMADO);
+    } catch (const runtime_error& e) {
+        handle_controller_exception(e, "confirmar agendamentos pendentes");
+        throw;
+    }
+}
+
+vector<StatusUpdateResult> AgendamentoController::recusarPendentes(
+    long idProfessor, const vector<long>& ids) {
+    try {
+        return agendamentoService->updateStatusPendentes(idProfessor, ids,
+                                                         Status::RECUSADO);
+    } catch (const runtime_error& e) {
+        handle_controller_exception(e, "recusar agendamentos pendentes");
+        throw;
+    }
+}
+
+vector<StatusUpdateResult> AgendamentoController::alterarStatusEmLote(
+    const vector<pair<long, Status>>& mudancas) {
+    try {
+        return agendamentoService->updateStatusByIds(mudancas);
+    } catch (const runtime_error& e) {
+        handle_controller_exception(
+            e, "alterar o status de " + to_string(mudancas.size()) +
+                   " agendamento(s)");
+        throw;
+    }
 }
\ No newline at end of file
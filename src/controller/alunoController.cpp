@@ -1,12 +1,48 @@
 #include "controller/alunoController.hpp"
 
+#include "util/kdf.hpp"
 #include "util/utils.hpp"
 
+using std::exception;
 using std::invalid_argument;
 using std::runtime_error;
 using std::shared_ptr;
+using std::stol;
 using std::string;
 using std::to_string;
+using std::vector;
+
+static void validar_cadastro(const string& nome, const string& email,
+                             const string& senha, long matricula) {
+    if (nome.empty() || nome.length() < 3) {
+        throw invalid_argument("O nome deve ter pelo menos 3 caracteres.");
+    }
+    if (email.find('@') == string::npos || email.find('.') == string::npos) {
+        throw invalid_argument("Formato de email inválido.");
+    }
+    if (senha.length() < 4) {
+        throw invalid_argument("A senha deve ter pelo menos 4 caracteres.");
+    }
+    if (!is_alphanumeric(senha)) {
+        throw invalid_argument("A senha deve conter apenas letras e números.");
+    }
+    if (matricula <= 0) {
+        throw invalid_argument("A matrícula deve ser um número positivo.");
+    }
+}
+
+static long parse_matricula(const string& value) {
+    size_t pos = 0;
+    long matricula = 0;
+
+    try {
+        matricula = stol(value, &pos);
+    } catch (const exception&) {
+        pos = 0;
+    }
+
+    return pos == value.size() ? matricula : 0;
+}
 
 AlunoController::AlunoController(const shared_ptr<AlunoService>& service)
     : service(service) {}
@@ -15,25 +51,9 @@ shared_ptr<Aluno> AlunoController::create(const string& nome,
                                           const string& email,
                                           const string& senha, long matricula) {
     try {
-        if (nome.empty() || nome.length() < 3) {
-            throw invalid_argument("O nome deve ter pelo menos 3 caracteres.");
-        }
-        if (email.find('@') == string::npos ||
-            email.find('.') == string::npos) {
-            throw invalid_argument("Formato de email inválido.");
-        }
-        if (senha.length() < 4) {
-            throw invalid_argument("A senha deve ter pelo menos 4 caracteres.");
-        }
-        if (!is_alphanumeric(senha)) {
-            throw invalid_argument(
-                "A senha deve conter apenas letras e números.");
-        }
-        if (matricula <= 0) {
-            throw invalid_argument("A matrícula deve ser um número positivo.");
-        }
+        validar_cadastro(nome, email, senha, matricula);
 
-        return service->save(nome, email, mock_bcrypt(senha), matricula);
+        return service->save(nome, email, hash_password(senha), matricula);
 
     } catch (const invalid_argument& e) {
         handle_controller_exception(e, "validar novos dados do Aluno");
@@ -94,7 +114,7 @@ shared_ptr<Aluno> AlunoController::update(long id, const string& nome,
                 throw invalid_argument(
                     "A nova senha deve conter apenas letras e números...");
             }
-            newSenha = mock_bcrypt(senha);
+            newSenha = hash_password(senha);
         }
 
         long newMatricula = (matricula <= 0) ? late->getMatricula() : matricula;
@@ -129,4 +149,38 @@ bool AlunoController::destroy(long id) {
         handle_controller_exception(e, "excluir Aluno com ID " + to_string(id));
         throw;
     }
-}
\ No newline at end of file
+}
+
+ImportReport AlunoController::importar(const string& arquivo) {
+    try {
+        ImportReport report;
+        vector<ImportRow> validas;
+
+        for (auto& row : read_import_file(arquivo, 4, report)) {
+            long matricula = parse_matricula(row.campos[3]);
+
+            try {
+                validar_cadastro(row.campos[0], row.campos[1], row.campos[2],
+                                 matricula);
+            } catch (const invalid_argument& e) {
+                report.recusar(row.linha, e.what());
+                continue;
+            }
+
+            row.campos[3] = to_string(matricula);
+            validas.push_back(std::move(row));
+        }
+
+        // O hash é a etapa mais cara da importação: é feito em paralelo, e
+        // só para as linhas que passaram pela verificação de unicidade.
+        service->saveAll(validas, report, [](vector<ImportRow>& aceitas) {
+            hash_import_passwords(aceitas, 2);
+        });
+
+        return report;
+    } catch (const runtime_error& e) {
+        handle_controller_exception(e, "importar Alunos de " + arquivo);
+
+        throw;
+    }
+}
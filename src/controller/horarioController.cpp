@@ -4,6 +4,9 @@
 
 using std::exception;
 using std::shared_ptr;
+using std::string;
+using std::to_string;
+using std::vector;
 
 HorarioController::HorarioController(const shared_ptr<HorarioService>& service)
     : service(service) {}
@@ -25,4 +28,50 @@ bool HorarioController::excluirTodosPorProfessor(long idProfessor) {
 
 bool HorarioController::excluirPorId(long idHorario) {
     return service->deleteById(idHorario);
-}
\ No newline at end of file
+}
+
+HorarioPage HorarioController::buscarDisponiveis(Timestamp inicio,
+                                                 Timestamp fim,
+                                                 const string& disciplina,
+                                                 const TimeIndex::Cursor& after,
+                                                 size_t limite) {
+    try {
+        return service->listDisponiveisBetween(inicio, fim, disciplina, after,
+                                               limite);
+    } catch (const exception& e) {
+        handle_controller_exception(e, "buscar horários disponíveis");
+        throw;
+    }
+}
+
+ImportReport HorarioController::importar(const string& arquivo) {
+    try {
+        ImportReport report;
+        vector<ImportRow> validas;
+
+        for (auto& row : read_import_file(arquivo, 3, report)) {
+            Timestamp inicio = string_to_timestamp(row.campos[1]);
+            Timestamp fim = -1;
+
+            if (inicio != -1)
+                fim = string_to_end_timestamp(row.campos[2], inicio);
+
+            if (inicio == -1 || fim == -1) {
+                report.recusar(row.linha, "Data e hora inválidas (use dd/mm "
+                                          "HH:MM).");
+                continue;
+            }
+
+            row.campos[1] = to_string(inicio);
+            row.campos[2] = to_string(fim);
+            validas.push_back(std::move(row));
+        }
+
+        service->saveAll(validas, report);
+
+        return report;
+    } catch (const exception& e) {
+        handle_controller_exception(e, "importar Horários de " + arquivo);
+        throw;
+    }
+}
@@ -1,38 +1,117 @@
 #include "controller/loginController.hpp"
 
+#include <algorithm>
+#include <cctype>
+
 #include "event/events.hpp"
+#include "util/kdf.hpp"
+#include "util/passwordVerifier.hpp"
+#include "util/tracing.hpp"
 #include "util/utils.hpp"
 
+using std::cerr;
+using std::endl;
+using std::exception;
+using std::function;
 using std::invalid_argument;
+using std::lock_guard;
+using std::mutex;
 using std::runtime_error;
 using std::shared_ptr;
 using std::string;
+using std::transform;
+using std::unique_lock;
 
 LoginController::LoginController(
     const shared_ptr<AlunoService>& alunoService,
     const shared_ptr<ProfessorService>& professorService, EventBus& bus)
     : alunoService(alunoService),
       professorService(professorService),
-      bus(bus) {}
+      bus(bus),
+      limiter(LOGIN_EMAIL_RATE, LOGIN_EMAIL_BURST, LOGIN_GLOBAL_RATE,
+              LOGIN_GLOBAL_BURST) {}
+
+LoginController::~LoginController() {
+    unique_lock<mutex> lock(rehashMx);
+    rehashDone.wait(lock, [this]() { return rehashing.empty(); });
+}
+
+void LoginController::admit(const string& email) {
+    string key = email;
+    transform(key.begin(), key.end(), key.begin(),
+              [](unsigned char c) { return tolower(c); });
+
+    if (!limiter.allow(key))
+        throw LoginRateLimited(
+            "Muitas tentativas de login. Aguarde alguns segundos e tente "
+            "novamente.");
+}
+
+void LoginController::scheduleRehash(const string& cypher,
+                                     const string& senha,
+                                     function<void(const string&)> store) {
+    if (!kdf_needs_rehash(cypher))
+        return;
+
+    {
+        lock_guard<mutex> lock(rehashMx);
+
+        // Acima do limite, o rehash fica para um próximo login: os trabalhos
+        // de post() não contam para a capacidade do PasswordVerifier e
+        // disputariam as suas threads com as verificações.
+        if (rehashing.size() >= LOGIN_REHASH_CAPACITY ||
+            !rehashing.insert(cypher).second)
+            return;
+    }
+
+    TraceContext origin = Tracer::context();
+
+    PasswordVerifier::shared().post([this, cypher, senha, store, origin]() {
+        TraceSpan span("LoginController::rehash", origin);
+
+        try {
+            store(hash_password(senha));
+        } catch (const exception& e) {
+            cerr << "\n[ERRO] Falha ao atualizar o hash de senha: " << e.what()
+                 << endl;
+        }
+
+        lock_guard<mutex> lock(rehashMx);
+        rehashing.erase(cypher);
+        rehashDone.notify_all();
+    });
+}
 
 shared_ptr<Aluno> LoginController::loginAluno(string email, string senha) {
     try {
+        admit(email);
+
         auto aluno = alunoService->getOneByEmail(email);
 
         if (!aluno) {
             throw invalid_argument("Senha e/ou email inválidos.");
         }
 
-        if (!check(aluno->getSenha(), senha)) {
+        if (!PasswordVerifier::shared().verify(aluno->getSenha(), senha)) {
             throw invalid_argument("Senha e/ou email inválidos.");
         }
 
         bus.publish(AlunoLoggedInEvent(aluno->getId()));
 
+        scheduleRehash(aluno->getSenha(), senha,
+                       [service = alunoService, id = aluno->getId(),
+                        cypher = aluno->getSenha()](const string& novo) {
+                           service->updateSenhaById(id, cypher, novo);
+                       });
+
         return aluno;
     } catch (const invalid_argument& e) {
         handle_controller_exception(e, "validar autenticação");
 
+        throw;
+    } catch (const LoginRateLimited& e) {
+        handle_controller_exception(e, "admitir a tentativa de login");
+
         throw;
     } catch (const runtime_error& e) {
         handle_controller_exception(e, "resgatar aluno do serviço");
@@ -44,22 +123,35 @@ shared_ptr<Aluno> LoginController::loginAluno(string email, string senha) {
 shared_ptr<Professor> LoginController::loginProfessor(string email,
                                                       string senha) {
     try {
+        admit(email);
+
         auto professor = professorService->getOneByEmail(email);
 
         if (!professor) {
             throw invalid_argument("Senha e/ou email inválidos.");
         }
 
-        if (!check(professor->getSenha(), senha)) {
+        if (!PasswordVerifier::shared().verify(professor->getSenha(),
+                                               senha)) {
             throw invalid_argument("Senha e/ou email inválidos.");
         }
 
         bus.publish(ProfessorLoggedInEvent(professor->getId()));
 
+        scheduleRehash(professor->getSenha(), senha,
+                       [service = professorService, id = professor->getId(),
+                        cypher = professor->getSenha()](const string& novo) {
+                           service->updateSenhaById(id, cypher, novo);
+                       });
+
         return professor;
     } catch (const invalid_argument& e) {
         handle_controller_exception(e, "validar autenticação");
 
+        throw;
+    } catch (const LoginRateLimited& e) {
+        handle_controller_exception(e, "admitir a tentativa de login");
+
         throw;
     } catch (const runtime_error& e) {
         handle_controller_exception(e, "resgatar professor do serviço");
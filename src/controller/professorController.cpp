@@ -1,5 +1,6 @@
 #include "controller/professorController.hpp"
 
+#include "util/kdf.hpp"
 #include "util/utils.hpp"
 
 using std::invalid_argument;
@@ -9,6 +10,26 @@ using std::string;
 using std::to_string;
 using std::vector;
 
+static void validar_cadastro(const string& nome, const string& email,
+                             const string& senha, const string& disciplina) {
+    if (nome.empty() || nome.length() < 3) {
+        throw invalid_argument("O nome deve ter pelo menos 3 caracteres.");
+    }
+    if (email.find('@') == string::npos || email.find('.') == string::npos) {
+        throw invalid_argument("Formato de email inválido.");
+    }
+    if (senha.length() < 4) {
+        throw invalid_argument("A senha deve ter pelo menos 4 caracteres.");
+    }
+    if (!is_alphanumeric(senha)) {
+        throw invalid_argument("A senha deve conter apenas letras e números.");
+    }
+    if (disciplina.empty() || disciplina.length() < 3) {
+        throw invalid_argument(
+            "A disciplina deve ter pelo menos 3 caracteres.");
+    }
+}
+
 ProfessorController::ProfessorController(
     const shared_ptr<ProfessorService>& service)
     : service(service) {}
@@ -18,26 +39,9 @@ shared_ptr<Professor> ProfessorController::create(const string& nome,
                                                   const string& senha,
                                                   const string& disciplina) {
     try {
-        if (nome.empty() || nome.length() < 3) {
-            throw invalid_argument("O nome deve ter pelo menos 3 caracteres.");
-        }
-        if (email.find('@') == string::npos ||
-            email.find('.') == string::npos) {
-            throw invalid_argument("Formato de email inválido.");
-        }
-        if (senha.length() < 4) {
-            throw invalid_argument("A senha deve ter pelo menos 4 caracteres.");
-        }
-        if (!is_alphanumeric(senha)) {
-            throw invalid_argument(
-                "A senha deve conter apenas letras e números.");
-        }
-        if (disciplina.empty() || disciplina.length() < 3) {
-            throw invalid_argument(
-                "A disciplina deve ter pelo menos 3 caracteres.");
-        }
+        validar_cadastro(nome, email, senha, disciplina);
 
-        return service->save(nome, email, mock_bcrypt(senha), disciplina);
+        return service->save(nome, email, hash_password(senha), disciplina);
 
     } catch (const invalid_argument& e) {
         handle_controller_exception(e, "validar novos dados do Professor");
@@ -76,6 +80,21 @@ vector<shared_ptr<Professor>> ProfessorController::list() {
     }
 }
 
+ProfessorPage ProfessorController::listPage(const ProfessorCursor& after,
+                                            size_t limit) {
+    try {
+        return service->listPage(after, limit);
+    } catch (const invalid_argument& e) {
+        handle_controller_exception(e, "listar uma página de Professores");
+
+        throw;
+    } catch (const runtime_error& e) {
+        handle_controller_exception(e, "listar uma página de Professores");
+
+        throw;
+    }
+}
+
 shared_ptr<Professor> ProfessorController::update(long id, const string& nome,
                                                   const string& email,
                                                   const string& senha,
@@ -111,7 +130,7 @@ shared_ptr<Professor> ProfessorController::update(long id, const string& nome,
                 throw invalid_argument(
                     "A nova senha deve conter apenas letras e números...");
             }
-            newSenha = mock_bcrypt(senha);
+            newSenha = hash_password(senha);
         }
 
         string newDisciplina =
@@ -153,4 +172,35 @@ bool ProfessorController::destroy(long id) {
 
         throw;
     }
-}
\ No newline at end of file
+}
+
+ImportReport ProfessorController::importar(const string& arquivo) {
+    try {
+        ImportReport report;
+        vector<ImportRow> validas;
+
+        for (auto& row : read_import_file(arquivo, 4, report)) {
+            try {
+                validar_cadastro(row.campos[0], row.campos[1], row.campos[2],
+                                 row.campos[3]);
+            } catch (const invalid_argument& e) {
+                report.recusar(row.linha, e.what());
+                continue;
+            }
+
+            validas.push_back(std::move(row));
+        }
+
+        // O hash é a etapa mais cara da importação: é feito em paralelo, e
+        // só para as linhas que passaram pela verificação de unicidade.
+        service->saveAll(validas, report, [](vector<ImportRow>& aceitas) {
+            hash_import_passwords(aceitas, 2);
+        });
+
+        return report;
+    } catch (const runtime_error& e) {
+        handle_controller_exception(e, "importar Professores de " + arquivo);
+
+        throw;
+    }
+}
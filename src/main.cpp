@@ -1,11 +1,127 @@
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "app.hpp"
+#include "util/academicTerm.hpp"
+#include "util/kdf.hpp"
+#include "util/tracing.hpp"
+
+#define MAX_WORKERS 1024
+
+// Converte um argumento inteiro, recusando texto extra e valores fora de
+// [minimo, maximo].
+static bool parse_number(const std::string& texto, long minimo, long maximo,
+                         long& valor) {
+    try {
+        size_t lidos = 0;
+        valor = std::stol(texto, &lidos);
+
+        return lidos == texto.size() && valor >= minimo && valor <= maximo;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    std::string tracePath;
+
+    // --trace <arquivo> grava os spans de cada ação ao sair (formato de trace
+    // do Chrome).
+    auto trace = std::find(args.begin(), args.end(), "--trace");
+    if (trace != args.end() && trace + 1 != args.end()) {
+        tracePath = *(trace + 1);
+        args.erase(trace, trace + 2);
+        Tracer::instance().start();
+    }
+
+    // --kdf-iterations <n> fixa o custo dos novos hashes de senha em vez de
+    // usar o calibrado; hashes com menos iterações são refeitos no próximo
+    // login.
+    auto kdf = std::find(args.begin(), args.end(), "--kdf-iterations");
+    if (kdf != args.end() && kdf + 1 != args.end()) {
+        long iteracoes;
+
+        if (!parse_number(*(kdf + 1), 1, UINT32_MAX, iteracoes)) {
+            std::cerr << "[ERRO] Uso: --kdf-iterations <n>, com n inteiro "
+                         "positivo."
+                      << std::endl;
+            return 1;
+        }
+
+        set_kdf_iterations(static_cast<uint32_t>(iteracoes));
+        args.erase(kdf, kdf + 2);
+    }
+
+    // --periodo <dd/mm/aaaa> <dd/mm/aaaa> define o período letivo corrente
+    // (padrão: o semestre civil de hoje).
+    auto periodo = std::find(args.begin(), args.end(), "--periodo");
+    if (periodo != args.end() && args.end() - periodo > 2) {
+        Timestamp inicio = string_to_date(*(periodo + 1));
+        Timestamp fim = string_to_date(*(periodo + 2));
+
+        if (inicio == (Timestamp)-1 || fim == (Timestamp)-1 || fim <= inicio) {
+            std::cerr << "[ERRO] Período letivo inválido." << std::endl;
+            return 1;
+        }
+
+        set_term_window(inicio, fim);
+        args.erase(periodo, periodo + 3);
+    }
 
-int main() {
     App app;
+    int status = 0;
+
+    if (!args.empty() && args[0] == "--arquivar") {
+        app.archive();
+    } else if (!args.empty() && args[0] == "--importar") {
+        // --importar <alunos|professores|horarios> <arquivo.csv>
+        try {
+            if (args.size() != 3)
+                throw std::invalid_argument(
+                    "Uso: --importar <alunos|professores|horarios> "
+                    "<arquivo.csv>");
+
+            app.import(args[1], args[2]);
+        } catch (const std::exception& e) {
+            std::cerr << "[ERRO] " << e.what() << std::endl;
+            status = 1;
+        }
+    } else if (!args.empty() && args[0] == "--server") {
+        // --server [porta] [threads]
+        long port = 5050, workers = 0;
+
+        if ((args.size() > 1 && !parse_number(args[1], 0, UINT16_MAX, port)) ||
+            (args.size() > 2 &&
+             !parse_number(args[2], 0, MAX_WORKERS, workers)) ||
+            args.size() > 3) {
+            std::cerr << "[ERRO] Uso: --server [porta] [threads], com porta "
+                         "entre 0 e 65535 e até "
+                      << MAX_WORKERS << " threads." << std::endl;
+            return 1;
+        }
+
+        try {
+            app.serve(static_cast<uint16_t>(port), workers);
+        } catch (const std::exception& e) {
+            std::cerr << "[ERRO] " << e.what() << std::endl;
+            status = 1;
+        }
+    } else {
+        app.run();
+    }
+
+    if (!tracePath.empty()) {
+        Tracer::instance().stop();
 
-    app.run();
+        if (!Tracer::instance().write(tracePath))
+            std::cerr << "[ERRO] Falha ao gravar o trace em " << tracePath
+                      << std::endl;
+    }
 
-    return 0;
+    return status;
 }
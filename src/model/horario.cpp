@@ -7,15 +7,22 @@ using std::shared_ptr;
 using std::string;
 
 Horario::Horario(long id, long idProfessor, Timestamp inicio, Timestamp fim,
-                 bool disponivel, const ProfessorLoader& profLoader,
+                 bool disponivel, long versao,
+                 const ProfessorLoader& profLoader,
                  const AgendamentosLoader& agLoader)
     : id(id),
       idProfessor(idProfessor),
       inicio(inicio),
       fim(fim),
       disponivel(disponivel),
+      versao(versao),
       professorLoader(profLoader),
-      agendamentos(agLoader, id) {}
+      agendamentos(
+          agLoader, id,
+          [](const Agendamento& agendamento) {
+              return static_cast<size_t>(agendamento.getStatus());
+          },
+          STATUS_COUNT) {}
 
 long Horario::getId() const {
     return id;
@@ -37,6 +44,10 @@ bool Horario::isDisponivel() const {
     return disponivel;
 }
 
+long Horario::getVersao() const {
+    return versao;
+}
+
 string Horario::getInicioStr() const {
     return timestamp_to_string(inicio);
 }
@@ -51,29 +62,16 @@ shared_ptr<Professor> Horario::getProfessor() {
     return nullptr;
 }
 
-Horario::AgendamentoVector Horario::getAgendamentosPendentes() {
-    AgendamentoVector pendentes(agendamentos.begin(), agendamentos.end());
-
-    pendentes.erase(remove_if(pendentes.begin(), pendentes.end(),
-                              [](shared_ptr<Agendamento> ag) {
-                                  return ag->getStatus() != Status::PENDENTE;
-                              }),
-                    pendentes.end());
-
-    return pendentes;
+Horario::AgendamentoList& Horario::getAgendamentos() {
+    return agendamentos;
 }
 
-Horario::AgendamentoVector Horario::getAgendamentosConfirmados() {
-    AgendamentoVector confirmados(agendamentos.begin(), agendamentos.end());
-
-    confirmados.erase(remove_if(confirmados.begin(), confirmados.end(),
-                                [](shared_ptr<Agendamento> ag) {
-                                    return ag->getStatus() !=
-                                           Status::CONFIRMADO;
-                                }),
-                      confirmados.end());
+Horario::AgendamentoView Horario::getAgendamentosPendentes() {
+    return agendamentos.view(static_cast<size_t>(Status::PENDENTE));
+}
 
-    return confirmados;
+Horario::AgendamentoView Horario::getAgendamentosConfirmados() {
+    return agendamentos.view(static_cast<size_t>(Status::CONFIRMADO));
 }
 
 void Horario::setId(long id) {
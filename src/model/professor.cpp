@@ -1,19 +1,30 @@
 #include "model/professor.hpp"
 
-#include <algorithm>
-
 #include "model/horario.hpp"
+#include "util/academicTerm.hpp"
 
-using std::remove_if;
-using std::shared_ptr;
 using std::string;
 
+#define DISPONIVEIS_VIEW 0
+#define OCUPADOS_VIEW 1
+#define HORARIO_VIEWS 2
+
 Professor::Professor(long id, const string& nome, const string& email,
                      const string& senha, string disciplina,
                      const HorariosLoader& loader)
     : Usuario(id, nome, email, senha),
       disciplina(disciplina),
-      horarios(loader, id) {}
+      horarios(
+          loader, id,
+          // A lista começa no período letivo corrente (ver
+          // EntityManager::getHorarioListLoader()): um horário anterior a ele
+          // fica fora das visões e não entra na lista.
+          [inicio = current_term().inicio](const Horario& horario) -> size_t {
+              if (horario.getInicio() < inicio)
+                  return HORARIO_VIEWS;
+              return horario.isDisponivel() ? DISPONIVEIS_VIEW : OCUPADOS_VIEW;
+          },
+          HORARIO_VIEWS) {}
 
 const string& Professor::getDisciplina() const {
     return disciplina;
@@ -27,28 +38,12 @@ Professor::HorarioList& Professor::getHorarios() {
     return horarios;
 }
 
-Professor::HorarioVector Professor::getHorariosDisponiveis() {
-    HorarioVector disponiveis(horarios.begin(), horarios.end());
-
-    disponiveis.erase(remove_if(disponiveis.begin(), disponiveis.end(),
-                                [](shared_ptr<Horario> horario) {
-                                    return !horario->isDisponivel();
-                                }),
-                      disponiveis.end());
-
-    return disponiveis;
+Professor::HorarioView Professor::getHorariosDisponiveis() {
+    return horarios.view(DISPONIVEIS_VIEW);
 }
 
-Professor::HorarioVector Professor::getHorariosOcupados() {
-    HorarioVector ocupados(horarios.begin(), horarios.end());
-
-    ocupados.erase(remove_if(ocupados.begin(), ocupados.end(),
-                             [](shared_ptr<Horario> horario) {
-                                 return horario->isDisponivel();
-                             }),
-                   ocupados.end());
-
-    return ocupados;
+Professor::HorarioView Professor::getHorariosOcupados() {
+    return horarios.view(OCUPADOS_VIEW);
 }
 
 bool Professor::operator<(const Professor& other) const {
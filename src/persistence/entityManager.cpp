@@ -5,6 +5,7 @@
 #include "service/horarioService.hpp"
 #include "service/professorService.hpp"
 #include "service/sessionService.hpp"
+#include "util/tracing.hpp"
 
 using std::make_shared;
 using std::shared_ptr;
@@ -16,19 +17,38 @@ EntityManager::EntityManager(const MockConnection& conn, EventBus& bus) {
     agendamentoService = make_shared<AgendamentoService>(this, conn, bus);
     sessionService = make_shared<SessionService>(this, bus);
 
-    alunoLoader = [this](long id) { return alunoService->getById(id); };
-    professorLoader = [this](long id) { return professorService->getById(id); };
-    horarioLoader = [this](long id) { return horarioService->getById(id); };
+    // Cada loader abre um span próprio, para que os carregamentos
+    // preguiçosos apareçam no trace separados da consulta que os originou.
+    alunoLoader = [this](long id) {
+        TRACE_SPAN("EntityManager::alunoLoader");
+        return alunoService->getById(id);
+    };
+
+    professorLoader = [this](long id) {
+        TRACE_SPAN("EntityManager::professorLoader");
+        return professorService->getById(id);
+    };
+
+    horarioLoader = [this](long id) {
+        TRACE_SPAN("EntityManager::horarioLoader");
+        return horarioService->getById(id);
+    };
 
+    // A lista de horários do professor só inclui o período letivo corrente
+    // e os seguintes; horários antigos ficam fora das telas e das buscas por
+    // disponibilidade.
     horarioListLoader = [this](long professorId) {
-        return horarioService->listByIdProfessor(professorId);
+        TRACE_SPAN("EntityManager::horarioListLoader");
+        return horarioService->listCurrentByIdProfessor(professorId);
     };
 
     alunoAgendamentosLoader = [this](long alunoId) {
+        TRACE_SPAN("EntityManager::alunoAgendamentosLoader");
         return agendamentoService->listByIdAluno(alunoId);
     };
 
     horarioAgendamentosLoader = [this](long horarioId) {
+        TRACE_SPAN("EntityManager::horarioAgendamentosLoader");
         return agendamentoService->listByIdHorario(horarioId);
     };
 }
@@ -0,0 +1,93 @@
+#include "persistence/intervalIndex.hpp"
+
+#include <algorithm>
+#include <limits>
+
+using std::max;
+using std::numeric_limits;
+using std::vector;
+
+void IntervalIndex::clear() {
+    owners.clear();
+    byId.clear();
+}
+
+void IntervalIndex::insert(long owner, long id, Timestamp inicio,
+                           Timestamp fim) {
+    erase(id);
+
+    Owner& o = owners[owner];
+    Key key{inicio, id};
+
+    o.intervals[key] = fim;
+    o.maxLength = max(o.maxLength, fim - inicio);
+
+    byId[id] = {owner, key};
+}
+
+bool IntervalIndex::erase(long id) {
+    auto it = byId.find(id);
+
+    if (it == byId.end())
+        return false;
+
+    auto owner = owners.find(it->second.first);
+    owner->second.intervals.erase(it->second.second);
+
+    // A maior duração só é recalculada quando o dono fica vazio; um valor
+    // maior que o real apenas alarga a janela de busca.
+    if (owner->second.intervals.empty())
+        owners.erase(owner);
+
+    byId.erase(it);
+
+    return true;
+}
+
+size_t IntervalIndex::eraseOwner(long owner) {
+    auto it = owners.find(owner);
+
+    if (it == owners.end())
+        return 0;
+
+    size_t count = it->second.intervals.size();
+
+    for (const auto& interval : it->second.intervals)
+        byId.erase(interval.first.second);
+
+    owners.erase(it);
+
+    return count;
+}
+
+vector<long> IntervalIndex::overlapping(long owner, Timestamp inicio,
+                                        Timestamp fim, long except) const {
+    vector<long> ids;
+
+    auto it = owners.find(owner);
+
+    if (it == owners.end() || fim <= inicio)
+        return ids;
+
+    const Owner& o = it->second;
+
+    // Um intervalo com início até `inicio - maxLength` termina antes de
+    // `inicio`.
+    Timestamp from = inicio - o.maxLength;
+    auto interval =
+        o.intervals.upper_bound({from, numeric_limits<long>::max()});
+
+    for (; interval != o.intervals.end() && interval->first.first < fim;
+         ++interval) {
+        long id = interval->first.second;
+
+        if (interval->second > inicio && id != except)
+            ids.push_back(id);
+    }
+
+    return ids;
+}
+
+size_t IntervalIndex::size() const {
+    return byId.size();
+}
@@ -1,6 +1,11 @@
 #include "persistence/mockConnection.hpp"
 
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 #include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <limits>
@@ -8,20 +13,92 @@
 #include <stdexcept>
 #include <vector>
 
+#include "util/metrics.hpp"
+#include "util/parallel.hpp"
+#include "util/tracing.hpp"
+
+using std::atomic_load;
+using std::atomic_store;
+using std::defer_lock;
 using std::exception;
+using std::function;
 using std::getline;
 using std::ifstream;
 using std::invalid_argument;
 using std::ios;
+using std::lock_guard;
+using std::logic_error;
+using std::make_pair;
+using std::make_shared;
+using std::make_unique;
+using std::map;
+using std::memory_order_relaxed;
+using std::move;
+using std::mutex;
+using std::nullopt;
+using std::numeric_limits;
 using std::ofstream;
+using std::optional;
+using std::pair;
 using std::runtime_error;
+using std::shared_lock;
+using std::shared_mutex;
+using std::shared_ptr;
+using std::sort;
 using std::stol;
 using std::string;
 using std::stringstream;
 using std::to_string;
+using std::try_to_lock;
+using std::uintmax_t;
+using std::unique_lock;
 using std::vector;
 
+namespace fs = std::filesystem;
+
 #define DATA_PATH_PREFIX "data/"
+#define TEMP_SUFFIX ".tmp"
+
+// O diário do commit de uma transação: os nomes das tabelas cujos arquivos
+// temporários já podem substituir os originais.
+#define JOURNAL_PATH DATA_PATH_PREFIX "transacao.log"
+
+// Serializa o uso do diário pelos commits.
+static mutex journalMx;
+
+// O horário de modificação (em ns) e o tamanho de um arquivo, com uma única
+// chamada a stat() (o mínimo e 0 se ele não existir).
+static pair<int64_t, uintmax_t> stamp(const string& filename) {
+    struct stat info;
+
+    if (::stat(filename.c_str(), &info) < 0)
+        return {numeric_limits<int64_t>::min(), 0};
+
+    return {info.st_mtim.tv_sec * 1000000000LL + info.st_mtim.tv_nsec,
+            static_cast<uintmax_t>(info.st_size)};
+}
+
+// Sincroniza um arquivo, ou as entradas de um diretório, com o disco.
+static void syncPath(const string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd < 0)
+        throw runtime_error("Não foi possível abrir '" + path +
+                            "' para sincronizar.");
+
+    int result = ::fsync(fd);
+    ::close(fd);
+
+    if (result != 0)
+        throw runtime_error("Falha ao sincronizar '" + path +
+                            "' com o disco.");
+}
+
+// Retorna um contador rotulado com o nome da tabela.
+static Counter& counter(const string& family, const string& table_name) {
+    return MetricsRegistry::instance().counter(family,
+                                               "table=\"" + table_name + "\"");
+}
 
 string getFullFilePath(const string& table_name) {
     return DATA_PATH_PREFIX + table_name + ".csv";
@@ -55,7 +132,14 @@ long getIdFromLine(const string& line) {
     }
 }
 
-vector<string> readAllLines(const string& filename) {
+TableCounters::TableCounters(const string& table_name)
+    : bytesRead(counter("appointment_table_bytes_read_total", table_name)),
+      bytesWritten(
+          counter("appointment_table_bytes_written_total", table_name)),
+      linesParsed(counter("appointment_table_lines_parsed_total", table_name)),
+      rewrites(counter("appointment_table_rewrites_total", table_name)) {}
+
+vector<string> readAllLines(const string& filename, TableCounters& counters) {
     vector<string> lines;
     ifstream file(filename);
 
@@ -63,8 +147,11 @@ vector<string> readAllLines(const string& filename) {
         return lines;
     }
 
+    size_t bytes = 0;
     string line;
     while (getline(file, line)) {
+        bytes += line.size() + 1;
+
         if (!line.empty() && line.back() == '\r') {
             line.pop_back();
         }
@@ -72,145 +159,207 @@ vector<string> readAllLines(const string& filename) {
             lines.push_back(line);
         }
     }
+
+    counters.bytesRead.fetch_add(bytes, memory_order_relaxed);
+    counters.linesParsed.fetch_add(lines.size(), memory_order_relaxed);
+
     return lines;
 }
 
-void writeAllLines(const string& filename, const vector<string>& lines) {
+void writeAllLines(const string& filename, const vector<string>& lines,
+                   TableCounters& counters) {
     ofstream file(filename, ios::trunc);
 
     if (!file.is_open()) {
         throw runtime_error("Não foi possível abrir o arquivo para escrita: '" +
                             filename + "'.");
     }
+
+    size_t bytes = 0;
     for (const string& line : lines) {
         file << line << "\n";
+        bytes += line.size() + 1;
     }
+
+    counters.bytesWritten.fetch_add(bytes, memory_order_relaxed);
+    counters.rewrites.fetch_add(1, memory_order_relaxed);
 }
 
-long MockConnection::insert(const string& table_name,
-                            const string& data) const {
-    string filename = getFullFilePath(table_name);
-    vector<string> lines = readAllLines(filename);
-    long max_id = 0;
+vector<string> filterByColumn(const vector<string>& lines, size_t index,
+                              const string& value) {
+    return parallel_filter_map<string>(
+        lines, 1, [&index, &value](const string& line) -> optional<string> {
+            try {
+                if (extractColumnFromLine(line, index) == value)
+                    return line;
+            } catch (const invalid_argument& ignore) {
+            }
 
+            return nullopt;
+        });
+}
+
+string* findRecord(vector<string>& lines, long id) {
     for (size_t i = 1; i < lines.size(); ++i) {
         try {
-            long current_id = getIdFromLine(lines[i]);
-            if (current_id > max_id) {
-                max_id = current_id;
+            if (getIdFromLine(lines[i]) == id) {
+                return &lines[i];
             }
-        } catch (const invalid_argument& ignore) {
+        } catch (const invalid_argument& e) {
+            continue;
         }
     }
 
-    long new_id = max_id + 1;
-    string new_record;
+    return nullptr;
+}
 
+string buildRecord(long id, const string& data) {
     if (data.empty()) {
-        new_record = to_string(new_id);
-    } else {
-        new_record = to_string(new_id) + "," + data;
+        return to_string(id);
     }
 
-    ofstream file(filename, ios::app);
-    if (!file.is_open()) {
-        throw runtime_error("Não foi possível abrir o arquivo '" + filename +
-                            "' para anexar.");
+    return to_string(id) + "," + data;
+}
+
+// O maior ID entre as linhas de dados.
+static long maxId(const vector<string>& lines) {
+    long max_id = 0;
+
+    for (size_t i = 1; i < lines.size(); ++i) {
+        try {
+            long current_id = getIdFromLine(lines[i]);
+            if (current_id > max_id) {
+                max_id = current_id;
+            }
+        } catch (const invalid_argument& ignore) {
+        }
     }
-    file << new_record << "\n";
 
-    return new_id;
+    return max_id;
 }
 
-string MockConnection::selectOne(const string& table_name, long id) const {
-    vector<string> lines = selectByColumn(table_name, 0, to_string(id));
+// O registro com o ID dado; lança se não houver exatamente um.
+static string recordById(const vector<string>& lines,
+                         const string& table_name, long id) {
+    vector<string> found = filterByColumn(lines, 0, to_string(id));
 
-    if (lines.empty())
+    if (found.empty())
         throw runtime_error("O ID " + to_string(id) + " não existe na tabela " +
                             table_name + ".");
-    else if (lines.size() > 1)
+    else if (found.size() > 1)
         throw runtime_error("Mais de uma linha com ID " + to_string(id) +
                             ". Integridade da tabela " + table_name +
                             " comprometida.");
 
-    return lines.front();
+    return found.front();
 }
 
-vector<string> MockConnection::selectByColumn(const string& table_name,
-                                              size_t index,
-                                              const string& value) const {
-    string filename = getFullFilePath(table_name);
-    vector<string> lines = readAllLines(filename);
-    vector<string> results;
+// Substitui os dados do registro com o ID dado; lança se ele não existir.
+static void updateLines(vector<string>& lines, const string& table_name,
+                        long id, const string& data) {
+    string* record = findRecord(lines, id);
 
-    for (size_t i = 1; i < lines.size(); ++i) {
-        const string& line = lines[i];
-
-        try {
-            string col = extractColumnFromLine(line, index);
-            if (col == value) {
-                results.push_back(line);
-            }
-        } catch (const invalid_argument& ignore) {
-            continue;
-        }
+    if (!record) {
+        throw runtime_error("O ID " + to_string(id) +
+                            " não existe para ser atualizado na tabela " +
+                            table_name + ".");
     }
 
-    return results;
+    *record = buildRecord(id, data);
 }
 
-vector<string> MockConnection::selectAll(const string& table_name) const {
-    string filename = getFullFilePath(table_name);
-    vector<string> all_lines = readAllLines(filename);
+// A comparação e a troca de compareAndUpdate() sobre as linhas.
+static bool compareAndUpdateLines(vector<string>& lines,
+                                  const string& table_name, long id,
+                                  size_t index, const string& expected,
+                                  const string& data) {
+    string* record = findRecord(lines, id);
 
-    if (all_lines.size() > 1) {
-        return vector<string>(all_lines.begin() + 1, all_lines.end());
+    if (!record) {
+        throw runtime_error("O ID " + to_string(id) +
+                            " não existe para ser atualizado na tabela " +
+                            table_name + ".");
     }
-    return {};
-}
 
-void MockConnection::update(const string& table_name, long id,
-                            const string& data) const {
-    string filename = getFullFilePath(table_name);
-    vector<string> lines = readAllLines(filename);
-    string id_str = to_string(id);
-    string new_record;
-    bool updated = false;
+    string current;
 
-    if (data.empty()) {
-        new_record = id_str;
-    } else {
-        new_record = id_str + "," + data;
+    try {
+        current = extractColumnFromLine(*record, index);
+    } catch (const invalid_argument& e) {
+        current = "";
+    }
+
+    if (current != expected) {
+        return false;
     }
 
+    *record = buildRecord(id, data);
+
+    return true;
+}
+
+// As comparações e trocas de compareAndUpdateMany() sobre as linhas.
+static vector<long> compareAndUpdateManyLines(
+    vector<string>& lines, size_t index,
+    const map<long, pair<string, string>>& changes) {
+    vector<long> updated;
+
     for (size_t i = 1; i < lines.size(); ++i) {
-        string& line = lines[i];
+        long id;
 
         try {
-            long current_id = getIdFromLine(line);
-            if (current_id == id) {
-                line = new_record;
-                updated = true;
-                break;
-            }
+            id = getIdFromLine(lines[i]);
         } catch (const invalid_argument& e) {
             continue;
         }
-    }
 
-    if (!updated) {
-        throw runtime_error("O ID " + to_string(id) +
-                            " não existe para ser atualizado na tabela " +
-                            table_name + ".");
+        auto it = changes.find(id);
+
+        if (it == changes.end())
+            continue;
+
+        string current;
+
+        try {
+            current = extractColumnFromLine(lines[i], index);
+        } catch (const invalid_argument& e) {
+            current = "";
+        }
+
+        if (current != it->second.first)
+            continue;
+
+        lines[i] = buildRecord(id, it->second.second);
+        updated.push_back(id);
     }
 
-    writeAllLines(filename, lines);
+    sort(updated.begin(), updated.end());
+
+    return updated;
 }
 
-size_t MockConnection::deleteByColumn(const string& table_name, size_t index,
-                                      const string& value) const {
-    string filename = getFullFilePath(table_name);
-    vector<string> lines = readAllLines(filename);
+// Remove as linhas de dados que satisfazem o predicado e as retorna.
+static vector<string> removeLinesWhere(
+    vector<string>& lines, const function<bool(const string&)>& pred) {
+    vector<string> kept, removed;
+
+    if (lines.size() <= 1)
+        return removed;
+
+    kept.push_back(lines.front());
+
+    for (size_t i = 1; i < lines.size(); ++i)
+        (pred(lines[i]) ? removed : kept).push_back(lines[i]);
+
+    if (!removed.empty())
+        lines.swap(kept);
+
+    return removed;
+}
+
+// Remove as linhas de dados com o valor na coluna e retorna quantas eram.
+static size_t removeLinesByColumn(vector<string>& lines, size_t index,
+                                  const string& value) {
     size_t initial_size = lines.size();
 
     if (initial_size <= 1) {
@@ -231,22 +380,586 @@ size_t MockConnection::deleteByColumn(const string& table_name, size_t index,
                           }),
                 lines.end());
 
-    size_t removed_count = initial_size - lines.size();
+    return initial_size - lines.size();
+}
+
+MockConnection::Table& MockConnection::table(const string& table_name) const {
+    lock_guard<mutex> lock(tablesMx);
+
+    auto& entry = tables[table_name];
+
+    if (!entry)
+        entry = make_unique<Table>(table_name);
+
+    return *entry;
+}
+
+MockConnection::MockConnection() {
+    lock_guard<mutex> lock(journalMx);
+
+    ifstream journal(JOURNAL_PATH);
+
+    if (!journal.is_open())
+        return;
+
+    // O commit passou do ponto de confirmação: os temporários que restarem
+    // substituem as tabelas.
+    string table_name;
+    while (getline(journal, table_name)) {
+        string filename = getFullFilePath(table_name);
+
+        if (ifstream(filename + TEMP_SUFFIX).good())
+            fs::rename(filename + TEMP_SUFFIX, filename);
+    }
+
+    journal.close();
+    syncPath(DATA_PATH_PREFIX);
+    fs::remove(JOURNAL_PATH);
+}
+
+shared_ptr<const MockConnection::Snapshot> MockConnection::read(
+    const string& table_name, Table& t) const {
+    auto current = atomic_load(&t.snapshot);
+
+    if (current && stamp(getFullFilePath(table_name)) ==
+                       make_pair(current->mtime, current->size))
+        return current;
+
+    // O arquivo mudou: ou por fora, e a versão é relida, ou por um escritor
+    // que ainda não publicou a sua, e a anterior continua valendo.
+    shared_lock<shared_mutex> lock(t.lock, try_to_lock);
+
+    if (!lock.owns_lock()) {
+        if (current)
+            return current;
+
+        lock.lock();
+    }
+
+    return latest(table_name, t);
+}
+
+shared_ptr<const MockConnection::Snapshot> MockConnection::latest(
+    const string& table_name, Table& t) const {
+    string filename = getFullFilePath(table_name);
+    auto current = atomic_load(&t.snapshot);
+    auto [mtime, size] = stamp(filename);
+
+    if (current && current->mtime == mtime && current->size == size)
+        return current;
+
+    auto snapshot = make_shared<Snapshot>();
+
+    snapshot->lines = readAllLines(filename, t.counters);
+    snapshot->version = ++t.versions;
+    snapshot->mtime = mtime;
+    snapshot->size = size;
+
+    atomic_store(&t.snapshot, shared_ptr<const Snapshot>(snapshot));
+
+    return snapshot;
+}
+
+void MockConnection::publish(const string& table_name, Table& t,
+                             vector<string> lines) const {
+    auto snapshot = make_shared<Snapshot>();
+    auto [mtime, size] = stamp(getFullFilePath(table_name));
+
+    snapshot->lines = move(lines);
+    snapshot->version = ++t.versions;
+    snapshot->mtime = mtime;
+    snapshot->size = size;
+
+    atomic_store(&t.snapshot, shared_ptr<const Snapshot>(snapshot));
+}
+
+Transaction MockConnection::begin() const {
+    return Transaction(*this);
+}
+
+vector<string> MockConnection::load(const string& table_name,
+                                    uint64_t& version) const {
+    Table& t = table(table_name);
+    shared_lock<shared_mutex> lock(t.lock);
+    auto snapshot = latest(table_name, t);
+
+    version = snapshot->version;
+
+    return snapshot->lines;
+}
+
+void MockConnection::commit(
+    const map<string, Transaction::Buffer>& buffers) const {
+    // As tabelas em ordem de nome: dois commits nunca esperam um pelo outro
+    // em ordens diferentes.
+    vector<unique_lock<shared_mutex>> locks;
+    vector<pair<string, Table*>> dirty;
+
+    for (const auto& [table_name, buffer] : buffers) {
+        Table& t = table(table_name);
+
+        locks.emplace_back(t.lock);
+
+        if (latest(table_name, t)->version != buffer.version)
+            throw TransactionConflict("A tabela " + table_name +
+                                      " foi alterada por outra operação "
+                                      "durante a transação.");
+
+        if (buffer.dirty)
+            dirty.emplace_back(table_name, &t);
+    }
+
+    if (dirty.empty())
+        return;
+
+    for (const auto& [table_name, t] : dirty) {
+        string temporary = getFullFilePath(table_name) + TEMP_SUFFIX;
+
+        writeAllLines(temporary, buffers.at(table_name).lines, t->counters);
+        syncPath(temporary);
+    }
+
+    lock_guard<mutex> lock(journalMx);
+
+    {
+        ofstream journal(JOURNAL_PATH, ios::trunc);
+
+        for (const auto& entry : dirty)
+            journal << entry.first << "\n";
+
+        journal.flush();
+        if (!journal) {
+            throw runtime_error("Falha ao gravar o arquivo '" +
+                                string(JOURNAL_PATH) + "'.");
+        }
+    }
+
+    // O ponto de confirmação: o diário e os temporários estão no disco.
+    syncPath(JOURNAL_PATH);
+    syncPath(DATA_PATH_PREFIX);
+
+    for (const auto& [table_name, t] : dirty) {
+        string filename = getFullFilePath(table_name);
+
+        fs::rename(filename + TEMP_SUFFIX, filename);
+
+        publish(table_name, *t, buffers.at(table_name).lines);
+    }
+
+    syncPath(DATA_PATH_PREFIX);
+    fs::remove(JOURNAL_PATH);
+}
+
+long MockConnection::insert(const string& table_name,
+                            const string& data) const {
+    METRIC_SCOPE("MockConnection::insert");
+    TRACE_SPAN("MockConnection::insert");
+
+    if (Transaction* tx = Transaction::current(*this)) {
+        auto& buffer = tx->buffer(table_name);
+        long new_id = maxId(buffer.lines) + 1;
+
+        buffer.lines.push_back(buildRecord(new_id, data));
+        buffer.dirty = true;
+
+        return new_id;
+    }
+
+    Table& t = table(table_name);
+    unique_lock<shared_mutex> lock(t.lock);
+
+    string filename = getFullFilePath(table_name);
+    vector<string> lines = latest(table_name, t)->lines;
+    long new_id = maxId(lines) + 1;
+    string new_record = buildRecord(new_id, data);
+
+    {
+        ofstream file(filename, ios::app);
+        if (!file.is_open()) {
+            throw runtime_error("Não foi possível abrir o arquivo '" +
+                                filename + "' para anexar.");
+        }
+        file << new_record << "\n";
+    }
+
+    t.counters.bytesWritten.fetch_add(new_record.size() + 1,
+                                      memory_order_relaxed);
+
+    lines.push_back(move(new_record));
+    publish(table_name, t, move(lines));
+
+    return new_id;
+}
+
+long MockConnection::insertMany(const string& table_name,
+                                const vector<string>& data) const {
+    METRIC_SCOPE("MockConnection::insertMany");
+    TRACE_SPAN("MockConnection::insertMany");
+
+    if (data.empty())
+        return 0;
+
+    if (Transaction* tx = Transaction::current(*this)) {
+        auto& buffer = tx->buffer(table_name);
+        long max_id = maxId(buffer.lines);
+
+        for (size_t i = 0; i < data.size(); ++i)
+            buffer.lines.push_back(buildRecord(max_id + 1 + long(i), data[i]));
+        buffer.dirty = true;
+
+        return max_id + 1;
+    }
+
+    Table& t = table(table_name);
+    unique_lock<shared_mutex> lock(t.lock);
+
+    string filename = getFullFilePath(table_name);
+    vector<string> lines = latest(table_name, t)->lines;
+    long max_id = maxId(lines);
+
+    // Os registros recebem um bloco contíguo de IDs e são anexados em uma
+    // única escrita.
+    string records;
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        lines.push_back(buildRecord(max_id + 1 + long(i), data[i]));
+        records += lines.back();
+        records += '\n';
+    }
+
+    {
+        ofstream file(filename, ios::app);
+        if (!file.is_open()) {
+            throw runtime_error("Não foi possível abrir o arquivo '" +
+                                filename + "' para anexar.");
+        }
+        file << records;
+    }
+
+    t.counters.bytesWritten.fetch_add(records.size(), memory_order_relaxed);
+
+    publish(table_name, t, move(lines));
+
+    return max_id + 1;
+}
+
+string MockConnection::selectOne(const string& table_name, long id) const {
+    METRIC_SCOPE("MockConnection::selectOne");
+    TRACE_SPAN("MockConnection::selectOne");
+
+    if (Transaction* tx = Transaction::current(*this))
+        return recordById(tx->buffer(table_name).lines, table_name, id);
+
+    return recordById(read(table_name, table(table_name))->lines, table_name,
+                      id);
+}
+
+vector<string> MockConnection::selectByColumn(const string& table_name,
+                                              size_t index,
+                                              const string& value) const {
+    METRIC_SCOPE("MockConnection::selectByColumn");
+    TRACE_SPAN("MockConnection::selectByColumn");
+
+    if (Transaction* tx = Transaction::current(*this))
+        return filterByColumn(tx->buffer(table_name).lines, index, value);
+
+    return filterByColumn(read(table_name, table(table_name))->lines, index,
+                          value);
+}
+
+vector<string> MockConnection::selectAll(const string& table_name) const {
+    METRIC_SCOPE("MockConnection::selectAll");
+    TRACE_SPAN("MockConnection::selectAll");
+
+    // A versão lida fica viva até o fim da cópia.
+    shared_ptr<const Snapshot> snapshot;
+    const vector<string>* all_lines;
+
+    if (Transaction* tx = Transaction::current(*this)) {
+        all_lines = &tx->buffer(table_name).lines;
+    } else {
+        snapshot = read(table_name, table(table_name));
+        all_lines = &snapshot->lines;
+    }
+
+    if (all_lines->size() > 1) {
+        return vector<string>(all_lines->begin() + 1, all_lines->end());
+    }
+    return {};
+}
+
+void MockConnection::update(const string& table_name, long id,
+                            const string& data) const {
+    METRIC_SCOPE("MockConnection::update");
+    TRACE_SPAN("MockConnection::update");
+
+    if (Transaction* tx = Transaction::current(*this)) {
+        auto& buffer = tx->buffer(table_name);
+
+        updateLines(buffer.lines, table_name, id, data);
+        buffer.dirty = true;
+
+        return;
+    }
+
+    Table& t = table(table_name);
+    unique_lock<shared_mutex> lock(t.lock);
+
+    string filename = getFullFilePath(table_name);
+    vector<string> lines = latest(table_name, t)->lines;
+
+    updateLines(lines, table_name, id, data);
+
+    writeAllLines(filename, lines, t.counters);
+    publish(table_name, t, move(lines));
+}
+
+bool MockConnection::compareAndUpdate(const string& table_name, long id,
+                                      size_t index, const string& expected,
+                                      const string& data) const {
+    METRIC_SCOPE("MockConnection::compareAndUpdate");
+    TRACE_SPAN("MockConnection::compareAndUpdate");
+
+    if (Transaction* tx = Transaction::current(*this)) {
+        auto& buffer = tx->buffer(table_name);
+
+        if (!compareAndUpdateLines(buffer.lines, table_name, id, index,
+                                   expected, data))
+            return false;
+
+        buffer.dirty = true;
+
+        return true;
+    }
+
+    Table& t = table(table_name);
+    unique_lock<shared_mutex> lock(t.lock);
+
+    string filename = getFullFilePath(table_name);
+    vector<string> lines = latest(table_name, t)->lines;
+
+    if (!compareAndUpdateLines(lines, table_name, id, index, expected, data)) {
+        return false;
+    }
+
+    writeAllLines(filename, lines, t.counters);
+    publish(table_name, t, move(lines));
+
+    return true;
+}
+
+vector<long> MockConnection::compareAndUpdateMany(
+    const string& table_name, size_t index,
+    const map<long, pair<string, string>>& changes) const {
+    METRIC_SCOPE("MockConnection::compareAndUpdateMany");
+    TRACE_SPAN("MockConnection::compareAndUpdateMany");
+
+    if (changes.empty())
+        return {};
+
+    if (Transaction* tx = Transaction::current(*this)) {
+        auto& buffer = tx->buffer(table_name);
+        vector<long> updated =
+            compareAndUpdateManyLines(buffer.lines, index, changes);
+
+        if (!updated.empty())
+            buffer.dirty = true;
+
+        return updated;
+    }
+
+    Table& t = table(table_name);
+    unique_lock<shared_mutex> lock(t.lock);
+
+    string filename = getFullFilePath(table_name);
+    vector<string> lines = latest(table_name, t)->lines;
+    vector<long> updated = compareAndUpdateManyLines(lines, index, changes);
+
+    if (!updated.empty()) {
+        writeAllLines(filename, lines, t.counters);
+        publish(table_name, t, move(lines));
+    }
+
+    return updated;
+}
+
+size_t MockConnection::deleteByColumn(const string& table_name, size_t index,
+                                      const string& value) const {
+    METRIC_SCOPE("MockConnection::deleteByColumn");
+    TRACE_SPAN("MockConnection::deleteByColumn");
+
+    if (Transaction* tx = Transaction::current(*this)) {
+        auto& buffer = tx->buffer(table_name);
+        size_t removed_count = removeLinesByColumn(buffer.lines, index, value);
+
+        if (removed_count > 0)
+            buffer.dirty = true;
+
+        return removed_count;
+    }
+
+    Table& t = table(table_name);
+    unique_lock<shared_mutex> lock(t.lock);
+
+    vector<string> lines = latest(table_name, t)->lines;
+    size_t removed_count = removeLinesByColumn(lines, index, value);
 
     if (removed_count > 0) {
-        writeAllLines(filename, lines);
+        writeAllLines(getFullFilePath(table_name), lines, t.counters);
+        publish(table_name, t, move(lines));
     }
 
     return removed_count;
 }
 
 void MockConnection::deleteRecord(const string& table_name, long id) const {
+    METRIC_SCOPE("MockConnection::deleteRecord");
+    TRACE_SPAN("MockConnection::deleteRecord");
+
     string id_str = to_string(id);
+    size_t removed_count;
+
+    if (Transaction* tx = Transaction::current(*this)) {
+        auto& buffer = tx->buffer(table_name);
 
-    size_t removed_count = deleteByColumn(table_name, 0, id_str);
+        removed_count = removeLinesByColumn(buffer.lines, 0, id_str);
+
+        if (removed_count > 0)
+            buffer.dirty = true;
+    } else {
+        Table& t = table(table_name);
+        unique_lock<shared_mutex> lock(t.lock);
+
+        vector<string> lines = latest(table_name, t)->lines;
+
+        removed_count = removeLinesByColumn(lines, 0, id_str);
+
+        if (removed_count > 0) {
+            writeAllLines(getFullFilePath(table_name), lines, t.counters);
+            publish(table_name, t, move(lines));
+        }
+    }
 
     if (removed_count == 0) {
         throw invalid_argument("O ID " + to_string(id) +
                                " não existe na tabela " + table_name + ".");
     }
-}
\ No newline at end of file
+}
+
+vector<string> MockConnection::deleteWhere(
+    const string& table_name,
+    const function<bool(const string&)>& pred) const {
+    METRIC_SCOPE("MockConnection::deleteWhere");
+    TRACE_SPAN("MockConnection::deleteWhere");
+
+    if (Transaction* tx = Transaction::current(*this)) {
+        auto& buffer = tx->buffer(table_name);
+        vector<string> removed = removeLinesWhere(buffer.lines, pred);
+
+        if (!removed.empty())
+            buffer.dirty = true;
+
+        return removed;
+    }
+
+    Table& t = table(table_name);
+    unique_lock<shared_mutex> lock(t.lock);
+
+    string filename = getFullFilePath(table_name);
+    vector<string> lines = latest(table_name, t)->lines;
+    vector<string> removed = removeLinesWhere(lines, pred);
+
+    if (!removed.empty()) {
+        writeAllLines(filename, lines, t.counters);
+        publish(table_name, t, move(lines));
+    }
+
+    return removed;
+}
+
+vector<string> MockConnection::moveWhere(
+    const string& table_name, const string& archive_name,
+    const function<bool(const string&)>& pred) const {
+    METRIC_SCOPE("MockConnection::moveWhere");
+    TRACE_SPAN("MockConnection::moveWhere");
+
+    if (Transaction::current(*this))
+        throw logic_error("moveWhere não pode ser usada em uma transação.");
+
+    Table& source = table(table_name);
+    Table& target = table(archive_name);
+    unique_lock<shared_mutex> sourceLock(source.lock, defer_lock);
+    unique_lock<shared_mutex> targetLock(target.lock, defer_lock);
+    std::lock(sourceLock, targetLock);
+
+    string filename = getFullFilePath(table_name);
+    vector<string> lines = latest(table_name, source)->lines;
+    vector<string> kept, moved;
+
+    if (lines.size() <= 1)
+        return moved;
+
+    // O registro de maior ID fica na origem mesmo se satisfizer o predicado:
+    // insert() gera o próximo ID a partir dele, e não deve reutilizar IDs já
+    // arquivados.
+    long max_id = maxId(lines);
+
+    kept.push_back(lines.front());
+
+    for (size_t i = 1; i < lines.size(); ++i) {
+        bool last = false;
+        try {
+            last = getIdFromLine(lines[i]) == max_id;
+        } catch (const invalid_argument& ignore) {
+        }
+
+        (!last && pred(lines[i]) ? moved : kept).push_back(lines[i]);
+    }
+
+    if (moved.empty())
+        return moved;
+
+    string archive = getFullFilePath(archive_name);
+    bool exists = ifstream(archive).good();
+    vector<string> archived = latest(archive_name, target)->lines;
+
+    if (!exists)
+        archived.push_back(lines.front());
+
+    archived.insert(archived.end(), moved.begin(), moved.end());
+
+    {
+        ofstream file(archive, ios::app);
+        if (!file.is_open()) {
+            throw runtime_error("Não foi possível abrir o arquivo '" +
+                                archive + "' para anexar.");
+        }
+
+        size_t bytes = 0;
+
+        if (!exists) {
+            file << lines.front() << "\n";
+            bytes += lines.front().size() + 1;
+        }
+
+        for (const string& line : moved) {
+            file << line << "\n";
+            bytes += line.size() + 1;
+        }
+
+        file.flush();
+        if (!file) {
+            throw runtime_error("Falha ao gravar o arquivo '" + archive +
+                                "'.");
+        }
+
+        target.counters.bytesWritten.fetch_add(bytes, memory_order_relaxed);
+    }
+
+    publish(archive_name, target, move(archived));
+
+    writeAllLines(filename, kept, source.counters);
+    publish(table_name, source, move(kept));
+
+    return moved;
+}
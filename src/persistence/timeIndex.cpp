@@ -0,0 +1,191 @@
+#include "persistence/timeIndex.hpp"
+
+#include <algorithm>
+#include <tuple>
+
+using std::find_if;
+using std::function;
+using std::lower_bound;
+using std::sort;
+using std::tie;
+using std::upper_bound;
+using std::vector;
+
+#define PARTITION_SECONDS (TIME_INDEX_PARTITION_DAYS * 86400LL)
+
+// Ordem dos registros dentro de uma partição.
+static bool entryLess(const TimeIndex::Entry& a, const TimeIndex::Entry& b) {
+    return tie(a.owner, a.inicio, a.fim, a.id) <
+           tie(b.owner, b.inicio, b.fim, b.id);
+}
+
+long long TimeIndex::partitionOf(Timestamp tt) {
+    long long t = tt;
+
+    return t / PARTITION_SECONDS - (t % PARTITION_SECONDS < 0);
+}
+
+void TimeIndex::indexActive(Partition& partition) {
+    const vector<Entry>& sorted = partition.entries;
+
+    partition.active.clear();
+
+    for (size_t i = 0; i < sorted.size(); ++i)
+        if (sorted[i].active)
+            partition.active.push_back(i);
+
+    sort(partition.active.begin(), partition.active.end(),
+         [&sorted](size_t a, size_t b) {
+             return tie(sorted[a].inicio, sorted[a].id) <
+                    tie(sorted[b].inicio, sorted[b].id);
+         });
+}
+
+void TimeIndex::build(vector<Entry> entries) {
+    partitions.clear();
+    partitionById.clear();
+    count = entries.size();
+
+    for (auto& entry : entries) {
+        long long key = partitionOf(entry.inicio);
+
+        partitionById[entry.id] = key;
+        partitions[key].entries.push_back(std::move(entry));
+    }
+
+    for (auto& pair : partitions) {
+        Partition& partition = pair.second;
+
+        sort(partition.entries.begin(), partition.entries.end(), entryLess);
+        indexActive(partition);
+    }
+}
+
+bool TimeIndex::put(Entry entry) {
+    auto found = partitionById.find(entry.id);
+
+    if (found != partitionById.end()) {
+        Partition& partition = partitions[found->second];
+        vector<Entry>& entries = partition.entries;
+        auto it =
+            find_if(entries.begin(), entries.end(),
+                    [&entry](const Entry& e) { return e.id == entry.id; });
+
+        if (it->version > entry.version)
+            return false;
+
+        // Mesma posição (ex: uma reserva): só a linha e o flag mudam.
+        if (it->owner == entry.owner && it->inicio == entry.inicio &&
+            it->fim == entry.fim) {
+            bool reindex = it->active != entry.active;
+
+            *it = std::move(entry);
+
+            if (reindex)
+                indexActive(partition);
+
+            return true;
+        }
+
+        erase(entry.id);
+    }
+
+    long long key = partitionOf(entry.inicio);
+    Partition& partition = partitions[key];
+    auto at = upper_bound(partition.entries.begin(), partition.entries.end(),
+                          entry, entryLess);
+
+    partitionById[entry.id] = key;
+    partition.entries.insert(at, std::move(entry));
+    indexActive(partition);
+    ++count;
+
+    return true;
+}
+
+bool TimeIndex::erase(long id) {
+    auto found = partitionById.find(id);
+
+    if (found == partitionById.end())
+        return false;
+
+    auto partition = partitions.find(found->second);
+    vector<Entry>& entries = partition->second.entries;
+
+    entries.erase(find_if(entries.begin(), entries.end(),
+                          [id](const Entry& e) { return e.id == id; }));
+
+    if (entries.empty())
+        partitions.erase(partition);
+    else
+        indexActive(partition->second);
+
+    partitionById.erase(found);
+    --count;
+
+    return true;
+}
+
+vector<const TimeIndex::Entry*> TimeIndex::query(long owner, Timestamp from,
+                                                 Timestamp to) const {
+    vector<const Entry*> result;
+
+    if (to <= from)
+        return result;
+
+    auto first = partitions.lower_bound(partitionOf(from));
+    auto last = partitions.upper_bound(partitionOf(to - 1));
+
+    for (auto it = first; it != last; ++it) {
+        const vector<Entry>& entries = it->second.entries;
+
+        Entry key{from, 0, owner, 0, {}, false, 0};
+        auto e = lower_bound(entries.begin(), entries.end(), key,
+                             [](const Entry& a, const Entry& b) {
+                                 return tie(a.owner, a.inicio) <
+                                        tie(b.owner, b.inicio);
+                             });
+
+        for (; e != entries.end() && e->owner == owner && e->inicio < to; ++e)
+            result.push_back(&*e);
+    }
+
+    return result;
+}
+
+void TimeIndex::scan(Timestamp from, Timestamp to, const Cursor& after,
+                     const function<bool(const Entry&)>& visit) const {
+    // Posição inicial: o que vier por último entre `from` e `after`.
+    Cursor start = after;
+    if (from > start.inicio)
+        start = {from, 0};
+
+    if (to <= start.inicio)
+        return;
+
+    auto first = partitions.lower_bound(partitionOf(start.inicio));
+    auto last = partitions.upper_bound(partitionOf(to - 1));
+
+    for (auto it = first; it != last; ++it) {
+        const vector<Entry>& entries = it->second.entries;
+        const vector<size_t>& active = it->second.active;
+
+        auto a = upper_bound(active.begin(), active.end(), start,
+                             [&entries](const Cursor& c, size_t i) {
+                                 return tie(c.inicio, c.id) <
+                                        tie(entries[i].inicio, entries[i].id);
+                             });
+
+        for (; a != active.end() && entries[*a].inicio < to; ++a)
+            if (!visit(entries[*a]))
+                return;
+    }
+}
+
+size_t TimeIndex::size() const {
+    return count;
+}
+
+size_t TimeIndex::partitionCount() const {
+    return partitions.size();
+}
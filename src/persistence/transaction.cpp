@@ -0,0 +1,114 @@
+#include "persistence/transaction.hpp"
+
+#include <stdexcept>
+
+#include "persistence/mockConnection.hpp"
+#include "util/metrics.hpp"
+#include "util/tracing.hpp"
+
+using std::function;
+using std::logic_error;
+using std::move;
+using std::string;
+
+// A transação mais interna da thread, em qualquer conexão; as demais são
+// encadeadas por `outer`.
+static thread_local Transaction* innermost = nullptr;
+
+Transaction::Transaction(const MockConnection& connection)
+    : connection(connection), outer(innermost) {
+    Transaction* ativa = current(connection);
+
+    owner = ativa ? ativa->owner : this;
+    innermost = this;
+}
+
+Transaction::~Transaction() {
+    rollback();
+}
+
+Transaction* Transaction::current(const MockConnection& connection) {
+    for (Transaction* tx = innermost; tx; tx = tx->outer)
+        if (&tx->connection == &connection)
+            return tx;
+
+    return nullptr;
+}
+
+bool Transaction::inProgress() {
+    return innermost != nullptr;
+}
+
+void Transaction::afterCommit(const MockConnection& connection,
+                              function<void()> callback) {
+    if (Transaction* transaction = current(connection))
+        transaction->onCommit(move(callback));
+    else
+        callback();
+}
+
+Transaction::Buffer& Transaction::buffer(const string& table_name) {
+    if (owner != this)
+        return owner->buffer(table_name);
+
+    auto it = tables.find(table_name);
+
+    if (it == tables.end()) {
+        Buffer buffer;
+        buffer.lines = connection.load(table_name, buffer.version);
+        it = tables.emplace(table_name, move(buffer)).first;
+    }
+
+    return it->second;
+}
+
+void Transaction::finish() {
+    active = false;
+    innermost = outer;
+}
+
+void Transaction::commit() {
+    METRIC_SCOPE("Transaction::commit");
+    TRACE_SPAN("Transaction::commit");
+
+    if (!active)
+        throw logic_error("A transação já foi encerrada.");
+
+    finish();
+
+    if (owner != this)
+        return;
+
+    try {
+        connection.commit(tables);
+    } catch (...) {
+        discard();
+        throw;
+    }
+
+    tables.clear();
+
+    for (const auto& callback : callbacks)
+        callback();
+
+    callbacks.clear();
+}
+
+void Transaction::rollback() {
+    if (!active)
+        return;
+
+    finish();
+
+    if (owner == this)
+        discard();
+}
+
+void Transaction::onCommit(function<void()> callback) {
+    owner->callbacks.push_back(move(callback));
+}
+
+void Transaction::discard() {
+    tables.clear();
+    callbacks.clear();
+}
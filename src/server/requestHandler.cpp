@@ -0,0 +1,286 @@
+#include "server/requestHandler.hpp"
+
+#include <sstream>
+#include <stdexcept>
+
+#include "model/horario.hpp"
+#include "util/tracing.hpp"
+
+using std::exception;
+using std::invalid_argument;
+using std::istringstream;
+using std::ostringstream;
+using std::runtime_error;
+using std::shared_ptr;
+using std::string;
+using std::to_string;
+using std::vector;
+
+static string ok(const string& payload = "") {
+    return payload.empty() ? "OK\n" : "OK " + payload + "\n";
+}
+
+static string err(const string& message) {
+    string linha = message;
+
+    for (auto& c : linha)
+        if (c == '\n' || c == '\r')
+            c = ' ';
+
+    return "ERR " + linha + "\n";
+}
+
+static void require_args(const vector<string>& args, size_t count) {
+    if (args.size() != count + 1)
+        throw invalid_argument("Uso: " + args[0] + " exige " +
+                               to_string(count) + " argumento(s).");
+}
+
+static long parse_id(const string& value) {
+    size_t pos = 0;
+    long id = 0;
+
+    try {
+        id = std::stol(value, &pos);
+    } catch (const exception&) {
+        pos = 0;
+    }
+
+    if (pos != value.size() || id <= 0)
+        throw invalid_argument("ID inválido: " + value);
+
+    return id;
+}
+
+RequestHandler::RequestHandler(
+    LoginController& loginController, ProfessorController& professorController,
+    AgendamentoController& agendamentoController,
+    const shared_ptr<SessionService>& sessionService)
+    : loginController(loginController),
+      professorController(professorController),
+      agendamentoController(agendamentoController),
+      sessionService(sessionService) {}
+
+string RequestHandler::handle(const string& line) {
+    TRACE_SPAN("RequestHandler::handle");
+
+    vector<string> args;
+    istringstream in(line);
+    string token;
+
+    while (in >> token)
+        args.push_back(token);
+
+    if (args.empty())
+        return err("Requisição vazia.");
+
+    const string& comando = args[0];
+
+    try {
+        if (comando == "LOGIN_ALUNO")
+            return login(args, false);
+        if (comando == "LOGIN_PROFESSOR")
+            return login(args, true);
+        if (comando == "LOGOUT") {
+            require_args(args, 1);
+            sessionService->logout(args[1]);
+            return ok();
+        }
+        if (comando == "PROFESSORES")
+            return professores();
+        if (comando == "HORARIOS")
+            return horarios(args);
+        if (comando == "AGENDAMENTOS")
+            return agendamentos(args);
+        if (comando == "PENDENTES")
+            return pendentes(args);
+        if (comando == "AGENDAR")
+            return agendar(args);
+        if (comando == "CONFIRMAR")
+            return alterarStatus(args, Status::CONFIRMADO);
+        if (comando == "RECUSAR")
+            return alterarStatus(args, Status::RECUSADO);
+        if (comando == "CANCELAR")
+            return alterarStatus(args, Status::CANCELADO);
+        if (comando == "CONFIRMAR_LOTE")
+            return alterarStatusEmLote(args, Status::CONFIRMADO);
+        if (comando == "RECUSAR_LOTE")
+            return alterarStatusEmLote(args, Status::RECUSADO);
+
+        return err("Comando desconhecido: " + comando);
+    } catch (const exception& e) {
+        return err(e.what());
+    }
+}
+
+string RequestHandler::login(const vector<string>& args, bool professor) {
+    TRACE_SPAN("RequestHandler::login");
+
+    require_args(args, 2);
+
+    if (professor)
+        loginController.loginProfessor(args[1], args[2]);
+    else
+        loginController.loginAluno(args[1], args[2]);
+
+    // O evento de login abre a sessão e a associa à thread atual; o token é
+    // devolvido ao cliente e a thread é liberada para outras conexões.
+    string token = sessionService->current();
+    sessionService->bind("");
+
+    if (token.empty())
+        throw runtime_error("Não foi possível abrir a sessão.");
+
+    return ok(token);
+}
+
+string RequestHandler::professores() {
+    TRACE_SPAN("RequestHandler::professores");
+
+    auto lista = professorController.list();
+    ostringstream out;
+
+    out << "OK " << lista.size() << "\n";
+    for (const auto& professor : lista)
+        out << professor->getId() << "\t" << professor->getNome() << "\t"
+            << professor->getDisciplina() << "\n";
+
+    return out.str();
+}
+
+string RequestHandler::horarios(const vector<string>& args) {
+    TRACE_SPAN("RequestHandler::horarios");
+
+    require_args(args, 1);
+
+    auto professor = professorController.read(parse_id(args[1]));
+
+    if (!professor)
+        throw invalid_argument("Professor não encontrado.");
+
+    auto disponiveis = professor->getHorariosDisponiveis();
+    ostringstream out;
+
+    out << "OK " << disponiveis->size() << "\n";
+    for (const auto& horario : *disponiveis)
+        out << horario->getId() << "\t" << horario->getInicio() << "\t"
+            << horario->getFim() << "\n";
+
+    return out.str();
+}
+
+string RequestHandler::agendamentos(const vector<string>& args) {
+    TRACE_SPAN("RequestHandler::agendamentos");
+
+    require_args(args, 1);
+
+    auto aluno = sessionService->getAluno(args[1]);
+    auto& lista = aluno->getAgendamentos();
+    ostringstream out;
+
+    out << "OK " << lista.size() << "\n";
+    for (const auto& agendamento : lista)
+        out << agendamento->getId() << "\t" << agendamento->getHorarioId()
+            << "\t" << agendamento->getStatusStr() << "\n";
+
+    return out.str();
+}
+
+string RequestHandler::pendentes(const vector<string>& args) {
+    TRACE_SPAN("RequestHandler::pendentes");
+
+    require_args(args, 1);
+
+    auto professor = sessionService->getProfessor(args[1]);
+    auto pendentes = agendamentoController.listarPendentes(professor->getId());
+    ostringstream out;
+
+    out << "OK " << pendentes->size() << "\n";
+    for (const auto& agendamento : *pendentes)
+        out << agendamento->getId() << "\t" << agendamento->getHorarioId()
+            << "\t" << agendamento->getAlunoId() << "\n";
+
+    return out.str();
+}
+
+string RequestHandler::agendar(const vector<string>& args) {
+    TRACE_SPAN("RequestHandler::agendar");
+
+    require_args(args, 2);
+
+    auto aluno = sessionService->getAluno(args[1]);
+    auto agendamento =
+        agendamentoController.agendarHorario(aluno->getId(), parse_id(args[2]));
+
+    return ok(to_string(agendamento->getId()));
+}
+
+string RequestHandler::alterarStatus(const vector<string>& args,
+                                     const Status& status) {
+    TRACE_SPAN("RequestHandler::alterarStatus");
+
+    require_args(args, 2);
+
+    const string& token = args[1];
+    long id = parse_id(args[2]);
+
+    auto agendamento = agendamentoController.read(id);
+
+    if (!agendamento)
+        throw invalid_argument("Agendamento não encontrado.");
+
+    bool permitido = false;
+
+    if (sessionService->isProfessor(token)) {
+        auto horario = agendamento->getHorario();
+        permitido = horario && horario->getProfessorId() ==
+                                   sessionService->getProfessor(token)->getId();
+    } else if (status == Status::CANCELADO) {
+        permitido = agendamento->getAlunoId() ==
+                    sessionService->getAluno(token)->getId();
+    } else if (!sessionService->isLogged(token)) {
+        throw runtime_error("Nenhum usuário logado");
+    }
+
+    if (!permitido)
+        throw invalid_argument("Operação não permitida para este usuário.");
+
+    if (status == Status::CONFIRMADO)
+        agendamentoController.confirmar(id);
+    else if (status == Status::RECUSADO)
+        agendamentoController.recusar(id);
+    else
+        agendamentoController.cancelar(id);
+
+    return ok();
+}
+
+string RequestHandler::alterarStatusEmLote(const vector<string>& args,
+                                           const Status& status) {
+    TRACE_SPAN("RequestHandler::alterarStatusEmLote");
+
+    if (args.size() < 3)
+        throw invalid_argument("Uso: " + args[0] +
+                               " exige um token e ao menos um ID.");
+
+    auto professor = sessionService->getProfessor(args[1]);
+    vector<long> ids;
+
+    for (size_t i = 2; i < args.size(); ++i)
+        ids.push_back(parse_id(args[i]));
+
+    // Só os pedidos da caixa de entrada do professor são alterados; os demais
+    // voltam como erro na própria linha.
+    auto resultados =
+        status == Status::CONFIRMADO
+            ? agendamentoController.confirmarPendentes(professor->getId(), ids)
+            : agendamentoController.recusarPendentes(professor->getId(), ids);
+    ostringstream out;
+
+    out << "OK " << resultados.size() << "\n";
+    for (const auto& resultado : resultados)
+        out << resultado.id << "\t"
+            << (resultado.sucesso ? ok() : err(resultado.erro));
+
+    return out.str();
+}
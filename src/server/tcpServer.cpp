@@ -0,0 +1,400 @@
+#include "server/tcpServer.hpp"
+
+#include <stdexcept>
+
+using std::lock_guard;
+using std::make_unique;
+using std::mutex;
+using std::pair;
+using std::runtime_error;
+using std::string;
+using std::vector;
+
+#ifdef __linux__
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#define LISTEN_ID 0
+#define WAKE_ID 1
+#define MAX_EVENTS 64
+#define READ_CHUNK 4096
+#define MAX_LINE 65536
+#define MAX_INPUT (1 << 20)
+#define MAX_OUTPUT (1 << 20)
+
+static runtime_error system_error(const string& acao) {
+    return runtime_error("Falha ao " + acao + ": " + strerror(errno));
+}
+
+static void epoll_set(int epollFd, int op, int fd, uint32_t events,
+                      uint64_t id) {
+    epoll_event ev{};
+    ev.events = events;
+    ev.data.u64 = id;
+
+    if (epoll_ctl(epollFd, op, fd, &ev) < 0)
+        throw system_error("registrar socket no epoll");
+}
+
+TcpServer::TcpServer(RequestHandler& handler, size_t workers)
+    : handler(handler), pool(make_unique<ThreadPool>(workers)) {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0)
+        throw system_error("criar epoll");
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0)
+        throw system_error("criar eventfd");
+
+    epoll_set(epollFd, EPOLL_CTL_ADD, wakeFd, EPOLLIN, WAKE_ID);
+}
+
+TcpServer::~TcpServer() {
+    // Aguarda os lotes em andamento antes de fechar os descritores que eles
+    // usam para acordar o laço.
+    pool.reset();
+
+    for (auto& par : connections)
+        ::close(par.second.fd);
+
+    if (listenFd >= 0)
+        ::close(listenFd);
+    if (wakeFd >= 0)
+        ::close(wakeFd);
+    if (epollFd >= 0)
+        ::close(epollFd);
+}
+
+uint16_t TcpServer::listen(uint16_t port, const string& address) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+
+    if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1)
+        throw runtime_error("Endereço inválido: " + address);
+
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0)
+        throw system_error("criar socket");
+
+    int on = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0)
+        throw system_error("associar a porta " + std::to_string(port));
+
+    if (::listen(listenFd, SOMAXCONN) < 0)
+        throw system_error("escutar na porta " + std::to_string(port));
+
+    socklen_t len = sizeof(addr);
+    getsockname(listenFd, reinterpret_cast<sockaddr*>(&addr), &len);
+    boundPort = ntohs(addr.sin_port);
+
+    epoll_set(epollFd, EPOLL_CTL_ADD, listenFd, EPOLLIN, LISTEN_ID);
+
+    return boundPort;
+}
+
+uint16_t TcpServer::port() const {
+    return boundPort;
+}
+
+void TcpServer::run() {
+    if (listenFd < 0)
+        throw runtime_error("O servidor não está escutando em nenhuma porta.");
+
+    running = true;
+
+    epoll_event events[MAX_EVENTS];
+
+    while (running) {
+        int n = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            throw system_error("aguardar eventos");
+        }
+
+        for (int i = 0; i < n; ++i) {
+            uint64_t id = events[i].data.u64;
+            uint32_t ev = events[i].events;
+
+            if (id == LISTEN_ID) {
+                acceptAll();
+                continue;
+            }
+
+            if (id == WAKE_ID) {
+                uint64_t count;
+                while (read(wakeFd, &count, sizeof(count)) > 0) {
+                }
+                collectDone();
+                continue;
+            }
+
+            auto it = connections.find(id);
+            if (it == connections.end())
+                continue;
+
+            if ((ev & EPOLLERR) || ((ev & EPOLLIN) && !readFrom(it->second))) {
+                close(id);
+                continue;
+            }
+
+            if ((ev & EPOLLHUP) && !(ev & EPOLLIN))
+                it->second.eof = true;
+
+            progress(id);
+        }
+    }
+
+    for (auto& par : connections)
+        ::close(par.second.fd);
+    connections.clear();
+}
+
+void TcpServer::stop() {
+    running = false;
+    wake();
+}
+
+void TcpServer::wake() {
+    uint64_t one = 1;
+    ssize_t written = write(wakeFd, &one, sizeof(one));
+    (void)written;
+}
+
+void TcpServer::acceptAll() {
+    while (true) {
+        int fd = accept4(listenFd, nullptr, nullptr,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            return;
+        }
+
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+        uint64_t id = nextId++;
+        Connection conn;
+        conn.fd = fd;
+        conn.events = EPOLLIN;
+
+        epoll_set(epollFd, EPOLL_CTL_ADD, fd, conn.events, id);
+        connections.emplace(id, std::move(conn));
+    }
+}
+
+bool TcpServer::readFrom(Connection& conn) {
+    char buffer[READ_CHUNK];
+
+    // O restante fica no socket até que a entrada seja consumida; o epoll
+    // (disparado por nível) volta a avisar quando a leitura for religada.
+    while (conn.input.size() < MAX_INPUT) {
+        ssize_t n = recv(conn.fd, buffer, sizeof(buffer), 0);
+
+        if (n > 0) {
+            conn.input.append(buffer, n);
+
+            if (conn.input.size() > MAX_LINE &&
+                conn.input.find('\n') == string::npos)
+                return false;
+            continue;
+        }
+
+        if (n == 0) {
+            conn.eof = true;
+            return true;
+        }
+
+        if (errno == EINTR)
+            continue;
+
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+
+    return true;
+}
+
+void TcpServer::dispatch(uint64_t id, Connection& conn) {
+    // As respostas ainda não enviadas também seguram as próximas linhas: um
+    // cliente que não lê não acumula saída no servidor.
+    if (conn.busy || conn.output.size() > MAX_OUTPUT)
+        return;
+
+    vector<string> lines;
+    size_t start = 0, end;
+
+    while ((end = conn.input.find('\n', start)) != string::npos) {
+        string line = conn.input.substr(start, end - start);
+        start = end + 1;
+
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        if (line == "QUIT") {
+            conn.eof = true;
+            start = conn.input.size();
+            break;
+        }
+
+        if (!line.empty())
+            lines.push_back(std::move(line));
+    }
+
+    conn.input.erase(0, start);
+
+    // Uma última linha sem '\n' também é atendida quando o cliente encerra o
+    // envio.
+    if (conn.eof && !conn.input.empty()) {
+        lines.push_back(std::move(conn.input));
+        conn.input.clear();
+    }
+
+    if (lines.empty())
+        return;
+
+    conn.busy = true;
+
+    pool->post([this, id, lines = std::move(lines)]() {
+        string responses;
+
+        for (const auto& line : lines)
+            responses += handler.handle(line);
+
+        {
+            lock_guard<mutex> lock(doneMx);
+            done.emplace_back(id, std::move(responses));
+        }
+
+        wake();
+    });
+}
+
+bool TcpServer::flush(Connection& conn) {
+    size_t sent = 0;
+
+    while (sent < conn.output.size()) {
+        ssize_t n = send(conn.fd, conn.output.data() + sent,
+                         conn.output.size() - sent, MSG_NOSIGNAL);
+
+        if (n > 0) {
+            sent += n;
+            continue;
+        }
+
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+
+        return false;
+    }
+
+    conn.output.erase(0, sent);
+
+    return true;
+}
+
+void TcpServer::progress(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end())
+        return;
+
+    Connection& conn = it->second;
+
+    dispatch(id, conn);
+
+    if (!flush(conn)) {
+        close(id);
+        return;
+    }
+
+    if (conn.eof && !conn.busy && conn.output.empty()) {
+        close(id);
+        return;
+    }
+
+    uint32_t events = 0;
+    if (!conn.eof && !conn.busy && conn.output.size() <= MAX_OUTPUT &&
+        conn.input.size() < MAX_INPUT)
+        events |= EPOLLIN;
+    if (!conn.output.empty())
+        events |= EPOLLOUT;
+
+    if (events != conn.events) {
+        epoll_set(epollFd, EPOLL_CTL_MOD, conn.fd, events, id);
+        conn.events = events;
+    }
+}
+
+void TcpServer::collectDone() {
+    vector<pair<uint64_t, string>> ready;
+
+    {
+        lock_guard<mutex> lock(doneMx);
+        ready.swap(done);
+    }
+
+    for (auto& par : ready) {
+        auto it = connections.find(par.first);
+        if (it == connections.end())
+            continue;
+
+        it->second.output += par.second;
+        it->second.busy = false;
+
+        progress(par.first);
+    }
+}
+
+void TcpServer::close(uint64_t id) {
+    auto it = connections.find(id);
+    if (it == connections.end())
+        return;
+
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+    ::close(it->second.fd);
+
+    // Um lote ainda no pool para esta conexão terá a resposta descartada em
+    // collectDone(), já que o ID não é reutilizado.
+    connections.erase(it);
+}
+
+#else
+
+TcpServer::TcpServer(RequestHandler& handler, size_t workers)
+    : handler(handler), pool(make_unique<ThreadPool>(workers)) {}
+
+TcpServer::~TcpServer() = default;
+
+uint16_t TcpServer::listen(uint16_t port, const string& address) {
+    throw runtime_error("O modo servidor está disponível apenas no Linux.");
+}
+
+void TcpServer::run() {
+    throw runtime_error("O modo servidor está disponível apenas no Linux.");
+}
+
+void TcpServer::stop() {
+    running = false;
+}
+
+uint16_t TcpServer::port() const {
+    return boundPort;
+}
+
+#endif
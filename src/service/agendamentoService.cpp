@@ -5,19 +5,32 @@
 #include "event/events.hpp"
 #include "service/alunoService.hpp"
 #include "service/horarioService.hpp"
+#include "util/academicTerm.hpp"
+#include "util/metrics.hpp"
+#include "util/tracing.hpp"
 
+using std::function;
 using std::invalid_argument;
+using std::lock_guard;
+using std::lower_bound;
 using std::make_shared;
+using std::map;
+using std::mutex;
+using std::pair;
 using std::runtime_error;
+using std::set;
 using std::shared_ptr;
 using std::sort;
+using std::stol;
 using std::string;
 using std::stringstream;
 using std::to_string;
+using std::unordered_map;
 using std::vector;
 
 #define ID_ALUNO_COL_INDEX 1
 #define ID_HORARIO_COL_INDEX 2
+#define STATUS_COL_INDEX 3
 
 AgendamentoService::AgendamentoService(EntityManager* manager,
                                        const MockConnection& connection,
@@ -25,9 +38,183 @@ AgendamentoService::AgendamentoService(EntityManager* manager,
     : manager(manager),
       connection(connection),
       bus(bus),
-      cache({AGENDAMENTO_TABLE, HORARIO_TABLE}) {}
+      cache({AGENDAMENTO_TABLE, HORARIO_TABLE}),
+      inboxObserver({AGENDAMENTO_TABLE}),
+      sortedObserver({AGENDAMENTO_TABLE, HORARIO_TABLE}) {}
+
+bool AgendamentoCursor::operator<(const AgendamentoCursor& other) const {
+    if (prioridade != other.prioridade)
+        return prioridade < other.prioridade;
+
+    if (inicio != other.inicio)
+        return inicio > other.inicio;
+
+    if (fim != other.fim)
+        return fim > other.fim;
+
+    return id > other.id;
+}
+
+// Retorna o ID do horário de uma linha de agendamento.
+static long idHorarioOf(const string& line) {
+    size_t first = line.find(',');
+    size_t second = line.find(',', first + 1);
+
+    return stol(line.substr(second + 1));
+}
+
+// Ordena agendamentos pelo ID, que é a ordem dos pedidos.
+static bool byId(const shared_ptr<Agendamento>& agendamento, long id) {
+    return agendamento->getId() < id;
+}
+
+void AgendamentoService::refreshInbox() {
+    TRACE_SPAN("AgendamentoService::refreshInbox");
+
+    // As escritas deste service atualizam as caixas e consomem a alteração
+    // do arquivo logo em seguida; uma alteração pendente aqui vem de fora.
+    if (!inboxObserver.hasFileChanged() && inboxReady)
+        return;
+
+    inbox.clear();
+    inboxOwners.clear();
+
+    cache.invalidate();
+
+    // Os pedidos pendentes e, com uma única leitura da tabela de horários,
+    // os horários deles, que loadAgendamento() encontra depois no cache.
+    vector<string> pendentes;
+    set<long> idsHorarios;
+    string pendente(stringify(Status::PENDENTE));
+
+    for (const string& line : connection.selectAll(AGENDAMENTO_TABLE)) {
+        if (line.compare(line.rfind(',') + 1, string::npos, pendente) != 0)
+            continue;
+
+        pendentes.push_back(line);
+        idsHorarios.insert(idHorarioOf(line));
+    }
+
+    unordered_map<long, shared_ptr<Horario>> horarios;
+
+    for (const auto& horario :
+         manager->getHorarioService()->getByIds(idsHorarios))
+        horarios[horario->getId()] = horario;
+
+    // Só os horários do período letivo corrente em diante.
+    Timestamp inicioPeriodo = current_term().inicio;
+    map<long, Horario::AgendamentoVector> caixas;
+
+    for (const string& line : pendentes) {
+        auto horario = horarios.find(idHorarioOf(line));
+
+        if (horario == horarios.end() ||
+            horario->second->getInicio() < inicioPeriodo)
+            continue;
+
+        long idProfessor = horario->second->getProfessorId();
+        long id = getIdFromLine(line);
+        auto agendamento = cache.find(id);
+
+        if (!agendamento) {
+            agendamento = loadAgendamento(line);
+            cache.put(id, agendamento);
+        }
+
+        caixas[idProfessor].push_back(agendamento);
+        inboxOwners[id] = idProfessor;
+    }
+
+    for (auto& [idProfessor, caixa] : caixas) {
+        sort(caixa.begin(), caixa.end(),
+             [](const shared_ptr<Agendamento>& a,
+                const shared_ptr<Agendamento>& b) {
+                 return a->getId() < b->getId();
+             });
+
+        inbox[idProfessor] =
+            make_shared<const Horario::AgendamentoVector>(std::move(caixa));
+    }
+
+    inboxReady = true;
+}
+
+void AgendamentoService::inboxPut(const shared_ptr<Horario>& horario,
+                                  const shared_ptr<Agendamento>& agendamento) {
+    if (horario->getInicio() < current_term().inicio)
+        return;
+
+    long idProfessor = horario->getProfessorId();
+    Horario::AgendamentoVector caixa;
+
+    if (auto it = inbox.find(idProfessor); it != inbox.end())
+        caixa = *it->second;
+
+    caixa.insert(lower_bound(caixa.begin(), caixa.end(), agendamento->getId(),
+                             byId),
+                 agendamento);
+
+    inbox[idProfessor] =
+        make_shared<const Horario::AgendamentoVector>(std::move(caixa));
+    inboxOwners[agendamento->getId()] = idProfessor;
+}
+
+void AgendamentoService::inboxWritten(const function<void()>& apply) {
+    // Dentro de uma transação, a tabela só muda no commit, e as caixas,
+    // que as outras threads leem, também.
+    if (Transaction* transaction = Transaction::current(connection)) {
+        transaction->onCommit([this, apply] {
+            lock_guard<mutex> lock(inboxMx);
+            inboxObserver.hasFileChanged();
+
+            if (apply)
+                apply();
+        });
+    } else {
+        inboxObserver.hasFileChanged();
+
+        if (apply)
+            apply();
+    }
+}
+
+void AgendamentoService::agendamentosWritten(
+    const vector<shared_ptr<Agendamento>>& gravados,
+    const map<long, long>& excluidos) {
+    Transaction::afterCommit(connection, [this, gravados, excluidos] {
+        const auto& horarioService = manager->getHorarioService();
+
+        for (const auto& [id, idHorario] : excluidos)
+            horarioService->applyAgendamentoRemoval(idHorario, id);
+
+        for (const auto& agendamento : gravados)
+            horarioService->applyAgendamentoUpdate(agendamento);
+
+        horarioService->absorb();
+    });
+}
+
+void AgendamentoService::inboxErase(long id) {
+    auto owner = inboxOwners.find(id);
+
+    if (owner == inboxOwners.end())
+        return;
+
+    Horario::AgendamentoVector caixa(*inbox[owner->second]);
+    auto at = lower_bound(caixa.begin(), caixa.end(), id, byId);
+
+    if (at != caixa.end() && (*at)->getId() == id)
+        caixa.erase(at);
+
+    inbox[owner->second] =
+        make_shared<const Horario::AgendamentoVector>(std::move(caixa));
+    inboxOwners.erase(owner);
+}
 
 shared_ptr<Agendamento> AgendamentoService::save(long alunoId, long horarioId) {
+    METRIC_SCOPE("AgendamentoService::save");
+    TRACE_SPAN("AgendamentoService::save");
+
     auto horarioService = manager->getHorarioService();
 
     if (!horarioService->isDisponivelById(horarioId)) {
@@ -38,22 +225,33 @@ shared_ptr<Agendamento> AgendamentoService::save(long alunoId, long horarioId) {
     stringstream dados;
     dados << alunoId << "," << horarioId << "," << "PENDENTE";
 
+    lock_guard<mutex> lock(inboxMx);
+
+    refreshInbox();
+
     long newId = connection.insert(AGENDAMENTO_TABLE, dados.str());
 
+    inboxWritten();
+
     string new_record_csv = to_string(newId) + "," + dados.str();
 
     auto salvo = loadAgendamento(new_record_csv);
 
     cache.put(newId, salvo);
+    agendamentosWritten({salvo});
+    inboxPut(horarioService->getById(horarioId), salvo);
 
     return salvo;
 }
 
 shared_ptr<Agendamento> AgendamentoService::getById(long id) {
+    METRIC_SCOPE("AgendamentoService::getById");
+    TRACE_SPAN("AgendamentoService::getById");
+
     cache.invalidate();
 
-    if (cache.contains(id))
-        return cache.at(id);
+    if (auto cached = cache.find(id))
+        return cached;
 
     string linha = connection.selectOne(AGENDAMENTO_TABLE, id);
 
@@ -67,43 +265,100 @@ shared_ptr<Agendamento> AgendamentoService::getById(long id) {
 shared_ptr<Agendamento> AgendamentoService::updateById(long id, long alunoId,
                                                        long horarioId,
                                                        const Status& status) {
-    if (status == Status::CONFIRMADO) {
-        auto horarioService = manager->getHorarioService();
+    METRIC_SCOPE("AgendamentoService::updateById");
+    TRACE_SPAN("AgendamentoService::updateById");
 
-        if (!horarioService->isDisponivelById(horarioId))
-            throw invalid_argument(
-                "Este horário não está aberto para agendamentos.");
-    }
+    auto horarioService = manager->getHorarioService();
 
-    shared_ptr<Agendamento> late = getById(id);
+    stringstream dados;
+    dados << alunoId << "," << horarioId << "," << stringify(status);
 
-    if (!late)
-        return nullptr;
+    shared_ptr<Agendamento> updated;
+    long liberado = -1;
 
-    long lateHorarioId = late->getHorarioId();
-    Status lateStatus = late->getStatus();
+    {
+        lock_guard<mutex> lock(inboxMx);
 
-    stringstream dados;
-    dados << alunoId << "," << horarioId << "," << stringify(status);
-    connection.update(AGENDAMENTO_TABLE, id, dados.str());
+        refreshInbox();
 
-    if (lateStatus == Status::CONFIRMADO && status != Status::CONFIRMADO) {
-        this->bus.publish(HorarioLiberadoEvent(lateHorarioId));
-    } else if (lateStatus != Status::CONFIRMADO &&
-               status == Status::CONFIRMADO) {
-        this->bus.publish(HorarioOcupadoEvent(horarioId));
-    }
+        for (int attempt = 1;; ++attempt) {
+            shared_ptr<Agendamento> late = getById(id);
+
+            if (!late)
+                return nullptr;
+
+            long lateHorarioId = late->getHorarioId();
+            Status lateStatus = late->getStatus();
+
+            bool ocupa = lateStatus != Status::CONFIRMADO &&
+                         status == Status::CONFIRMADO;
+            bool libera = lateStatus == Status::CONFIRMADO &&
+                          status != Status::CONFIRMADO;
+
+            if (ocupa && !horarioService->reservarById(horarioId))
+                throw invalid_argument(
+                    "Este horário não está aberto para agendamentos.");
+
+            bool gravado;
+
+            try {
+                gravado = connection.compareAndUpdate(
+                    AGENDAMENTO_TABLE, id, STATUS_COL_INDEX,
+                    string(stringify(lateStatus)), dados.str());
+            } catch (...) {
+                if (ocupa)
+                    horarioService->liberarById(horarioId);
+                throw;
+            }
+
+            if (!gravado) {
+                // Outro escritor alterou o status desde a leitura: desfaz a
+                // reserva e tenta de novo a partir do estado persistido.
+                if (ocupa)
+                    horarioService->liberarById(horarioId);
+
+                cache.erase(id);
+
+                if (attempt == TRANSACTION_MAX_ATTEMPTS)
+                    throw TransactionConflict(
+                        "O agendamento foi alterado por outra operação.");
+
+                continue;
+            }
+
+            inboxWritten();
+
+            // A confirmação já reservou o horário acima (reservarById()).
+            if (libera)
+                liberado = lateHorarioId;
+
+            break;
+        }
+
+        string updatedStr = to_string(id) + "," + dados.str();
+        updated = loadAgendamento(updatedStr);
 
-    string updatedStr = to_string(id) + "," + dados.str();
-    auto updated = loadAgendamento(updatedStr);
+        cache.put(id, updated);
+        agendamentosWritten({updated});
+
+        inboxErase(id);
+        if (status == Status::PENDENTE)
+            inboxPut(horarioService->getById(horarioId), updated);
+    }
 
-    cache.put(id, updated);
+    // Publicado fora de inboxMx: o HorarioService grava o horário e avisa os
+    // assinantes, que podem voltar a este service.
+    if (liberado != -1)
+        bus.publish(HorarioLiberadoEvent(liberado));
 
     return updated;
 }
 
 shared_ptr<Agendamento> AgendamentoService::updateStatusById(
     long id, const Status& status) {
+    METRIC_SCOPE("AgendamentoService::updateStatusById");
+    TRACE_SPAN("AgendamentoService::updateStatusById");
+
     auto agendamento = getById(id);
 
     if (!agendamento)
@@ -113,27 +368,281 @@ shared_ptr<Agendamento> AgendamentoService::updateStatusById(
                       agendamento->getHorarioId(), status);
 }
 
-bool AgendamentoService::deleteById(long id) {
-    auto agendamento = getById(id);
+Horario::AgendamentoView AgendamentoService::listPendentesByIdProfessor(
+    long idProfessor) {
+    METRIC_SCOPE("AgendamentoService::listPendentesByIdProfessor");
+    TRACE_SPAN("AgendamentoService::listPendentesByIdProfessor");
 
-    if (!agendamento)
-        return false;
+    lock_guard<mutex> lock(inboxMx);
+
+    refreshInbox();
+
+    auto it = inbox.find(idProfessor);
+
+    if (it == inbox.end())
+        return make_shared<const Horario::AgendamentoVector>();
+
+    return it->second;
+}
+
+vector<StatusUpdateResult> AgendamentoService::applyStatusUpdates(
+    const vector<pair<long, Status>>& mudancas) {
+    TRACE_SPAN("AgendamentoService::applyStatusUpdates");
+
+    auto horarioService = manager->getHorarioService();
+    size_t n = mudancas.size();
+    vector<StatusUpdateResult> results(n);
+    map<long, size_t> itens;
+
+    for (size_t i = 0; i < n; ++i) {
+        results[i].id = mudancas[i].first;
+
+        if (!itens.emplace(mudancas[i].first, i).second)
+            results[i].erro = "Agendamento repetido no lote.";
+    }
+
+    // O estado atual de todos os agendamentos do lote, em uma leitura.
+    vector<shared_ptr<Agendamento>> atuais(n);
+
+    for (const string& line : connection.selectAll(AGENDAMENTO_TABLE)) {
+        auto it = itens.find(getIdFromLine(line));
+
+        if (it != itens.end())
+            atuais[it->second] = loadAgendamento(line);
+    }
+
+    map<long, size_t> reservas;
+    set<long> liberacoes;
+
+    for (auto& [id, i] : itens) {
+        if (!atuais[i]) {
+            results[i].erro = "Agendamento não encontrado.";
+            continue;
+        }
+
+        if (atuais[i]->getStatus() == Status::CONFIRMADO &&
+            mudancas[i].second != Status::CONFIRMADO)
+            liberacoes.insert(atuais[i]->getHorarioId());
+    }
+
+    for (auto& [id, i] : itens) {
+        if (!atuais[i] || atuais[i]->getStatus() == Status::CONFIRMADO ||
+            mudancas[i].second != Status::CONFIRMADO)
+            continue;
+
+        if (!reservas.emplace(atuais[i]->getHorarioId(), i).second)
+            results[i].erro = "Outro agendamento do lote ocupa este horário.";
+    }
+
+    // Um horário liberado e ocupado no mesmo lote continua ocupado; os
+    // demais mudam de disponibilidade em uma única escrita, antes dos
+    // agendamentos, para que duas confirmações nunca ocupem o mesmo horário.
+    map<long, bool> disponiveis;
+
+    for (const auto& reserva : reservas)
+        if (!liberacoes.count(reserva.first))
+            disponiveis[reserva.first] = false;
+
+    for (long horarioId : liberacoes)
+        if (!reservas.count(horarioId))
+            disponiveis[horarioId] = true;
+
+    set<long> alterados = horarioService->updateDisponivelByIds(disponiveis);
+
+    for (const auto& [horarioId, i] : reservas)
+        if (disponiveis.count(horarioId) && !alterados.count(horarioId))
+            results[i].erro = "Este horário não está aberto para agendamentos.";
+
+    map<long, pair<string, string>> changes;
+
+    for (auto& [id, i] : itens) {
+        if (!results[i].erro.empty())
+            continue;
+
+        const auto& atual = atuais[i];
+
+        if (atual->getStatus() == mudancas[i].second) {
+            results[i].sucesso = true;
+            results[i].agendamento = atual;
+            continue;
+        }
+
+        stringstream dados;
+        dados << atual->getAlunoId() << "," << atual->getHorarioId() << ","
+              << stringify(mudancas[i].second);
+
+        changes[id] = {string(stringify(atual->getStatus())), dados.str()};
+    }
+
+    // Desfaz as mudanças de disponibilidade dos horários de agendamentos que
+    // não foram gravados.
+    auto desfazer = [&](const set<long>& horarios) {
+        map<long, bool> volta;
+
+        for (long horarioId : horarios)
+            if (alterados.count(horarioId))
+                volta[horarioId] = !disponiveis[horarioId];
+
+        horarioService->updateDisponivelByIds(volta);
+    };
+
+    vector<long> gravados;
 
-    Status statusOriginal = agendamento->getStatus();
-    long horarioId = agendamento->getHorarioId();
+    try {
+        gravados = connection.compareAndUpdateMany(
+            AGENDAMENTO_TABLE, STATUS_COL_INDEX, changes);
+    } catch (...) {
+        desfazer(alterados);
+        throw;
+    }
+
+    if (!gravados.empty())
+        inboxWritten();
+
+    set<long> ok(gravados.begin(), gravados.end());
+    set<long> perdidos;
+    vector<shared_ptr<Agendamento>> atualizados;
 
-    connection.deleteRecord(AGENDAMENTO_TABLE, id);
+    for (const auto& [id, change] : changes) {
+        size_t i = itens[id];
+        long horarioId = atuais[i]->getHorarioId();
+
+        if (!ok.count(id)) {
+            results[i].erro = "O agendamento foi alterado por outra operação.";
+            perdidos.insert(horarioId);
+            continue;
+        }
 
-    cache.erase(id);
+        auto updated = loadAgendamento(to_string(id) + "," + change.second);
 
-    if (statusOriginal == Status::CONFIRMADO) {
-        bus.publish(HorarioLiberadoEvent(horarioId));
+        cache.put(id, updated);
+        atualizados.push_back(updated);
+
+        inboxErase(id);
+        if (updated->getStatus() == Status::PENDENTE)
+            inboxPut(horarioService->getById(horarioId), updated);
+
+        results[i].sucesso = true;
+        results[i].agendamento = updated;
     }
 
-    return true;
+    agendamentosWritten(atualizados);
+    desfazer(perdidos);
+
+    return results;
+}
+
+vector<StatusUpdateResult> AgendamentoService::updateStatusByIds(
+    const vector<pair<long, Status>>& mudancas) {
+    METRIC_SCOPE("AgendamentoService::updateStatusByIds");
+    TRACE_SPAN("AgendamentoService::updateStatusByIds");
+
+    lock_guard<mutex> lock(inboxMx);
+
+    refreshInbox();
+
+    return applyStatusUpdates(mudancas);
+}
+
+vector<StatusUpdateResult> AgendamentoService::updateStatusPendentes(
+    long idProfessor, const vector<long>& ids, const Status& status) {
+    METRIC_SCOPE("AgendamentoService::updateStatusPendentes");
+    TRACE_SPAN("AgendamentoService::updateStatusPendentes");
+
+    if (status != Status::CONFIRMADO && status != Status::RECUSADO)
+        throw invalid_argument(
+            "Um agendamento pendente só pode ser confirmado ou recusado.");
+
+    lock_guard<mutex> lock(inboxMx);
+
+    refreshInbox();
+
+    vector<StatusUpdateResult> results(ids.size());
+    vector<pair<long, Status>> mudancas;
+    vector<size_t> origem;
+    auto caixa = inbox.find(idProfessor);
+
+    for (size_t i = 0; i < ids.size(); ++i) {
+        results[i].id = ids[i];
+
+        bool pendente = false;
+
+        if (caixa != inbox.end()) {
+            const auto& pendentes = *caixa->second;
+            auto at =
+                lower_bound(pendentes.begin(), pendentes.end(), ids[i], byId);
+
+            pendente = at != pendentes.end() && (*at)->getId() == ids[i];
+        }
+
+        if (!pendente) {
+            results[i].erro =
+                "O agendamento não está pendente para o professor.";
+            continue;
+        }
+
+        mudancas.emplace_back(ids[i], status);
+        origem.push_back(i);
+    }
+
+    auto aplicados = applyStatusUpdates(mudancas);
+
+    for (size_t j = 0; j < aplicados.size(); ++j)
+        results[origem[j]] = aplicados[j];
+
+    return results;
+}
+
+void AgendamentoService::invalidateInbox() {
+    lock_guard<mutex> lock(inboxMx);
+
+    inboxReady = false;
+}
+
+bool AgendamentoService::deleteById(long id) {
+    METRIC_SCOPE("AgendamentoService::deleteById");
+    TRACE_SPAN("AgendamentoService::deleteById");
+
+    // O agendamento é lido dentro da transação, para que um conflito no
+    // commit refaça tudo a partir do status novo; a liberação do horário só
+    // é publicada no commit, para não liberar por uma exclusão desfeita.
+    return Transaction::retry(connection, [&] {
+        auto linhas =
+            connection.selectByColumn(AGENDAMENTO_TABLE, 0, to_string(id));
+
+        if (linhas.empty())
+            return false;
+
+        auto agendamento = loadAgendamento(linhas.front());
+
+        {
+            lock_guard<mutex> lock(inboxMx);
+
+            refreshInbox();
+
+            connection.deleteRecord(AGENDAMENTO_TABLE, id);
+
+            inboxWritten([this, id] { inboxErase(id); });
+            agendamentosWritten({}, {{id, agendamento->getHorarioId()}});
+
+            cache.erase(id);
+        }
+
+        if (agendamento->getStatus() == Status::CONFIRMADO) {
+            Transaction::afterCommit(
+                connection, [this, idHorario = agendamento->getHorarioId()] {
+                    bus.publish(HorarioLiberadoEvent(idHorario));
+                });
+        }
+
+        return true;
+    });
 }
 
 vector<shared_ptr<Agendamento>> AgendamentoService::listByIdAluno(long id) {
+    METRIC_SCOPE("AgendamentoService::listByIdAluno");
+    TRACE_SPAN("AgendamentoService::listByIdAluno");
+
     cache.invalidate();
 
     vector<shared_ptr<Agendamento>> agendamentos;
@@ -142,8 +651,8 @@ vector<shared_ptr<Agendamento>> AgendamentoService::listByIdAluno(long id) {
     for (const auto& linha : linhas) {
         long id = getIdFromLine(linha);
 
-        if (cache.contains(id))
-            agendamentos.push_back(cache.at(id));
+        if (auto cached = cache.find(id))
+            agendamentos.push_back(cached);
         else {
             auto agendamento = loadAgendamento(linha);
             cache.put(id, agendamento);
@@ -159,49 +668,242 @@ vector<shared_ptr<Agendamento>> AgendamentoService::listByIdAluno(long id) {
     return agendamentos;
 }
 
-bool AgendamentoService::deleteByIdAluno(long idAluno) {
-    auto agendamentos = listByIdAluno(idAluno);
+void AgendamentoService::refreshSorted() {
+    TRACE_SPAN("AgendamentoService::refreshSorted");
 
-    if (agendamentos.empty())
-        return false;
+    // Consulta o observador antes de ler as tabelas, para não perder uma
+    // escrita feita durante a montagem.
+    if (!sortedObserver.hasFileChanged() && sortedReady)
+        return;
 
-    vector<long> horariosParaLiberar;
+    sortedByAluno.clear();
+    sortedByHorario.clear();
+    sortedLines.clear();
 
-    for (const auto& agendamento : agendamentos) {
-        if (agendamento->getStatus() == Status::CONFIRMADO) {
-            horariosParaLiberar.push_back(agendamento->getHorarioId());
+    auto intervalos = manager->getHorarioService()->mapIntervalsById();
+
+    for (const string& line : connection.selectAll(AGENDAMENTO_TABLE)) {
+        stringstream ss(line);
+        string idStr, alunoIdStr, horarioIdStr, statusStr;
+
+        getline(ss, idStr, ',');
+        getline(ss, alunoIdStr, ',');
+        getline(ss, horarioIdStr, ',');
+        getline(ss, statusStr, ',');
+
+        // Um horário inexistente fica com o intervalo zerado; carregar o
+        // agendamento falha do mesmo jeito que em listByIdAluno().
+        AgendamentoCursor key;
+        auto intervalo = intervalos.find(stol(horarioIdStr));
+
+        key.prioridade = getStatusPriority(parseStatus(statusStr));
+        key.id = stol(idStr);
+
+        if (intervalo != intervalos.end()) {
+            key.inicio = intervalo->second.first;
+            key.fim = intervalo->second.second;
         }
 
-        cache.erase(agendamento->getId());
+        sortedByAluno[stol(alunoIdStr)].insert(key);
+        sortedByHorario[stol(horarioIdStr)].insert(key);
+        sortedLines[key.id] = line;
     }
 
-    connection.deleteByColumn(AGENDAMENTO_TABLE, ID_ALUNO_COL_INDEX,
-                              to_string(idAluno));
+    sortedReady = true;
+}
+
+AgendamentoPage AgendamentoService::pageOf(
+    const set<AgendamentoCursor>* sorted, const AgendamentoCursor& after,
+    size_t limit) {
+    AgendamentoPage page;
 
-    for (long horarioId : horariosParaLiberar) {
-        bus.publish(HorarioLiberadoEvent(horarioId));
+    if (!sorted)
+        return page;
+
+    for (auto it = sorted->upper_bound(after); it != sorted->end(); ++it) {
+        if (page.agendamentos.size() == limit) {
+            page.hasMore = true;
+            break;
+        }
+
+        auto agendamento = cache.find(it->id);
+        if (!agendamento) {
+            agendamento = loadAgendamento(sortedLines.at(it->id));
+            cache.put(it->id, agendamento);
+        }
+
+        page.agendamentos.push_back(agendamento);
+        page.next = *it;
     }
 
-    return true;
+    return page;
+}
+
+AgendamentoPage AgendamentoService::listPageByIdAluno(
+    long id, const AgendamentoCursor& after, size_t limit) {
+    METRIC_SCOPE("AgendamentoService::listPageByIdAluno");
+    TRACE_SPAN("AgendamentoService::listPageByIdAluno");
+
+    if (limit == 0)
+        throw invalid_argument("O tamanho da página deve ser positivo.");
+
+    cache.invalidate();
+
+    lock_guard<mutex> lock(sortedMx);
+
+    refreshSorted();
+
+    auto it = sortedByAluno.find(id);
+
+    return pageOf(it == sortedByAluno.end() ? nullptr : &it->second, after,
+                  limit);
+}
+
+bool AgendamentoService::deleteByIdAluno(long idAluno) {
+    METRIC_SCOPE("AgendamentoService::deleteByIdAluno");
+    TRACE_SPAN("AgendamentoService::deleteByIdAluno");
+
+    // Os agendamentos e os horários liberados são gravados juntos.
+    return Transaction::retry(connection, [&] {
+        auto agendamentos = listByIdAluno(idAluno);
+
+        if (agendamentos.empty())
+            return false;
+
+        map<long, bool> horariosParaLiberar;
+        map<long, long> excluidos;
+        set<long> ids;
+
+        {
+            lock_guard<mutex> lock(inboxMx);
+
+            refreshInbox();
+
+            for (const auto& agendamento : agendamentos) {
+                if (agendamento->getStatus() == Status::CONFIRMADO) {
+                    horariosParaLiberar[agendamento->getHorarioId()] = true;
+                }
+
+                cache.erase(agendamento->getId());
+                ids.insert(agendamento->getId());
+                excluidos[agendamento->getId()] = agendamento->getHorarioId();
+            }
+
+            connection.deleteByColumn(AGENDAMENTO_TABLE, ID_ALUNO_COL_INDEX,
+                                      to_string(idAluno));
+
+            inboxWritten([this, ids] {
+                for (long id : ids)
+                    inboxErase(id);
+            });
+            agendamentosWritten({}, excluidos);
+        }
+
+        // Em vez de um HorarioLiberadoEvent (e uma escrita) por horário,
+        // todos são liberados juntos depois da exclusão.
+        manager->getHorarioService()->updateDisponivelByIds(
+            horariosParaLiberar);
+
+        return true;
+    });
 }
 
 bool AgendamentoService::deleteByIdHorario(long idHorario) {
-    auto agendamentos = listByIdHorario(idHorario);
+    METRIC_SCOPE("AgendamentoService::deleteByIdHorario");
+    TRACE_SPAN("AgendamentoService::deleteByIdHorario");
+
+    return deleteByIdHorarios({idHorario}) > 0;
+}
+
+size_t AgendamentoService::deleteByIdHorarios(const set<long>& ids) {
+    METRIC_SCOPE("AgendamentoService::deleteByIdHorarios");
+    TRACE_SPAN("AgendamentoService::deleteByIdHorarios");
+
+    if (ids.empty())
+        return 0;
+
+    lock_guard<mutex> lock(inboxMx);
+
+    refreshInbox();
+
+    auto removed = connection.deleteWhere(
+        AGENDAMENTO_TABLE, [&ids](const string& line) {
+            return ids.count(idHorarioOf(line)) > 0;
+        });
 
-    if (agendamentos.empty())
-        return false;
+    set<long> removidos;
+    map<long, long> excluidos;
 
-    connection.deleteByColumn(AGENDAMENTO_TABLE, ID_HORARIO_COL_INDEX,
-                              to_string(idHorario));
+    for (const string& line : removed) {
+        cache.erase(getIdFromLine(line));
+        removidos.insert(getIdFromLine(line));
+        excluidos[getIdFromLine(line)] = idHorarioOf(line);
+    }
+
+    agendamentosWritten({}, excluidos);
+
+    inboxWritten([this, removidos] {
+        for (long id : removidos)
+            inboxErase(id);
+    });
+
+    return removed.size();
+}
+
+size_t AgendamentoService::archiveByIdHorarios(const set<long>& ids) {
+    METRIC_SCOPE("AgendamentoService::archiveByIdHorarios");
+    TRACE_SPAN("AgendamentoService::archiveByIdHorarios");
+
+    if (ids.empty())
+        return 0;
+
+    lock_guard<mutex> lock(inboxMx);
+
+    refreshInbox();
+
+    auto moved =
+        connection.moveWhere(AGENDAMENTO_TABLE, AGENDAMENTO_ARCHIVE_TABLE,
+                             [&ids](const string& line) {
+                                 return ids.count(idHorarioOf(line)) > 0;
+                             });
+
+    inboxWritten();
+
+    map<long, long> arquivados;
+
+    for (const string& line : moved) {
+        cache.erase(getIdFromLine(line));
+        inboxErase(getIdFromLine(line));
+        arquivados[getIdFromLine(line)] = idHorarioOf(line);
+    }
+
+    agendamentosWritten({}, arquivados);
+
+    return moved.size();
+}
+
+long AgendamentoService::lastIdHorario() {
+    METRIC_SCOPE("AgendamentoService::lastIdHorario");
+    TRACE_SPAN("AgendamentoService::lastIdHorario");
+
+    long maxId = 0, idHorario = -1;
+
+    for (const string& line : connection.selectAll(AGENDAMENTO_TABLE)) {
+        long id = getIdFromLine(line);
 
-    for (const auto& agendamento : agendamentos) {
-        cache.erase(agendamento->getId());
+        if (id > maxId) {
+            maxId = id;
+            idHorario = idHorarioOf(line);
+        }
     }
 
-    return true;
+    return idHorario;
 }
 
 vector<shared_ptr<Agendamento>> AgendamentoService::listByIdHorario(long id) {
+    METRIC_SCOPE("AgendamentoService::listByIdHorario");
+    TRACE_SPAN("AgendamentoService::listByIdHorario");
+
     cache.invalidate();
 
     vector<shared_ptr<Agendamento>> agendamentos;
@@ -210,8 +912,8 @@ vector<shared_ptr<Agendamento>> AgendamentoService::listByIdHorario(long id) {
     for (const auto& linha : linhas) {
         long id = getIdFromLine(linha);
 
-        if (cache.contains(id))
-            agendamentos.push_back(cache.at(id));
+        if (auto cached = cache.find(id))
+            agendamentos.push_back(cached);
         else {
             auto agendamento = loadAgendamento(linha);
             cache.put(id, agendamento);
@@ -227,8 +929,31 @@ vector<shared_ptr<Agendamento>> AgendamentoService::listByIdHorario(long id) {
     return agendamentos;
 }
 
+AgendamentoPage AgendamentoService::listPageByIdHorario(
+    long id, const AgendamentoCursor& after, size_t limit) {
+    METRIC_SCOPE("AgendamentoService::listPageByIdHorario");
+    TRACE_SPAN("AgendamentoService::listPageByIdHorario");
+
+    if (limit == 0)
+        throw invalid_argument("O tamanho da página deve ser positivo.");
+
+    cache.invalidate();
+
+    lock_guard<mutex> lock(sortedMx);
+
+    refreshSorted();
+
+    auto it = sortedByHorario.find(id);
+
+    return pageOf(it == sortedByHorario.end() ? nullptr : &it->second, after,
+                  limit);
+}
+
 shared_ptr<Agendamento> AgendamentoService::loadAgendamento(
     const string& line) {
+    METRIC_SCOPE("AgendamentoService::loadAgendamento");
+    TRACE_SPAN("AgendamentoService::loadAgendamento");
+
     stringstream ss(line);
     string idStr, alunoIdStr, horarioIdStr, statusStr;
 
@@ -1,8 +1,13 @@
 #include "service/alunoService.hpp"
 
+#include <unordered_set>
+
 #include "event/events.hpp"
 #include "service/agendamentoService.hpp"
+#include "util/metrics.hpp"
+#include "util/tracing.hpp"
 
+using std::function;
 using std::invalid_argument;
 using std::make_shared;
 using std::runtime_error;
@@ -10,6 +15,7 @@ using std::shared_ptr;
 using std::string;
 using std::stringstream;
 using std::to_string;
+using std::unordered_set;
 using std::vector;
 
 #define EMAIL_COL_INDEX 2
@@ -23,6 +29,9 @@ AlunoService::AlunoService(EntityManager* manager,
       cache({ALUNO_TABLE, AGENDAMENTO_TABLE, HORARIO_TABLE}) {}
 
 vector<shared_ptr<Aluno>> AlunoService::getByEmail(const string& email) {
+    METRIC_SCOPE("AlunoService::getByEmail");
+    TRACE_SPAN("AlunoService::getByEmail");
+
     cache.invalidate();
 
     vector<shared_ptr<Aluno>> alunos;
@@ -32,8 +41,8 @@ vector<shared_ptr<Aluno>> AlunoService::getByEmail(const string& email) {
     for (const auto& linha : linhas) {
         long id = getIdFromLine(linha);
 
-        if (cache.contains(id))
-            alunos.push_back(cache.at(id));
+        if (auto cached = cache.find(id))
+            alunos.push_back(cached);
         else {
             auto aluno = loadAluno(linha);
             cache.put(id, aluno);
@@ -45,6 +54,9 @@ vector<shared_ptr<Aluno>> AlunoService::getByEmail(const string& email) {
 }
 
 vector<shared_ptr<Aluno>> AlunoService::getByMatricula(long matricula) {
+    METRIC_SCOPE("AlunoService::getByMatricula");
+    TRACE_SPAN("AlunoService::getByMatricula");
+
     cache.invalidate();
 
     vector<shared_ptr<Aluno>> alunos;
@@ -54,8 +66,8 @@ vector<shared_ptr<Aluno>> AlunoService::getByMatricula(long matricula) {
     for (const auto& linha : linhas) {
         long id = getIdFromLine(linha);
 
-        if (cache.contains(id))
-            alunos.push_back(cache.at(id));
+        if (auto cached = cache.find(id))
+            alunos.push_back(cached);
         else {
             auto aluno = loadAluno(linha);
             cache.put(id, aluno);
@@ -67,10 +79,16 @@ vector<shared_ptr<Aluno>> AlunoService::getByMatricula(long matricula) {
 }
 
 bool AlunoService::existsByEmail(string email) {
+    METRIC_SCOPE("AlunoService::existsByEmail");
+    TRACE_SPAN("AlunoService::existsByEmail");
+
     return !getByEmail(email).empty();
 }
 
 bool AlunoService::existsByEmailAndIdNot(string email, long id) {
+    METRIC_SCOPE("AlunoService::existsByEmailAndIdNot");
+    TRACE_SPAN("AlunoService::existsByEmailAndIdNot");
+
     auto email_matches = getByEmail(email);
 
     for (const auto& aluno : email_matches) {
@@ -83,10 +101,16 @@ bool AlunoService::existsByEmailAndIdNot(string email, long id) {
 }
 
 bool AlunoService::existsByMatricula(long matricula) {
+    METRIC_SCOPE("AlunoService::existsByMatricula");
+    TRACE_SPAN("AlunoService::existsByMatricula");
+
     return !getByMatricula(matricula).empty();
 }
 
 bool AlunoService::existsByMatriculaAndIdNot(long matricula, long id) {
+    METRIC_SCOPE("AlunoService::existsByMatriculaAndIdNot");
+    TRACE_SPAN("AlunoService::existsByMatriculaAndIdNot");
+
     auto matricula_matches = getByMatricula(matricula);
 
     for (const auto& aluno : matricula_matches) {
@@ -100,6 +124,9 @@ bool AlunoService::existsByMatriculaAndIdNot(long matricula, long id) {
 
 shared_ptr<Aluno> AlunoService::save(const string& nome, const string& email,
                                      const string& senha, long matricula) {
+    METRIC_SCOPE("AlunoService::save");
+    TRACE_SPAN("AlunoService::save");
+
     if (existsByEmail(email)) {
         throw invalid_argument("O email '" + email +
                                "' já está em uso por outro aluno.");
@@ -122,11 +149,74 @@ shared_ptr<Aluno> AlunoService::save(const string& nome, const string& email,
     return salvo;
 }
 
+size_t AlunoService::saveAll(
+    const vector<ImportRow>& rows, ImportReport& report,
+    const function<void(vector<ImportRow>&)>& preparar) {
+    METRIC_SCOPE("AlunoService::saveAll");
+    TRACE_SPAN("AlunoService::saveAll");
+
+    // Emails e matrículas já cadastrados, em uma leitura da tabela; as
+    // linhas aceitas entram nos conjuntos, o que também recusa repetições
+    // dentro do próprio lote.
+    unordered_set<string> emails, matriculas;
+
+    for (const string& linha : connection.selectAll(ALUNO_TABLE)) {
+        stringstream ss(linha);
+        string campo;
+
+        for (size_t col = 0; getline(ss, campo, ','); ++col) {
+            if (col == EMAIL_COL_INDEX)
+                emails.insert(campo);
+            else if (col == MATRICULA_COL_INDEX)
+                matriculas.insert(campo);
+        }
+    }
+
+    vector<ImportRow> aceitos;
+
+    for (const auto& row : rows) {
+        const string& email = row.campos[1];
+        const string& matricula = row.campos[3];
+
+        if (!emails.insert(email).second) {
+            report.recusar(row.linha, "O email '" + email +
+                                          "' já está em uso por outro aluno.");
+            continue;
+        }
+        if (!matriculas.insert(matricula).second) {
+            emails.erase(email);
+            report.recusar(row.linha, "A matrícula '" + matricula +
+                                          "' já está registrada.");
+            continue;
+        }
+
+        aceitos.push_back(row);
+    }
+
+    // Só as linhas aceitas são preparadas (ex: hash das senhas).
+    if (preparar)
+        preparar(aceitos);
+
+    vector<string> dados;
+
+    for (const auto& row : aceitos)
+        dados.push_back(row.campos[0] + "," + row.campos[1] + "," +
+                        row.campos[2] + "," + row.campos[3]);
+
+    connection.insertMany(ALUNO_TABLE, dados);
+    report.importados += dados.size();
+
+    return dados.size();
+}
+
 shared_ptr<Aluno> AlunoService::getById(long id) {
+    METRIC_SCOPE("AlunoService::getById");
+    TRACE_SPAN("AlunoService::getById");
+
     cache.invalidate();
 
-    if (cache.contains(id))
-        return cache.at(id);
+    if (auto cached = cache.find(id))
+        return cached;
 
     string linha = connection.selectOne(ALUNO_TABLE, id);
 
@@ -138,6 +228,9 @@ shared_ptr<Aluno> AlunoService::getById(long id) {
 }
 
 shared_ptr<Aluno> AlunoService::getOneByEmail(const string& email) {
+    METRIC_SCOPE("AlunoService::getOneByEmail");
+    TRACE_SPAN("AlunoService::getOneByEmail");
+
     auto results = getByEmail(email);
 
     if (results.size() > 1) {
@@ -158,6 +251,9 @@ shared_ptr<Aluno> AlunoService::updateById(long id, const string& nome,
                                            const string& email,
                                            const string& senha,
                                            long matricula) {
+    METRIC_SCOPE("AlunoService::updateById");
+    TRACE_SPAN("AlunoService::updateById");
+
     if (existsByEmailAndIdNot(email, id)) {
         throw invalid_argument("O email '" + email +
                                "' já está em uso por outro aluno.");
@@ -185,17 +281,59 @@ shared_ptr<Aluno> AlunoService::updateById(long id, const string& nome,
     return updated;
 }
 
-bool AlunoService::deleteById(long id) {
-    auto aluno = getById(id);
+bool AlunoService::updateSenhaById(long id, const string& esperada,
+                                   const string& senha) {
+    METRIC_SCOPE("AlunoService::updateSenhaById");
+    TRACE_SPAN("AlunoService::updateSenhaById");
 
-    if (!aluno)
-        return false;
+    return Transaction::retry(connection, [&] {
+        auto linhas =
+            connection.selectByColumn(ALUNO_TABLE, 0, to_string(id));
+
+        if (linhas.empty())
+            return false;
+
+        auto late = loadAluno(linhas.front());
+
+        if (late->getSenha() != esperada)
+            return false;
+
+        stringstream dados;
+        dados << late->getNome() << "," << late->getEmail() << "," << senha
+              << "," << late->getMatricula();
+
+        connection.update(ALUNO_TABLE, id, dados.str());
+
+        auto updated = loadAluno(to_string(id) + "," + dados.str());
+
+        Transaction::afterCommit(
+            connection, [this, id, updated] { cache.put(id, updated); });
+
+        return true;
+    });
+}
+
+bool AlunoService::deleteById(long id) {
+    METRIC_SCOPE("AlunoService::deleteById");
+    TRACE_SPAN("AlunoService::deleteById");
 
     const auto& agendamentoService = manager->getAgendamentoService();
 
-    agendamentoService->deleteByIdAluno(id);
+    // Os agendamentos, os horários liberados e o aluno são gravados juntos,
+    // no commit; um conflito refaz a exclusão (ver Transaction::retry()).
+    bool excluido = Transaction::retry(connection, [&] {
+        if (connection.selectByColumn(ALUNO_TABLE, 0, to_string(id)).empty())
+            return false;
 
-    connection.deleteRecord(ALUNO_TABLE, id);
+        agendamentoService->deleteByIdAluno(id);
+
+        connection.deleteRecord(ALUNO_TABLE, id);
+
+        return true;
+    });
+
+    if (!excluido)
+        return false;
 
     cache.erase(id);
 
@@ -205,6 +343,9 @@ bool AlunoService::deleteById(long id) {
 }
 
 shared_ptr<Aluno> AlunoService::loadAluno(const string& line) {
+    METRIC_SCOPE("AlunoService::loadAluno");
+    TRACE_SPAN("AlunoService::loadAluno");
+
     stringstream ss(line);
     string idStr, nome, email, senha, matriculaStr;
 
@@ -1,108 +1,253 @@
 #include "service/horarioService.hpp"
 
 #include <algorithm>
+#include <limits>
+#include <set>
 
 #include "event/events.hpp"
+#include "model/agendamento.hpp"
 #include "service/agendamentoService.hpp"
+#include "service/professorService.hpp"
+#include "util/academicTerm.hpp"
+#include "util/metrics.hpp"
+#include "util/tracing.hpp"
 
+using std::function;
 using std::getline;
 using std::invalid_argument;
+using std::lock_guard;
 using std::make_shared;
+using std::map;
+using std::mutex;
+using std::numeric_limits;
+using std::pair;
 using std::runtime_error;
+using std::set;
 using std::shared_ptr;
 using std::sort;
 using std::stol;
 using std::string;
 using std::stringstream;
 using std::to_string;
+using std::unordered_map;
+using std::unordered_set;
 using std::vector;
 
 #define ID_PROFESSOR_COL_INDEX 1
+#define VERSAO_COL_INDEX 5
+
+// Retorna o registro de um horário no índice de horários.
+static TimeIndex::Entry entryOf(const Horario& horario) {
+    stringstream linha;
+    linha << horario.getId() << "," << horario.getProfessorId() << ","
+          << horario.getInicio() << "," << horario.getFim() << ","
+          << horario.isDisponivel() << "," << horario.getVersao();
+
+    return {horario.getInicio(), horario.getFim(), horario.getProfessorId(),
+            horario.getId(),     linha.str(),      horario.isDisponivel(),
+            horario.getVersao()};
+}
 
 HorarioService::HorarioService(EntityManager* manager,
                                const MockConnection& connection, EventBus& bus)
     : manager(manager),
       connection(connection),
       bus(bus),
-      cache({HORARIO_TABLE, AGENDAMENTO_TABLE}) {
+      // Como no ProfessorService, as escritas do processo são aplicadas e
+      // absorvidas (ver absorb()); a observação é para as edições de fora.
+      cache({HORARIO_TABLE, AGENDAMENTO_TABLE}),
+      indexObserver({HORARIO_TABLE}),
+      disciplinasObserver({PROFESSOR_TABLE}),
+      intervalsObserver({HORARIO_TABLE}) {
     bus.subscribe<HorarioLiberadoEvent>(
         [this](const HorarioLiberadoEvent& event) {
-            updateDisponivelById(event.horarioId, true);
-        });
-
-    bus.subscribe<HorarioOcupadoEvent>(
-        [this](const HorarioOcupadoEvent& event) {
-            updateDisponivelById(event.horarioId, false);
+            liberarById(event.horarioId);
         });
 }
 
 shared_ptr<Horario> HorarioService::save(long idProfessor, Timestamp inicio,
                                          Timestamp fim) {
+    METRIC_SCOPE("HorarioService::save");
+    TRACE_SPAN("HorarioService::save");
+
     if (fim <= inicio) {
         throw invalid_argument(
             "O horário final deve ser posterior ao horário inicial.");
     }
 
-    auto horarios = listByIdProfessor(idProfessor);
+    lock_guard<mutex> lock(intervalsMx);
 
-    for (const auto& horario : horarios) {
-        if (inicio == horario->getInicio() && fim == horario->getFim()) {
-            throw invalid_argument(
-                "Já existe um horário cadastrado nesse período.");
-        }
-    }
+    refreshIntervals();
+    checkOverlap(idProfessor, inicio, fim, -1);
 
     stringstream dados;
-    dados << idProfessor << "," << inicio << "," << fim << ",1";
+    dados << idProfessor << "," << inicio << "," << fim << ",1,0";
     long newId = connection.insert(HORARIO_TABLE, dados.str());
 
+    intervals.insert(idProfessor, newId, inicio, fim);
+    intervalsWritten();
+
     string new_record_csv = to_string(newId) + "," + dados.str();
 
     auto salvo = loadHorario(new_record_csv);
 
-    cache.put(newId, salvo);
+    horariosWritten({salvo});
 
     return salvo;
 }
 
-bool HorarioService::deleteByIdProfessor(long id) {
-    auto horarios = listByIdProfessor(id);
+size_t HorarioService::saveAll(const vector<ImportRow>& rows,
+                               ImportReport& report) {
+    METRIC_SCOPE("HorarioService::saveAll");
+    TRACE_SPAN("HorarioService::saveAll");
 
-    if (horarios.empty())
-        return false;
+    auto professores = manager->getProfessorService()->mapIdsByEmail();
 
-    const auto& agendamentoService = manager->getAgendamentoService();
+    lock_guard<mutex> lock(intervalsMx);
+
+    refreshIntervals();
+
+    // Os horários aceitos do lote, identificados pela linha do arquivo, para
+    // recusar sobreposições dentro do próprio lote.
+    IntervalIndex lote;
+    vector<string> dados;
+    vector<pair<long, pair<Timestamp, Timestamp>>> aceitos;
+
+    for (const auto& row : rows) {
+        auto professor = professores.find(row.campos[0]);
+        Timestamp inicio = stol(row.campos[1]);
+        Timestamp fim = stol(row.campos[2]);
+
+        if (professor == professores.end()) {
+            report.recusar(row.linha, "Professor '" + row.campos[0] +
+                                          "' não encontrado.");
+            continue;
+        }
+        if (fim <= inicio) {
+            report.recusar(
+                row.linha,
+                "O horário final deve ser posterior ao horário inicial.");
+            continue;
+        }
+
+        long idProfessor = professor->second;
+
+        try {
+            checkOverlap(idProfessor, inicio, fim, -1);
+        } catch (const invalid_argument& e) {
+            report.recusar(row.linha, e.what());
+            continue;
+        }
+
+        auto conflitos = lote.overlapping(idProfessor, inicio, fim, -1);
+
+        if (!conflitos.empty()) {
+            report.recusar(row.linha, "Sobrepõe o horário da linha " +
+                                          to_string(conflitos.front()) + ".");
+            continue;
+        }
 
-    for (const auto& horario : horarios) {
-        cache.erase(horario->getId());
+        lote.insert(idProfessor, long(row.linha), inicio, fim);
 
-        agendamentoService->deleteByIdHorario(horario->getId());
+        stringstream linha;
+        linha << idProfessor << "," << inicio << "," << fim << ",1,0";
+        dados.push_back(linha.str());
+        aceitos.push_back({idProfessor, {inicio, fim}});
     }
 
-    connection.deleteByColumn(HORARIO_TABLE, ID_PROFESSOR_COL_INDEX,
-                              to_string(id));
+    long firstId = connection.insertMany(HORARIO_TABLE, dados);
+    vector<shared_ptr<Horario>> salvos;
 
-    return true;
+    for (size_t i = 0; i < aceitos.size(); ++i) {
+        intervals.insert(aceitos[i].first, firstId + long(i),
+                         aceitos[i].second.first, aceitos[i].second.second);
+        salvos.push_back(
+            loadHorario(to_string(firstId + long(i)) + "," + dados[i]));
+    }
+    intervalsWritten();
+    horariosWritten(salvos);
+
+    report.importados += dados.size();
+
+    return dados.size();
 }
 
-bool HorarioService::deleteById(long id) {
-    auto horario = getById(id);
+bool HorarioService::deleteByIdProfessor(long id) {
+    METRIC_SCOPE("HorarioService::deleteByIdProfessor");
+    TRACE_SPAN("HorarioService::deleteByIdProfessor");
 
-    if (!horario)
-        return false;
+    // A exclusão é planejada como uma operação de conjunto: os IDs dos
+    // horários são lidos uma vez, sem carregar os horários, e cada tabela é
+    // reescrita uma única vez, dos agendamentos (filhos) para os horários,
+    // no commit da transação.
+    set<long> ids;
+
+    bool excluido = Transaction::retry(connection, [&] {
+        ids.clear();
+
+        for (const string& linha : connection.selectByColumn(
+                 HORARIO_TABLE, ID_PROFESSOR_COL_INDEX, to_string(id)))
+            ids.insert(getIdFromLine(linha));
+
+        if (ids.empty())
+            return false;
+
+        lock_guard<mutex> lock(intervalsMx);
+
+        refreshIntervals();
+
+        manager->getAgendamentoService()->deleteByIdHorarios(ids);
+
+        connection.deleteByColumn(HORARIO_TABLE, ID_PROFESSOR_COL_INDEX,
+                                  to_string(id));
+
+        intervalsWritten([this, id] { intervals.eraseOwner(id); });
+
+        map<long, long> excluidos;
+        for (long horarioId : ids)
+            excluidos[horarioId] = id;
+        horariosWritten({}, excluidos);
+
+        return true;
+    });
+
+    return excluido;
+}
+
+bool HorarioService::deleteById(long id) {
+    METRIC_SCOPE("HorarioService::deleteById");
+    TRACE_SPAN("HorarioService::deleteById");
 
     const auto& agendamentoService = manager->getAgendamentoService();
 
-    agendamentoService->deleteByIdHorario(id);
+    return Transaction::retry(connection, [&] {
+        auto linhas =
+            connection.selectByColumn(HORARIO_TABLE, 0, to_string(id));
 
-    connection.deleteRecord(HORARIO_TABLE, id);
+        if (linhas.empty())
+            return false;
 
-    cache.erase(id);
+        long idProfessor = loadHorario(linhas.front())->getProfessorId();
 
-    return true;
+        agendamentoService->deleteByIdHorario(id);
+
+        lock_guard<mutex> lock(intervalsMx);
+
+        refreshIntervals();
+
+        connection.deleteRecord(HORARIO_TABLE, id);
+
+        intervalsWritten([this, id] { intervals.erase(id); });
+        horariosWritten({}, {{id, idProfessor}});
+
+        return true;
+    });
 }
 
 vector<shared_ptr<Horario>> HorarioService::listByIdProfessor(long id) {
+    METRIC_SCOPE("HorarioService::listByIdProfessor");
+    TRACE_SPAN("HorarioService::listByIdProfessor");
+
     cache.invalidate();
 
     vector<string> csv_records = connection.selectByColumn(
@@ -112,8 +257,8 @@ vector<shared_ptr<Horario>> HorarioService::listByIdProfessor(long id) {
     for (const string& csv_line : csv_records) {
         long id = getIdFromLine(csv_line);
 
-        if (cache.contains(id))
-            horarios.push_back(cache.at(id));
+        if (auto cached = cache.find(id))
+            horarios.push_back(cached);
         else {
             auto horario = loadHorario(csv_line);
             cache.put(id, horario);
@@ -128,11 +273,284 @@ vector<shared_ptr<Horario>> HorarioService::listByIdProfessor(long id) {
     return horarios;
 }
 
+void HorarioService::refreshIndex() {
+    TRACE_SPAN("HorarioService::refreshIndex");
+
+    // Consulta o observador antes de ler a tabela, para não perder uma
+    // escrita feita durante a reconstrução.
+    if (!indexObserver.hasFileChanged() && indexReady)
+        return;
+
+    vector<TimeIndex::Entry> entries;
+
+    for (const string& line : connection.selectAll(HORARIO_TABLE)) {
+        stringstream ss(line);
+        string idStr, professorIdStr, inicioStr, fimStr, disponivelStr;
+        string versaoStr;
+
+        getline(ss, idStr, ',');
+        getline(ss, professorIdStr, ',');
+        getline(ss, inicioStr, ',');
+        getline(ss, fimStr, ',');
+        getline(ss, disponivelStr, ',');
+        getline(ss, versaoStr, ',');
+
+        entries.push_back({stol(inicioStr), stol(fimStr), stol(professorIdStr),
+                           stol(idStr), line, disponivelStr == "1",
+                           versaoStr.empty() ? 0 : stol(versaoStr)});
+    }
+
+    index.build(std::move(entries));
+    indexReady = true;
+}
+
+void HorarioService::intervalsWritten(const function<void()>& apply) {
+    auto absorb = [this] {
+        lock_guard<mutex> lock(intervalsObserverMx);
+        intervalsObserver.hasFileChanged();
+    };
+
+    // Dentro de uma transação, a tabela só muda no commit, e os intervalos,
+    // que as outras threads consultam, também.
+    if (Transaction* transaction = Transaction::current(connection)) {
+        transaction->onCommit([this, apply, absorb] {
+            if (!apply)
+                return absorb();
+
+            lock_guard<mutex> lock(intervalsMx);
+            absorb();
+            apply();
+        });
+    } else {
+        absorb();
+
+        if (apply)
+            apply();
+    }
+}
+
+void HorarioService::horariosWritten(
+    const vector<shared_ptr<Horario>>& gravados,
+    const map<long, long>& excluidos) {
+    Transaction::afterCommit(connection, [this, gravados, excluidos] {
+        // O índice é atualizado antes, e com indexMx solto depois: a lista
+        // de um professor é carregada com ele travado.
+        {
+            lock_guard<mutex> lock(indexMx);
+            indexObserver.hasFileChanged();
+
+            if (indexReady) {
+                for (const auto& excluido : excluidos)
+                    index.erase(excluido.first);
+
+                for (const auto& horario : gravados)
+                    index.put(entryOf(*horario));
+            }
+        }
+
+        const auto& professorService = manager->getProfessorService();
+
+        for (const auto& [id, idProfessor] : excluidos) {
+            cache.erase(id);
+            professorService->applyHorarioRemoval(idProfessor, id);
+        }
+
+        // Commits concorrentes podem chegar aqui fora de ordem; a versão
+        // mais nova do horário é mantida.
+        for (const auto& horario : gravados) {
+            auto cached = cache.find(horario->getId());
+
+            if (cached && cached->getVersao() > horario->getVersao())
+                continue;
+
+            cache.put(horario->getId(), horario);
+            professorService->applyHorarioUpdate(horario);
+        }
+
+        absorb();
+    });
+}
+
+void HorarioService::refreshIntervals() {
+    TRACE_SPAN("HorarioService::refreshIntervals");
+
+    bool changed;
+
+    {
+        lock_guard<mutex> lock(intervalsObserverMx);
+        changed = intervalsObserver.hasFileChanged();
+    }
+
+    if (!changed && intervalsReady)
+        return;
+
+    intervals.clear();
+
+    for (const string& line : connection.selectAll(HORARIO_TABLE)) {
+        stringstream ss(line);
+        string idStr, professorIdStr, inicioStr, fimStr;
+
+        getline(ss, idStr, ',');
+        getline(ss, professorIdStr, ',');
+        getline(ss, inicioStr, ',');
+        getline(ss, fimStr, ',');
+
+        intervals.insert(stol(professorIdStr), stol(idStr), stol(inicioStr),
+                         stol(fimStr));
+    }
+
+    intervalsReady = true;
+}
+
+void HorarioService::checkOverlap(long idProfessor, Timestamp inicio,
+                                  Timestamp fim, long except) {
+    auto conflitos = intervals.overlapping(idProfessor, inicio, fim, except);
+
+    if (conflitos.empty())
+        return;
+
+    auto conflito = getById(conflitos.front());
+
+    throw invalid_argument("Já existe um horário cadastrado nesse período (" +
+                           timestamp_to_string(conflito->getInicio()) + " - " +
+                           timestamp_to_string(conflito->getFim()) + ").");
+}
+
+vector<shared_ptr<Horario>> HorarioService::listByIdProfessorBetween(
+    long id, Timestamp from, Timestamp to) {
+    METRIC_SCOPE("HorarioService::listByIdProfessorBetween");
+    TRACE_SPAN("HorarioService::listByIdProfessorBetween");
+
+    cache.invalidate();
+
+    vector<shared_ptr<Horario>> horarios;
+    lock_guard<mutex> lock(indexMx);
+
+    refreshIndex();
+
+    for (const TimeIndex::Entry* entry : index.query(id, from, to)) {
+        if (auto cached = cache.find(entry->id))
+            horarios.push_back(cached);
+        else {
+            auto horario = loadHorario(entry->line);
+            cache.put(entry->id, horario);
+            horarios.push_back(horario);
+        }
+    }
+
+    return horarios;
+}
+
+const unordered_set<long>& HorarioService::professoresDe(
+    const string& disciplina) {
+    if (disciplinasObserver.hasFileChanged())
+        disciplinas.clear();
+
+    auto it = disciplinas.find(disciplina);
+
+    if (it == disciplinas.end())
+        it = disciplinas
+                 .emplace(disciplina, manager->getProfessorService()
+                                          ->listIdsByDisciplina(disciplina))
+                 .first;
+
+    return it->second;
+}
+
+HorarioPage HorarioService::listDisponiveisBetween(
+    Timestamp from, Timestamp to, const string& disciplina,
+    const TimeIndex::Cursor& after, size_t limit) {
+    METRIC_SCOPE("HorarioService::listDisponiveisBetween");
+    TRACE_SPAN("HorarioService::listDisponiveisBetween");
+
+    if (limit == 0)
+        throw invalid_argument("O tamanho da página deve ser positivo.");
+
+    cache.invalidate();
+
+    HorarioPage page;
+    lock_guard<mutex> lock(indexMx);
+
+    refreshIndex();
+
+    const unordered_set<long>* professores =
+        disciplina.empty() ? nullptr : &professoresDe(disciplina);
+
+    index.scan(from, to, after, [&](const TimeIndex::Entry& entry) {
+        if (professores && !professores->count(entry.owner))
+            return true;
+
+        if (page.horarios.size() == limit) {
+            page.hasMore = true;
+            return false;
+        }
+
+        auto horario = cache.find(entry.id);
+        if (!horario) {
+            horario = loadHorario(entry.line);
+            cache.put(entry.id, horario);
+        }
+
+        page.horarios.push_back(horario);
+        page.next = {entry.inicio, entry.id};
+
+        return true;
+    });
+
+    return page;
+}
+
+vector<shared_ptr<Horario>> HorarioService::listCurrentByIdProfessor(long id) {
+    METRIC_SCOPE("HorarioService::listCurrentByIdProfessor");
+    TRACE_SPAN("HorarioService::listCurrentByIdProfessor");
+
+    return listByIdProfessorBetween(id, current_term().inicio,
+                                    numeric_limits<Timestamp>::max());
+}
+
+size_t HorarioService::archiveBefore(Timestamp corte) {
+    METRIC_SCOPE("HorarioService::archiveBefore");
+    TRACE_SPAN("HorarioService::archiveBefore");
+
+    const auto& agendamentoService = manager->getAgendamentoService();
+
+    long fixo = agendamentoService->lastIdHorario();
+
+    lock_guard<mutex> lock(intervalsMx);
+
+    refreshIntervals();
+
+    auto moved = connection.moveWhere(
+        HORARIO_TABLE, HORARIO_ARCHIVE_TABLE, [&](const string& line) {
+            auto horario = loadHorario(line);
+            return horario->getFim() < corte && horario->getId() != fixo;
+        });
+
+    set<long> ids;
+    map<long, long> excluidos;
+    for (const string& line : moved) {
+        auto horario = loadHorario(line);
+        ids.insert(horario->getId());
+        excluidos[horario->getId()] = horario->getProfessorId();
+        intervals.erase(horario->getId());
+    }
+
+    intervalsWritten();
+    horariosWritten({}, excluidos);
+
+    agendamentoService->archiveByIdHorarios(ids);
+
+    return ids.size();
+}
+
 shared_ptr<Horario> HorarioService::getById(long id) {
+    METRIC_SCOPE("HorarioService::getById");
+    TRACE_SPAN("HorarioService::getById");
+
     cache.invalidate();
 
-    if (cache.contains(id))
-        return cache.at(id);
+    if (auto cached = cache.find(id))
+        return cached;
 
     string linha = connection.selectOne(HORARIO_TABLE, id);
 
@@ -143,7 +561,68 @@ shared_ptr<Horario> HorarioService::getById(long id) {
     return horario;
 }
 
+vector<shared_ptr<Horario>> HorarioService::getByIds(const set<long>& ids) {
+    METRIC_SCOPE("HorarioService::getByIds");
+    TRACE_SPAN("HorarioService::getByIds");
+
+    cache.invalidate();
+
+    vector<shared_ptr<Horario>> horarios;
+    set<long> faltantes;
+
+    for (long id : ids) {
+        if (auto cached = cache.find(id))
+            horarios.push_back(cached);
+        else
+            faltantes.insert(id);
+    }
+
+    if (faltantes.empty())
+        return horarios;
+
+    // Os que não estão no cache saem de uma única leitura da tabela, em vez
+    // de um selectOne() por horário.
+    for (const string& linha : connection.selectAll(HORARIO_TABLE)) {
+        long id = getIdFromLine(linha);
+
+        if (!faltantes.count(id))
+            continue;
+
+        auto horario = loadHorario(linha);
+
+        cache.put(id, horario);
+        horarios.push_back(horario);
+    }
+
+    return horarios;
+}
+
+unordered_map<long, pair<Timestamp, Timestamp>>
+HorarioService::mapIntervalsById() {
+    METRIC_SCOPE("HorarioService::mapIntervalsById");
+    TRACE_SPAN("HorarioService::mapIntervalsById");
+
+    unordered_map<long, pair<Timestamp, Timestamp>> intervalos;
+
+    for (const string& line : connection.selectAll(HORARIO_TABLE)) {
+        stringstream ss(line);
+        string idStr, professorIdStr, inicioStr, fimStr;
+
+        getline(ss, idStr, ',');
+        getline(ss, professorIdStr, ',');
+        getline(ss, inicioStr, ',');
+        getline(ss, fimStr, ',');
+
+        intervalos[stol(idStr)] = {stol(inicioStr), stol(fimStr)};
+    }
+
+    return intervalos;
+}
+
 bool HorarioService::isDisponivelById(long id) {
+    METRIC_SCOPE("HorarioService::isDisponivelById");
+    TRACE_SPAN("HorarioService::isDisponivelById");
+
     auto horario = this->getById(id);
 
     return horario->isDisponivel();
@@ -152,42 +631,68 @@ bool HorarioService::isDisponivelById(long id) {
 shared_ptr<Horario> HorarioService::updateById(long id, long idProfessor,
                                                Timestamp inicio, Timestamp fim,
                                                bool disponivel) {
+    METRIC_SCOPE("HorarioService::updateById");
+    TRACE_SPAN("HorarioService::updateById");
+
     if (fim <= inicio) {
         throw invalid_argument(
             "O horário final deve ser posterior ao horário inicial.");
     }
 
-    auto horarios = listByIdProfessor(idProfessor);
+    lock_guard<mutex> lock(intervalsMx);
 
-    for (const auto& horario : horarios) {
-        if (id != horario->getId() && inicio == horario->getInicio() &&
-            fim == horario->getFim()) {
-            throw invalid_argument(
-                "Já existe um horário cadastrado nesse período.");
-        }
-    }
+    refreshIntervals();
 
-    auto late = getById(id);
+    // Como em compareAndSetDisponivel(), a escrita é condicionada à versão
+    // lida: se outro escritor (ex: uma reserva) gravou o horário no meio do
+    // caminho, o horário é relido e a verificação é refeita.
+    shared_ptr<Horario> late, updated;
 
-    if (!late)
-        return nullptr;
+    while (!updated) {
+        auto lines = connection.selectByColumn(HORARIO_TABLE, 0, to_string(id));
 
-    stringstream dados;
-    dados << idProfessor << "," << inicio << "," << fim << "," << disponivel;
-    string data_csv = dados.str();
+        if (lines.empty())
+            return nullptr;
+
+        late = loadHorario(lines.front());
+
+        // Só o intervalo é verificado: mudar apenas a disponibilidade não é
+        // recusado por sobreposições gravadas antes desta verificação.
+        if (idProfessor != late->getProfessorId() ||
+            inicio != late->getInicio() || fim != late->getFim())
+            checkOverlap(idProfessor, inicio, fim, id);
 
-    connection.update(HORARIO_TABLE, id, data_csv);
+        stringstream dados;
+        dados << idProfessor << "," << inicio << "," << fim << ","
+              << disponivel << "," << late->getVersao() + 1;
+        string data_csv = dados.str();
 
-    string updatedStr = to_string(id) + "," + data_csv;
-    auto updated = loadHorario(updatedStr);
+        if (connection.compareAndUpdate(HORARIO_TABLE, id, VERSAO_COL_INDEX,
+                                        to_string(late->getVersao()),
+                                        data_csv))
+            updated = loadHorario(to_string(id) + "," + data_csv);
+    }
+
+    intervals.insert(idProfessor, id, inicio, fim);
+    intervalsWritten();
 
-    cache.put(id, updated);
+    if (idProfessor != late->getProfessorId())
+        horariosWritten({updated}, {{id, late->getProfessorId()}});
+    else
+        horariosWritten({updated});
+
+    // Os pedidos pendentes do horário mudam de caixa de entrada.
+    if (idProfessor != late->getProfessorId())
+        manager->getAgendamentoService()->invalidateInbox();
 
     return updated;
 }
 
 shared_ptr<Horario> HorarioService::updateDisponivelById(long id,
                                                          bool disponivel) {
+    METRIC_SCOPE("HorarioService::updateDisponivelById");
+    TRACE_SPAN("HorarioService::updateDisponivelById");
+
     auto horario = getById(id);
 
     if (!horario)
@@ -197,27 +702,154 @@ shared_ptr<Horario> HorarioService::updateDisponivelById(long id,
                       horario->getFim(), disponivel);
 }
 
+bool HorarioService::reservarById(long id) {
+    METRIC_SCOPE("HorarioService::reservarById");
+    TRACE_SPAN("HorarioService::reservarById");
+
+    return compareAndSetDisponivel(id, true, false);
+}
+
+bool HorarioService::liberarById(long id) {
+    METRIC_SCOPE("HorarioService::liberarById");
+    TRACE_SPAN("HorarioService::liberarById");
+
+    return compareAndSetDisponivel(id, false, true);
+}
+
+bool HorarioService::compareAndSetDisponivel(long id, bool esperado,
+                                             bool novo) {
+    METRIC_SCOPE("HorarioService::compareAndSetDisponivel");
+    TRACE_SPAN("HorarioService::compareAndSetDisponivel");
+
+    while (true) {
+        auto atual = loadHorario(connection.selectOne(HORARIO_TABLE, id));
+
+        if (atual->isDisponivel() != esperado)
+            return false;
+
+        stringstream dados;
+        dados << atual->getProfessorId() << "," << atual->getInicio() << ","
+              << atual->getFim() << "," << novo << ","
+              << atual->getVersao() + 1;
+        string data_csv = dados.str();
+
+        if (connection.compareAndUpdate(HORARIO_TABLE, id, VERSAO_COL_INDEX,
+                                        to_string(atual->getVersao()),
+                                        data_csv)) {
+            intervalsWritten();
+            horariosWritten({loadHorario(to_string(id) + "," + data_csv)});
+
+            return true;
+        }
+    }
+}
+
+set<long> HorarioService::updateDisponivelByIds(
+    const map<long, bool>& disponiveis) {
+    METRIC_SCOPE("HorarioService::updateDisponivelByIds");
+    TRACE_SPAN("HorarioService::updateDisponivelByIds");
+
+    set<long> alterados;
+    map<long, bool> pendentes(disponiveis);
+
+    // Como em compareAndSetDisponivel(), uma versão alterada no meio do
+    // caminho faz os horários afetados serem relidos e tentados de novo.
+    while (!pendentes.empty()) {
+        map<long, pair<string, string>> changes;
+
+        for (const string& line : connection.selectAll(HORARIO_TABLE)) {
+            auto it = pendentes.find(getIdFromLine(line));
+
+            if (it == pendentes.end())
+                continue;
+
+            auto atual = loadHorario(line);
+
+            if (atual->isDisponivel() == it->second)
+                continue;
+
+            stringstream dados;
+            dados << atual->getProfessorId() << "," << atual->getInicio()
+                  << "," << atual->getFim() << "," << it->second << ","
+                  << atual->getVersao() + 1;
+
+            changes[it->first] = {to_string(atual->getVersao()), dados.str()};
+        }
+
+        if (changes.empty())
+            break;
+
+        vector<shared_ptr<Horario>> gravados;
+
+        for (long id : connection.compareAndUpdateMany(
+                 HORARIO_TABLE, VERSAO_COL_INDEX, changes)) {
+            gravados.push_back(
+                loadHorario(to_string(id) + "," + changes[id].second));
+
+            alterados.insert(id);
+            changes.erase(id);
+        }
+
+        if (!gravados.empty()) {
+            intervalsWritten();
+            horariosWritten(gravados);
+        }
+
+        pendentes.clear();
+        for (const auto& change : changes)
+            pendentes[change.first] = disponiveis.at(change.first);
+    }
+
+    return alterados;
+}
+
+void HorarioService::applyAgendamentoUpdate(
+    const shared_ptr<Agendamento>& agendamento) {
+    TRACE_SPAN("HorarioService::applyAgendamentoUpdate");
+
+    if (auto horario = cache.find(agendamento->getHorarioId()))
+        horario->getAgendamentos().replace(agendamento);
+}
+
+void HorarioService::applyAgendamentoRemoval(long idHorario, long id) {
+    TRACE_SPAN("HorarioService::applyAgendamentoRemoval");
+
+    if (auto horario = cache.find(idHorario))
+        horario->getAgendamentos().remove(id);
+}
+
+void HorarioService::absorb() {
+    cache.absorb();
+    manager->getProfessorService()->absorb();
+}
+
 shared_ptr<Horario> HorarioService::loadHorario(const string& line) {
+    METRIC_SCOPE("HorarioService::loadHorario");
+    TRACE_SPAN("HorarioService::loadHorario");
+
     stringstream ss(line);
     string idStr, professorIdStr, inicioStr, fimStr, disponivelStr;
+    string versaoStr;
 
     getline(ss, idStr, ',');
     getline(ss, professorIdStr, ',');
     getline(ss, inicioStr, ',');
     getline(ss, fimStr, ',');
     getline(ss, disponivelStr, ',');
+    getline(ss, versaoStr, ',');
 
     long id = stol(idStr);
     long professorId = stol(professorIdStr);
     long inicio = stol(inicioStr);
     long fim = stol(fimStr);
     bool disponivel = disponivelStr == "1";
+    long versao = versaoStr.empty() ? 0 : stol(versaoStr);
 
     auto& professorLoader = manager->getProfessorLoader();
     auto& agendamentosLoader = manager->getHorarioAgendamentosListLoader();
 
     auto horario =
-        make_shared<Horario>(id, professorId, inicio, fim, disponivel,
+        make_shared<Horario>(id, professorId, inicio, fim, disponivel, versao,
                              professorLoader, agendamentosLoader);
 
     return horario;
@@ -1,21 +1,27 @@
 #include "service/professorService.hpp"
 
-#include <algorithm>
-
 #include "event/events.hpp"
 #include "service/horarioService.hpp"
+#include "util/metrics.hpp"
+#include "util/tracing.hpp"
 
+using std::function;
 using std::invalid_argument;
+using std::lock_guard;
 using std::make_shared;
+using std::mutex;
 using std::runtime_error;
 using std::shared_ptr;
-using std::sort;
 using std::string;
 using std::stringstream;
 using std::to_string;
+using std::unordered_map;
+using std::unordered_set;
 using std::vector;
 
+#define NOME_COL_INDEX 1
 #define EMAIL_COL_INDEX 2
+#define DISCIPLINA_COL_INDEX 4
 
 ProfessorService::ProfessorService(EntityManager* manager,
                                    const MockConnection& connection,
@@ -23,10 +29,47 @@ ProfessorService::ProfessorService(EntityManager* manager,
     : manager(manager),
       connection(connection),
       bus(bus),
-      cache({PROFESSOR_TABLE, HORARIO_TABLE, AGENDAMENTO_TABLE}) {}
+      // As escritas do processo nos horários e agendamentos são aplicadas às
+      // listas e absorvidas (ver absorb()); as tabelas continuam observadas
+      // para as edições feitas fora dele.
+      cache({PROFESSOR_TABLE, HORARIO_TABLE, AGENDAMENTO_TABLE}),
+      sortedObserver({PROFESSOR_TABLE}) {}
+
+bool ProfessorCursor::operator<(const ProfessorCursor& other) const {
+    if (nome != other.nome)
+        return nome < other.nome;
+
+    return id < other.id;
+}
+
+void ProfessorService::refreshSorted() {
+    TRACE_SPAN("ProfessorService::refreshSorted");
+
+    // Consulta o observador antes de ler a tabela, para não perder uma
+    // escrita feita durante a montagem.
+    if (!sortedObserver.hasFileChanged() && sortedReady)
+        return;
+
+    sorted.clear();
+
+    for (const string& linha : connection.selectAll(PROFESSOR_TABLE)) {
+        stringstream ss(linha);
+        string nome;
+
+        for (size_t col = 0; col <= NOME_COL_INDEX; ++col)
+            getline(ss, nome, ',');
+
+        sorted.emplace(ProfessorCursor{nome, getIdFromLine(linha)}, linha);
+    }
+
+    sortedReady = true;
+}
 
 vector<shared_ptr<Professor>> ProfessorService::getByEmail(
     const string& email) {
+    METRIC_SCOPE("ProfessorService::getByEmail");
+    TRACE_SPAN("ProfessorService::getByEmail");
+
     cache.invalidate();
 
     vector<shared_ptr<Professor>> professores;
@@ -36,8 +79,8 @@ vector<shared_ptr<Professor>> ProfessorService::getByEmail(
     for (const auto& linha : linhas) {
         long id = getIdFromLine(linha);
 
-        if (cache.contains(id))
-            professores.push_back(cache.at(id));
+        if (auto cached = cache.find(id))
+            professores.push_back(cached);
         else {
             auto professor = loadProfessor(linha);
             cache.put(id, professor);
@@ -49,10 +92,16 @@ vector<shared_ptr<Professor>> ProfessorService::getByEmail(
 }
 
 bool ProfessorService::existsByEmail(string email) {
+    METRIC_SCOPE("ProfessorService::existsByEmail");
+    TRACE_SPAN("ProfessorService::existsByEmail");
+
     return !getByEmail(email).empty();
 }
 
 bool ProfessorService::existsByEmailAndIdNot(string email, long id) {
+    METRIC_SCOPE("ProfessorService::existsByEmailAndIdNot");
+    TRACE_SPAN("ProfessorService::existsByEmailAndIdNot");
+
     auto email_matches = getByEmail(email);
 
     for (const auto& professor : email_matches) {
@@ -68,6 +117,9 @@ shared_ptr<Professor> ProfessorService::save(const string& nome,
                                              const string& email,
                                              const string& senha,
                                              const string& disciplina) {
+    METRIC_SCOPE("ProfessorService::save");
+    TRACE_SPAN("ProfessorService::save");
+
     if (existsByEmail(email)) {
         throw invalid_argument("O email '" + email +
                                "' já está em uso por outro professor.");
@@ -82,16 +134,65 @@ shared_ptr<Professor> ProfessorService::save(const string& nome,
 
     auto salvo = loadProfessor(new_record_csv);
 
-    cache.put(id, salvo);
+    Transaction::afterCommit(connection, [this, id, salvo] {
+        cache.put(id, salvo);
+        cache.absorb();
+    });
 
     return salvo;
 }
 
+size_t ProfessorService::saveAll(
+    const vector<ImportRow>& rows, ImportReport& report,
+    const function<void(vector<ImportRow>&)>& preparar) {
+    METRIC_SCOPE("ProfessorService::saveAll");
+    TRACE_SPAN("ProfessorService::saveAll");
+
+    unordered_set<string> emails;
+
+    for (const auto& cadastro : mapIdsByEmail())
+        emails.insert(cadastro.first);
+
+    vector<ImportRow> aceitos;
+
+    for (const auto& row : rows) {
+        const string& email = row.campos[1];
+
+        if (!emails.insert(email).second) {
+            report.recusar(row.linha,
+                           "O email '" + email +
+                               "' já está em uso por outro professor.");
+            continue;
+        }
+
+        aceitos.push_back(row);
+    }
+
+    // Só as linhas aceitas são preparadas (ex: hash das senhas).
+    if (preparar)
+        preparar(aceitos);
+
+    vector<string> dados;
+
+    for (const auto& row : aceitos)
+        dados.push_back(row.campos[0] + "," + row.campos[1] + "," +
+                        row.campos[2] + "," + row.campos[3]);
+
+    connection.insertMany(PROFESSOR_TABLE, dados);
+    Transaction::afterCommit(connection, [this] { cache.absorb(); });
+    report.importados += dados.size();
+
+    return dados.size();
+}
+
 shared_ptr<Professor> ProfessorService::getById(long id) {
+    METRIC_SCOPE("ProfessorService::getById");
+    TRACE_SPAN("ProfessorService::getById");
+
     cache.invalidate();
 
-    if (cache.contains(id))
-        return cache.at(id);
+    if (auto cached = cache.find(id))
+        return cached;
 
     string linha = connection.selectOne(PROFESSOR_TABLE, id);
 
@@ -103,6 +204,9 @@ shared_ptr<Professor> ProfessorService::getById(long id) {
 }
 
 shared_ptr<Professor> ProfessorService::getOneByEmail(const string& email) {
+    METRIC_SCOPE("ProfessorService::getOneByEmail");
+    TRACE_SPAN("ProfessorService::getOneByEmail");
+
     auto results = getByEmail(email);
     if (results.size() > 1) {
         throw runtime_error(
@@ -119,34 +223,122 @@ shared_ptr<Professor> ProfessorService::getOneByEmail(const string& email) {
 }
 
 vector<shared_ptr<Professor>> ProfessorService::listAll() {
+    METRIC_SCOPE("ProfessorService::listAll");
+    TRACE_SPAN("ProfessorService::listAll");
+
     cache.invalidate();
 
-    vector<string> csv_records = connection.selectAll(PROFESSOR_TABLE);
+    // As linhas já estão ordenadas; entre nomes iguais, pelo ID.
     vector<shared_ptr<Professor>> professors;
+    lock_guard<mutex> lock(sortedMx);
 
-    for (const string& csv_line : csv_records) {
-        long id = getIdFromLine(csv_line);
+    refreshSorted();
 
-        if (cache.contains(id))
-            professors.push_back(cache.at(id));
-        else {
-            auto professor = loadProfessor(csv_line);
-            cache.put(id, professor);
-            professors.push_back(professor);
+    for (const auto& [key, linha] : sorted) {
+        auto professor = cache.find(key.id);
+        if (!professor) {
+            professor = loadProfessor(linha);
+            cache.put(key.id, professor);
         }
-    }
 
-    sort(professors.begin(), professors.end(),
-         [](const shared_ptr<Professor>& first,
-            const shared_ptr<Professor>& second) { return *first < *second; });
+        professors.push_back(professor);
+    }
 
     return professors;
 }
 
+ProfessorPage ProfessorService::listPage(const ProfessorCursor& after,
+                                         size_t limit) {
+    METRIC_SCOPE("ProfessorService::listPage");
+    TRACE_SPAN("ProfessorService::listPage");
+
+    if (limit == 0)
+        throw invalid_argument("O tamanho da página deve ser positivo.");
+
+    cache.invalidate();
+
+    ProfessorPage page;
+    lock_guard<mutex> lock(sortedMx);
+
+    refreshSorted();
+
+    for (auto it = sorted.upper_bound(after); it != sorted.end(); ++it) {
+        if (page.professores.size() == limit) {
+            page.hasMore = true;
+            break;
+        }
+
+        auto professor = cache.find(it->first.id);
+        if (!professor) {
+            professor = loadProfessor(it->second);
+            cache.put(it->first.id, professor);
+        }
+
+        page.professores.push_back(professor);
+        page.next = it->first;
+    }
+
+    return page;
+}
+
+unordered_set<long> ProfessorService::listIdsByDisciplina(
+    const string& disciplina) {
+    METRIC_SCOPE("ProfessorService::listIdsByDisciplina");
+    TRACE_SPAN("ProfessorService::listIdsByDisciplina");
+
+    unordered_set<long> ids;
+
+    for (const string& linha : connection.selectByColumn(
+             PROFESSOR_TABLE, DISCIPLINA_COL_INDEX, disciplina))
+        ids.insert(getIdFromLine(linha));
+
+    return ids;
+}
+
+unordered_map<string, long> ProfessorService::mapIdsByEmail() {
+    METRIC_SCOPE("ProfessorService::mapIdsByEmail");
+    TRACE_SPAN("ProfessorService::mapIdsByEmail");
+
+    unordered_map<string, long> ids;
+
+    for (const string& linha : connection.selectAll(PROFESSOR_TABLE)) {
+        stringstream ss(linha);
+        string campo;
+
+        for (size_t col = 0; col <= EMAIL_COL_INDEX; ++col)
+            getline(ss, campo, ',');
+
+        ids.emplace(campo, getIdFromLine(linha));
+    }
+
+    return ids;
+}
+
+void ProfessorService::applyHorarioUpdate(const shared_ptr<Horario>& horario) {
+    TRACE_SPAN("ProfessorService::applyHorarioUpdate");
+
+    if (auto professor = cache.find(horario->getProfessorId()))
+        professor->getHorarios().replace(horario);
+}
+
+void ProfessorService::applyHorarioRemoval(long idProfessor, long id) {
+    TRACE_SPAN("ProfessorService::applyHorarioRemoval");
+
+    if (auto professor = cache.find(idProfessor))
+        professor->getHorarios().remove(id);
+}
+
+void ProfessorService::absorb() {
+    cache.absorb();
+}
+
 shared_ptr<Professor> ProfessorService::updateById(long id, const string& nome,
                                                    const string& email,
                                                    const string& senha,
                                                    const string& disciplina) {
+    METRIC_SCOPE("ProfessorService::updateById");
+    TRACE_SPAN("ProfessorService::updateById");
+
     if (existsByEmailAndIdNot(email, id)) {
         throw invalid_argument("O email '" + email +
                                "' já está em uso por outro professor.");
@@ -166,24 +358,74 @@ shared_ptr<Professor> ProfessorService::updateById(long id, const string& nome,
     string updatedStr = to_string(id) + "," + data_csv;
     auto updated = loadProfessor(updatedStr);
 
-    cache.put(id, updated);
+    Transaction::afterCommit(connection, [this, id, updated] {
+        cache.put(id, updated);
+        cache.absorb();
+    });
 
     return updated;
 }
 
-bool ProfessorService::deleteById(long id) {
-    auto professor = getById(id);
+bool ProfessorService::updateSenhaById(long id, const string& esperada,
+                                       const string& senha) {
+    METRIC_SCOPE("ProfessorService::updateSenhaById");
+    TRACE_SPAN("ProfessorService::updateSenhaById");
 
-    if (!professor)
-        return false;
+    return Transaction::retry(connection, [&] {
+        auto linhas =
+            connection.selectByColumn(PROFESSOR_TABLE, 0, to_string(id));
+
+        if (linhas.empty())
+            return false;
+
+        auto late = loadProfessor(linhas.front());
+
+        if (late->getSenha() != esperada)
+            return false;
+
+        stringstream dados;
+        dados << late->getNome() << "," << late->getEmail() << "," << senha
+              << "," << late->getDisciplina();
+        string data_csv = dados.str();
+
+        connection.update(PROFESSOR_TABLE, id, data_csv);
+
+        auto updated = loadProfessor(to_string(id) + "," + data_csv);
+
+        Transaction::afterCommit(connection, [this, id, updated] {
+            cache.put(id, updated);
+            cache.absorb();
+        });
+
+        return true;
+    });
+}
+
+bool ProfessorService::deleteById(long id) {
+    METRIC_SCOPE("ProfessorService::deleteById");
+    TRACE_SPAN("ProfessorService::deleteById");
 
     const auto& horarioService = manager->getHorarioService();
 
-    horarioService->deleteByIdProfessor(id);
+    // Os agendamentos, os horários e o professor são gravados juntos, no
+    // commit; um conflito refaz a exclusão (ver Transaction::retry()).
+    bool excluido = Transaction::retry(connection, [&] {
+        if (connection.selectByColumn(PROFESSOR_TABLE, 0, to_string(id))
+                .empty())
+            return false;
 
-    connection.deleteRecord(PROFESSOR_TABLE, id);
+        horarioService->deleteByIdProfessor(id);
+
+        connection.deleteRecord(PROFESSOR_TABLE, id);
+
+        return true;
+    });
+
+    if (!excluido)
+        return false;
 
     cache.erase(id);
+    cache.absorb();
 
     bus.publish(ProfessorDeletedEvent(id));
 
@@ -191,6 +433,9 @@ bool ProfessorService::deleteById(long id) {
 }
 
 shared_ptr<Professor> ProfessorService::loadProfessor(const string& line) {
+    METRIC_SCOPE("ProfessorService::loadProfessor");
+    TRACE_SPAN("ProfessorService::loadProfessor");
+
     stringstream ss(line);
     string idStr, nome, email, senha, disciplina;
 
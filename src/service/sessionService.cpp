@@ -1,73 +1,277 @@
 #include "service/sessionService.hpp"
 
+#include <sys/random.h>
+
+#include <cerrno>
+#include <iomanip>
+#include <sstream>
 #include <stdexcept>
 
 #include "event/events.hpp"
+#include "util/metrics.hpp"
+#include "util/tracing.hpp"
 
+using std::hex;
+using std::lock_guard;
+using std::mutex;
+using std::nullopt;
+using std::optional;
+using std::ostringstream;
 using std::runtime_error;
+using std::setfill;
+using std::setw;
 using std::shared_ptr;
+using std::string;
+using std::thread;
+using std::chrono::duration_cast;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+using std::this_thread::get_id;
+
+#define WHEEL_SLOTS 64
+#define TOKEN_BYTES 16
+
+static uint64_t toTick(steady_clock::time_point tp) {
+    return duration_cast<seconds>(tp.time_since_epoch()).count();
+}
+
+// Os bytes do token vêm do gerador criptográfico do sistema: um token
+// previsível permitiria assumir a sessão de outro usuário.
+static string generate_token() {
+    unsigned char bytes[TOKEN_BYTES];
+    size_t lidos = 0;
+
+    while (lidos < sizeof(bytes)) {
+        ssize_t n = getrandom(bytes + lidos, sizeof(bytes) - lidos, 0);
+
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            throw runtime_error("Falha ao gerar o token da sessão.");
+        }
+
+        lidos += n;
+    }
+
+    ostringstream ss;
+    ss << hex << setfill('0');
+
+    for (unsigned char byte : bytes)
+        ss << setw(2) << static_cast<int>(byte);
+
+    return ss.str();
+}
 
-SessionService::SessionService(EntityManager* manager, EventBus& bus)
+SessionService::SessionService(EntityManager* manager, EventBus& bus,
+                               seconds idleTimeout)
     : manager(manager),
       bus(bus),
-      userId(0),
-      type(UserType::NONE),
+      wheel(WHEEL_SLOTS, toTick(steady_clock::now())),
+      idleTimeout(idleTimeout),
       alunoLoader(manager->getAlunoLoader()),
       professorLoader(manager->getProfessorLoader()) {
     bus.subscribe<AlunoLoggedInEvent>([this](const AlunoLoggedInEvent& event) {
-        type = UserType::ALUNO;
-        userId = event.alunoId;
+        bind(open(UserType::ALUNO, event.alunoId));
     });
 
     bus.subscribe<ProfessorLoggedInEvent>(
         [this](const ProfessorLoggedInEvent& event) {
-            type = UserType::PROFESSOR;
-            userId = event.professorId;
+            bind(open(UserType::PROFESSOR, event.professorId));
         });
 
     bus.subscribe<AlunoDeletedEvent>([this](const AlunoDeletedEvent& event) {
-        if (type == UserType::ALUNO && userId == event.alunoId)
-            logout();
+        sessions.eraseIf([&event](const string&, const Session& s) {
+            return s.type == UserType::ALUNO && s.userId == event.alunoId;
+        });
     });
 
     bus.subscribe<ProfessorDeletedEvent>(
         [this](const ProfessorDeletedEvent& event) {
-            if (type == UserType::PROFESSOR && userId == event.professorId)
-                logout();
+            sessions.eraseIf([&event](const string&, const Session& s) {
+                return s.type == UserType::PROFESSOR &&
+                       s.userId == event.professorId;
+            });
         });
 }
 
-void SessionService::logout() {
-    type = UserType::NONE;
-    userId = 0;
+string SessionService::open(UserType type, long userId) {
+    METRIC_SCOPE("SessionService::open");
+    TRACE_SPAN("SessionService::open");
+
+    auto now = steady_clock::now();
+    string token = generate_token();
+
+    sessions.put(token, Session{type, userId, now});
+
+    {
+        lock_guard<mutex> lock(wheelMx);
+        wheel.schedule(token, toTick(now + idleTimeout));
+    }
+
+    expireIdle();
+
+    return token;
 }
 
-bool SessionService::isLogged() const {
-    return type != UserType::NONE && userId > 0;
+void SessionService::bind(const string& token) {
+    if (token.empty())
+        bound.erase(get_id());
+    else
+        bound.put(get_id(), token);
 }
 
-bool SessionService::isAluno() const {
-    return isLogged() && type == UserType::ALUNO;
+string SessionService::currentToken() const {
+    auto token = bound.find(get_id());
+
+    return token ? *token : string();
 }
 
-bool SessionService::isProfessor() const {
-    return isLogged() && type == UserType::PROFESSOR;
+string SessionService::current() const {
+    return currentToken();
 }
 
-shared_ptr<Professor> SessionService::getProfessor() {
-    if (!isLogged())
+size_t SessionService::expireIdle() {
+    METRIC_SCOPE("SessionService::expireIdle");
+    TRACE_SPAN("SessionService::expireIdle");
+
+    lock_guard<mutex> lock(wheelMx);
+
+    size_t expired = 0;
+    auto now = steady_clock::now();
+
+    wheel.advance(toTick(now), [&](const string& token) -> uint64_t {
+        auto session = sessions.find(token);
+
+        if (!session)
+            return 0;
+
+        auto deadline = session->lastSeen + idleTimeout;
+
+        if (deadline > now)
+            return toTick(deadline);
+
+        sessions.erase(token);
+        ++expired;
+        return 0;
+    });
+
+    return expired;
+}
+
+size_t SessionService::activeSessions() const {
+    return sessions.size();
+}
+
+optional<Session> SessionService::find(const string& token) const {
+    METRIC_SCOPE("SessionService::find");
+    TRACE_SPAN("SessionService::find");
+
+    if (token.empty())
+        return nullopt;
+
+    auto session = sessions.find(token);
+
+    if (!session || session->lastSeen + idleTimeout <= steady_clock::now())
+        return nullopt;
+
+    return session;
+}
+
+void SessionService::touch(const string& token) {
+    METRIC_SCOPE("SessionService::touch");
+    TRACE_SPAN("SessionService::touch");
+
+    auto now = steady_clock::now();
+
+    sessions.update(token, [&now](Session& s) { s.lastSeen = now; });
+
+    expireIdle();
+}
+
+void SessionService::logout(const string& token) {
+    METRIC_SCOPE("SessionService::logout");
+    TRACE_SPAN("SessionService::logout");
+
+    sessions.erase(token);
+
+    // A thread que atende o logout nem sempre é a que usava a sessão.
+    bound.eraseIf([&token](const thread::id&, const string& associado) {
+        return associado == token;
+    });
+}
+
+bool SessionService::isLogged(const string& token) const {
+    auto session = find(token);
+
+    return session && session->type != UserType::NONE && session->userId > 0;
+}
+
+bool SessionService::isAluno(const string& token) const {
+    auto session = find(token);
+
+    return session && session->userId > 0 &&
+           session->type == UserType::ALUNO;
+}
+
+bool SessionService::isProfessor(const string& token) const {
+    auto session = find(token);
+
+    return session && session->userId > 0 &&
+           session->type == UserType::PROFESSOR;
+}
+
+shared_ptr<Professor> SessionService::getProfessor(const string& token) {
+    METRIC_SCOPE("SessionService::getProfessor");
+    TRACE_SPAN("SessionService::getProfessor");
+
+    auto session = find(token);
+
+    if (!session || session->userId <= 0)
         throw runtime_error("Nenhum usuário logado");
-    if (!isProfessor())
+    if (session->type != UserType::PROFESSOR)
         throw runtime_error("O usuário logado não é Professor");
 
-    return professorLoader(userId);
+    touch(token);
+
+    return professorLoader(session->userId);
 }
 
-shared_ptr<Aluno> SessionService::getAluno() {
-    if (!isLogged())
+shared_ptr<Aluno> SessionService::getAluno(const string& token) {
+    METRIC_SCOPE("SessionService::getAluno");
+    TRACE_SPAN("SessionService::getAluno");
+
+    auto session = find(token);
+
+    if (!session || session->userId <= 0)
         throw runtime_error("Nenhum usuário logado");
-    if (!isAluno())
+    if (session->type != UserType::ALUNO)
         throw runtime_error("O usuário logado não é Aluno");
 
-    return alunoLoader(userId);
-}
\ No newline at end of file
+    touch(token);
+
+    return alunoLoader(session->userId);
+}
+
+void SessionService::logout() {
+    logout(currentToken());
+}
+
+bool SessionService::isLogged() const {
+    return isLogged(currentToken());
+}
+
+bool SessionService::isAluno() const {
+    return isAluno(currentToken());
+}
+
+bool SessionService::isProfessor() const {
+    return isProfessor(currentToken());
+}
+
+shared_ptr<Professor> SessionService::getProfessor() {
+    return getProfessor(currentToken());
+}
+
+shared_ptr<Aluno> SessionService::getAluno() {
+    return getAluno(currentToken());
+}
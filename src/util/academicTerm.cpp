@@ -0,0 +1,42 @@
+#include "util/academicTerm.hpp"
+
+#include <mutex>
+#include <stdexcept>
+
+using std::invalid_argument;
+using std::lock_guard;
+using std::mutex;
+
+static mutex termMx;
+static bool configured = false;
+static AcademicTerm window;
+
+AcademicTerm semester_of(Timestamp tt) {
+    int year = local_year(tt);
+    Timestamp julho = local_timestamp(year, 7, 1, 0, 0);
+
+    if (tt < julho)
+        return {local_timestamp(year, 1, 1, 0, 0), julho};
+
+    return {julho, local_timestamp(year + 1, 1, 1, 0, 0)};
+}
+
+void set_term_window(Timestamp inicio, Timestamp fim) {
+    if (fim <= inicio)
+        throw invalid_argument(
+            "O fim do período letivo deve ser posterior ao início.");
+
+    lock_guard<mutex> lock(termMx);
+    configured = true;
+    window = {inicio, fim};
+}
+
+AcademicTerm current_term() {
+    {
+        lock_guard<mutex> lock(termMx);
+        if (configured)
+            return window;
+    }
+
+    return semester_of(std::time(nullptr));
+}
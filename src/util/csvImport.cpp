@@ -0,0 +1,78 @@
+#include "util/csvImport.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "util/kdf.hpp"
+
+using std::getline;
+using std::ifstream;
+using std::runtime_error;
+using std::string;
+using std::stringstream;
+using std::to_string;
+using std::vector;
+
+static string trim(const string& value) {
+    size_t begin = value.find_first_not_of(" \t");
+
+    if (begin == string::npos)
+        return "";
+
+    return value.substr(begin, value.find_last_not_of(" \t") - begin + 1);
+}
+
+vector<ImportRow> read_import_file(const string& path, size_t campos,
+                                   ImportReport& report) {
+    ifstream file(path);
+
+    if (!file.is_open())
+        throw runtime_error("Não foi possível abrir o arquivo '" + path +
+                            "'.");
+
+    vector<ImportRow> rows;
+    string line;
+    size_t numero = 0;
+
+    while (getline(file, line)) {
+        ++numero;
+
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (numero == 1 || trim(line).empty())
+            continue;
+
+        ImportRow row{numero, {}};
+        stringstream ss(line);
+        string campo;
+
+        while (getline(ss, campo, ','))
+            row.campos.push_back(trim(campo));
+        if (line.back() == ',')
+            row.campos.push_back("");
+
+        if (row.campos.size() != campos) {
+            report.recusar(numero, "Esperados " + to_string(campos) +
+                                       " campos, encontrados " +
+                                       to_string(row.campos.size()) + ".");
+            continue;
+        }
+
+        rows.push_back(std::move(row));
+    }
+
+    return rows;
+}
+
+void hash_import_passwords(vector<ImportRow>& rows, size_t coluna) {
+    vector<string> senhas;
+
+    for (const auto& row : rows)
+        senhas.push_back(row.campos[coluna]);
+
+    vector<string> hashes = hash_passwords(senhas);
+
+    for (size_t i = 0; i < rows.size(); ++i)
+        rows[i].campos[coluna] = hashes[i];
+}
@@ -1,5 +1,7 @@
 #include "util/fileObserver.hpp"
 
+#include "util/metrics.hpp"
+
 using std::string;
 using std::vector;
 
@@ -12,6 +14,8 @@ FileObserver::FileObserver(const vector<string>& filenames) {
 }
 
 bool FileObserver::hasFileChanged() {
+    METRIC_SCOPE("FileObserver::hasFileChanged");
+
     bool changed = false;
 
     for (auto& pair : fileTimestamps) {
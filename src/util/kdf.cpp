@@ -0,0 +1,463 @@
+#include "util/kdf.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+#include "util/parallel.hpp"
+
+using std::atomic;
+using std::current_exception;
+using std::exception_ptr;
+using std::future;
+using std::ifstream;
+using std::min;
+using std::mt19937_64;
+using std::ofstream;
+using std::random_device;
+using std::rethrow_exception;
+using std::string;
+using std::to_string;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+// Alfabeto base64 adaptado do passlib: '.' no lugar de '+', sem padding.
+static const char AB64[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789./";
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static const uint32_t IV[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372,
+                               0xa54ff53a, 0x510e527f, 0x9b05688c,
+                               0x1f83d9ab, 0x5be0cd19};
+
+static inline uint32_t rotr(uint32_t x, int n) {
+    return (x >> n) | (x << (32 - n));
+}
+
+static inline void store_be32(uint8_t* out, uint32_t v) {
+    out[0] = v >> 24;
+    out[1] = v >> 16;
+    out[2] = v >> 8;
+    out[3] = v;
+}
+
+static inline void store_state(uint8_t out[32], const uint32_t state[8]) {
+    for (int i = 0; i < 8; ++i)
+        store_be32(out + 4 * i, state[i]);
+}
+
+void Sha256::compress(uint32_t state[8], const uint8_t block[64]) {
+    uint32_t w[64];
+
+    for (int i = 0; i < 16; ++i)
+        w[i] = uint32_t(block[4 * i]) << 24 |
+               uint32_t(block[4 * i + 1]) << 16 |
+               uint32_t(block[4 * i + 2]) << 8 | uint32_t(block[4 * i + 3]);
+
+    for (int i = 16; i < 64; ++i) {
+        uint32_t s0 =
+            rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 =
+            rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int i = 0; i < 64; ++i) {
+        uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+        uint32_t ch = (e & f) ^ (~e & g);
+        uint32_t t1 = h + s1 + ch + K[i] + w[i];
+        uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+        uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+        uint32_t t2 = s0 + maj;
+
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+Sha256::Sha256() {
+    std::memcpy(state, IV, sizeof(state));
+}
+
+void Sha256::update(const uint8_t* data, size_t size) {
+    length += size;
+
+    while (size > 0) {
+        size_t n = min(size, sizeof(buffer) - buffered);
+        std::memcpy(buffer + buffered, data, n);
+        buffered += n;
+        data += n;
+        size -= n;
+
+        if (buffered == sizeof(buffer)) {
+            compress(state, buffer);
+            buffered = 0;
+        }
+    }
+}
+
+void Sha256::finish(uint8_t out[32]) {
+    uint64_t bits = length * 8;
+    uint8_t pad = 0x80;
+    uint8_t zero = 0;
+    uint8_t size[8];
+
+    for (int i = 0; i < 8; ++i)
+        size[i] = bits >> (56 - 8 * i);
+
+    update(&pad, 1);
+    while (buffered != 56)
+        update(&zero, 1);
+    update(size, 8);
+
+    store_state(out, state);
+}
+
+void Sha256::exportState(uint32_t out[8]) const {
+    std::memcpy(out, state, sizeof(state));
+}
+
+void pbkdf2_sha256(const string& pwd, const uint8_t* salt, size_t saltLen,
+                   uint32_t iterations, uint8_t* out, size_t outLen) {
+    uint8_t key[64] = {0};
+
+    if (pwd.size() > sizeof(key)) {
+        Sha256 h;
+        h.update(reinterpret_cast<const uint8_t*>(pwd.data()), pwd.size());
+        h.finish(key);
+    } else {
+        std::memcpy(key, pwd.data(), pwd.size());
+    }
+
+    uint8_t ipad[64], opad[64];
+    for (int i = 0; i < 64; ++i) {
+        ipad[i] = key[i] ^ 0x36;
+        opad[i] = key[i] ^ 0x5c;
+    }
+
+    // Estados do HMAC após o bloco da chave, reaproveitados em toda iteração.
+    uint32_t innerState[8], outerState[8];
+    {
+        Sha256 inner, outer;
+        inner.update(ipad, 64);
+        outer.update(opad, 64);
+        inner.exportState(innerState);
+        outer.exportState(outerState);
+    }
+
+    // Blocos finais de HMAC(U): 32 bytes de dados, padding e tamanho fixo
+    // (64 + 32 bytes = 768 bits).
+    uint8_t block[64] = {0};
+    block[32] = 0x80;
+    block[62] = 0x03;
+
+    for (uint32_t index = 1; outLen > 0; ++index) {
+        uint8_t u[32], t[32], counter[4];
+        store_be32(counter, index);
+
+        Sha256 inner, outer;
+        inner.update(ipad, 64);
+        inner.update(salt, saltLen);
+        inner.update(counter, 4);
+        inner.finish(u);
+        outer.update(opad, 64);
+        outer.update(u, 32);
+        outer.finish(u);
+
+        std::memcpy(t, u, 32);
+
+        for (uint32_t j = 1; j < iterations; ++j) {
+            uint32_t s[8];
+
+            std::memcpy(block, u, 32);
+            std::memcpy(s, innerState, sizeof(s));
+            Sha256::compress(s, block);
+
+            store_state(block, s);
+            std::memcpy(s, outerState, sizeof(s));
+            Sha256::compress(s, block);
+
+            store_state(u, s);
+            for (int k = 0; k < 32; ++k)
+                t[k] ^= u[k];
+        }
+
+        size_t n = min<size_t>(outLen, 32);
+        std::memcpy(out, t, n);
+        out += n;
+        outLen -= n;
+    }
+}
+
+uint32_t calibrate_kdf_iterations(milliseconds budget) {
+    const uint32_t sample = KDF_MIN_ITERATIONS;
+    uint8_t salt[KDF_SALT_BYTES] = {0};
+    uint8_t out[KDF_HASH_BYTES];
+
+    auto start = steady_clock::now();
+    pbkdf2_sha256("calibracao", salt, sizeof(salt), sample, out, sizeof(out));
+    auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+
+    double perIteration =
+        static_cast<double>(std::max<long long>(elapsed.count(), 1)) / sample;
+    double iterations =
+        duration_cast<microseconds>(budget).count() / perIteration;
+
+    // Arredonda para o milhar, mantendo o mínimo.
+    uint32_t rounded = static_cast<uint32_t>(iterations / 1000) * 1000;
+
+    return std::max<uint32_t>(rounded, KDF_MIN_ITERATIONS);
+}
+
+static atomic<uint32_t> configuredIterations{0};
+
+// Lê o alvo gravado por uma execução anterior ou calibra e grava um novo:
+// uma calibração por execução mudaria o alvo a cada abertura e, com ele, os
+// hashes que kdf_needs_rehash() manda refazer.
+static uint32_t stored_kdf_iterations() {
+    ifstream in(KDF_ITERATIONS_PATH);
+    uint64_t stored = 0;
+
+    if (in >> stored && stored >= KDF_MIN_ITERATIONS && stored <= UINT32_MAX)
+        return static_cast<uint32_t>(stored);
+
+    uint32_t calibrated =
+        calibrate_kdf_iterations(milliseconds(KDF_TARGET_MS));
+
+    ofstream out(KDF_ITERATIONS_PATH, std::ios::trunc);
+    out << calibrated << "\n";
+
+    return calibrated;
+}
+
+uint32_t kdf_iterations() {
+    uint32_t configured = configuredIterations.load();
+    if (configured)
+        return configured;
+
+    static const uint32_t target = stored_kdf_iterations();
+
+    return target;
+}
+
+void set_kdf_iterations(uint32_t iterations) {
+    configuredIterations = iterations;
+}
+
+static string encode_ab64(const uint8_t* data, size_t size) {
+    string out;
+    out.reserve((size * 4 + 2) / 3);
+
+    for (size_t i = 0; i < size; i += 3) {
+        uint32_t v = uint32_t(data[i]) << 16;
+        if (i + 1 < size)
+            v |= uint32_t(data[i + 1]) << 8;
+        if (i + 2 < size)
+            v |= data[i + 2];
+
+        out += AB64[(v >> 18) & 63];
+        out += AB64[(v >> 12) & 63];
+        if (i + 1 < size)
+            out += AB64[(v >> 6) & 63];
+        if (i + 2 < size)
+            out += AB64[v & 63];
+    }
+
+    return out;
+}
+
+// Decodifica para `out`; retorna false se houver caractere inválido ou se o
+// tamanho não for exatamente `size` bytes.
+static bool decode_ab64(const string& text, uint8_t* out, size_t size) {
+    if (text.size() != (size * 4 + 2) / 3)
+        return false;
+
+    uint32_t v = 0;
+    int bits = 0;
+    size_t n = 0;
+
+    for (char c : text) {
+        const char* p = std::strchr(AB64, c);
+        if (!p || !c)
+            return false;
+
+        v = (v << 6) | uint32_t(p - AB64);
+        bits += 6;
+
+        if (bits >= 8) {
+            bits -= 8;
+            out[n++] = (v >> bits) & 0xff;
+        }
+    }
+
+    return n == size;
+}
+
+string hash_password(const string& pwd, uint32_t iterations) {
+    if (iterations == 0)
+        iterations = kdf_iterations();
+
+    static thread_local mt19937_64 generator(random_device{}());
+
+    uint8_t salt[KDF_SALT_BYTES];
+    for (size_t i = 0; i < sizeof(salt); i += 8) {
+        uint64_t r = generator();
+        std::memcpy(salt + i, &r, min<size_t>(8, sizeof(salt) - i));
+    }
+
+    uint8_t digest[KDF_HASH_BYTES];
+    pbkdf2_sha256(pwd, salt, sizeof(salt), iterations, digest, sizeof(digest));
+
+    return KDF_PREFIX + to_string(iterations) + "$" +
+           encode_ab64(salt, sizeof(salt)) + "$" +
+           encode_ab64(digest, sizeof(digest));
+}
+
+vector<string> hash_passwords(const vector<string>& pwds,
+                              uint32_t iterations) {
+    // Calibra antes de dividir o trabalho, para que os blocos não disputem
+    // a primeira medição.
+    if (iterations == 0)
+        iterations = kdf_iterations();
+
+    vector<string> hashes(pwds.size());
+    ThreadPool& pool = ThreadPool::shared();
+    size_t chunks = min(pwds.size(), pool.size() * PARALLEL_CHUNKS_PER_THREAD);
+
+    if (chunks < 2) {
+        for (size_t i = 0; i < pwds.size(); ++i)
+            hashes[i] = hash_password(pwds[i], iterations);
+
+        return hashes;
+    }
+
+    size_t chunkSize = (pwds.size() + chunks - 1) / chunks;
+
+    auto runChunk = [&](size_t begin) {
+        size_t end = min(pwds.size(), begin + chunkSize);
+
+        for (size_t i = begin; i < end; ++i)
+            hashes[i] = hash_password(pwds[i], iterations);
+    };
+
+    vector<future<void>> pending;
+
+    for (size_t begin = chunkSize; begin < pwds.size(); begin += chunkSize)
+        pending.push_back(
+            pool.submit([&runChunk, begin]() { runChunk(begin); }, &pending));
+
+    // Os blocos escrevem em `hashes`: todos precisam terminar antes do
+    // retorno, mesmo que algum lance uma exceção.
+    exception_ptr error;
+
+    try {
+        runChunk(0);
+    } catch (...) {
+        error = current_exception();
+    }
+
+    for (auto& chunk : pending) {
+        try {
+            pool.await(chunk, &pending);
+        } catch (...) {
+            if (!error)
+                error = current_exception();
+        }
+    }
+
+    if (error)
+        rethrow_exception(error);
+
+    return hashes;
+}
+
+uint32_t kdf_hash_iterations(const string& cypher) {
+    const size_t prefix = std::strlen(KDF_PREFIX);
+
+    if (cypher.compare(0, prefix, KDF_PREFIX) != 0)
+        return 0;
+
+    uint64_t iterations = 0;
+    size_t i = prefix;
+
+    for (; i < cypher.size() && cypher[i] != '$'; ++i) {
+        if (cypher[i] < '0' || cypher[i] > '9' || iterations > UINT32_MAX / 10)
+            return 0;
+        iterations = iterations * 10 + (cypher[i] - '0');
+    }
+
+    if (i == prefix || i == cypher.size() || iterations > UINT32_MAX)
+        return 0;
+
+    return static_cast<uint32_t>(iterations);
+}
+
+bool kdf_needs_rehash(const string& cypher) {
+    uint32_t iterations = kdf_hash_iterations(cypher);
+    if (iterations == 0)
+        return true;
+
+    return iterations < kdf_iterations();
+}
+
+bool verify_kdf(const string& cypher, const string& pwd) {
+    uint32_t iterations = kdf_hash_iterations(cypher);
+    if (iterations == 0)
+        return false;
+
+    size_t saltStart = cypher.find('$', std::strlen(KDF_PREFIX)) + 1;
+    size_t saltEnd = cypher.find('$', saltStart);
+    if (saltEnd == string::npos)
+        return false;
+
+    uint8_t salt[KDF_SALT_BYTES], expected[KDF_HASH_BYTES];
+
+    if (!decode_ab64(cypher.substr(saltStart, saltEnd - saltStart), salt,
+                     sizeof(salt)) ||
+        !decode_ab64(cypher.substr(saltEnd + 1), expected, sizeof(expected)))
+        return false;
+
+    uint8_t digest[KDF_HASH_BYTES];
+    pbkdf2_sha256(pwd, salt, sizeof(salt), iterations, digest, sizeof(digest));
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < sizeof(digest); ++i)
+        diff |= digest[i] ^ expected[i];
+
+    return diff == 0;
+}
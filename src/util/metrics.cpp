@@ -0,0 +1,283 @@
+#include "util/metrics.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+using std::endl;
+using std::fixed;
+using std::left;
+using std::length_error;
+using std::lock_guard;
+using std::make_pair;
+using std::make_unique;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+using std::mutex;
+using std::ofstream;
+using std::ostream;
+using std::right;
+using std::setprecision;
+using std::setw;
+using std::string;
+using std::vector;
+
+#define SUB_BUCKET_BITS 3
+#define SUB_BUCKETS (1 << SUB_BUCKET_BITS)
+#define LINEAR_LIMIT (2 * SUB_BUCKETS)
+#define MAX_EXPONENT 39
+
+thread_local MetricsRegistry::ThreadHistograms* MetricsRegistry::current =
+    nullptr;
+
+size_t LatencyHistogram::bucketOf(uint64_t ns) {
+    if (ns < LINEAR_LIMIT)
+        return ns;
+
+    int exponent = 63 - __builtin_clzll(ns);
+
+    if (exponent > MAX_EXPONENT)
+        return HISTOGRAM_BUCKETS - 1;
+
+    size_t sub = (ns >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+
+    return LINEAR_LIMIT + (exponent - 4) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::lowerBound(size_t bucket) {
+    if (bucket < LINEAR_LIMIT)
+        return bucket;
+
+    size_t exponent = (bucket - LINEAR_LIMIT) / SUB_BUCKETS + 4;
+    uint64_t sub = (bucket - LINEAR_LIMIT) % SUB_BUCKETS;
+
+    return (SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS);
+}
+
+uint64_t LatencyHistogram::upperBound(size_t bucket) {
+    if (bucket < LINEAR_LIMIT)
+        return bucket;
+
+    size_t exponent = (bucket - LINEAR_LIMIT) / SUB_BUCKETS + 4;
+
+    return lowerBound(bucket) + (uint64_t(1) << (exponent - SUB_BUCKET_BITS)) -
+           1;
+}
+
+void HistogramSnapshot::merge(const LatencyHistogram& histogram) {
+    buckets.resize(HISTOGRAM_BUCKETS, 0);
+
+    for (size_t i = 0; i < HISTOGRAM_BUCKETS; ++i)
+        buckets[i] += histogram.buckets[i].load(memory_order_relaxed);
+
+    count += histogram.count.load(memory_order_relaxed);
+    sum += histogram.sum.load(memory_order_relaxed);
+
+    uint64_t other = histogram.max.load(memory_order_relaxed);
+    if (other > max)
+        max = other;
+}
+
+uint64_t HistogramSnapshot::percentile(double p) const {
+    uint64_t total = 0;
+    for (uint64_t c : buckets)
+        total += c;
+
+    if (total == 0)
+        return 0;
+
+    uint64_t rank = static_cast<uint64_t>(p * (total - 1)) + 1;
+    uint64_t seen = 0;
+
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+
+        if (seen >= rank) {
+            uint64_t lower = LatencyHistogram::lowerBound(i);
+            uint64_t mid =
+                lower + (LatencyHistogram::upperBound(i) - lower) / 2;
+            return mid < max ? mid : max;
+        }
+    }
+
+    return max;
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    // Nunca destruído: threads podem gravar métricas durante o encerramento.
+    static MetricsRegistry* registry = new MetricsRegistry();
+    return *registry;
+}
+
+bool MetricsRegistry::enabled() {
+#ifdef ENABLE_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+MetricsRegistry::ThreadHistograms& MetricsRegistry::local() {
+    if (!current) {
+        lock_guard<mutex> lock(mx);
+        threads.push_back(make_unique<ThreadHistograms>());
+        current = threads.back().get();
+    }
+
+    return *current;
+}
+
+size_t MetricsRegistry::id(const string& name) {
+    lock_guard<mutex> lock(mx);
+
+    auto it = ids.find(name);
+    if (it != ids.end())
+        return it->second;
+
+    if (names.size() >= METRICS_MAX)
+        throw length_error("Limite de métricas excedido: " + name);
+
+    names.push_back(name);
+    ids.emplace(name, names.size() - 1);
+
+    return names.size() - 1;
+}
+
+void MetricsRegistry::record(size_t id, uint64_t ns) {
+    ThreadHistograms& histograms = local();
+    LatencyHistogram* histogram =
+        histograms.slots[id].load(memory_order_relaxed);
+
+    if (!histogram) {
+        histograms.owned.push_back(make_unique<LatencyHistogram>());
+        histogram = histograms.owned.back().get();
+        histograms.slots[id].store(histogram, memory_order_release);
+    }
+
+    histogram->record(ns);
+}
+
+vector<HistogramSnapshot> MetricsRegistry::snapshot() const {
+    lock_guard<mutex> lock(mx);
+
+    vector<HistogramSnapshot> result(names.size());
+
+    for (size_t id = 0; id < names.size(); ++id) {
+        result[id].name = names[id];
+        result[id].buckets.assign(HISTOGRAM_BUCKETS, 0);
+
+        for (const auto& thread : threads) {
+            if (auto* h = thread->slots[id].load(memory_order_acquire))
+                result[id].merge(*h);
+        }
+    }
+
+    return result;
+}
+
+Counter& MetricsRegistry::counter(const string& family, const string& labels) {
+    lock_guard<mutex> lock(mx);
+
+    Counter*& slot = counterIds[make_pair(family, labels)];
+
+    if (!slot) {
+        counters.emplace_back(0);
+        slot = &counters.back();
+    }
+
+    return *slot;
+}
+
+// Escapa um valor de rótulo do Prometheus.
+static string label(const string& value) {
+    string out;
+
+    for (char c : value) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+
+    return out;
+}
+
+void MetricsRegistry::write(ostream& out, MetricsFormat format) const {
+    vector<HistogramSnapshot> metrics = snapshot();
+    static const double quantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+    if (format == MetricsFormat::PROMETHEUS) {
+        out << "# HELP appointment_latency_seconds Latência das operações "
+               "instrumentadas.\n"
+            << "# TYPE appointment_latency_seconds summary\n";
+
+        for (const auto& m : metrics) {
+            string op = "op=\"" + label(m.name) + "\"";
+
+            for (double q : quantiles)
+                out << "appointment_latency_seconds{" << op << ",quantile=\""
+                    << q << "\"} " << m.percentile(q) / 1e9 << "\n";
+
+            out << "appointment_latency_seconds_sum{" << op << "} "
+                << m.sum / 1e9 << "\n"
+                << "appointment_latency_seconds_count{" << op << "} "
+                << m.count << "\n";
+        }
+
+        writeCounters(out, format);
+
+        return;
+    }
+
+    if (!enabled())
+        out << "# histogramas desativados (compile com METRICS=1)" << endl;
+
+    out << left << setw(40) << "operacao" << right << setw(10) << "n"
+        << setw(12) << "media(us)" << setw(12) << "p50(us)" << setw(12)
+        << "p90(us)" << setw(12) << "p99(us)" << setw(12) << "max(us)"
+        << endl;
+
+    out << fixed << setprecision(1);
+
+    for (const auto& m : metrics) {
+        out << left << setw(40) << m.name << right << setw(10) << m.count
+            << setw(12) << (m.count ? m.sum / 1e3 / m.count : 0.0) << setw(12)
+            << m.percentile(0.5) / 1e3 << setw(12) << m.percentile(0.9) / 1e3
+            << setw(12) << m.percentile(0.99) / 1e3 << setw(12)
+            << m.max / 1e3 << endl;
+    }
+
+    out << endl;
+    writeCounters(out, format);
+}
+
+void MetricsRegistry::writeCounters(ostream& out, MetricsFormat format) const {
+    lock_guard<mutex> lock(mx);
+
+    string family;
+
+    // O mapa é ordenado por família, então cada família sai contígua.
+    for (const auto& entry : counterIds) {
+        if (format == MetricsFormat::PROMETHEUS &&
+            entry.first.first != family) {
+            family = entry.first.first;
+            out << "# TYPE " << family << " counter\n";
+        }
+
+        out << entry.first.first;
+        if (!entry.first.second.empty())
+            out << "{" << entry.first.second << "}";
+        out << " " << entry.second->load(memory_order_relaxed) << "\n";
+    }
+}
+
+bool MetricsRegistry::dump(const string& path, MetricsFormat format) const {
+    ofstream out(path, std::ios::trunc);
+
+    if (!out.is_open())
+        return false;
+
+    write(out, format);
+
+    return true;
+}
@@ -0,0 +1,48 @@
+#include "util/passwordVerifier.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "util/utils.hpp"
+
+using std::function;
+using std::max;
+using std::runtime_error;
+using std::string;
+using std::thread;
+
+PasswordVerifier::PasswordVerifier(size_t threads, size_t capacity)
+    : pool(max<size_t>(threads, 1)), capacity(max<size_t>(capacity, 1)) {}
+
+PasswordVerifier& PasswordVerifier::shared() {
+    static PasswordVerifier verifier(thread::hardware_concurrency() / 2,
+                                     PASSWORD_VERIFIER_CAPACITY);
+
+    return verifier;
+}
+
+bool PasswordVerifier::verify(const string& cypher, const string& pwd) {
+    if (inFlight.fetch_add(1) >= capacity) {
+        --inFlight;
+        throw runtime_error(
+            "Muitas verificações de senha em andamento. Tente novamente.");
+    }
+
+    // Libera a vaga mesmo se a verificação lançar.
+    struct Slot {
+        std::atomic<size_t>& count;
+        ~Slot() { --count; }
+    } slot{inFlight};
+
+    auto result = pool.submit([&cypher, &pwd]() { return check(cypher, pwd); });
+
+    return result.get();
+}
+
+void PasswordVerifier::post(function<void()> job) {
+    pool.post(std::move(job));
+}
+
+size_t PasswordVerifier::pending() const {
+    return inFlight.load();
+}
@@ -0,0 +1,67 @@
+#include "util/rateLimiter.hpp"
+
+#include <algorithm>
+
+using std::make_shared;
+using std::max;
+using std::memory_order_relaxed;
+using std::shared_ptr;
+using std::string;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+TokenBucket::TokenBucket(double perSecond, uint32_t burst)
+    : interval(static_cast<int64_t>(1e9 / perSecond)),
+      tolerance(interval * max<uint32_t>(burst, 1)) {}
+
+bool TokenBucket::tryAcquire(int64_t now) {
+    int64_t current = fullAt.load(memory_order_relaxed);
+
+    while (true) {
+        int64_t next = max(current, now) + interval;
+
+        if (next - now > tolerance)
+            return false;
+
+        if (fullAt.compare_exchange_weak(current, next, memory_order_relaxed))
+            return true;
+    }
+}
+
+bool TokenBucket::full(int64_t now) const {
+    return fullAt.load(memory_order_relaxed) <= now;
+}
+
+RateLimiter::RateLimiter(double keyRate, uint32_t keyBurst, double globalRate,
+                         uint32_t globalBurst)
+    : keyRate(keyRate), keyBurst(keyBurst), global(globalRate, globalBurst) {}
+
+bool RateLimiter::allow(const string& key) {
+    int64_t now =
+        duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+            .count();
+
+    if (requests.fetch_add(1, memory_order_relaxed) %
+            RATE_LIMITER_SWEEP_EVERY ==
+        RATE_LIMITER_SWEEP_EVERY - 1)
+        sweep(now);
+
+    // O lock do fragmento cobre só a busca; a ficha é consumida fora dele.
+    shared_ptr<TokenBucket> bucket = buckets.getOrCreate(key, [this]() {
+        return make_shared<TokenBucket>(keyRate, keyBurst);
+    });
+
+    return bucket->tryAcquire(now) && global.tryAcquire(now);
+}
+
+void RateLimiter::sweep(int64_t now) {
+    buckets.eraseIf(
+        [now](const string&, const shared_ptr<TokenBucket>& bucket) {
+            return bucket->full(now);
+        });
+}
+
+size_t RateLimiter::tracked() const {
+    return buckets.size();
+}
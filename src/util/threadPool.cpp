@@ -0,0 +1,132 @@
+#include "util/threadPool.hpp"
+
+#include <algorithm>
+
+using std::find_if;
+using std::function;
+using std::lock_guard;
+using std::make_unique;
+using std::mutex;
+using std::thread;
+using std::unique_lock;
+
+// Identifica a fila da thread corrente; threads de fora de qualquer pool têm
+// owner nulo.
+static thread_local const ThreadPool* owner = nullptr;
+static thread_local size_t ownerIndex = 0;
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0)
+        threads = thread::hardware_concurrency();
+    if (threads == 0)
+        threads = 1;
+
+    for (size_t i = 0; i < threads; ++i)
+        queues.push_back(make_unique<Queue>());
+
+    for (size_t i = 0; i < threads; ++i)
+        workers.emplace_back([this, i]() { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(sleepMx);
+        stopping = true;
+    }
+
+    cv.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+
+    return pool;
+}
+
+size_t ThreadPool::localIndex() const {
+    return owner == this ? ownerIndex : queues.size();
+}
+
+void ThreadPool::post(function<void()> task, const void* batch) {
+    size_t index = localIndex();
+
+    if (index == queues.size())
+        index = nextQueue++ % queues.size();
+
+    {
+        lock_guard<mutex> lock(queues[index]->mx);
+        queues[index]->tasks.push_back(Task{std::move(task), batch});
+    }
+
+    {
+        lock_guard<mutex> lock(sleepMx);
+        ++pending;
+    }
+
+    cv.notify_one();
+}
+
+bool ThreadPool::take(size_t home, function<void()>& task,
+                      const void* batch) {
+    size_t count = queues.size();
+    auto matches = [batch](const Task& t) {
+        return !batch || t.batch == batch;
+    };
+
+    if (home < count) {
+        Queue& local = *queues[home];
+        lock_guard<mutex> lock(local.mx);
+
+        auto it = find_if(local.tasks.rbegin(), local.tasks.rend(), matches);
+
+        if (it != local.tasks.rend()) {
+            task = std::move(it->fn);
+            local.tasks.erase(std::next(it).base());
+            --pending;
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i <= count; ++i) {
+        Queue& victim = *queues[(home + i) % count];
+        lock_guard<mutex> lock(victim.mx);
+
+        auto it = find_if(victim.tasks.begin(), victim.tasks.end(), matches);
+
+        if (it != victim.tasks.end()) {
+            task = std::move(it->fn);
+            victim.tasks.erase(it);
+            --pending;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t ThreadPool::size() const {
+    return workers.size();
+}
+
+void ThreadPool::workerLoop(size_t index) {
+    owner = this;
+    ownerIndex = index;
+
+    while (true) {
+        function<void()> task;
+
+        if (take(index, task)) {
+            task();
+            continue;
+        }
+
+        unique_lock<mutex> lock(sleepMx);
+        cv.wait(lock, [this]() { return stopping || pending > 0; });
+
+        if (stopping && pending == 0)
+            return;
+    }
+}
@@ -0,0 +1,164 @@
+#include "util/tracing.hpp"
+
+#include <fstream>
+#include <iomanip>
+
+using std::fixed;
+using std::lock_guard;
+using std::make_unique;
+using std::memory_order_relaxed;
+using std::memory_order_release;
+using std::mutex;
+using std::ofstream;
+using std::setprecision;
+using std::string;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+thread_local Tracer::Buffer* Tracer::local = nullptr;
+thread_local TraceContext Tracer::current;
+
+Tracer& Tracer::instance() {
+    // Nunca destruído: threads podem encerrar spans durante o encerramento.
+    static Tracer* tracer = new Tracer();
+    return *tracer;
+}
+
+void Tracer::start() {
+    {
+        lock_guard<mutex> lock(mx);
+
+        for (auto& buffer : buffers) {
+            lock_guard<mutex> bufferLock(buffer->mx);
+            buffer->events.clear();
+        }
+
+        epoch = steady_clock::now();
+        dropped = 0;
+    }
+
+    active.store(true, memory_order_release);
+}
+
+void Tracer::stop() {
+    active.store(false, memory_order_relaxed);
+}
+
+TraceContext Tracer::context() {
+    return current;
+}
+
+uint64_t Tracer::now() const {
+    return duration_cast<nanoseconds>(steady_clock::now() - epoch).count();
+}
+
+void Tracer::record(const TraceEvent& event) {
+    if (!local) {
+        lock_guard<mutex> lock(mx);
+        buffers.push_back(make_unique<Buffer>());
+        local = buffers.back().get();
+        local->tid = buffers.size();
+    }
+
+    lock_guard<mutex> lock(local->mx);
+
+    if (local->events.size() >= TRACE_MAX_EVENTS_PER_THREAD) {
+        dropped.fetch_add(1, memory_order_relaxed);
+        return;
+    }
+
+    local->events.push_back(event);
+}
+
+// Escapa uma string para JSON.
+static string quote(const char* value) {
+    string out = "\"";
+
+    for (const char* c = value; *c; ++c) {
+        if (*c == '"' || *c == '\\')
+            out += '\\';
+        out += *c;
+    }
+
+    return out + "\"";
+}
+
+bool Tracer::write(const string& path) const {
+    ofstream out(path, std::ios::trunc);
+
+    if (!out.is_open())
+        return false;
+
+    out << fixed << setprecision(3);
+    out << "{\"displayTimeUnit\": \"ms\", \"otherData\": {\"dropped\": "
+        << dropped.load(memory_order_relaxed) << "},\n\"traceEvents\": [";
+
+    lock_guard<mutex> lock(mx);
+    bool first = true;
+
+    for (const auto& buffer : buffers) {
+        lock_guard<mutex> bufferLock(buffer->mx);
+
+        for (const auto& e : buffer->events) {
+            out << (first ? "\n" : ",\n") << "{\"name\": " << quote(e.name)
+                << ", \"cat\": \"app\", \"ph\": \"X\", \"pid\": 1, \"tid\": "
+                << buffer->tid << ", \"ts\": " << e.startNs / 1e3
+                << ", \"dur\": " << e.durationNs / 1e3
+                << ", \"args\": {\"request\": " << e.request;
+
+            if (e.origin)
+                out << ", \"origem\": " << quote(e.origin);
+
+            out << "}}";
+            first = false;
+        }
+    }
+
+    out << "\n]}\n";
+
+    return true;
+}
+
+TraceSpan::TraceSpan(const char* name) : name(name), origin(nullptr) {
+    if (Tracer::instance().enabled())
+        open(Tracer::current);
+}
+
+TraceSpan::TraceSpan(const char* name, const TraceContext& parent)
+    : name(name), origin(parent.span) {
+    if (!Tracer::instance().enabled())
+        return;
+
+    TraceContext context = Tracer::current;
+    if (context.request == 0)
+        context.request = parent.request;
+
+    open(context);
+}
+
+void TraceSpan::open(const TraceContext& parent) {
+    Tracer& tracer = Tracer::instance();
+
+    saved = Tracer::current;
+    Tracer::current.request =
+        parent.request ? parent.request
+                       : tracer.nextRequest.fetch_add(1, memory_order_relaxed);
+    Tracer::current.span = name;
+
+    active = true;
+    start = tracer.now();
+}
+
+TraceSpan::~TraceSpan() {
+    if (!active)
+        return;
+
+    Tracer& tracer = Tracer::instance();
+    uint64_t end = tracer.now();
+
+    tracer.record({name, origin, Tracer::current.request, start, end - start});
+
+    Tracer::current = saved;
+}
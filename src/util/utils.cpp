@@ -1,28 +1,35 @@
 #include "util/utils.hpp"
 
+#include <cctype>
+#include <charconv>
 #include <iomanip>
 #include <random>
+#include <string_view>
+
+#include "util/kdf.hpp"
+#include "util/metrics.hpp"
+#include "util/tracing.hpp"
 
 using std::cin;
 using std::cout;
 using std::endl;
-using std::get_time;
 using std::hash;
-using std::istringstream;
 using std::mt19937;
 using std::numeric_limits;
-using std::ostringstream;
-using std::put_time;
 using std::random_device;
 using std::setfill;
 using std::setw;
 using std::streamsize;
 using std::string;
+using std::string_view;
 using std::stringstream;
 using std::to_string;
 using std::uniform_int_distribution;
 using std::vector;
 
+// Número de dias na tabela de deslocamentos de fuso de cada thread.
+#define TZ_MEMO_DAYS 512
+
 const string CHARSET =
     "./"
     "0123456789"
@@ -32,6 +39,7 @@ const size_t CHARSET_LEN = 64;
 const size_t SALT_LEN = 16;
 const size_t HASH_LEN = 11;
 const string ALGO_PREFIX = "$mk$";
+const int64_t SECONDS_PER_DAY = 86400;
 
 string generate_salt() {
     auto rand_char = []() -> char {
@@ -59,6 +67,19 @@ string encode_digest(size_t hash) {
     return encoded_hash;
 }
 
+// Rodadas do hash legado: mesmo resultado de hash<string>(to_string(h)), mas
+// com a representação decimal montada na pilha, sem alocar a cada rodada.
+static size_t legacy_rounds(size_t hash_value, int iterations) {
+    char digits[24];
+
+    for (int i = 0; i < iterations; ++i) {
+        auto end = std::to_chars(digits, digits + sizeof(digits), hash_value);
+        hash_value = hash<string_view>{}(string_view(digits, end.ptr - digits));
+    }
+
+    return hash_value;
+}
+
 string mock_bcrypt(const string& pwd, int cost_factor) {
     int iterations = static_cast<int>(pow(2, cost_factor));
 
@@ -67,10 +88,7 @@ string mock_bcrypt(const string& pwd, int cost_factor) {
     string to_hash = pwd + salt;
     size_t hash_value = hash<string>{}(to_hash);
 
-    for (int i = 0; i < iterations; ++i) {
-        to_hash = to_string(hash_value);
-        hash_value = hash<string>{}(to_hash);
-    }
+    hash_value = legacy_rounds(hash_value, iterations);
 
     string encoded_hash = encode_digest(hash_value);
 
@@ -82,6 +100,12 @@ string mock_bcrypt(const string& pwd, int cost_factor) {
 }
 
 bool check(const string& cypher, const string& pwd) {
+    METRIC_SCOPE("check");
+    TRACE_SPAN("check");
+
+    if (cypher.compare(0, string(KDF_PREFIX).size(), KDF_PREFIX) == 0)
+        return verify_kdf(cypher, pwd);
+
     stringstream ss(cypher);
     string segment;
     vector<string> parts;
@@ -106,10 +130,7 @@ bool check(const string& cypher, const string& pwd) {
     string to_hash = pwd + stored_salt;
     size_t hash_value = hash<string>{}(to_hash);
 
-    for (int i = 0; i < iterations; ++i) {
-        to_hash = to_string(hash_value);
-        hash_value = hash<string>{}(to_hash);
-    }
+    hash_value = legacy_rounds(hash_value, iterations);
 
     string new_digest = encode_digest(hash_value);
 
@@ -155,37 +176,246 @@ void desenhar_relogio() {
     cout << endl;
 }
 
+// Dias desde 01/01/1970 de uma data do calendário gregoriano.
+static int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const int64_t era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// Ano, mês e dia de um número de dias desde 01/01/1970.
+static void civil_from_days(int64_t z, int64_t& y, unsigned& m, unsigned& d) {
+    z += 719468;
+    const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(z - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+
+    d = doy - (153 * mp + 2) / 5 + 1;
+    m = mp < 10 ? mp + 3 : mp - 9;
+    y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+static int64_t floor_div(int64_t a, int64_t b) {
+    return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+// Deslocamento do fuso local em um instante, pela biblioteca C (lento).
+static int64_t local_offset(Timestamp tt) {
+    tm local = {};
+#ifdef _WIN32
+    localtime_s(&local, &tt);
+#else
+    localtime_r(&tt, &local);
+#endif
+
+    int64_t seconds =
+        days_from_civil(local.tm_year + 1900, local.tm_mon + 1,
+                        local.tm_mday) *
+            SECONDS_PER_DAY +
+        local.tm_hour * 3600 + local.tm_min * 60 + local.tm_sec;
+
+    return seconds - tt;
+}
+
+/**
+ * @brief Deslocamentos do fuso em um dia UTC: `before` até `transition`
+ * (exclusivo) e `after` a partir dele. Sem mudança de horário no dia,
+ * `transition` é o início do dia seguinte.
+ */
+struct DayOffset {
+    int64_t day = INT64_MIN;
+    int64_t transition = 0;
+    int64_t before = 0;
+    int64_t after = 0;
+};
+
+// Deslocamento do fuso local, memoizado por dia em uma tabela da thread: a
+// biblioteca C só é consultada na primeira vez que um dia aparece.
+static int64_t utc_offset(Timestamp tt) {
+    static thread_local DayOffset memo[TZ_MEMO_DAYS];
+
+    int64_t day = floor_div(tt, SECONDS_PER_DAY);
+    DayOffset& entry = memo[static_cast<uint64_t>(day) % TZ_MEMO_DAYS];
+
+    if (entry.day != day) {
+        int64_t start = day * SECONDS_PER_DAY;
+        int64_t lo = start, hi = start + SECONDS_PER_DAY - 1;
+
+        entry.day = day;
+        entry.before = local_offset(lo);
+        entry.after = local_offset(hi);
+        entry.transition = start + SECONDS_PER_DAY;
+
+        if (entry.before != entry.after) {
+            // Busca binária do segundo em que o deslocamento muda.
+            while (hi - lo > 1) {
+                int64_t mid = lo + (hi - lo) / 2;
+                (local_offset(mid) == entry.before ? lo : hi) = mid;
+            }
+            entry.transition = hi;
+        }
+    }
+
+    return tt < entry.transition ? entry.before : entry.after;
+}
+
+size_t format_timestamp(Timestamp tt, char* out) {
+    int64_t local = tt + utc_offset(tt);
+    int64_t day = floor_div(local, SECONDS_PER_DAY);
+    int64_t seconds = local - day * SECONDS_PER_DAY;
+    int64_t year;
+    unsigned month, mday;
+
+    civil_from_days(day, year, month, mday);
+
+    unsigned hour = seconds / 3600, minute = seconds % 3600 / 60;
+
+    out[0] = '0' + mday / 10;
+    out[1] = '0' + mday % 10;
+    out[2] = '/';
+    out[3] = '0' + month / 10;
+    out[4] = '0' + month % 10;
+    out[5] = ' ';
+    out[6] = '0' + hour / 10;
+    out[7] = '0' + hour % 10;
+    out[8] = ':';
+    out[9] = '0' + minute / 10;
+    out[10] = '0' + minute % 10;
+    out[11] = '\0';
+
+    return TIMESTAMP_TEXT_SIZE - 1;
+}
+
 string timestamp_to_string(Timestamp tt) {
-    tm tm_struct = *localtime(&tt);
+    char text[TIMESTAMP_TEXT_SIZE];
+    size_t size = format_timestamp(tt, text);
 
-    ostringstream ss;
-    ss << put_time(&tm_struct, "%d/%m %H:%M");
-    return ss.str();
+    return string(text, size);
 }
 
-Timestamp string_to_timestamp(const string& timeStr) {
-    tm tm_struct = {};
-    istringstream ss(timeStr);
+// Lê um campo numérico de 1 a `width` dígitos, após espaços opcionais (como
+// os campos de std::get_time).
+static bool read_field(const char*& p, const char* end, unsigned& value,
+                       int width = 2) {
+    while (p != end && isspace(static_cast<unsigned char>(*p)))
+        ++p;
+
+    int digits = 0;
+    value = 0;
+
+    while (p != end && digits < width && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p++ - '0');
+        ++digits;
+    }
+
+    return digits > 0;
+}
 
-    ss >> get_time(&tm_struct, "%d/%m %H:%M");
+static bool read_literal(const char*& p, const char* end, char c) {
+    if (p == end || *p != c)
+        return false;
 
-    if (ss.fail()) {
+    ++p;
+    return true;
+}
+
+Timestamp local_timestamp(int year, unsigned month, unsigned day,
+                          unsigned hour, unsigned minute) {
+    static const unsigned DAYS_IN_MONTH[] = {31, 28, 31, 30, 31, 30,
+                                             31, 31, 30, 31, 30, 31};
+    bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+
+    if (month < 1 || month > 12 || day < 1 || hour > 23 || minute > 59 ||
+        day > DAYS_IN_MONTH[month - 1] + (month == 2 && leap)) {
         return (Timestamp)-1;
     }
 
-    int original_day = tm_struct.tm_mday;
-    int original_mon = tm_struct.tm_mon;
+    int64_t local = days_from_civil(year, month, day) * SECONDS_PER_DAY +
+                    hour * 3600 + minute * 60;
+
+    // O deslocamento depende do instante UTC, que ainda não se conhece. Os
+    // candidatos são os deslocamentos vigentes um dia antes e um dia depois;
+    // como no mktime, um horário repetido (fim do horário de verão) fica com
+    // a primeira ocorrência.
+    int64_t before = local - utc_offset(local - SECONDS_PER_DAY);
+    int64_t after = local - utc_offset(local + SECONDS_PER_DAY);
+    bool beforeValid = before + utc_offset(before) == local;
+    bool afterValid = after + utc_offset(after) == local;
+
+    if (beforeValid && afterValid)
+        return std::min(before, after);
+    if (beforeValid)
+        return before;
+    if (afterValid)
+        return after;
+
+    // Horário inexistente (início do horário de verão): corrige a estimativa
+    // pelo deslocamento do próprio instante.
+    return local - utc_offset(local - utc_offset(local));
+}
 
-    const int ANO_BASE = 2025;
-    tm_struct.tm_year = ANO_BASE - 1900;
-    tm_struct.tm_isdst = -1;
+int local_year(Timestamp tt) {
+    int64_t local = tt + utc_offset(tt);
+    int64_t year;
+    unsigned month, mday;
 
-    Timestamp result = mktime(&tm_struct);
+    civil_from_days(floor_div(local, SECONDS_PER_DAY), year, month, mday);
 
-    if (result == (Timestamp)-1 || tm_struct.tm_mday != original_day ||
-        tm_struct.tm_mon != original_mon) {
+    return static_cast<int>(year);
+}
+
+Timestamp string_to_timestamp(const string& timeStr, Timestamp reference) {
+    const char* p = timeStr.data();
+    const char* end = p + timeStr.size();
+    unsigned mday, month, hour, minute;
+
+    if (!read_field(p, end, mday) || !read_literal(p, end, '/') ||
+        !read_field(p, end, month) || !read_field(p, end, hour) ||
+        !read_literal(p, end, ':') || !read_field(p, end, minute)) {
         return (Timestamp)-1;
     }
 
-    return result;
-}
\ No newline at end of file
+    // O ano é o da próxima ocorrência a partir da referência. Um 29/02 pode
+    // estar até 8 anos à frente (ex: 2097 -> 2104).
+    int year = local_year(reference);
+
+    for (int i = 0; i <= 8; ++i) {
+        Timestamp result = local_timestamp(year + i, month, mday, hour, minute);
+
+        if (result != (Timestamp)-1 && result >= reference)
+            return result;
+    }
+
+    return (Timestamp)-1;
+}
+
+Timestamp string_to_end_timestamp(const string& timeStr, Timestamp inicio) {
+    int64_t local = inicio + utc_offset(inicio);
+    int64_t year;
+    unsigned month, mday;
+
+    civil_from_days(floor_div(local, SECONDS_PER_DAY), year, month, mday);
+
+    return string_to_timestamp(
+        timeStr, local_timestamp(static_cast<int>(year), month, mday, 0, 0));
+}
+
+Timestamp string_to_date(const string& dateStr) {
+    const char* p = dateStr.data();
+    const char* end = p + dateStr.size();
+    unsigned mday, month, year;
+
+    if (!read_field(p, end, mday) || !read_literal(p, end, '/') ||
+        !read_field(p, end, month) || !read_literal(p, end, '/') ||
+        !read_field(p, end, year, 4) || year < 1000) {
+        return (Timestamp)-1;
+    }
+
+    return local_timestamp(year, month, mday, 0, 0);
+}
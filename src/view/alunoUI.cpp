@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include "util/academicTerm.hpp"
+#include "util/tracing.hpp"
 #include "util/utils.hpp"
 
 using std::cin;
@@ -18,46 +20,71 @@ static void imprimir_menu();
 static void imprimir_confirmacao();
 
 AlunoUI::AlunoUI(AlunoController& ac, ProfessorController& pc,
-                 AgendamentoController& agc,
+                 HorarioController& hc, AgendamentoController& agc,
                  const shared_ptr<SessionService>& ss)
     : ConsoleUI(ss),
       alunoController(ac),
       professorController(pc),
+      horarioController(hc),
       agendamentoController(agc) {}
 
 void AlunoUI::agendar_horario() {
-    cout << "\n--- Professores ---" << endl;
+    TRACE_SPAN("AlunoUI::agendar_horario");
 
-    vector<shared_ptr<Professor>> professores;
+    ProfessorCursor cursor;
+    size_t pagina = 1;
+    shared_ptr<Professor> prof;
+
+    while (!prof) {
+        ProfessorPage page;
+
+        try {
+            page = this->professorController.listPage(cursor,
+                                                      ALUNO_UI_PAGE_SIZE);
+        } catch (const exception& e) {
+            cout << "\n>> ERRO ao listar professores: " << e.what() << endl;
+            return;
+        }
+
+        const auto& professores = page.professores;
 
-    try {
-        professores = this->professorController.list();
         if (professores.empty()) {
             cout << "\n>> Nenhum professor cadastrado no sistema." << endl;
             return;
         }
 
+        cout << "\n--- Professores (página " << pagina << ") ---" << endl;
+
         for (size_t i = 0; i < professores.size(); i++) {
-            const auto& prof = professores[i];
+            const auto& p = professores[i];
 
-            cout << '#' << (i + 1) << " | Nome: " << prof->getNome()
-                 << " | Disciplina: " << prof->getDisciplina() << endl;
+            cout << '#' << (i + 1) << " | Nome: " << p->getNome()
+                 << " | Disciplina: " << p->getDisciplina() << endl;
         }
-    } catch (const exception& e) {
-        cout << "\n>> ERRO ao listar professores: " << e.what() << endl;
-        return;
-    }
 
-    size_t profIdx = read_integer_range(
-        "Escolha um professor (0 para cancelar): ", 0, professores.size());
+        size_t opcoes = professores.size();
 
-    if (profIdx == 0) {
-        cout << "\n>> Agendamento cancelado." << endl;
-        return;
+        if (page.hasMore)
+            cout << '#' << ++opcoes << " | Próxima página" << endl;
+
+        size_t profIdx = read_integer_range(
+            "Escolha um professor (0 para cancelar): ", 0, opcoes);
+
+        if (profIdx == 0) {
+            cout << "\n>> Agendamento cancelado." << endl;
+            return;
+        }
+
+        if (profIdx <= professores.size()) {
+            prof = professores[profIdx - 1];
+        } else {
+            cursor = page.next;
+            ++pagina;
+        }
     }
 
-    const auto& prof = professores[profIdx - 1];
-    const auto& horarios = prof->getHorariosDisponiveis();
+    auto disponiveis = prof->getHorariosDisponiveis();
+    const auto& horarios = *disponiveis;
 
     cout << "\n--- Horários Disponíveis ---" << endl;
 
@@ -81,8 +108,95 @@ void AlunoUI::agendar_horario() {
         return;
     }
 
-    const auto& horario = horarios[horarioIdx - 1];
+    enviar_agendamento(horarios[horarioIdx - 1]);
+}
+
+void AlunoUI::buscar_horarios_livres() {
+    TRACE_SPAN("AlunoUI::buscar_horarios_livres");
+
+    string deStr, ateStr, disciplina;
+
+    cout << "\n--- Buscar Horários Livres ---" << endl;
+
+    cout << "De (dd/mm/aaaa, vazio para agora): ";
+    getline(cin, deStr);
+
+    cout << "Até (dd/mm/aaaa, vazio para o fim do período letivo): ";
+    getline(cin, ateStr);
+
+    cout << "Disciplina (vazio para todas): ";
+    getline(cin, disciplina);
+
+    Timestamp de = deStr.empty() ? time(nullptr) : string_to_date(deStr);
+    Timestamp ate =
+        ateStr.empty() ? current_term().fim : string_to_date(ateStr);
+
+    if (de == -1 || ate == -1) {
+        cout << "\n>> ERRO DE VALIDAÇÃO: Data inválida." << endl;
+        return;
+    }
+
+    // A data final entra inteira na busca.
+    if (!ateStr.empty())
+        ate += 86400;
+
+    TimeIndex::Cursor cursor;
+    size_t pagina = 1;
+
+    while (true) {
+        HorarioPage page;
+
+        try {
+            page = horarioController.buscarDisponiveis(
+                de, ate, disciplina, cursor, ALUNO_UI_PAGE_SIZE);
+        } catch (const exception& e) {
+            cout << "\n>> ERRO ao buscar horários: " << e.what() << endl;
+            return;
+        }
+
+        const auto& horarios = page.horarios;
+
+        if (horarios.empty()) {
+            cout << "\n>> Nenhum horário disponível no período." << endl;
+            return;
+        }
+
+        cout << "\n--- Horários Livres (página " << pagina << ") ---" << endl;
+
+        for (size_t i = 0; i < horarios.size(); i++) {
+            const auto& h = horarios[i];
+            const auto& prof = h->getProfessor();
+
+            cout << '#' << (i + 1) << " | Início: " << h->getInicioStr()
+                 << " | Fim: " << h->getFimStr()
+                 << " | Professor: " << prof->getNome() << " ("
+                 << prof->getDisciplina() << ")" << endl;
+        }
+
+        size_t opcoes = horarios.size();
 
+        if (page.hasMore)
+            cout << '#' << ++opcoes << " | Próxima página" << endl;
+
+        size_t escolha = read_integer_range(
+            "Escolha um horário para agendar (0 para cancelar): ", 0, opcoes);
+
+        if (escolha == 0) {
+            cout << "\n>> Agendamento cancelado." << endl;
+            return;
+        }
+
+        if (escolha <= horarios.size()) {
+            enviar_agendamento(horarios[escolha - 1]);
+            return;
+        }
+
+        cursor = page.next;
+        ++pagina;
+    }
+}
+
+void AlunoUI::enviar_agendamento(const shared_ptr<Horario>& horario) {
     try {
         long alunoId = sessionService->getAluno()->getId();
         long horarioId = horario->getId();
@@ -93,7 +207,7 @@ void AlunoUI::agendar_horario() {
                 "=="
              << endl;
         cout << "✅ SUCESSO! Agendamento enviado:" << endl;
-        cout << "   Professor: " << prof->getNome() << endl;
+        cout << "   Professor: " << horario->getProfessor()->getNome() << endl;
         cout << "   Início: " << horario->getInicioStr() << endl;
         cout << "   Fim: " << horario->getFimStr() << endl;
         cout << "================================================"
@@ -105,6 +219,8 @@ void AlunoUI::agendar_horario() {
 }
 
 void AlunoUI::atualizar_perfil() {
+    TRACE_SPAN("AlunoUI::atualizar_perfil");
+
     try {
         const auto& current = sessionService->getAluno();
         long alunoId = current->getId();
@@ -156,42 +272,73 @@ void AlunoUI::atualizar_perfil() {
 }
 
 void AlunoUI::visualizar_agendamentos() {
-    const auto& aluno = sessionService->getAluno();
-    auto& agendamentos = aluno->getAgendamentos();
+    TRACE_SPAN("AlunoUI::visualizar_agendamentos");
 
-    cout << "\n--- Meus Agendamentos ---" << endl;
+    long alunoId = sessionService->getAluno()->getId();
+    AgendamentoCursor cursor;
+    size_t pagina = 1;
 
-    if (agendamentos.empty()) {
-        cout << "\n>> Nenhum agendamento cadastrado." << endl;
-        return;
-    }
+    while (true) {
+        AgendamentoPage page;
 
-    for (const auto& a : agendamentos) {
         try {
-            auto horario = a->getHorario();
-            auto professor = horario->getProfessor();
-
-            cout << "Professor: " << professor->getNome()
-                 << " | Início: " << horario->getInicioStr()
-                 << " | Fim: " << horario->getFimStr()
-                 << " | Status: " << a->getStatusStr() << endl;
-        } catch (const invalid_argument& e) {
-            cout << "\n>> ERRO DE VALIDAÇÃO: " << e.what() << endl;
-            cout << ">> Tente novamente com dados válidos." << endl;
-        } catch (const runtime_error& e) {
-            cout << "\n>> ERRO INTERNO DO SISTEMA: Falha ao resgatar o horário."
-                 << endl;
-            cout << ">> Detalhes do Erro: " << e.what() << endl;
-        } catch (...) {
-            cout << "\n>> ERRO DESCONHECIDO: Ocorreu uma falha inesperada "
-                    "durante "
-                    "a listagem."
-                 << endl;
+            page = agendamentoController.listarPorAluno(alunoId, cursor,
+                                                        ALUNO_UI_PAGE_SIZE);
+        } catch (const exception& e) {
+            cout << "\n>> ERRO ao listar agendamentos: " << e.what() << endl;
+            return;
+        }
+
+        const auto& agendamentos = page.agendamentos;
+
+        if (agendamentos.empty()) {
+            cout << "\n>> Nenhum agendamento cadastrado." << endl;
+            return;
+        }
+
+        cout << "\n--- Meus Agendamentos (página " << pagina << ") ---"
+             << endl;
+
+        for (const auto& a : agendamentos) {
+            try {
+                auto horario = a->getHorario();
+                auto professor = horario->getProfessor();
+
+                cout << "Professor: " << professor->getNome()
+                     << " | Início: " << horario->getInicioStr()
+                     << " | Fim: " << horario->getFimStr()
+                     << " | Status: " << a->getStatusStr() << endl;
+            } catch (const invalid_argument& e) {
+                cout << "\n>> ERRO DE VALIDAÇÃO: " << e.what() << endl;
+                cout << ">> Tente novamente com dados válidos." << endl;
+            } catch (const runtime_error& e) {
+                cout << "\n>> ERRO INTERNO DO SISTEMA: Falha ao resgatar o "
+                        "horário."
+                     << endl;
+                cout << ">> Detalhes do Erro: " << e.what() << endl;
+            } catch (...) {
+                cout << "\n>> ERRO DESCONHECIDO: Ocorreu uma falha inesperada "
+                        "durante a listagem."
+                     << endl;
+            }
         }
+
+        if (!page.hasMore)
+            return;
+
+        cout << "#1 | Próxima página" << endl;
+
+        if (read_integer_range("Escolha uma opção (0 para sair): ", 0, 1) == 0)
+            return;
+
+        cursor = page.next;
+        ++pagina;
     }
 }
 
 void AlunoUI::cancelar_agendamento() {
+    TRACE_SPAN("AlunoUI::cancelar_agendamento");
+
     const auto& aluno = sessionService->getAluno();
     auto cancelaveis = aluno->getAgendamentosCancelaveis();
 
@@ -238,6 +385,8 @@ void AlunoUI::cancelar_agendamento() {
 }
 
 void AlunoUI::deletar_perfil() {
+    TRACE_SPAN("AlunoUI::deletar_perfil");
+
     cout << "\n--- Deletar perfil ---" << endl;
 
     imprimir_confirmacao();
@@ -276,7 +425,7 @@ bool AlunoUI::show() {
         desenhar_relogio();
         imprimir_menu();
 
-        opcao = read_integer_range("Escolha uma opcao: ", 0, 6);
+        opcao = read_integer_range("Escolha uma opcao: ", 0, 7);
 
         switch (opcao) {
             case 0:
@@ -285,18 +434,21 @@ bool AlunoUI::show() {
                 agendar_horario();
                 break;
             case 2:
-                visualizar_agendamentos();
+                buscar_horarios_livres();
                 break;
             case 3:
-                cancelar_agendamento();
+                visualizar_agendamentos();
                 break;
             case 4:
-                atualizar_perfil();
+                cancelar_agendamento();
                 break;
             case 5:
-                deletar_perfil();
+                atualizar_perfil();
                 break;
             case 6:
+                deletar_perfil();
+                break;
+            case 7:
                 fazer_logout();
                 break;
         }
@@ -311,11 +463,12 @@ bool AlunoUI::show() {
 void imprimir_menu() {
     cout << "MENU ALUNO:" << endl;
     cout << "1 - Agendar Horário" << endl;
-    cout << "2 - Listar meus agendamentos" << endl;
-    cout << "3 - Cancelar agendamento" << endl;
-    cout << "4 - Atualizar Perfil" << endl;
-    cout << "5 - Deletar perfil" << endl;
-    cout << "6 - Logout" << endl;
+    cout << "2 - Buscar horários livres" << endl;
+    cout << "3 - Listar meus agendamentos" << endl;
+    cout << "4 - Cancelar agendamento" << endl;
+    cout << "5 - Atualizar Perfil" << endl;
+    cout << "6 - Deletar perfil" << endl;
+    cout << "7 - Logout" << endl;
     cout << "0 - Sair do programa" << endl;
 }
 
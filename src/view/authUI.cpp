@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include "util/metrics.hpp"
+#include "util/tracing.hpp"
 #include "util/utils.hpp"
 
 using std::cin;
@@ -26,6 +28,8 @@ AuthUI::AuthUI(AlunoController& ac, ProfessorController& pc,
       professorController(pc) {}
 
 void AuthUI::fazer_login() {
+    TRACE_SPAN("AuthUI::fazer_login");
+
     imprimir_menu_login();
 
     int opcao = read_integer_range("Escolha uma opcao: ", 0, 2);
@@ -43,6 +47,8 @@ void AuthUI::fazer_login() {
 }
 
 void AuthUI::fazer_cadastro() {
+    TRACE_SPAN("AuthUI::fazer_cadastro");
+
     imprimir_menu_signup();
 
     int opcao = read_integer_range("Escolha uma opcao: ", 0, 2);
@@ -60,6 +66,8 @@ void AuthUI::fazer_cadastro() {
 }
 
 void AuthUI::login_aluno() {
+    TRACE_SPAN("AuthUI::login_aluno");
+
     string email, senha;
 
     cout << "\n--- Entrar Aluno ---" << endl;
@@ -90,6 +98,8 @@ void AuthUI::login_aluno() {
 }
 
 void AuthUI::login_professor() {
+    TRACE_SPAN("AuthUI::login_professor");
+
     string email, senha;
 
     cout << "\n--- Entrar Professor ---" << endl;
@@ -122,6 +132,8 @@ void AuthUI::login_professor() {
 }
 
 void AuthUI::cadastro_aluno() {
+    TRACE_SPAN("AuthUI::cadastro_aluno");
+
     string nome, email, senha;
     long matricula;
 
@@ -170,6 +182,8 @@ void AuthUI::cadastro_aluno() {
 }
 
 void AuthUI::cadastro_professor() {
+    TRACE_SPAN("AuthUI::cadastro_professor");
+
     string nome, email, senha, disciplina;
 
     cout << "\n--- Cadastrar Novo Professor ---" << endl;
@@ -222,6 +236,11 @@ bool AuthUI::show() {
                 break;
             case 2:
                 fazer_cadastro();
+                break;
+            case 3:
+                // Comando oculto: despeja latências e contadores.
+                cout << endl;
+                MetricsRegistry::instance().write(cout, MetricsFormat::TEXT);
         }
 
         cout << "\nPressione Enter para continuar...";
@@ -2,6 +2,7 @@
 
 #include <iostream>
 
+#include "util/tracing.hpp"
 #include "util/utils.hpp"
 
 using std::cin;
@@ -12,6 +13,7 @@ using std::invalid_argument;
 using std::runtime_error;
 using std::shared_ptr;
 using std::string;
+using std::vector;
 
 static void imprimir_menu();
 static void imprimir_opcoes();
@@ -26,6 +28,8 @@ ProfessorUI::ProfessorUI(ProfessorController& pc, HorarioController& hc,
       agendamentoController(ac) {}
 
 void ProfessorUI::cadastro_horario() {
+    TRACE_SPAN("ProfessorUI::cadastro_horario");
+
     string inicioStr, fimStr;
 
     cout << "\n--- Cadastrar Novo Horário ---" << endl;
@@ -45,7 +49,7 @@ void ProfessorUI::cadastro_horario() {
     cout << "Data e hora de término (ex: 1/11 09:00): ";
     getline(cin, fimStr);
 
-    Timestamp fim = string_to_timestamp(fimStr);
+    Timestamp fim = string_to_end_timestamp(fimStr, inicio);
 
     if (fim == -1) {
         cout << "\n>> ERRO DE VALIDAÇÃO: Data e hora de término inválidas."
@@ -79,6 +83,8 @@ void ProfessorUI::cadastro_horario() {
 }
 
 void ProfessorUI::listar_horarios() {
+    TRACE_SPAN("ProfessorUI::listar_horarios");
+
     cout << "\n--- Meus Horários ---" << endl;
 
     try {
@@ -108,6 +114,8 @@ void ProfessorUI::listar_horarios() {
 }
 
 void ProfessorUI::excluir_horario() {
+    TRACE_SPAN("ProfessorUI::excluir_horario");
+
     cout << "\n--- Excluir Horário ---" << endl;
 
     const auto& prof = sessionService->getProfessor();
@@ -162,6 +170,8 @@ void ProfessorUI::excluir_horario() {
 }
 
 void ProfessorUI::excluir_todos_horarios() {
+    TRACE_SPAN("ProfessorUI::excluir_todos_horarios");
+
     cout << "\n--- Excluir Todos os Meus Horários ---" << endl;
 
     try {
@@ -198,6 +208,8 @@ void ProfessorUI::excluir_todos_horarios() {
 }
 
 void ProfessorUI::atualizar_perfil() {
+    TRACE_SPAN("ProfessorUI::atualizar_perfil");
+
     try {
         const auto& current = sessionService->getProfessor();
         long professorId = current->getId();
@@ -239,6 +251,8 @@ void ProfessorUI::atualizar_perfil() {
 }
 
 void ProfessorUI::deletar_perfil() {
+    TRACE_SPAN("ProfessorUI::deletar_perfil");
+
     cout << "\n--- Deletar perfil ---" << endl;
 
     imprimir_confirmacao();
@@ -272,6 +286,8 @@ void ProfessorUI::deletar_perfil() {
 }
 
 void ProfessorUI::fazer_avaliacoes() {
+    TRACE_SPAN("ProfessorUI::fazer_avaliacoes");
+
     cout << "\n--- Gerenciar Agendamentos Pendentes ---" << endl;
 
     bool keepRunning = true;
@@ -282,17 +298,11 @@ void ProfessorUI::fazer_avaliacoes() {
 }
 
 bool ProfessorUI::avaliar_agendamentos() {
-    const auto& professor = sessionService->getProfessor();
-    auto horarios = professor->getHorariosDisponiveis();
-
-    Horario::AgendamentoVector agendamentos;
-
-    for (auto& horario : horarios) {
-        auto pendentes = horario->getAgendamentosPendentes();
+    TRACE_SPAN("ProfessorUI::avaliar_agendamentos");
 
-        agendamentos.insert(agendamentos.begin(), pendentes.begin(),
-                            pendentes.end());
-    }
+    const auto& professor = sessionService->getProfessor();
+    auto pendentes = agendamentoController.listarPendentes(professor->getId());
+    const auto& agendamentos = *pendentes;
 
     if (agendamentos.empty()) {
         cout << "\n>> Nenhum agendamento pendente." << endl;
@@ -309,15 +319,24 @@ bool ProfessorUI::avaliar_agendamentos() {
              << " | Início: " << horario->getInicioStr()
              << " | Fim: " << horario->getFimStr() << endl;
     }
+    cout << '#' << (agendamentos.size() + 1) << " | Todos os agendamentos"
+         << endl;
+
     size_t agtIdx = read_integer_range(
         "\nEscolha um agendamento para confirmar ou recusar (0 para "
         "voltar): ",
-        0, agendamentos.size());
+        0, agendamentos.size() + 1);
 
     if (agtIdx == 0) {
         cout << "\n>> Voltando ao menu principal." << endl;
         return false;
     }
+
+    if (agtIdx > agendamentos.size()) {
+        responder_todos(agendamentos);
+        return true;
+    }
+
     size_t vectorIndex = agtIdx - 1;
     const auto& agendamento = agendamentos[vectorIndex];
 
@@ -349,7 +368,53 @@ bool ProfessorUI::avaliar_agendamentos() {
     return true;
 }
 
+void ProfessorUI::responder_todos(
+    const Horario::AgendamentoVector& agendamentos) {
+    imprimir_opcoes();
+    int escolha = read_integer_range("Escolha uma opção: ", 0, 2);
+
+    if (escolha == 0) {
+        cout << "\n>> Seleção cancelada. Voltando à lista..." << endl;
+        return;
+    }
+
+    long idProfessor = sessionService->getProfessor()->getId();
+    vector<long> ids;
+
+    for (const auto& agendamento : agendamentos)
+        ids.push_back(agendamento->getId());
+
+    try {
+        auto resultados =
+            escolha == 1
+                ? agendamentoController.confirmarPendentes(idProfessor, ids)
+                : agendamentoController.recusarPendentes(idProfessor, ids);
+        size_t total = 0;
+
+        for (const auto& resultado : resultados)
+            if (resultado.sucesso)
+                ++total;
+
+        cout << "\n=========================================" << endl;
+        cout << "✅ SUCESSO! " << total << " de " << ids.size()
+             << (escolha == 1 ? " agendamento(s) CONFIRMADO(S)."
+                              : " agendamento(s) RECUSADO(S).")
+             << endl;
+        cout << "=========================================" << endl;
+
+        for (const auto& resultado : resultados)
+            if (!resultado.sucesso)
+                cout << ">> Agendamento #" << resultado.id << ": "
+                     << resultado.erro << endl;
+    } catch (const exception& e) {
+        cout << "\n>> ERRO AO PROCESSAR AGENDAMENTOS: " << e.what() << endl;
+        cout << ">> Tente novamente." << endl;
+    }
+}
+
 void ProfessorUI::cancelar_agendamento() {
+    TRACE_SPAN("ProfessorUI::cancelar_agendamento");
+
     cout << "\n--- Cancelar Agendamento ---" << endl;
 
     const auto& professor = sessionService->getProfessor();
@@ -357,11 +422,11 @@ void ProfessorUI::cancelar_agendamento() {
 
     Horario::AgendamentoVector agendamentos;
 
-    for (const auto& horario : horarios) {
+    for (const auto& horario : *horarios) {
         auto confirmados = horario->getAgendamentosConfirmados();
 
-        agendamentos.insert(agendamentos.begin(), confirmados.begin(),
-                            confirmados.end());
+        agendamentos.insert(agendamentos.begin(), confirmados->begin(),
+                            confirmados->end());
     }
 
     if (agendamentos.empty()) {